@@ -7,9 +7,9 @@
 #include "LocalClock.h"
 #include "Tests.h"
 #include "VertexStructs.h"
-AfterglowApplication::AfterglowApplication() : 
-	_window(),
-	_renderer(_window), 
+AfterglowApplication::AfterglowApplication(const launch::Options& options) : 
+	_window(options),
+	_renderer(_window, options), 
 	_system(_window, _renderer.materialManager(), _renderer.ui()) {
 	_renderer.bindRenderableContext(_system.renderableContext());
 
@@ -344,4 +344,8 @@ void AfterglowApplication::run() {
 
 	_system.stopSystemThread();
 	_renderer.stopRenderThread();
+}
+
+bool AfterglowApplication::benchmarkPassed() const noexcept {
+	return _renderer.benchmarkPassed();
 }
\ No newline at end of file
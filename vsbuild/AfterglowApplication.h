@@ -5,8 +5,9 @@
 
 class AfterglowApplication {
 public:
-	AfterglowApplication();
+	AfterglowApplication(const launch::Options& options = {});
 	void run();
+	bool benchmarkPassed() const noexcept;
 
 private:
 	AfterglowWindow _window;
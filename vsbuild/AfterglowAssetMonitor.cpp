@@ -4,8 +4,11 @@
 #include <unordered_set>
 #include <thread>
 #include <mutex>
+#include <atomic>
 
 #include "AfterglowTicker.h"
+#include "AfterglowUtilities.h"
+#include "FileWatcher.h"
 #include "LocalClock.h"
 #include "DebugUtilities.h"
 
@@ -16,14 +19,24 @@ struct AfterglowAssetMonitor::Impl {
 	void stopAssetThread();
 
 	void monitorAssetLoop(std::stop_token stopToken);
+	// @brief: Polling fallback, check modified time of all assets every interval.
 	void recordModifiedAssets();
+	// @brief: Wait file events, a file is reported once no event of it arrived for an interval.
+	void recordChangedFiles();
 
 	void applyModifiedCaches();
 	void applyRegisterCaches();
 
+	// @brief: Invoke callbacks if the asset was deleted or its modified time changed.
+	void checkAsset(const std::string& path);
+	void watchAsset(const std::string& path);
+	void unwatchAsset(const std::string& path);
+	// @return: Watched directory of the normalized asset path.
+	static inline std::string watchedDirectory(const std::string& normalizedPath);
+
 	AfterglowAssetMonitor& monitor;
 
-	// Unit seconds.
+	// Unit seconds, polling interval, or debouncing interval of file events.
 	// @note: minimum interval 0.0333f for 30 fps update.
 	float checkInterval = 0.1f;
 	float lastCheckTime = 0.0f;
@@ -41,14 +54,30 @@ struct AfterglowAssetMonitor::Impl {
 	std::unique_ptr<std::jthread> assetThread;
 	std::unordered_set<const std::string*> deletedPathCaches;
 	std::unordered_set<const std::string*> modifiedPathCaches;
+	// Normalized paths of changed files (or directories whose events were overflowed), debounced.
+	std::unordered_set<std::string> changedPathCaches;
 	std::mutex assetThreadMutex;
 
 	AfterglowTicker ticker;
+
+	// Fall back to polling if the platform or any directory is not supported.
+	FileWatcher fileWatcher;
+	std::atomic<bool> eventDriven = false;
+	// Asset thread only.
+	FileWatcher::ChangedPaths changedPathBuffer;
+	std::unordered_map<std::string, std::chrono::steady_clock::time_point> pendingChangedPaths;
+	// Render thread only. <normalizedPath, registeredPath>
+	std::unordered_map<std::string, std::string> watchedAssetPaths;
+	std::unordered_map<std::string, uint32_t> watchedDirectoryCounts;
 };
 
 AfterglowAssetMonitor::AfterglowAssetMonitor() : 
 	_impl(std::make_unique<Impl>(*this)) {
 	_impl->ticker.setMaximumFPS(30.0f);
+	_impl->eventDriven = _impl->fileWatcher.available();
+	if (!_impl->eventDriven) {
+		DEBUG_CLASS_INFO("File events are not supported, assets are polled.");
+	}
 	_impl->startAssetThread();
 }
 
@@ -133,7 +162,12 @@ void AfterglowAssetMonitor::Impl::stopAssetThread() {
 
 void AfterglowAssetMonitor::Impl::monitorAssetLoop(std::stop_token stopToken) {
 	while(!stopToken.stop_requested()) {
-		recordModifiedAssets();
+		if (eventDriven) {
+			recordChangedFiles();
+		}
+		else {
+			recordModifiedAssets();
+		}
 	}
 }
 
@@ -166,9 +200,49 @@ void AfterglowAssetMonitor::Impl::recordModifiedAssets() {
 	modifiedPathCaches = std::move(tempModifiedPathCaches);
 }
 
+void AfterglowAssetMonitor::Impl::recordChangedFiles() {
+	auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(checkInterval));
+	// Timeout makes sure stop request and pending paths are handled in time.
+	fileWatcher.waitChanges(changedPathBuffer, std::chrono::duration_cast<std::chrono::milliseconds>(interval));
+
+	auto now = std::chrono::steady_clock::now();
+	for (const auto& changedPath : changedPathBuffer) {
+		pendingChangedPaths[util::NormalizePath(changedPath)] = now;
+	}
+	changedPathBuffer.clear();
+	if (pendingChangedPaths.empty()) {
+		return;
+	}
+
+	// Editors save a file with several events, report it once.
+	std::lock_guard lock{ assetThreadMutex };
+	std::erase_if(pendingChangedPaths, [this, &now, &interval](const auto& item) {
+		bool settled = now - item.second >= interval;
+		if (settled) {
+			changedPathCaches.insert(item.first);
+		}
+		return settled;
+	});
+}
+
 void AfterglowAssetMonitor::Impl::applyModifiedCaches() {
 	std::lock_guard lock{ assetThreadMutex };
 
+	for (const auto& changedPath : changedPathCaches) {
+		if (auto iterator = watchedAssetPaths.find(changedPath); iterator != watchedAssetPaths.end()) {
+			checkAsset(iterator->second);
+		}
+		else if (watchedDirectoryCounts.contains(changedPath)) {
+			// Events of this directory were lost, check all assets inside it.
+			for (const auto& [normalizedPath, path] : watchedAssetPaths) {
+				if (watchedDirectory(normalizedPath) == changedPath) {
+					checkAsset(path);
+				}
+			}
+		}
+	}
+	changedPathCaches.clear();
+
 	for (const auto* path : deletedPathCaches) {
 		auto& info = monitoredAssets[*path];
 		auto& deletedCallback = deletedCallbacks[info.type];
@@ -202,13 +276,74 @@ void AfterglowAssetMonitor::Impl::applyRegisterCaches() {
 		});
 	 }
 
+	for (const auto& path : unregisterPathCaches) {
+		unwatchAsset(path);
+	}
+
 	for (auto& [path, info] : registerAssetCaches) {
 		DEBUG_CLASS_INFO(std::format("Asset is registered: {}", path));
 		// TODO: Check exists to prevent overwrite
 		// TODO: Due to shared material only update one of them when the shader was updated.
 		monitoredAssets[path] = info;
+		watchAsset(path);
 	}
 	registerAssetCaches.clear();
 	unregisterPathCaches.clear();
 	//DEBUG_COST_END;
 }
+
+void AfterglowAssetMonitor::Impl::checkAsset(const std::string& path) {
+	auto iterator = monitoredAssets.find(path);
+	if (iterator == monitoredAssets.end()) {
+		return;
+	}
+	auto& info = iterator->second;
+	std::error_code error;
+	if (!std::filesystem::exists(path, error)) {
+		auto& deletedCallback = deletedCallbacks[info.type];
+		if (deletedCallback) {
+			deletedCallback(path, info.tagInfos);
+		}
+		monitor.unregisterAsset(path);
+		return;
+	}
+	auto modifiedTime = std::filesystem::last_write_time(path, error);
+	if (error || modifiedTime == info.lastModifiedTime) {
+		return;
+	}
+	info.lastModifiedTime = modifiedTime;
+	auto& modifiedCallback = modifiedCallbacks[info.type];
+	if (modifiedCallback) {
+		modifiedCallback(path, info.tagInfos);
+	}
+}
+
+void AfterglowAssetMonitor::Impl::watchAsset(const std::string& path) {
+	auto normalizedPath = util::NormalizePath(path);
+	if (!watchedAssetPaths.emplace(normalizedPath, path).second) {
+		return;
+	}
+	auto directory = watchedDirectory(normalizedPath);
+	if (watchedDirectoryCounts[directory]++ == 0 && eventDriven && !fileWatcher.watchDirectory(directory)) {
+		DEBUG_CLASS_WARNING(std::format("Failed to watch directory: \"{}\", assets are polled instead.", directory));
+		eventDriven = false;
+	}
+}
+
+void AfterglowAssetMonitor::Impl::unwatchAsset(const std::string& path) {
+	auto iterator = watchedAssetPaths.find(util::NormalizePath(path));
+	if (iterator == watchedAssetPaths.end()) {
+		return;
+	}
+	auto directory = watchedDirectory(iterator->first);
+	watchedAssetPaths.erase(iterator);
+	if (--watchedDirectoryCounts[directory] == 0) {
+		watchedDirectoryCounts.erase(directory);
+		fileWatcher.unwatchDirectory(directory);
+	}
+}
+
+inline std::string AfterglowAssetMonitor::Impl::watchedDirectory(const std::string& normalizedPath) {
+	auto directory = std::filesystem::path(normalizedPath).parent_path().generic_string();
+	return directory.empty() ? "." : directory;
+}
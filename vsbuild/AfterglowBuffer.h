@@ -1,7 +1,7 @@
 #pragma once
 
 #include <string>
-#include "AfterglowDeviceMemory.h"
+#include "AfterglowMemoryAllocator.h"
 #include "AfterglowPhysicalDevice.h"
 
 namespace buffer {
@@ -35,10 +35,8 @@ protected:
 	void cmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcStagingBuffer, VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
 
 	AfterglowDevice& _device;
-	AfterglowDeviceMemory::AsElement _memory;
-
-private:
-	uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+	// As a member, it is released after the buffer was destroyed in destructor.
+	AfterglowMemoryAllocator::Allocation _memory;
 };
 
 
@@ -64,17 +62,9 @@ inline void AfterglowBuffer<DerivedType>::cmdCopyBuffer(VkCommandBuffer commandB
 
 template <typename DerivedType>
 inline void AfterglowBuffer<DerivedType>::initMemory(VkMemoryPropertyFlags properties) {
-	VkMemoryRequirements memoryRequirements;
 	// Remind that data() could not create automatically, so we use *this.
-	vkGetBufferMemoryRequirements(_device, *this, &memoryRequirements);
-	_memory = AfterglowDeviceMemory::makeElement(_device);
-	_memory->allocationSize = memoryRequirements.size;
-	_memory->memoryTypeIndex = findMemoryType(memoryRequirements.memoryTypeBits, properties);
-
-	// Bind buffer with memory.
-	if (vkBindBufferMemory(_device, Parent::data(), _memory, 0) != VK_SUCCESS) {
-		throw Parent::runtimeError("Faild to bind buffer memory.");
-	}
+	// Buffer is bound with the sub allocation inside.
+	_memory = _device.memoryAllocator().allocate(static_cast<VkBuffer>(*this), properties);
 }
 
 template <typename DerivedType>
@@ -94,14 +84,3 @@ inline void AfterglowBuffer<DerivedType>::create() {
 	}
 }
 
-template <typename DerivedType>
-inline uint32_t AfterglowBuffer<DerivedType>::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-	VkPhysicalDeviceMemoryProperties memoryProperties;
-	vkGetPhysicalDeviceMemoryProperties(_device.physicalDevice(), &memoryProperties);
-	for (uint32_t index = 0; index < memoryProperties.memoryTypeCount; ++index) {
-		if ((typeFilter & (1 << index)) && (memoryProperties.memoryTypes[index].propertyFlags & properties)) {
-			return index;
-		}
-	}
-	throw Parent::runtimeError("Failed to find suitable memory type.");
-}
@@ -10,11 +10,12 @@ class AfterglowCommandBuffer : public AfterglowProxyArray<DerivedType, VkCommand
 public:
 	using Parent = AfterglowProxyArray<DerivedType, VkCommandBuffer, VkCommandBufferAllocateInfo>;
 
-	AfterglowCommandBuffer(AfterglowCommandPool& commandPool);
+	AfterglowCommandBuffer(AfterglowCommandPool& commandPool, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 	~AfterglowCommandBuffer();
 
 	// @brief: Current frame command buffer.
 	VkCommandBuffer& current() noexcept;
+	VkCommandBufferLevel level() const noexcept;
 	//uint32_t count();
 
 	void reset(uint32_t currentFrameIndex);
@@ -28,13 +29,15 @@ proxy_base_protected(Parent) :
 
 private:
 	AfterglowCommandPool& _commandPool;
+	VkCommandBufferLevel _level;
 };
 
 
 template<typename DerivedType>
-inline AfterglowCommandBuffer<DerivedType>::AfterglowCommandBuffer(AfterglowCommandPool& commandPool) :
+inline AfterglowCommandBuffer<DerivedType>::AfterglowCommandBuffer(AfterglowCommandPool& commandPool, VkCommandBufferLevel level) :
 	Parent(cfg::maxFrameInFlight),
-	_commandPool(commandPool) {
+	_commandPool(commandPool), 
+	_level(level) {
 	Parent::initialize();
 }
 
@@ -50,6 +53,11 @@ inline VkCommandBuffer& AfterglowCommandBuffer<DerivedType>::current() noexcept
 	return _currentCommandBuffer;
 }
 
+template<typename DerivedType>
+inline VkCommandBufferLevel AfterglowCommandBuffer<DerivedType>::level() const noexcept {
+	return _level;
+}
+
 //template<typename DerivedType>
 //inline uint32_t AfterglowCommandBuffer<DerivedType>::count() {
 //	return sizeof(AfterglowCommandBuffer::Raw) / 0x8;
@@ -63,7 +71,7 @@ inline void AfterglowCommandBuffer<DerivedType>::reset(uint32_t currentFrameInde
 template<typename DerivedType>
 inline void AfterglowCommandBuffer<DerivedType>::initCreateInfo() {
 	Parent::info().sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	Parent::info().level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	Parent::info().level = _level;
 	Parent::info().commandPool = _commandPool;
 	Parent::info().commandBufferCount = cfg::maxFrameInFlight;
 }
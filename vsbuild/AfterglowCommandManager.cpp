@@ -1,15 +1,21 @@
 #include "AfterglowCommandManager.h"
+#include <algorithm>
 #include <backends/imgui_impl_vulkan.h>
 
 #include "AfterglowDrawCommandBuffer.h"
 #include "AfterglowComputeCommandBuffer.h"
+#include "AfterglowDescriptorSetReferences.h"
 #include "AfterglowFramebuffer.h"
 #include "AfterglowMaterialResource.h"
 #include "AfterglowIndexBuffer.h"
+#include "AfterglowPipeline.h"
 #include "AfterglowComputePipeline.h"
 #include "AfterglowPassManager.h"
+#include "AfterglowPhysicalDevice.h"
 #include "ComputeDefinitions.h"
 #include "AfterglowComputeTask.h"
+#include "WorkerPool.h"
+#include "LinearAllocator.h"
 
 struct AfterglowCommandManager::Impl {
 	template<typename PipelineType, typename RecordInfoType>
@@ -29,29 +35,90 @@ struct AfterglowCommandManager::Impl {
 			AfterglowComputePipeline* inPipeline, 
 			AfterglowDescriptorSetReferences* inSetReferences, 
 			AfterglowComputeCommandBuffer::RecordInfo&& inRecordInfo, 
-			std::unique_ptr<PreparingComputeDependency> inPreparing = nullptr
-		) : RecordDependency(inPipeline, inSetReferences, std::move(inRecordInfo)), preparing(std::move(inPreparing)) {}
+			PreparingComputeDependency* inPreparing = nullptr
+		) : RecordDependency(inPipeline, inSetReferences, std::move(inRecordInfo)), preparing(inPreparing) {}
 
-		std::unique_ptr<PreparingComputeDependency> preparing;
+		// Allocated from the frame allocator.
+		PreparingComputeDependency* preparing;
 	};
 
-	using DrawRecordDependency = RecordDependency<AfterglowPipeline, AfterglowDrawCommandBuffer::RecordInfo>;
+	struct DrawRecordDependency : public RecordDependency<AfterglowPipeline, AfterglowDrawCommandBuffer::RecordInfo> {
+		DrawRecordDependency(
+			AfterglowPipeline* inPipeline,
+			AfterglowDescriptorSetReferences* inSetReferences,
+			float inDepth
+		) : RecordDependency(inPipeline, inSetReferences, AfterglowDrawCommandBuffer::RecordInfo{}), depth(inDepth) {}
+
+		// Normalized view depth in [0, 1], for sorting only.
+		float depth;
+	};
 
 	using PerSubpassRecordDependencies = std::vector<DrawRecordDependency>;
 	using PerPassRecordDependencies = std::vector<PerSubpassRecordDependencies>;
 	using DrawRecordDependencies = std::array<std::unique_ptr<PerPassRecordDependencies>, util::EnumValue(render::Domain::EnumCount)>;
 	using ComputeRecordDependencies = std::vector<ComputeRecordDependency>;
 
+	// Continuous draws of a subpass, a worker records them into one secondary command buffer.
+	struct SecondaryRecordChunk {
+		PerSubpassRecordDependencies* subpassRecordInfos;
+		uint32_t subpassIndex;
+		uint32_t begin;
+		uint32_t end;
+		VkCommandBuffer commandBuffer = nullptr;
+		render::BindCounters bindCounters;
+	};
+
+	/**
+	* Draw sort key layout, from high bits to low bits:
+	*	Opaque:      | subpass 4 | pipeline 16 | descriptor sets 16 | mesh 12 | depth 16 (front to back) |
+	*	Transparent: | subpass 4 | depth 16 (back to front) | pipeline 16 | descriptor sets 16 | mesh 12 |
+	* Ids are hashed from pointers and handles, a collision only makes state changes a little more.
+	* Only domains in sortable() are sorted, others (e.g. Decal, PostProcess, UserInterface) rely on the recorded order.
+	*/
+	struct DrawSortKey {
+		static constexpr uint32_t subpassBits = 4;
+		static constexpr uint32_t pipelineBits = 16;
+		static constexpr uint32_t setBits = 16;
+		static constexpr uint32_t meshBits = 12;
+		static constexpr uint32_t depthBits = 16;
+		static_assert(subpassBits + pipelineBits + setBits + meshBits + depthBits == 64);
+
+		static inline bool sortable(render::Domain domain) noexcept;
+		static inline uint64_t make(render::Domain domain, uint32_t subpassIndex, const DrawRecordDependency& dependency) noexcept;
+	};
+
+	// Command pools are externally synchronized, so every worker owns its pool and secondary command buffers.
+	struct RecordWorkerContext {
+		RecordWorkerContext(AfterglowDevice& device) : commandPool(device) {}
+
+		inline AfterglowDrawCommandBuffer& acquireSecondaryCommandBuffer();
+
+		AfterglowCommandPool commandPool;
+		std::vector<std::unique_ptr<AfterglowDrawCommandBuffer>> secondaryCommandBuffers;
+		// Reset every frame.
+		uint32_t usedCount = 0;
+	};
+
 	Impl(AfterglowPassManager& inPassManager);
 
 	inline AfterglowDrawCommandBuffer::RecordInfo* aquireDrawRecordInfo(
-		AfterglowMaterialResource& matResource, AfterglowDescriptorSetReferences& setRefs
+		AfterglowMaterialResource& matResource, AfterglowDescriptorSetReferences& setRefs, float depth = 0.0f
 	);
 
+	// @brief: Radix sort draws of sortable domains by DrawSortKey, so the state tracker of command buffer could skip most of binds.
+	inline void sortSubpassRecordInfos(render::Domain domain, uint32_t subpassIndex, PerSubpassRecordDependencies& subpassRecordInfos);
+
 	inline void drawCustomPassSets(uint32_t domainIndex);
 	inline void applyPassDrawCommands(AfterglowPassInterface& pass, PerPassRecordDependencies& passRecordInfos, int32_t imageIndex);
+	// @return: Chunk count, 0 if draws are not enough for parallel recording.
+	inline uint32_t appendSecondaryRecordChunks(PerSubpassRecordDependencies& subpassRecordInfos, uint32_t subpassIndex);
+	inline void recordSecondaryChunks(AfterglowPassInterface& pass, int32_t imageIndex);
 	inline void applyDrawCommands(int32_t imageIndex);
 	inline void applyComputeCommands();
+	// @param dependOnLastSubmission: Barrier for the SSBOs written by the last submission of the same queue.
+	inline void applyComputeCommands(
+		AfterglowComputeCommandBuffer& commandBuffer, ComputeRecordDependencies& recordInfos, bool dependOnLastSubmission = false
+	);
 
 	// @brief: If material is defined in a custom pass, return false. (don't draw them in the command manager directly)
 	inline bool verifyMaterialDomain(AfterglowMaterialResource& matResource) const noexcept;
@@ -66,18 +133,103 @@ struct AfterglowCommandManager::Impl {
 	AfterglowComputeCommandBuffer computeCommandBuffer;
 	ComputeRecordDependencies computeRecordInfos;
 
+	// Command buffers for dedicated compute queue family should be allocated from the pool of that family.
+	AfterglowCommandPool asyncComputeCommandPool;
+	AfterglowComputeCommandBuffer asyncComputeCommandBuffer;
+	ComputeRecordDependencies asyncComputeRecordInfos;
+	bool asyncComputeApplied = false;
+
 	ImDrawData* uiDrawData = nullptr;
+
+	WorkerPool recordWorkers;
+	std::vector<std::unique_ptr<RecordWorkerContext>> recordWorkerContexts;
+	std::vector<SecondaryRecordChunk> secondaryRecordChunks;
+	std::vector<VkCommandBuffer> secondaryCommandBuffers;
+
+	// Reused sorting storages.
+	std::vector<util::SortEntry> sortEntries;
+	std::vector<util::SortEntry> sortScratch;
+	PerSubpassRecordDependencies sortedRecordInfos;
+
+	// Binds of last applyDrawCommands().
+	render::BindCounters bindCounters;
+
+	// Transient record data of a frame, reset after compute commands were applied.
+	// Draw data of the last frame is dead at that time, and compute data of this frame was consumed.
+	LinearAllocator frameAllocator;
 };
 
+inline bool AfterglowCommandManager::Impl::DrawSortKey::sortable(render::Domain domain) noexcept {
+	switch (domain) {
+	case render::Domain::DepthPrepass:
+	case render::Domain::Shadow:
+	case render::Domain::DeferredGeometry:
+	case render::Domain::Forward:
+	case render::Domain::Transparency:
+		return true;
+	default:
+		return false;
+	}
+}
+
+inline uint64_t AfterglowCommandManager::Impl::DrawSortKey::make(
+	render::Domain domain, uint32_t subpassIndex, const DrawRecordDependency& dependency
+) noexcept {
+	uint64_t subpassID = std::min<uint64_t>(subpassIndex, (1ull << subpassBits) - 1);
+	uint64_t pipelineID = util::HashBits(reinterpret_cast<uint64_t>(dependency.pipeline), pipelineBits);
+	// Objects share material sets and the per object set, so group them by material sets.
+	const void* sets = dependency.setReferences->source() ? 
+		static_cast<const void*>(dependency.setReferences->source()) : static_cast<const void*>(dependency.setReferences);
+	uint64_t setID = util::HashBits(reinterpret_cast<uint64_t>(sets), setBits);
+	uint64_t meshID = util::HashBits(
+		reinterpret_cast<uint64_t>(dependency.recordInfo.vertexBuffer) ^ (reinterpret_cast<uint64_t>(dependency.recordInfo.indexBuffer) << 1), 
+		meshBits
+	);
+	constexpr float maxDepth = static_cast<float>((1u << depthBits) - 1);
+	uint64_t depthID = static_cast<uint64_t>(std::clamp(dependency.depth, 0.0f, 1.0f) * maxDepth);
+
+	uint64_t key = subpassID;
+	if (domain == render::Domain::Transparency) {
+		// Far objects first.
+		key = (key << depthBits) | ((1ull << depthBits) - 1 - depthID);
+		key = (key << pipelineBits) | pipelineID;
+		key = (key << setBits) | setID;
+		key = (key << meshBits) | meshID;
+	}
+	else {
+		key = (key << pipelineBits) | pipelineID;
+		key = (key << setBits) | setID;
+		key = (key << meshBits) | meshID;
+		key = (key << depthBits) | depthID;
+	}
+	return key;
+}
+
+inline AfterglowDrawCommandBuffer& AfterglowCommandManager::Impl::RecordWorkerContext::acquireSecondaryCommandBuffer() {
+	if (usedCount == secondaryCommandBuffers.size()) {
+		secondaryCommandBuffers.push_back(
+			std::make_unique<AfterglowDrawCommandBuffer>(commandPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY)
+		);
+	}
+	return *secondaryCommandBuffers[usedCount++];
+}
+
 AfterglowCommandManager::Impl::Impl(AfterglowPassManager& inPassManager) :
 	passManager(inPassManager),
 	commandPool(passManager.device()),
 	drawCommandBuffer(commandPool),
-	computeCommandBuffer(commandPool) {
+	computeCommandBuffer(commandPool), 
+	asyncComputeCommandPool(passManager.device(), passManager.device().physicalDevice().asyncComputeFamilyIndex()), 
+	asyncComputeCommandBuffer(asyncComputeCommandPool), 
+	recordWorkers(cfg::drawRecordWorkerCount) {
+	recordWorkerContexts.reserve(recordWorkers.workerCount());
+	for (uint32_t workerIndex = 0; workerIndex < recordWorkers.workerCount(); ++workerIndex) {
+		recordWorkerContexts.push_back(std::make_unique<RecordWorkerContext>(passManager.device()));
+	}
 }
 
 inline AfterglowDrawCommandBuffer::RecordInfo* AfterglowCommandManager::Impl::aquireDrawRecordInfo(
-	AfterglowMaterialResource& matResource, AfterglowDescriptorSetReferences& setRefs
+	AfterglowMaterialResource& matResource, AfterglowDescriptorSetReferences& setRefs, float depth
 ) {
 	if (!verifyMaterialDomain(matResource)) {
 		return nullptr;
@@ -92,7 +244,27 @@ inline AfterglowDrawCommandBuffer::RecordInfo* AfterglowCommandManager::Impl::aq
 		return nullptr;
 	}
 	auto& subpassDrawRecordInfos = (*drawRecordInfos[util::EnumValue(domain)])[subpassIndex];
-	return &subpassDrawRecordInfos.emplace_back(&pipeline, &setRefs, AfterglowDrawCommandBuffer::RecordInfo{}).recordInfo;
+	return &subpassDrawRecordInfos.emplace_back(&pipeline, &setRefs, depth).recordInfo;
+}
+
+inline void AfterglowCommandManager::Impl::sortSubpassRecordInfos(
+	render::Domain domain, uint32_t subpassIndex, PerSubpassRecordDependencies& subpassRecordInfos
+) {
+	if (subpassRecordInfos.size() <= 1 || !DrawSortKey::sortable(domain)) {
+		return;
+	}
+	sortEntries.clear();
+	for (uint32_t index = 0; index < subpassRecordInfos.size(); ++index) {
+		sortEntries.push_back({ DrawSortKey::make(domain, subpassIndex, subpassRecordInfos[index]), index });
+	}
+	util::RadixSort(sortEntries, sortScratch);
+
+	sortedRecordInfos.clear();
+	sortedRecordInfos.reserve(subpassRecordInfos.size());
+	for (const auto& entry : sortEntries) {
+		sortedRecordInfos.push_back(std::move(subpassRecordInfos[entry.index]));
+	}
+	subpassRecordInfos.swap(sortedRecordInfos);
 }
 
 inline void AfterglowCommandManager::Impl::drawCustomPassSets(uint32_t domainIndex) {
@@ -101,28 +273,62 @@ inline void AfterglowCommandManager::Impl::drawCustomPassSets(uint32_t domainInd
 		return;
 	}
 	for (auto& customPassSet : *domainCustomPassSets) {
+		if (passManager.renderGraph().culled(*customPassSet)) {
+			continue;
+		}
 		customPassSet->submitCommands(drawCommandBuffer);
 	}
 }
 
 inline void AfterglowCommandManager::Impl::applyPassDrawCommands(AfterglowPassInterface& pass, PerPassRecordDependencies& passRecordInfos, int32_t imageIndex) {
-	drawCommandBuffer.beginRenderPass(pass, imageIndex);
+	bool drawUI = uiDrawData && passManager.isFinalPass(pass);
+	uint32_t subpassCount = static_cast<uint32_t>(passRecordInfos.size());
+
+	// Heavy subpasses are recorded into secondary command buffers by workers first.
+	secondaryRecordChunks.clear();
+	std::pmr::vector<uint32_t> subpassChunkCounts(subpassCount, 0, &frameAllocator);
+	for (uint32_t subpassIndex = 0; subpassIndex < subpassCount; ++subpassIndex) {
+		// UI is recorded inline, a subpass can't mix inline commands and secondary command buffers.
+		if (drawUI && subpassIndex + 1 == subpassCount) {
+			continue;
+		}
+		subpassChunkCounts[subpassIndex] = appendSecondaryRecordChunks(passRecordInfos[subpassIndex], subpassIndex);
+	}
+	recordSecondaryChunks(pass, imageIndex);
+
+	uint32_t chunkIndex = 0;
+	for (uint32_t subpassIndex = 0; subpassIndex < subpassCount; ++subpassIndex) {
+		uint32_t chunkCount = subpassChunkCounts[subpassIndex];
+		VkSubpassContents contents = chunkCount > 0 ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
+		if (subpassIndex == 0) {
+			drawCommandBuffer.beginRenderPass(pass, imageIndex, contents);
+		}
+		else {
+			drawCommandBuffer.nextSubpass(contents);
+		}
 
-	bool isFirstSubpass = true;
-	for (auto& subpassRecordInfos : passRecordInfos) {
-		if (!isFirstSubpass) {
-			drawCommandBuffer.nextSubpass();
+		if (chunkCount > 0) {
+			secondaryCommandBuffers.clear();
+			for (uint32_t index = 0; index < chunkCount; ++index) {
+				secondaryCommandBuffers.push_back(secondaryRecordChunks[chunkIndex + index].commandBuffer);
+			}
+			chunkIndex += chunkCount;
+			drawCommandBuffer.executeCommands(secondaryCommandBuffers.data(), chunkCount);
+			continue;
 		}
-		isFirstSubpass = false;
-		for (auto& [pipeline, setRefs, recordInfo] : subpassRecordInfos) {
-			drawCommandBuffer.setupPipeline(*pipeline);
-			drawCommandBuffer.setupDescriptorSets(*setRefs);
-			drawCommandBuffer.draw(recordInfo);
+
+		for (auto& dependency : passRecordInfos[subpassIndex]) {
+			drawCommandBuffer.setupPipeline(*dependency.pipeline);
+			drawCommandBuffer.setupDescriptorSets(*dependency.setReferences);
+			drawCommandBuffer.draw(dependency.recordInfo);
 		}
 	}
+	if (subpassCount == 0) {
+		drawCommandBuffer.beginRenderPass(pass, imageIndex);
+	}
 
 	// Draw UI
-	if (passManager.isFinalPass(pass)) {
+	if (uiDrawData && passManager.isFinalPass(pass)) {
 		ImGui_ImplVulkan_RenderDrawData(uiDrawData, drawCommandBuffer.current());
 	}
 
@@ -130,18 +336,81 @@ inline void AfterglowCommandManager::Impl::applyPassDrawCommands(AfterglowPassIn
 	drawCommandBuffer.barrier(pass);
 }
 
+inline uint32_t AfterglowCommandManager::Impl::appendSecondaryRecordChunks(PerSubpassRecordDependencies& subpassRecordInfos, uint32_t subpassIndex) {
+	uint32_t drawCount = static_cast<uint32_t>(subpassRecordInfos.size());
+	if (drawCount < cfg::parallelDrawRecordThreshold) {
+		return 0;
+	}
+
+	// Proxy objects are created lazily when they are converted to vulkan handles first time, 
+	// create pipelines here to avoid creating them in different workers concurrently.
+	AfterglowPipeline* lastPipeline = nullptr;
+	for (auto& recordInfo : subpassRecordInfos) {
+		if (recordInfo.pipeline != lastPipeline) {
+			lastPipeline = recordInfo.pipeline;
+			[[maybe_unused]] VkPipeline pipeline = *lastPipeline;
+		}
+	}
+
+	uint32_t chunkCount = 0;
+	for (uint32_t begin = 0; begin < drawCount; begin += cfg::drawRecordChunkSize) {
+		secondaryRecordChunks.push_back({ 
+			.subpassRecordInfos = &subpassRecordInfos, 
+			.subpassIndex = subpassIndex, 
+			.begin = begin, 
+			.end = std::min(begin + cfg::drawRecordChunkSize, drawCount)
+		});
+		++chunkCount;
+	}
+	return chunkCount;
+}
+
+inline void AfterglowCommandManager::Impl::recordSecondaryChunks(AfterglowPassInterface& pass, int32_t imageIndex) {
+	uint32_t frameIndex = commandPool.device().currentFrameIndex();
+	recordWorkers.parallelFor(
+		static_cast<uint32_t>(secondaryRecordChunks.size()), 
+		[this, &pass, imageIndex, frameIndex](uint32_t chunkIndex, uint32_t workerIndex) {
+			auto& chunk = secondaryRecordChunks[chunkIndex];
+			auto& secondaryCommandBuffer = recordWorkerContexts[workerIndex]->acquireSecondaryCommandBuffer();
+			secondaryCommandBuffer.reset(frameIndex);
+			secondaryCommandBuffer.beginSecondaryRecord(pass, chunk.subpassIndex, imageIndex);
+			for (uint32_t index = chunk.begin; index < chunk.end; ++index) {
+				auto& dependency = (*chunk.subpassRecordInfos)[index];
+				secondaryCommandBuffer.setupPipeline(*dependency.pipeline);
+				secondaryCommandBuffer.setupDescriptorSets(*dependency.setReferences);
+				secondaryCommandBuffer.draw(dependency.recordInfo);
+			}
+			secondaryCommandBuffer.endRecord();
+			chunk.commandBuffer = secondaryCommandBuffer.current();
+			chunk.bindCounters = secondaryCommandBuffer.bindCounters();
+		}
+	);
+	for (const auto& chunk : secondaryRecordChunks) {
+		bindCounters += chunk.bindCounters;
+	}
+}
+
 inline void AfterglowCommandManager::Impl::applyDrawCommands(int32_t imageIndex) {
 	drawCommandBuffer.reset(commandPool.device().currentFrameIndex());
 	drawCommandBuffer.beginRecord();
+	for (auto& workerContext : recordWorkerContexts) {
+		workerContext->usedCount = 0;
+	}
+	bindCounters = {};
 
 	for (uint32_t index = 0; index < drawRecordInfos.size(); ++index) {
 		auto& passRecordInfos = drawRecordInfos[index];
 		if (!passRecordInfos) {
 			continue;
 		}
+		for (uint32_t subpassIndex = 0; subpassIndex < passRecordInfos->size(); ++subpassIndex) {
+			sortSubpassRecordInfos(render::Domain(index), subpassIndex, (*passRecordInfos)[subpassIndex]);
+		}
 		// Apply per pass commands.
 		auto* pass = passManager.findPass(render::Domain(index));
-		applyPassDrawCommands(*pass, *passRecordInfos, imageIndex);
+		if (!passManager.renderGraph().culled(*pass)) {
+			applyPassDrawCommands(*pass, *passRecordInfos, imageIndex);
+		}
 
 		// Apply custom pass set commands only if input domain exists.
 		drawCustomPassSets(index);
@@ -153,32 +422,49 @@ inline void AfterglowCommandManager::Impl::applyDrawCommands(int32_t imageIndex)
 	}
 
 	drawCommandBuffer.endRecord();
+	bindCounters += drawCommandBuffer.bindCounters();
 }
 
 inline void AfterglowCommandManager::Impl::applyComputeCommands() {
-	computeCommandBuffer.reset(commandPool.device().currentFrameIndex());
-	computeCommandBuffer.beginRecord();
+	applyComputeCommands(computeCommandBuffer, computeRecordInfos);
+
+	// Nothing to submit, keep the async queue idle.
+	asyncComputeApplied = !asyncComputeRecordInfos.empty();
+	if (asyncComputeApplied) {
+		// Async tasks read the SSBOs written by themselves in last frame.
+		applyComputeCommands(asyncComputeCommandBuffer, asyncComputeRecordInfos, true);
+	}
+	frameAllocator.reset();
+}
+
+inline void AfterglowCommandManager::Impl::applyComputeCommands(
+	AfterglowComputeCommandBuffer& commandBuffer, ComputeRecordDependencies& recordInfos, bool dependOnLastSubmission) {
+	commandBuffer.reset(commandPool.device().currentFrameIndex());
+	commandBuffer.beginRecord();
+	if (dependOnLastSubmission) {
+		commandBuffer.barrier();
+	}
 
-	for (auto& info : computeRecordInfos) {
+	for (auto& info : recordInfos) {
 		// Update preparing computeinfo, indirect etc..
 		if (info.preparing) {
 			// They both keep same descriptorSets, so setup once only.
-			computeCommandBuffer.setupDescriptorSets(*info.setReferences, info.pipeline->pipelineLayout());
-			computeCommandBuffer.setupPipeline(*info.preparing->pipeline);
-			computeCommandBuffer.dispatch(info.preparing->recordInfo);
-			computeCommandBuffer.barrier();
-			computeCommandBuffer.setupPipeline(*info.pipeline);
+			commandBuffer.setupDescriptorSets(*info.setReferences, info.pipeline->pipelineLayout());
+			commandBuffer.setupPipeline(*info.preparing->pipeline);
+			commandBuffer.dispatch(info.preparing->recordInfo);
+			commandBuffer.barrier();
+			commandBuffer.setupPipeline(*info.pipeline);
 		}
 		else {
-			computeCommandBuffer.setupPipeline(*info.pipeline);
-			computeCommandBuffer.setupDescriptorSets(*info.setReferences);
+			commandBuffer.setupPipeline(*info.pipeline);
+			commandBuffer.setupDescriptorSets(*info.setReferences);
 		}
 		// Primary compute commands.
-		computeCommandBuffer.dispatch(info.recordInfo);
+		commandBuffer.dispatch(info.recordInfo);
 	}
-	computeRecordInfos.clear();
+	recordInfos.clear();
 
-	computeCommandBuffer.endRecord();
+	commandBuffer.endRecord();
 }
 
 inline bool AfterglowCommandManager::Impl::verifyMaterialDomain(AfterglowMaterialResource& matResource) const noexcept {
@@ -204,15 +490,25 @@ VkCommandBuffer* AfterglowCommandManager::computeCommandBuffers() noexcept {
 	return &_impl->computeCommandBuffer.current();
 }
 
+VkCommandBuffer* AfterglowCommandManager::asyncComputeCommandBuffers() noexcept {
+	return &_impl->asyncComputeCommandBuffer.current();
+}
+
+bool AfterglowCommandManager::asyncComputeApplied() const noexcept {
+	return _impl->asyncComputeApplied;
+}
+
 bool AfterglowCommandManager::recordDraw(
 	AfterglowMaterialResource& matResource, 
 	AfterglowDescriptorSetReferences& setRefs,
 	AfterglowVertexBufferHandle& vertexBufferHandle,
 	AfterglowIndexBuffer* indexBuffer,
 	AfterglowStorageBuffer* indirectBuffer,
-	uint32_t instanceCount
+	uint32_t instanceCount, 
+	uint32_t firstInstance, 
+	float depth
 ) {
-	auto* recordInfo = _impl->aquireDrawRecordInfo(matResource, setRefs);
+	auto* recordInfo = _impl->aquireDrawRecordInfo(matResource, setRefs, depth);
 	if (!recordInfo) {
 		return false;
 	}
@@ -221,6 +517,7 @@ bool AfterglowCommandManager::recordDraw(
 	// TODO: Same indexBuffer for different vertexBuffers
 	recordInfo->vertexCount = vertexBufferHandle.vertexCount;
 	recordInfo->instanceCount = instanceCount;
+	recordInfo->firstInstance = firstInstance;
 
 	if (indexBuffer) {
 		recordInfo->indexBuffer = *indexBuffer;
@@ -272,13 +569,14 @@ void AfterglowCommandManager::recordCompute(AfterglowMaterialResource& matResour
 	auto frameIndex = _impl->commandPool.device().currentFrameIndex();
 	auto& matLayout = matResource.materialLayout();
 	auto& computeTask = matLayout.material().computeTask();
+	auto& computeRecordInfos = matResource.isAsyncCompute() ? _impl->asyncComputeRecordInfos : _impl->computeRecordInfos;
 
 	// SSBO initialization from compute shader.
 	// Order dependency buffer.
 	if (computeTask.dispatchStatus(frameIndex) == AfterglowComputeTask::DispatchStatus::None) {
 		auto& ssboInitComputePipelines = matLayout.ssboInitComputePipelines();
 		for (AfterglowComputePipeline& pipeline : ssboInitComputePipelines) {
-			_impl->computeRecordInfos.emplace_back(
+			computeRecordInfos.emplace_back(
 				&pipeline, 
 				&setRefs, 
 				AfterglowComputeCommandBuffer::RecordInfo{ computeTask.dispatchGroup() }
@@ -289,7 +587,7 @@ void AfterglowCommandManager::recordCompute(AfterglowMaterialResource& matResour
 	}
 	// Dispatch regular comptue shader.
 	else {
-		auto& info = _impl->computeRecordInfos.emplace_back(
+		auto& info = computeRecordInfos.emplace_back(
 			&matLayout.computePipeline(),
 			&setRefs,
 			AfterglowComputeCommandBuffer::RecordInfo{ computeTask.dispatchGroup() }
@@ -297,7 +595,7 @@ void AfterglowCommandManager::recordCompute(AfterglowMaterialResource& matResour
 		// Find indirect buffer reset pipeline.
 		auto* indirectResetPipeline = matLayout.indirectResetPipeline();
 		if (indirectResetPipeline) {
-			info.preparing = std::make_unique<Impl::PreparingComputeDependency>(
+			info.preparing = _impl->frameAllocator.create<Impl::PreparingComputeDependency>(
 				indirectResetPipeline, AfterglowComputeCommandBuffer::RecordInfo{ {.x = 1, .y = 1, .z = 1} }
 			);
 		}
@@ -308,6 +606,10 @@ void AfterglowCommandManager::applyComputeCommands() {
 	_impl->applyComputeCommands();
 }
 
+const render::BindCounters& AfterglowCommandManager::bindCounters() const noexcept {
+	return _impl->bindCounters;
+}
+
 void AfterglowCommandManager::recordUIDraw(ImDrawData* uiDrawData) {
 	_impl->uiDrawData = uiDrawData;
 }
@@ -3,6 +3,7 @@
 #include <imgui.h>
 
 #include "AfterglowCommandPool.h"
+#include "RenderDefinitions.h"
 
 
 struct ImDrawData;
@@ -24,8 +25,14 @@ public:
 	// But just one commandBuffer is required here.
 	VkCommandBuffer* drawCommandBuffers() noexcept;
 	VkCommandBuffer* computeCommandBuffers() noexcept;
+	// @brief: Command buffers of the dedicated compute queue family.
+	VkCommandBuffer* asyncComputeCommandBuffers() noexcept;
+	// @return: True if the last applyComputeCommands() recorded any async compute task.
+	bool asyncComputeApplied() const noexcept;
 
 	// @brief: Record a StaticMesh!
+	// @param firstInstance: Offset of the object instance buffer for instancing materials.
+	// @param depth: Normalized view depth in [0, 1], draws are sorted by it in a same state.
 	// @return: record successfullys.
 	bool recordDraw(
 		AfterglowMaterialResource& matResource, 
@@ -33,7 +40,9 @@ public:
 		AfterglowVertexBufferHandle& vertexBufferHandle, 
 		AfterglowIndexBuffer* indexBuffer = nullptr, 
 		AfterglowStorageBuffer* indirectBuffer = nullptr, 
-		uint32_t instanceCount = 1
+		uint32_t instanceCount = 1, 
+		uint32_t firstInstance = 0, 
+		float depth = 0.0f
 	);
 
 	// For compute vertex input.
@@ -55,6 +64,9 @@ public:
 	*/
 	void applyDrawCommands(int32_t imageIndex);
 
+	// @brief: Draws and binds recorded by the last applyDrawCommands(), including secondary command buffers.
+	const render::BindCounters& bindCounters() const noexcept;
+
 	void recordCompute(
 		AfterglowMaterialResource& matResource,
 		AfterglowDescriptorSetReferences& setRefs
@@ -4,7 +4,11 @@
 #include "Configurations.h"
 
 AfterglowCommandPool::AfterglowCommandPool(AfterglowDevice& device) : 
-_device(device) {
+	AfterglowCommandPool(device, device.physicalDevice().graphicsFamilyIndex()) {
+}
+
+AfterglowCommandPool::AfterglowCommandPool(AfterglowDevice& device, uint32_t queueFamilyIndex) :
+	_device(device), _queueFamilyIndex(queueFamilyIndex) {
 }
 
 AfterglowCommandPool::~AfterglowCommandPool() {
@@ -21,7 +25,7 @@ void AfterglowCommandPool::initCreateInfo() {
 	info().sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	// Every frame we want to use this commandbuffer, so mark it as RESET
 	info().flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-	info().queueFamilyIndex = _device.physicalDevice().graphicsFamilyIndex();
+	info().queueFamilyIndex = _queueFamilyIndex;
 }
 
 void AfterglowCommandPool::create() {
@@ -4,6 +4,8 @@
 class AfterglowCommandPool : public AfterglowProxyObject<AfterglowCommandPool, VkCommandPool, VkCommandPoolCreateInfo> {
 public:
 	AfterglowCommandPool(AfterglowDevice& device);
+	// @param queueFamilyIndex: Command buffers of this pool can be submitted to queues of this family only.
+	AfterglowCommandPool(AfterglowDevice& device, uint32_t queueFamilyIndex);
 	~AfterglowCommandPool();
 
 	AfterglowDevice& device() noexcept;
@@ -18,6 +20,7 @@ proxy_protected:
 
 private:
 	AfterglowDevice& _device;
+	uint32_t _queueFamilyIndex;
 };
 
 
@@ -12,6 +12,9 @@ AfterglowComputeCommandBuffer::AfterglowComputeCommandBuffer(AfterglowCommandPoo
 
 void AfterglowComputeCommandBuffer::beginRecord() {
 	updateCurrentCommandBuffer();
+	// Bound states are not inherited from the last recording.
+	_currentPipeline = nullptr;
+	_currentSetRefs = nullptr;
 
 	VkCommandBufferBeginInfo beginInfo{
 		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
@@ -42,8 +45,8 @@ void AfterglowComputeCommandBuffer::setupDescriptorSets(const AfterglowDescripto
 			0,
 			setRefs.size(),
 			setRefs.address(),
-			0,
-			nullptr
+			setRefs.dynamicOffsetCount(),
+			setRefs.dynamicOffsets()
 		);
 	}
 }
@@ -57,8 +60,8 @@ void AfterglowComputeCommandBuffer::setupDescriptorSets(const AfterglowDescripto
 			0,
 			setRefs.size(),
 			setRefs.address(),
-			0,
-			nullptr
+			setRefs.dynamicOffsetCount(),
+			setRefs.dynamicOffsets()
 		);
 	}
 }
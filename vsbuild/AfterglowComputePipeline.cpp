@@ -1,4 +1,5 @@
 #include "AfterglowComputePipeline.h"
+#include "AfterglowPipelineCache.h"
 #include "Configurations.h"
 
 AfterglowComputePipeline::AfterglowComputePipeline(AfterglowDevice& device) : 
@@ -35,7 +36,7 @@ void AfterglowComputePipeline::create() {
 	// Delay binding for modify pipline layout after create info.
 	info().layout = _pipelineLayout;
 
-	if (vkCreateComputePipelines(_device, VK_NULL_HANDLE, 1, &info(), nullptr, &data()) != VK_SUCCESS) {
+	if (vkCreateComputePipelines(_device, _device.pipelineCache(), 1, &info(), nullptr, &data()) != VK_SUCCESS) {
 		throw runtimeError("Failed to create compute pipeline.");
 	}
 	_dependencies.reset();
@@ -8,8 +8,16 @@ AfterglowComputeQueue::AfterglowComputeQueue(AfterglowDevice& device) :
 	AfterglowQueue(device, device.physicalDevice().graphicsFamilyIndex()){
 }
 
+AfterglowComputeQueue::AfterglowComputeQueue(AfterglowDevice& device, uint32_t queueFamilyIndex) :
+	AfterglowQueue(device, queueFamilyIndex) {
+}
+
 
 void AfterglowComputeQueue::cancelSemaphore(AfterglowSynchronizer& synchronizer) {
+	// Timeline value needs not to be consumed, next graphics submission waits a greater one.
+	if (synchronizer.timelined()) {
+		return;
+	}
 	synchronizer.wait(AfterglowSynchronizer::FenceFlag::ComputeInFlight);
 	synchronizer.reset(AfterglowSynchronizer::FenceFlag::ComputeInFlight);
 
@@ -22,6 +30,7 @@ void AfterglowComputeQueue::cancelSemaphore(AfterglowSynchronizer& synchronizer)
 	submitInfo.pWaitSemaphores = &synchronizer.semaphore(AfterglowSynchronizer::SemaphoreFlag::ComputeFinished);
 	submitInfo.pWaitDstStageMask = waitStages;
 
+	synchronizer.advance(AfterglowSynchronizer::TimelineFlag::Compute);
 	if (vkQueueSubmit(_queue, 1, &submitInfo, synchronizer.fence(AfterglowSynchronizer::FenceFlag::ComputeInFlight)) != VK_SUCCESS) {
 		EXCEPT_CLASS_RUNTIME("Failed to cancel compute semaphore.");
 	}
@@ -34,9 +43,50 @@ void AfterglowComputeQueue::submit(VkCommandBuffer* commandBuffers, AfterglowSyn
 	submitInfo.pCommandBuffers = commandBuffers;
 
 	submitInfo.signalSemaphoreCount = 1;
-	submitInfo.pSignalSemaphores = &synchronizer.semaphore(AfterglowSynchronizer::SemaphoreFlag::ComputeFinished);
 
-	if (vkQueueSubmit(_queue, 1, &submitInfo, synchronizer.fence(AfterglowSynchronizer::FenceFlag::ComputeInFlight)) != VK_SUCCESS) {
+	uint64_t signalValue = synchronizer.advance(AfterglowSynchronizer::TimelineFlag::Compute);
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	if (synchronizer.timelined()) {
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.signalSemaphoreValueCount = 1;
+		timelineInfo.pSignalSemaphoreValues = &signalValue;
+		submitInfo.pNext = &timelineInfo;
+		submitInfo.pSignalSemaphores = &synchronizer.timelineSemaphore(AfterglowSynchronizer::TimelineFlag::Compute);
+	}
+	else {
+		submitInfo.pSignalSemaphores = &synchronizer.semaphore(AfterglowSynchronizer::SemaphoreFlag::ComputeFinished);
+	}
+
+	if (vkQueueSubmit(_queue, 1, &submitInfo, synchronizer.submitFence(AfterglowSynchronizer::FenceFlag::ComputeInFlight)) != VK_SUCCESS) {
 		EXCEPT_CLASS_RUNTIME("Failed to submit compute command buffer.");
 	}
+}
+
+void AfterglowComputeQueue::submitAsync(VkCommandBuffer* commandBuffers, AfterglowSynchronizer& synchronizer) {
+	VkSemaphore waitSemaphore = synchronizer.timelineSemaphore(AfterglowSynchronizer::TimelineFlag::Render);
+	uint64_t waitValue = synchronizer.submittedValue(AfterglowSynchronizer::TimelineFlag::Render);
+	VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	uint64_t signalValue = synchronizer.advance(AfterglowSynchronizer::TimelineFlag::AsyncCompute);
+
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.waitSemaphoreValueCount = 1;
+	timelineInfo.pWaitSemaphoreValues = &waitValue;
+	timelineInfo.signalSemaphoreValueCount = 1;
+	timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.pWaitSemaphores = &waitSemaphore;
+	submitInfo.pWaitDstStageMask = &waitStage;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = commandBuffers;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &synchronizer.timelineSemaphore(AfterglowSynchronizer::TimelineFlag::AsyncCompute);
+
+	if (vkQueueSubmit(_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+		EXCEPT_CLASS_RUNTIME("Failed to submit async compute command buffer.");
+	}
 }
\ No newline at end of file
@@ -4,15 +4,26 @@
 class AfterglowComputeQueue : public AfterglowQueue {
 public:
 	AfterglowComputeQueue(AfterglowDevice& device);
+	AfterglowComputeQueue(AfterglowDevice& device, uint32_t queueFamilyIndex);
 
 	/*
 	@desc:
 		If semaphore is signaled but in some reasom graphics queue will not submit, 
 		cancel semaphore to avoid repeative signal.
 		This operation includes fence sychronzation, so you don't need to wait and reset them.
+		Timeline backend has nothing to cancel, it returns immediately.
 	*/
 	void cancelSemaphore(AfterglowSynchronizer& synchronizer);
 
 	void submit(VkCommandBuffer* commandBuffers, AfterglowSynchronizer& synchronizer);
+
+	/**
+	* @brief: Submit async compute tasks, they run one frame ahead of graphics.
+	* @desc: 
+	*	Waits the last graphics submission, because it was reading the SSBOs which will be written now.
+	*	Graphics of the next frame waits this submission by AfterglowSynchronizer::TimelineFlag::AsyncCompute.
+	* @warning: Timeline backend only.
+	*/
+	void submitAsync(VkCommandBuffer* commandBuffers, AfterglowSynchronizer& synchronizer);
 };
 
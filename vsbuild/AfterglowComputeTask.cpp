@@ -70,10 +70,18 @@ void AfterglowComputeTask::setComputeOnly(bool computeOnly) noexcept {
 	_computeOnly = computeOnly;
 }
 
+void AfterglowComputeTask::setAsync(bool async) noexcept {
+	_async = async;
+}
+
 void AfterglowComputeTask::setComputeShader(const std::string& computeShaderPath) {
 	_computeShaderPath = computeShaderPath;
 }
 
+void AfterglowComputeTask::setShaderModel(shader::Model shaderModel) noexcept {
+	_shaderModel = shaderModel;
+}
+
 void AfterglowComputeTask::setDispatchGroup(const compute::DispatchGroup& dispatchGroup) noexcept {
 	_dispatchGroup = dispatchGroup;
 }
@@ -101,6 +109,10 @@ bool AfterglowComputeTask::isComputeOnly() const noexcept{
 	return _computeOnly;
 }
 
+bool AfterglowComputeTask::isAsync() const noexcept {
+	return _async;
+}
+
 const AfterglowSSBOInfo* AfterglowComputeTask::vertexInputSSBOInfo() const {
 	return findFirstUsageSSBOInfo(compute::SSBOUsage::VertexInput);
 }
@@ -113,6 +125,10 @@ const std::string& AfterglowComputeTask::computeShaderPath() const noexcept {
 	return _computeShaderPath;
 }
 
+shader::Model AfterglowComputeTask::shaderModel() const noexcept {
+	return _shaderModel;
+}
+
 const compute::DispatchGroup AfterglowComputeTask::dispatchGroup() const noexcept {
 	return _dispatchGroup;
 }
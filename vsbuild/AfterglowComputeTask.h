@@ -53,7 +53,14 @@ public:
 
 	// @brief: If computeOnly == true, material layout will skip graphics layout.
 	void setComputeOnly(bool computeOnly) noexcept;
+	/**
+	* @brief: If async == true, task is submitted on the dedicated compute queue and runs one frame ahead of graphics.
+	* @note: Graphics reads the SSBOs written in the last frame, it falls back to the graphics queue if device does not support async compute.
+	*/
+	void setAsync(bool async) noexcept;
 	void setComputeShader(const std::string& computeShaderPath);
+	// @brief: Requested shader model of the compute shader and SSBO initializer compute shaders.
+	void setShaderModel(shader::Model shaderModel) noexcept;
 	void setDispatchGroup(const compute::DispatchGroup& dispatchGroup) noexcept;
 	void setDispatchFrequency(compute::DispatchFrequency dispatchFrequency) noexcept;
 	void setDispatchStatus(uint32_t frameIndex, DispatchStatus dispatchStatus);
@@ -61,11 +68,13 @@ public:
 	void setDispatchStatuses(DispatchStatus dispatchStatus);
 
 	bool isComputeOnly() const noexcept;
+	bool isAsync() const noexcept;
 	// @return: fist VetexInput usage ssbo index. If vertex input ssbo not found, return a nullptr.
 	const AfterglowSSBOInfo* vertexInputSSBOInfo() const;
 	const AfterglowSSBOInfo* indexInputSSBOInfo() const;
 
 	const std::string& computeShaderPath() const  noexcept;
+	shader::Model shaderModel() const noexcept;
 	const compute::DispatchGroup dispatchGroup() const noexcept;
 	compute::DispatchFrequency dispatchFrequency() const noexcept;
 	DispatchStatus dispatchStatus(uint32_t frameIndex) const;
@@ -107,9 +116,11 @@ private:
 
 
 	bool _computeOnly = false;
+	bool _async = false;
 	compute::DispatchFrequency _dispatchFrequency = compute::DispatchFrequency::Never;
 	std::array<DispatchStatus, cfg::maxFrameInFlight> _inFlightDispatchStatuses = { DispatchStatus::None };
 	std::string _computeShaderPath;
+	shader::Model _shaderModel = shader::Model::SM6_0;
 	compute::DispatchGroup _dispatchGroup = {};
 	SSBOInfos _ssboInfos;
 	ExternalSSBOs _externalSSBOs;
@@ -0,0 +1,13 @@
+#include "AfterglowDeletionQueue.h"
+
+AfterglowDeletionQueue::AfterglowDeletionQueue(AfterglowSynchronizer& synchronizer) :
+	_synchronizer(synchronizer) {
+}
+
+void AfterglowDeletionQueue::update() {
+	_queue.update([this](const AfterglowSynchronizer::TimelinePoint& point) { return _synchronizer.completed(point); });
+}
+
+size_t AfterglowDeletionQueue::pendingCount() const noexcept {
+	return _queue.pendingCount();
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <utility>
+
+#include "AfterglowSynchronizer.h"
+#include "DeletionQueue.h"
+
+/**
+* @brief: Deferred destruction of released vulkan objects, the CPU never waits for the GPU to destroy them.
+* @desc:
+*	Each released object is tagged with the submitted timeline point, the object may be used by any submission before it.
+*	update() destroys objects whose points were completed, in order of release.
+* @note: Not thread safe, release and update objects in the render thread.
+* @warning: Pending objects are destroyed with the queue, make sure the device is idle at that time.
+*/
+class AfterglowDeletionQueue : public AfterglowObject {
+public:
+	AfterglowDeletionQueue(AfterglowSynchronizer& synchronizer);
+
+	/**
+	* @brief: Take the ownership of the object, it is destroyed after all submissions so far were completed.
+	* @note: Release it after the object was detached, submissions which are recorded later should not use it.
+	*/
+	template<typename Type>
+	void release(Type&& object);
+
+	// @brief: Destroy objects whose submissions were completed, never blocks.
+	void update();
+
+	size_t pendingCount() const noexcept;
+
+private:
+	AfterglowSynchronizer& _synchronizer;
+	// Submitted points never decrease, so entries are retired from the front.
+	DeletionQueue<AfterglowSynchronizer::TimelinePoint> _queue;
+};
+
+
+template<typename Type>
+inline void AfterglowDeletionQueue::release(Type&& object) {
+	_queue.release(_synchronizer.submittedPoint(), std::forward<Type>(object));
+}
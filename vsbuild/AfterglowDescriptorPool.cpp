@@ -49,6 +49,24 @@ void AfterglowDescriptorPool::extendImageSamplerPoolSize(uint32_t descriptorCoun
 	);
 }
 
+void AfterglowDescriptorPool::extendStorageBufferPoolSize(uint32_t descriptorCount) {
+	if (isDataExists()) {
+		throw runtimeError("Can not extend pool size because pool has been created.");
+	}
+	_poolSizes.emplace_back(
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, descriptorCount
+	);
+}
+
+void AfterglowDescriptorPool::extendUniformDynamicPoolSize(uint32_t descriptorCount) {
+	if (isDataExists()) {
+		throw runtimeError("Can not extend pool size because pool has been created.");
+	}
+	_poolSizes.emplace_back(
+		VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, descriptorCount
+	);
+}
+
 void AfterglowDescriptorPool::setMaxDescritporSets(uint32_t maxSets) {
 	if (isDataExists()) {
 		throw runtimeError("Can not set descriptor count due to pool has been created.");
@@ -19,6 +19,8 @@ public:
 
 	void extendUniformPoolSize(uint32_t descriptorCount);
 	void extendImageSamplerPoolSize(uint32_t descriptorCount);
+	void extendStorageBufferPoolSize(uint32_t descriptorCount);
+	void extendUniformDynamicPoolSize(uint32_t descriptorCount);
 
 	void setMaxDescritporSets(uint32_t maxSets);
 
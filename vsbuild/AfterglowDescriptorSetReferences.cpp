@@ -6,6 +6,8 @@ void AfterglowDescriptorSetReferences::reset(const AfterglowDescriptorSets& sour
 	_refData.resize(sourceSets.size());
 	uint32_t byteSize = sourceSets.size() * sizeof(AfterglowDescriptorSets::Raw);
 	memcpy_s(_refData.data(), byteSize, sourceSets.address(), byteSize);
+	_dynamicSetIndex = invalidSetIndex;
+	_dynamicOffset = 0;
 }
 
 const AfterglowDescriptorSets* AfterglowDescriptorSetReferences::source() const noexcept {
@@ -26,4 +28,21 @@ void AfterglowDescriptorSetReferences::resize(uint32_t size) {
 
 AfterglowDescriptorSets::Raw& AfterglowDescriptorSetReferences::operator[](uint32_t index) {
 	return _refData[index];
+}
+
+void AfterglowDescriptorSetReferences::setDynamicOffset(uint32_t setIndex, uint32_t offset) noexcept {
+	_dynamicSetIndex = setIndex;
+	_dynamicOffset = offset;
+}
+
+uint32_t AfterglowDescriptorSetReferences::dynamicSetIndex() const noexcept {
+	return _dynamicSetIndex;
+}
+
+const uint32_t* AfterglowDescriptorSetReferences::dynamicOffsets() const noexcept {
+	return &_dynamicOffset;
+}
+
+uint32_t AfterglowDescriptorSetReferences::dynamicOffsetCount(uint32_t firstSet) const noexcept {
+	return (firstSet <= _dynamicSetIndex && _dynamicSetIndex < size()) ? 1 : 0;
 }
\ No newline at end of file
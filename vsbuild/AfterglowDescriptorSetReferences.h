@@ -1,8 +1,12 @@
 #pragma once
+#include <limits>
 #include "AfterglowDescriptorSets.h"
 
 class AfterglowDescriptorSetReferences {
 public:
+	static constexpr uint32_t invalidSetIndex = std::numeric_limits<uint32_t>::max();
+
+	// @note: Dynamic offset is cleared.
 	void reset(const AfterglowDescriptorSets& sourceSets);
 
 	const AfterglowDescriptorSets* source() const noexcept;
@@ -14,9 +18,20 @@ public:
 
 	AfterglowDescriptorSets::Raw& operator[](uint32_t index);
 
+	// @brief: Offset of the single dynamic descriptor, which is inside set[setIndex].
+	void setDynamicOffset(uint32_t setIndex, uint32_t offset) noexcept;
+	// @return: invalidSetIndex if there is no dynamic descriptor.
+	uint32_t dynamicSetIndex() const noexcept;
+	const uint32_t* dynamicOffsets() const noexcept;
+	// @brief: Dynamic offset count of sets in [firstSet, size()).
+	uint32_t dynamicOffsetCount(uint32_t firstSet = 0) const noexcept;
+
 private:
 	const AfterglowDescriptorSets* _source = nullptr;
 	std::vector<AfterglowDescriptorSets::Raw> _refData;
 
+	uint32_t _dynamicSetIndex = invalidSetIndex;
+	uint32_t _dynamicOffset = 0;
+
 };
 
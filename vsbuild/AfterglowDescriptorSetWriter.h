@@ -28,12 +28,14 @@ public:
 
 	AfterglowDevice& device() noexcept;
 
+	// @param range: Dynamic buffer descriptor views one element only, otherwise the whole buffer.
 	template<buffer::BufferType Type>
 	void registerBuffer(
 		Type& buffer,
 		const AfterglowDescriptorSetLayout& setLayout, 
 		const VkDescriptorSet& set, 
-		uint32_t bindingIndex
+		uint32_t bindingIndex, 
+		VkDeviceSize range = VK_WHOLE_SIZE
 	);
 
 	template<img::ImageType Type>
@@ -69,13 +71,14 @@ void AfterglowDescriptorSetWriter::registerBuffer(
 	Type& buffer,
 	const AfterglowDescriptorSetLayout& setLayout,
 	const VkDescriptorSet& set,
-	uint32_t bindingIndex) {
+	uint32_t bindingIndex, 
+	VkDeviceSize range) {
 	// C++ 20 Features.
 	_writeDescriptorInfos.bufferWriteContexts.emplace_back(
 		VkDescriptorBufferInfo{
 			.buffer = buffer,
 			.offset = 0,
-			.range = buffer.byteSize()
+			.range = (range == VK_WHOLE_SIZE) ? buffer.byteSize() : range
 		},
 		setLayout,
 		set,
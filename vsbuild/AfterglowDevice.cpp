@@ -1,6 +1,8 @@
 #include "AfterglowDevice.h"
 #include <set>
 #include "AfterglowPhysicalDevice.h"
+#include "AfterglowPipelineCache.h"
+#include "AfterglowMemoryAllocator.h"
 #include "Configurations.h"
 
 AfterglowDevice::AfterglowDevice(AfterglowPhysicalDevice& physicalDevice) : 
@@ -8,6 +10,10 @@ AfterglowDevice::AfterglowDevice(AfterglowPhysicalDevice& physicalDevice) :
 }
 
 AfterglowDevice::~AfterglowDevice() {
+	// Pipeline cache is saved and destroyed before the device.
+	_pipelineCache.reset();
+	// Memory blocks are freed before the device.
+	_memoryAllocator.reset();
 	destroy(vkDestroyDevice, data(), nullptr);
 }
 
@@ -15,6 +21,14 @@ AfterglowPhysicalDevice& AfterglowDevice::physicalDevice() {
 	return _physicalDevice;
 }
 
+AfterglowPipelineCache& AfterglowDevice::pipelineCache() {
+	return *_pipelineCache;
+}
+
+AfterglowMemoryAllocator& AfterglowDevice::memoryAllocator() {
+	return *_memoryAllocator;
+}
+
 void AfterglowDevice::waitIdle() {
 	vkDeviceWaitIdle(*this);
 }
@@ -27,10 +41,38 @@ uint32_t AfterglowDevice::lastFrameIndex() const noexcept {
 	return (_currentFrameIndex + cfg::maxFrameInFlight - 1) % cfg::maxFrameInFlight;
 }
 
+uint32_t AfterglowDevice::nextFrameIndex() const noexcept {
+	return (_currentFrameIndex + 1) % cfg::maxFrameInFlight;
+}
+
 void AfterglowDevice::updateCurrentFrameIndex() noexcept {
 	_currentFrameIndex = (_currentFrameIndex + 1) % cfg::maxFrameInFlight;
 }
 
+bool AfterglowDevice::timelineSemaphoreEnabled() const noexcept {
+	return _timelineSemaphoreEnabled;
+}
+
+bool AfterglowDevice::native16BitTypesEnabled() const noexcept {
+	return _native16BitTypesEnabled;
+}
+
+bool AfterglowDevice::asyncComputeEnabled() const noexcept {
+	return _asyncComputeEnabled;
+}
+
+const std::array<uint32_t, 2>& AfterglowDevice::asyncComputeSharedFamilyIndices() const noexcept {
+	return _asyncComputeSharedFamilyIndices;
+}
+
+bool AfterglowDevice::memoryBudgetEnabled() const noexcept {
+	return _memoryBudgetEnabled;
+}
+
+bool AfterglowDevice::presentEnabled() const noexcept {
+	return _presentEnabled;
+}
+
 void AfterglowDevice::initCreateInfo() {
 	// (Optional) Info ptr will be init on initCreateInfoShell automatically.
 	// AfterglowProxyObject::initCreateInfo();
@@ -39,6 +81,15 @@ void AfterglowDevice::initCreateInfo() {
 		_physicalDevice.graphicsFamilyIndex(),
 		_physicalDevice.presentFamilyIndex()
 	};
+	// Async compute waits graphics by timeline values across queues.
+	_asyncComputeEnabled = cfg::enableAsyncCompute 
+		&& _physicalDevice.asyncComputeFamilySupport() 
+		&& cfg::enableTimelineSemaphore 
+		&& _physicalDevice.timelineSemaphoreSupport();
+	if (_asyncComputeEnabled) {
+		uniqueQueueFamilies.insert(_physicalDevice.asyncComputeFamilyIndex());
+		_asyncComputeSharedFamilyIndices = { _physicalDevice.graphicsFamilyIndex(), _physicalDevice.asyncComputeFamilyIndex() };
+	}
 	_queueCreateInfos = std::make_unique<QueueCreateInfoArray>();
 
 	// Because uniqueQueueFamilies is a set, 
@@ -61,14 +112,46 @@ void AfterglowDevice::initCreateInfo() {
 	_deviceFeatures->sampleRateShading = physicalDeviceFeatures.sampleRateShading;
 	_deviceFeatures->shaderResourceMinLod = physicalDeviceFeatures.shaderResourceMinLod;
 	_deviceFeatures->fillModeNonSolid = physicalDeviceFeatures.fillModeNonSolid;
+	_native16BitTypesEnabled = _physicalDevice.native16BitTypesSupport();
+	_deviceFeatures->shaderInt16 = _native16BitTypesEnabled;
 
 	info().sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	info().queueCreateInfoCount = static_cast<uint32_t>(_queueCreateInfos->size());
 	info().pQueueCreateInfos = _queueCreateInfos->data();
 	info().pEnabledFeatures = _deviceFeatures.get();
 
-	info().enabledExtensionCount = static_cast<uint32_t>(cfg::deviceExtensions.size());
-	info().ppEnabledExtensionNames = cfg::deviceExtensions.data();
+	// Vulkan 1.2 features are chained, they are not in VkPhysicalDeviceFeatures.
+	_timelineSemaphoreEnabled = cfg::enableTimelineSemaphore && _physicalDevice.timelineSemaphoreSupport();
+	if (_timelineSemaphoreEnabled) {
+		_timelineSemaphoreFeatures = std::make_unique<VkPhysicalDeviceTimelineSemaphoreFeatures>();
+		_timelineSemaphoreFeatures->sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		_timelineSemaphoreFeatures->timelineSemaphore = VK_TRUE;
+		info().pNext = _timelineSemaphoreFeatures.get();
+	}
+	if (_native16BitTypesEnabled) {
+		_float16Int8Features = std::make_unique<VkPhysicalDeviceShaderFloat16Int8Features>();
+		_float16Int8Features->sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES;
+		_float16Int8Features->shaderFloat16 = VK_TRUE;
+		_float16Int8Features->pNext = const_cast<void*>(info().pNext);
+		_storage16BitFeatures = std::make_unique<VkPhysicalDevice16BitStorageFeatures>();
+		_storage16BitFeatures->sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES;
+		_storage16BitFeatures->storageBuffer16BitAccess = VK_TRUE;
+		_storage16BitFeatures->uniformAndStorageBuffer16BitAccess = VK_TRUE;
+		_storage16BitFeatures->pNext = _float16Int8Features.get();
+		info().pNext = _storage16BitFeatures.get();
+	}
+
+	_enabledExtensions = std::make_unique<std::vector<const char*>>(cfg::deviceExtensions);
+	_presentEnabled = _physicalDevice.presentSupport();
+	if (_presentEnabled) {
+		_enabledExtensions->insert(_enabledExtensions->end(), cfg::presentDeviceExtensions.begin(), cfg::presentDeviceExtensions.end());
+	}
+	_memoryBudgetEnabled = _physicalDevice.memoryBudgetSupport();
+	if (_memoryBudgetEnabled) {
+		_enabledExtensions->push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	}
+	info().enabledExtensionCount = static_cast<uint32_t>(_enabledExtensions->size());
+	info().ppEnabledExtensionNames = _enabledExtensions->data();
 
 	if (cfg::enableValidationLayers) {
 		info().enabledLayerCount = static_cast<uint32_t> (cfg::validationLayers.size());
@@ -86,5 +169,12 @@ void AfterglowDevice::create() {
 
 	// Release custom create info.
 	_deviceFeatures.reset();
+	_timelineSemaphoreFeatures.reset();
+	_float16Int8Features.reset();
+	_storage16BitFeatures.reset();
 	_queueCreateInfos.reset();
+	_enabledExtensions.reset();
+
+	_pipelineCache = std::make_unique<AfterglowPipelineCache>(*this);
+	_memoryAllocator = std::make_unique<AfterglowMemoryAllocator>(*this);
 }
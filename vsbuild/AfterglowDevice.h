@@ -1,8 +1,12 @@
 #pragma once
 
+#include <array>
+
 #include "AfterglowProxyObject.h"
 
 class AfterglowPhysicalDevice;
+class AfterglowPipelineCache;
+class AfterglowMemoryAllocator;
 
 class AfterglowDevice : public AfterglowProxyObject<AfterglowDevice, VkDevice, VkDeviceCreateInfo> {
 public:
@@ -11,12 +15,30 @@ public:
 	~AfterglowDevice();
 
 	AfterglowPhysicalDevice& physicalDevice();
+	// @brief: Shared by all graphics and compute pipelines, it's created with the device.
+	AfterglowPipelineCache& pipelineCache();
+	// @brief: Sub-allocates memory of all buffers and images, it's created with the device.
+	AfterglowMemoryAllocator& memoryAllocator();
 
 	void waitIdle();
 	uint32_t currentFrameIndex() const noexcept;
 	uint32_t lastFrameIndex() const noexcept;
+	uint32_t nextFrameIndex() const noexcept;
 	void updateCurrentFrameIndex() noexcept;
 
+	// @return: True if timeline semaphore is supported and enabled by cfg::enableTimelineSemaphore.
+	bool timelineSemaphoreEnabled() const noexcept;
+	// @return: True if 16-bit types are supported, they are enabled for shaders compiled with shader model 6.2 or higher.
+	bool native16BitTypesEnabled() const noexcept;
+	// @return: True if a dedicated compute family exists and cfg::enableAsyncCompute, it requires timeline semaphore.
+	bool asyncComputeEnabled() const noexcept;
+	// @return: Graphics and async compute families, resources shared by both queues use them in concurrent sharing mode.
+	const std::array<uint32_t, 2>& asyncComputeSharedFamilyIndices() const noexcept;
+	// @return: True if VK_EXT_memory_budget is supported, it is enabled optionally.
+	bool memoryBudgetEnabled() const noexcept;
+	// @return: False in headless mode, VK_KHR_swapchain is not enabled and present layouts should never be used.
+	bool presentEnabled() const noexcept;
+
 proxy_protected:
 	void initCreateInfo();
 	void create();
@@ -24,10 +46,23 @@ proxy_protected:
 private:
 	AfterglowPhysicalDevice& _physicalDevice;
 	std::unique_ptr<VkPhysicalDeviceFeatures> _deviceFeatures;
+	std::unique_ptr<VkPhysicalDeviceTimelineSemaphoreFeatures> _timelineSemaphoreFeatures;
+	std::unique_ptr<VkPhysicalDeviceShaderFloat16Int8Features> _float16Int8Features;
+	std::unique_ptr<VkPhysicalDevice16BitStorageFeatures> _storage16BitFeatures;
 	std::unique_ptr<QueueCreateInfoArray> _queueCreateInfos;
+	// cfg::deviceExtensions, cfg::presentDeviceExtensions if presentable and supported optional extensions.
+	std::unique_ptr<std::vector<const char*>> _enabledExtensions;
+	std::unique_ptr<AfterglowPipelineCache> _pipelineCache;
+	std::unique_ptr<AfterglowMemoryAllocator> _memoryAllocator;
 	// Only one priority is supported yet. queuePriority range from 0.0 to 1.0.
 	float _queuePriority = 1.0f;
 
 	uint32_t _currentFrameIndex;
+	bool _timelineSemaphoreEnabled = false;
+	bool _native16BitTypesEnabled = false;
+	bool _asyncComputeEnabled = false;
+	bool _memoryBudgetEnabled = false;
+	bool _presentEnabled = false;
+	std::array<uint32_t, 2> _asyncComputeSharedFamilyIndices{};
 };
 
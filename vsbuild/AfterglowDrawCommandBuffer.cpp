@@ -6,12 +6,14 @@
 #include "RenderConfigurations.h"
 
 
-AfterglowDrawCommandBuffer::AfterglowDrawCommandBuffer(AfterglowCommandPool& commandPool) : 
-	AfterglowCommandBuffer(commandPool) {
+AfterglowDrawCommandBuffer::AfterglowDrawCommandBuffer(AfterglowCommandPool& commandPool, VkCommandBufferLevel level) : 
+	AfterglowCommandBuffer(commandPool, level) {
 }
 
 void AfterglowDrawCommandBuffer::beginRecord() {
 	updateCurrentCommandBuffer();
+	invalidateBoundStates();
+	_bindCounters = {};
 
 	VkCommandBufferBeginInfo commandBufferBegin{};
 	commandBufferBegin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -24,12 +26,39 @@ void AfterglowDrawCommandBuffer::beginRecord() {
 	}
 }
 
-void AfterglowDrawCommandBuffer::beginRenderPass(PassBeginInfo& beginInfo) {
-	// # 0 cmd
-	// VK_SUBPASS_CONTENTS_INLINE: for primary command buffers.
-	// VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS: for secondary command buffers.
-	vkCmdBeginRenderPass(_currentCommandBuffer, &beginInfo.renderPassBegin, VK_SUBPASS_CONTENTS_INLINE);
+void AfterglowDrawCommandBuffer::beginSecondaryRecord(AfterglowPassInterface& pass, uint32_t subpassIndex, uint32_t imageIndex) {
+	if (level() != VK_COMMAND_BUFFER_LEVEL_SECONDARY) {
+		throw runtimeError("beginSecondaryRecord() requires a secondary command buffer.");
+	}
+	updateCurrentCommandBuffer();
+	invalidateBoundStates();
+	_bindCounters = {};
+
+	auto beginInfo = makePassBeginInfo(pass, imageIndex);
+
+	VkCommandBufferInheritanceInfo inheritance{};
+	inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritance.renderPass = beginInfo.renderPassBegin.renderPass;
+	inheritance.subpass = subpassIndex;
+	inheritance.framebuffer = beginInfo.renderPassBegin.framebuffer;
+
+	VkCommandBufferBeginInfo commandBufferBegin{};
+	commandBufferBegin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	commandBufferBegin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	commandBufferBegin.pInheritanceInfo = &inheritance;
 
+	if (vkBeginCommandBuffer(_currentCommandBuffer, &commandBufferBegin) != VK_SUCCESS) {
+		throw runtimeError("Failed to begin recording secondary command buffer.");
+	}
+
+	// Dynamic states are not inherited from the primary command buffer.
+	vkCmdSetViewport(_currentCommandBuffer, 0, 1, &beginInfo.viewport);
+	vkCmdSetScissor(_currentCommandBuffer, 0, 1, &beginInfo.scissor);
+}
+
+void AfterglowDrawCommandBuffer::beginRenderPass(PassBeginInfo& beginInfo, VkSubpassContents contents) {
+	// Dynamic states are set outside the render pass, 
+	// because nothing but vkCmdExecuteCommands is allowed in a subpass with secondary command buffer contents.
 	// TODO: Given a function to reset viewport and scissor for downsampling.
 	// # 4 cmd
 	vkCmdSetViewport(_currentCommandBuffer, 0, 1, &beginInfo.viewport);
@@ -37,26 +66,16 @@ void AfterglowDrawCommandBuffer::beginRenderPass(PassBeginInfo& beginInfo) {
 	// # 5 cmd
 	// vkCmdSetScissor(commandBuffer, firstScissorIndex, scissorCount, scissorHandle);
 	vkCmdSetScissor(_currentCommandBuffer, 0, 1, &beginInfo.scissor);
-}
-
-void AfterglowDrawCommandBuffer::beginRenderPass(AfterglowPassInterface& pass, uint32_t imageIndex) {
-	auto& subpassContext = pass.subpassContext();
-	if (pass.framebuffers().size() <= 1) {
-		imageIndex = 0;
-	}
-	auto& framebuffer = pass.framebuffer(imageIndex);
 
-	AfterglowDrawCommandBuffer::PassBeginInfo beginInfo{};
-	beginInfo.renderPassBegin.renderPass = pass.renderPass();
-	beginInfo.renderPassBegin.framebuffer = framebuffer;
-	beginInfo.renderPassBegin.renderArea.extent = framebuffer.extent();
-	beginInfo.renderPassBegin.clearValueCount = subpassContext.clearValueCount();
-	beginInfo.renderPassBegin.pClearValues = subpassContext.clearValues().data();
-	beginInfo.viewport.width = static_cast<float>(framebuffer.extent().width);
-	beginInfo.viewport.height = static_cast<float>(framebuffer.extent().height);
-	beginInfo.scissor.extent = framebuffer.extent();
+	// # 0 cmd
+	// VK_SUBPASS_CONTENTS_INLINE: for primary command buffers.
+	// VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS: for secondary command buffers.
+	vkCmdBeginRenderPass(_currentCommandBuffer, &beginInfo.renderPassBegin, contents);
+}
 
-	beginRenderPass(beginInfo);
+void AfterglowDrawCommandBuffer::beginRenderPass(AfterglowPassInterface& pass, uint32_t imageIndex, VkSubpassContents contents) {
+	auto beginInfo = makePassBeginInfo(pass, imageIndex);
+	beginRenderPass(beginInfo, contents);
 }
 
 void AfterglowDrawCommandBuffer::setResolution(float width, float height) {
@@ -81,6 +100,7 @@ void AfterglowDrawCommandBuffer::setupPipeline(AfterglowPipeline& pipeline) {
 		_currentPipeline = &pipeline;
 		// The second parameter specifies if the pipeline object is a graphics or compute pipeline.
 		vkCmdBindPipeline(_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		++_bindCounters.pipelineBinds;
 	}
 }
 
@@ -89,32 +109,69 @@ void AfterglowDrawCommandBuffer::setupDescriptorSets(const AfterglowDescriptorSe
 		throw runtimeError("setupPipeline() should be called before setupDescriptorSets().");
 	}
 	
-	if (_currentSetRefs != &setRefs) {
-		_currentSetRefs = &setRefs;
-		// vkCmdBindDescriptorSets(commandBuffer, pipelineBindPoint, pipelineLayout, firstSetIndex, setCount, pSets, dynamicOffsetCount, pDynamicOffset);
-		vkCmdBindDescriptorSets(
-			_currentCommandBuffer,
-			VK_PIPELINE_BIND_POINT_GRAPHICS,
-			_currentPipeline->pipelineLayout(),
-			0,
-			setRefs.size(),
-			setRefs.address(),
-			0,
-			nullptr
-		);
+	VkPipelineLayout pipelineLayout = _currentPipeline->pipelineLayout();
+	const VkDescriptorSet* sets = setRefs.address();
+	uint32_t setCount = setRefs.size();
+	uint32_t dynamicSetIndex = setRefs.dynamicSetIndex();
+
+	// Sets stay bound while pipeline layout is not changed, so bind from the first different set only.
+	uint32_t firstSet = 0;
+	if (pipelineLayout == _boundPipelineLayout) {
+		uint32_t comparableCount = std::min(setCount, static_cast<uint32_t>(_boundDescriptorSets.size()));
+		while (firstSet < comparableCount && _boundDescriptorSets[firstSet] == sets[firstSet]) {
+			++firstSet;
+		}
+		// Same set with another dynamic offset should be bound again.
+		if (dynamicSetIndex < setCount && *setRefs.dynamicOffsets() != _boundDynamicOffset) {
+			firstSet = std::min(firstSet, dynamicSetIndex);
+		}
+		if (firstSet == setCount) {
+			return;
+		}
+	}
+
+	uint32_t dynamicOffsetCount = setRefs.dynamicOffsetCount(firstSet);
+	// vkCmdBindDescriptorSets(commandBuffer, pipelineBindPoint, pipelineLayout, firstSetIndex, setCount, pSets, dynamicOffsetCount, pDynamicOffset);
+	vkCmdBindDescriptorSets(
+		_currentCommandBuffer,
+		VK_PIPELINE_BIND_POINT_GRAPHICS,
+		pipelineLayout,
+		firstSet,
+		setCount - firstSet,
+		sets + firstSet,
+		dynamicOffsetCount,
+		setRefs.dynamicOffsets()
+	);
+	_boundPipelineLayout = pipelineLayout;
+	_boundDescriptorSets.assign(sets, sets + setCount);
+	if (dynamicOffsetCount > 0) {
+		_boundDynamicOffset = *setRefs.dynamicOffsets();
 	}
+	++_bindCounters.descriptorSetBinds;
 }
 
 void AfterglowDrawCommandBuffer::draw(const RecordInfo& recordInfo) {
 	static constexpr std::array<VkDeviceSize, 1> vertexoffsets = { 0 };
 	
-	vkCmdBindVertexBuffers(
-		_currentCommandBuffer, 0, 1, &recordInfo.vertexBuffer, vertexoffsets.data()
-	);
+	if (_boundVertexBuffer != recordInfo.vertexBuffer) {
+		_boundVertexBuffer = recordInfo.vertexBuffer;
+		vkCmdBindVertexBuffers(
+			_currentCommandBuffer, 0, 1, &recordInfo.vertexBuffer, vertexoffsets.data()
+		);
+		++_bindCounters.vertexBufferBinds;
+	}
+	++_bindCounters.draws;
+	if (!recordInfo.indirectBuffer) {
+		_bindCounters.instances += recordInfo.instanceCount;
+	}
 
 	// If indexBuffer exists, draw indexed.
 	if (recordInfo.indexBuffer) {
-		vkCmdBindIndexBuffer(_currentCommandBuffer, recordInfo.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+		if (_boundIndexBuffer != recordInfo.indexBuffer) {
+			_boundIndexBuffer = recordInfo.indexBuffer;
+			vkCmdBindIndexBuffer(_currentCommandBuffer, recordInfo.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+			++_bindCounters.indexBufferBinds;
+		}
 
 		if (recordInfo.indirectBuffer) {
 			// @note: support indexed indiret draw only
@@ -124,7 +181,7 @@ void AfterglowDrawCommandBuffer::draw(const RecordInfo& recordInfo) {
 		}
 		else {
 			// Usage: vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstanceIndex);
-			vkCmdDrawIndexed(_currentCommandBuffer, recordInfo.indexCount, recordInfo.instanceCount, 0, 0, 0);
+			vkCmdDrawIndexed(_currentCommandBuffer, recordInfo.indexCount, recordInfo.instanceCount, 0, 0, recordInfo.firstInstance);
 		}
 	}
 	// Otherwise draw directly.
@@ -135,13 +192,22 @@ void AfterglowDrawCommandBuffer::draw(const RecordInfo& recordInfo) {
 		}
 		else {
 			// Usage: vkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertexIndex, firstInstanceIndex);
-			vkCmdDraw(_currentCommandBuffer, recordInfo.vertexCount, recordInfo.instanceCount, 0, 0);
+			vkCmdDraw(_currentCommandBuffer, recordInfo.vertexCount, recordInfo.instanceCount, 0, recordInfo.firstInstance);
 		}
 	}
 }
 
-void AfterglowDrawCommandBuffer::nextSubpass() {
-	vkCmdNextSubpass(_currentCommandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+void AfterglowDrawCommandBuffer::nextSubpass(VkSubpassContents contents) {
+	vkCmdNextSubpass(_currentCommandBuffer, contents);
+}
+
+void AfterglowDrawCommandBuffer::executeCommands(const VkCommandBuffer* commandBuffers, uint32_t count) {
+	if (count == 0) {
+		return;
+	}
+	vkCmdExecuteCommands(_currentCommandBuffer, count, commandBuffers);
+	// Bound states become undefined after executing secondary command buffers.
+	invalidateBoundStates();
 }
 
 void AfterglowDrawCommandBuffer::endRenderPass() {
@@ -176,7 +242,39 @@ void AfterglowDrawCommandBuffer::barrier(
 }
 
 void AfterglowDrawCommandBuffer::barrier(AfterglowPassInterface& pass) {
-	barrier(pass.exportBarriers(), pass.exportBarrierSrcPipelineStage());
+	barrier(pass.exportBarriers(), pass.exportBarrierSrcPipelineStage(), pass.exportBarrierDstPipelineStage());
+}
+
+const render::BindCounters& AfterglowDrawCommandBuffer::bindCounters() const noexcept {
+	return _bindCounters;
+}
+
+inline void AfterglowDrawCommandBuffer::invalidateBoundStates() noexcept {
+	_currentPipeline = nullptr;
+	_boundPipelineLayout = VK_NULL_HANDLE;
+	_boundDescriptorSets.clear();
+	_boundDynamicOffset = 0;
+	_boundVertexBuffer = VK_NULL_HANDLE;
+	_boundIndexBuffer = VK_NULL_HANDLE;
+}
+
+AfterglowDrawCommandBuffer::PassBeginInfo AfterglowDrawCommandBuffer::makePassBeginInfo(AfterglowPassInterface& pass, uint32_t imageIndex) {
+	auto& subpassContext = pass.subpassContext();
+	if (pass.framebuffers().size() <= 1) {
+		imageIndex = 0;
+	}
+	auto& framebuffer = pass.framebuffer(imageIndex);
+
+	AfterglowDrawCommandBuffer::PassBeginInfo beginInfo{};
+	beginInfo.renderPassBegin.renderPass = pass.renderPass();
+	beginInfo.renderPassBegin.framebuffer = framebuffer;
+	beginInfo.renderPassBegin.renderArea.extent = framebuffer.extent();
+	beginInfo.renderPassBegin.clearValueCount = subpassContext.clearValueCount();
+	beginInfo.renderPassBegin.pClearValues = subpassContext.clearValues().data();
+	beginInfo.viewport.width = static_cast<float>(framebuffer.extent().width);
+	beginInfo.viewport.height = static_cast<float>(framebuffer.extent().height);
+	beginInfo.scissor.extent = framebuffer.extent();
+	return beginInfo;
 }
 
 AfterglowDrawCommandBuffer::PassBeginInfo::PassBeginInfo() {
@@ -1,5 +1,6 @@
 #pragma once
 #include "AfterglowCommandBuffer.h"
+#include "RenderDefinitions.h"
 
 class AfterglowPipeline;
 class AfterglowPassInterface;
@@ -33,9 +34,11 @@ public:
 		uint32_t indexCount = 0;
 		uint32_t vertexCount = 0;
 		uint32_t instanceCount = 1;
+		// Offset of SV_InstanceID, instanced draws use it to index the object instance buffer.
+		uint32_t firstInstance = 0;
 	};
 
-	AfterglowDrawCommandBuffer(AfterglowCommandPool& commandPool);
+	AfterglowDrawCommandBuffer(AfterglowCommandPool& commandPool, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 
 	// Call layers example: 
 	// beginRecord
@@ -58,14 +61,27 @@ public:
 	//				-> ... 
 	//	endRenderPass
 	// endRecord
+	//
+	// Secondary command buffer call layers:
+	// beginSecondaryRecord
+	//	-> setupPipeline 
+	//		-> setupDescriptorSets 
+	//			-> record 
+	// endRecord
+	// Then primary command buffer executes it inside a subpass which was begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS.
 	void beginRecord();
-	void beginRenderPass(PassBeginInfo& beginInfo);
+	/**
+	* @brief: Begin a secondary command buffer which continues a subpass, viewport and scissor are set from the pass.
+	* @param imageIndex: for multiple framebuffers case.
+	*/
+	void beginSecondaryRecord(AfterglowPassInterface& pass, uint32_t subpassIndex, uint32_t imageIndex = 0);
+	void beginRenderPass(PassBeginInfo& beginInfo, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 	/**
 	* @brief: Create pass begin info from pass automatically.
 	* @param imageIndex: for multiple framebuffers case.
 	*/
 	// 
-	void beginRenderPass(AfterglowPassInterface& pass, uint32_t imageIndex = 0);
+	void beginRenderPass(AfterglowPassInterface& pass, uint32_t imageIndex = 0, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 	void setResolution(float width, float height);
 	// Relative with material.
 	void setupPipeline(AfterglowPipeline& pipeline);
@@ -73,7 +89,8 @@ public:
 	void setupDescriptorSets(const AfterglowDescriptorSetReferences& setRefs);
 	// Relative with drawcall mesh.
 	void draw(const RecordInfo& recordInfo);
-	void nextSubpass();
+	void nextSubpass(VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+	void executeCommands(const VkCommandBuffer* commandBuffers, uint32_t count);
 	void endRenderPass();
 	void endRecord();
 
@@ -84,8 +101,23 @@ public:
 	);
 	void barrier(AfterglowPassInterface& pass);
 
+	// @brief: Binds and draws since the last beginRecord().
+	const render::BindCounters& bindCounters() const noexcept;
+
 private:
+	static PassBeginInfo makePassBeginInfo(AfterglowPassInterface& pass, uint32_t imageIndex);
+
+	// Bound states are not shared between command buffers, so reset these caches when begin a record.
+	inline void invalidateBoundStates() noexcept;
+
+	// State tracker, skip binds which are same as the bound ones.
 	AfterglowPipeline* _currentPipeline = nullptr;
-	const AfterglowDescriptorSetReferences* _currentSetRefs = nullptr;
+	VkPipelineLayout _boundPipelineLayout = VK_NULL_HANDLE;
+	std::vector<VkDescriptorSet> _boundDescriptorSets;
+	uint32_t _boundDynamicOffset = 0;
+	VkBuffer _boundVertexBuffer = VK_NULL_HANDLE;
+	VkBuffer _boundIndexBuffer = VK_NULL_HANDLE;
+
+	render::BindCounters _bindCounters;
 };
 
@@ -1,9 +1,12 @@
 #include "AfterglowDxcIncludeHandler.h"
-#include "AfterglowShaderAsset.h"
 #include "AfterglowUtilities.h"
 #include "Configurations.h"
 #include "DebugUtilities.h"
 
+AfterglowDxcIncludeHandler::AfterglowDxcIncludeHandler(IDxcUtils& utils, AfterglowShaderIncludeCache& includeCache) :
+	_utils(utils), _includeCache(includeCache) {
+}
+
 STDMETHODIMP_(HRESULT __stdcall) AfterglowDxcIncludeHandler::QueryInterface(REFIID riid, void** ppvObject) {
 	if (riid == IID_IUnknown || riid == __uuidof(IDxcIncludeHandler)) {
 		*ppvObject = this;
@@ -27,19 +30,26 @@ STDMETHODIMP_(ULONG __stdcall) AfterglowDxcIncludeHandler::Release() {
 }
 
 STDMETHODIMP_(HRESULT __stdcall) AfterglowDxcIncludeHandler::LoadSource(LPCWSTR pFilename, IDxcBlob** ppIncludeSource) {
-	Microsoft::WRL::ComPtr<IDxcUtils> pUtils;
-	DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&pUtils));
 	Microsoft::WRL::ComPtr<IDxcBlobEncoding> pBlob;
+	std::string path = util::ToString(pFilename);
 	try {
-		AfterglowShaderAsset shaderAsset(util::ToString(pFilename));
-		// IDxcBlobEncoding
-		pUtils->CreateBlob(shaderAsset.code().data(), shaderAsset.code().size(), CP_UTF8, &pBlob);		
+		auto source = _includeCache.load(path);
+		// IDxcBlobEncoding, cached source is pinned instead of copied.
+		_utils.CreateBlobFromPinned(source->code.data(), static_cast<UINT32>(source->code.size()), CP_UTF8, &pBlob);
+		_includedFiles.push_back({ path, source->contentHash });
+		_includedSources.push_back(std::move(source));
 	}
 	catch (const std::exception& error) {
 		DEBUG_CLASS_ERROR(std::format("Failed to include shader: {}", error.what()));
 		std::string emptyCode;
-		pUtils->CreateBlob(emptyCode.data(), emptyCode.size(), CP_UTF8, &pBlob);
+		_utils.CreateBlob(emptyCode.data(), static_cast<UINT32>(emptyCode.size()), CP_UTF8, &pBlob);
+		// Missing file never matches a content hash, so this cache entry is always outdated.
+		_includedFiles.push_back({ path, 0 });
 	}
 	*ppIncludeSource = pBlob.Detach();
 	return S_OK;
 }
+
+const AfterglowSpirvCache::IncludedFiles& AfterglowDxcIncludeHandler::includedFiles() const noexcept {
+	return _includedFiles;
+}
@@ -2,10 +2,15 @@
 #include <d3d12shader.h>
 #include <dxc/dxcapi.h>
 #include <wrl/client.h>
+#include "AfterglowSpirvCache.h"
+#include "AfterglowShaderIncludeCache.h"
 
 // Windows only.
+// @note: One handler per compilation, included sources are pinned by the handler until it is destroyed.
 class AfterglowDxcIncludeHandler : public IDxcIncludeHandler {
 public:
+	AfterglowDxcIncludeHandler(IDxcUtils& utils, AfterglowShaderIncludeCache& includeCache);
+
 	// IUnknown
 	STDMETHODIMP QueryInterface(REFIID riid, void** ppvObject) override;
 
@@ -16,7 +21,14 @@ public:
 	// IDxcIncludeHandler
 	STDMETHODIMP LoadSource(LPCWSTR pFilename, IDxcBlob** ppIncludeSource) override;
 
+	// @brief: Files loaded by the compiler and their content hashes, for spirv cache validation.
+	const AfterglowSpirvCache::IncludedFiles& includedFiles() const noexcept;
+
 private:
 	ULONG _refCount = 1;
+	IDxcUtils& _utils;
+	AfterglowShaderIncludeCache& _includeCache;
+	AfterglowSpirvCache::IncludedFiles _includedFiles;
+	std::vector<AfterglowShaderIncludeCache::SourcePtr> _includedSources;
 };
 
@@ -0,0 +1,27 @@
+#include "AfterglowDxcInstances.h"
+#include "ExceptionUtilities.h"
+
+AfterglowDxcInstances& AfterglowDxcInstances::threadInstances() {
+	thread_local AfterglowDxcInstances instances;
+	return instances;
+}
+
+IDxcUtils& AfterglowDxcInstances::utils() noexcept {
+	return *_utils.Get();
+}
+
+IDxcCompiler3& AfterglowDxcInstances::compiler() noexcept {
+	return *_compiler.Get();
+}
+
+uint32_t AfterglowDxcInstances::createdCount() noexcept {
+	return _createdCount;
+}
+
+AfterglowDxcInstances::AfterglowDxcInstances() {
+	if (FAILED(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&_utils)))
+		|| FAILED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&_compiler)))) {
+		EXCEPT_CLASS_RUNTIME("Failed to create DXC instances.");
+	}
+	++_createdCount;
+}
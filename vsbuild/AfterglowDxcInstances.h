@@ -0,0 +1,29 @@
+#pragma once
+#include <atomic>
+#include <d3d12shader.h>
+#include <dxc/dxcapi.h>
+#include <wrl/client.h>
+
+// Windows only.
+/**
+* @brief: DXC objects of the calling thread, created on first use and reused by all following compilations of the thread.
+* @note: DXC objects are not thread safe, so instances are pooled per thread instead of shared.
+*/
+class AfterglowDxcInstances {
+public:
+	static AfterglowDxcInstances& threadInstances();
+
+	IDxcUtils& utils() noexcept;
+	IDxcCompiler3& compiler() noexcept;
+
+	// @return: Count of instance sets created in this session, it's the count of compiling threads if instances are reused.
+	static uint32_t createdCount() noexcept;
+
+private:
+	AfterglowDxcInstances();
+
+	static inline std::atomic<uint32_t> _createdCount = 0;
+
+	Microsoft::WRL::ComPtr<IDxcUtils> _utils;
+	Microsoft::WRL::ComPtr<IDxcCompiler3> _compiler;
+};
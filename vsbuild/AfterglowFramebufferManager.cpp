@@ -3,22 +3,50 @@
 #include "AfterglowPassManager.h"
 #include "AfterglowSwapchain.h"
 #include "AfterglowSynchronizer.h"
+#include "SwapchainConfigurations.h"
 #include "ExceptionUtilities.h"
 
 AfterglowFramebufferManager::AfterglowFramebufferManager(AfterglowPassManager& passManager, AfterglowSwapchain& swapchain) :
-	_passManager(passManager), _swapchain(swapchain) {
+	_passManager(passManager), _device(swapchain.device()), _swapchain(&swapchain) {
 	// @note: Invoke this function manually for late initialize.
 }
 
+AfterglowFramebufferManager::AfterglowFramebufferManager(AfterglowPassManager& passManager, AfterglowDevice& device, VkExtent2D offscreenExtent) :
+	_passManager(passManager), _device(device), _swapchain(nullptr), _offscreenExtent(offscreenExtent) {
+	recreateOffscreenTargets();
+}
+
 inline AfterglowDevice& AfterglowFramebufferManager::device() noexcept {
-	return _swapchain.device();
+	return _device;
 }
 
+// @warning: Never call it in headless mode.
 inline AfterglowSwapchain& AfterglowFramebufferManager::swapchain() noexcept {
-	return _swapchain;
+	return *_swapchain;
+}
+
+bool AfterglowFramebufferManager::headless() const noexcept {
+	return !_swapchain;
+}
+
+VkExtent2D AfterglowFramebufferManager::extent() const noexcept {
+	if (_swapchain) {
+		return _swapchain->extent();
+	}
+	return _offscreenExtent;
+}
+
+float AfterglowFramebufferManager::aspectRatio() const noexcept {
+	if (_swapchain) {
+		return _swapchain->aspectRatio();
+	}
+	return static_cast<float>(_offscreenExtent.width) / _offscreenExtent.height;
 }
 
 void AfterglowFramebufferManager::recreateSwapchain() {
+	if (headless()) {
+		return;
+	}
 	// Make sure resource is not be used.
 	swapchain().device().waitIdle();
 	swapchain().recreate();
@@ -27,6 +55,11 @@ void AfterglowFramebufferManager::recreateSwapchain() {
 }
 
 int AfterglowFramebufferManager::acquireNextImage(AfterglowSynchronizer& synchronizer) {
+	// Offscreen target is protected by the in flight fence of the same frame index.
+	if (headless()) {
+		return static_cast<int>(device().currentFrameIndex() % _offscreenTargets.size());
+	}
+
 	// Obstruct automatically and reset fence if acquire imageIndex successfully.
 	uint32_t imageIndex;
 	VkResult state = vkAcquireNextImageKHR(
@@ -67,19 +100,33 @@ void AfterglowFramebufferManager::recreateAllFramebuffers() {
 	//_images.clear();
 	//_imageReferences.clear();
 
+	auto& renderGraph = _passManager.renderGraph();
+	renderGraph.compile(_passManager);
+	_aliasedImages.clear();
+	_aliasedImages.resize(renderGraph.aliasSlotCount());
+
 	_passManager.forEachPass([this](AfterglowPassInterface& pass) {
 		recreatePassFramebuffers(pass);
 	});
+	renderGraph.recreateBarriers(_imageReferences);
 	_swapchainImageSetOutdatedFlag = true;
 }
 
 void AfterglowFramebufferManager::recreateSwapchainFramebuffers() {
 	// TODO: Try scale present only and late to recreate others when the window size is stable.
+	auto& renderGraph = _passManager.renderGraph();
+	for (uint32_t aliasSlot = 0; aliasSlot < _aliasedImages.size(); ++aliasSlot) {
+		if (renderGraph.aliasSlotExtentMode(aliasSlot) == AfterglowPassInterface::ExtentMode::Swapchain) {
+			_aliasedImages[aliasSlot].reference.reset();
+			_aliasedImages[aliasSlot].image.reset();
+		}
+	}
 	_passManager.forEachPass([this](AfterglowPassInterface& pass){
 		if (pass.extentMode() == AfterglowPassInterface::ExtentMode::Swapchain) {
 			recreatePassFramebuffers(pass);
 		}
 	});
+	renderGraph.recreateBarriers(_imageReferences);
 	_swapchainImageSetOutdatedFlag = true;
 }
 
@@ -91,10 +138,10 @@ void AfterglowFramebufferManager::recreatePassFramebuffers(AfterglowPassInterfac
 
 	// Recreate attachment images
 	auto& subpassContext = pass.subpassContext();
+	auto& renderGraph = _passManager.renderGraph();
 	//int32_t presentIndex = AfterglowPassInterface::invalidAttachmentIndex();
 	VkExtent2D extent = passExtent(pass);
 	for (uint32_t attachmentIndex = 0; attachmentIndex < subpassContext.attachmentCount(); ++attachmentIndex) {
-		auto& attachment = subpassContext.attachment(attachmentIndex);
 		auto* importAttachment = pass.findImportAttachment(attachmentIndex);
 		// Image from other renderpass.
 		if (importAttachment) {
@@ -108,30 +155,19 @@ void AfterglowFramebufferManager::recreatePassFramebuffers(AfterglowPassInterfac
 			// Image referenced from another pass, so don't create a real image buffer.
 			passImages.emplace_back(nullptr);
 		}
-		// DepthImage
-		else if (subpassContext.isDepthAttachmentIndex(attachmentIndex)) {
-			// @note: One depth image only, for read and write.
-			auto usage = AfterglowDepthImage::inputAttachmentUsage();
-			auto depthImage = std::make_unique<AfterglowDepthImage>(
-				device(), extent, attachment.samples, usage
-			);
-			depthImage->sampler().setAddressModes(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
-			passImageRefs.emplace_back(img::MakeImageReference(*depthImage));
-			passImages.emplace_back(std::move(depthImage));
+		// Image shared with other attachments whose lifetimes are not overlapped in the render graph.
+		else if (int32_t aliasSlot = renderGraph.aliasSlot(pass, attachmentIndex); aliasSlot != AfterglowRenderGraph::invalidAliasSlot()) {
+			auto& aliasedImage = _aliasedImages[aliasSlot];
+			if (!aliasedImage.image) {
+				aliasedImage.reference.emplace(createAttachmentImage(pass, attachmentIndex, extent, aliasedImage.image));
+			}
+			passImageRefs.push_back(*aliasedImage.reference);
+			passImages.emplace_back(nullptr);
 		}
-		// ColorImage
 		else {
-			auto usage = AfterglowColorImage::defaultUsage();
-			if (attachment.finalLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL /* Input attachment and vast majority export*/
-				|| pass.isExportColorAttachment(attachmentIndex) /* Present export case*/) {
-				usage = AfterglowColorImage::inputAttachmentUsage();
-			}
-			auto colorImage = std::make_unique<AfterglowColorImage>(
-			device(), extent, attachment.format, attachment.samples, usage
-			);	
-			colorImage->sampler().setAddressModes(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
-			passImageRefs.emplace_back(img::MakeImageReference(*colorImage));
-			passImages.emplace_back(std::move(colorImage));
+			std::unique_ptr<AfterglowObject> image;
+			passImageRefs.push_back(createAttachmentImage(pass, attachmentIndex, extent, image));
+			passImages.emplace_back(std::move(image));
 		}
 		// find present index.
 		//if (attachment.finalLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR) {
@@ -139,21 +175,7 @@ void AfterglowFramebufferManager::recreatePassFramebuffers(AfterglowPassInterfac
 		//}
 	}
 
-	// Recreate pass barriers
-	pass.clearBarriers();
-	if (!_passManager.isFinalPass(pass)) {
-		for (uint32_t exportColorAttachmentIndex : pass.exportColorAttachmentIndices()) {
-			if (!AfterglowPassInterface::isValidAttachment(exportColorAttachmentIndex)) {
-				continue;
-			}
-			VkImage exportColorImage = passImageRefs[exportColorAttachmentIndex].image;
-			pass.appendColorBarrier(exportColorImage, exportColorAttachmentIndex);
-		}
-		if (AfterglowPassInterface::isValidAttachment(pass.exportDepthAttachmentIndex())) {
-			VkImage exportDepthImage = passImageRefs[pass.exportDepthAttachmentIndex()].image;
-			pass.appendDepthBarrier(exportDepthImage);
-		}
-	}
+	// Pass barriers are recreated by the render graph after all pass images are ready.
 
 	// Recreate framebuffer(s)
 	pass.clearFramebufferBindings();
@@ -163,7 +185,7 @@ void AfterglowFramebufferManager::recreatePassFramebuffers(AfterglowPassInterfac
 	// On screen case
 	bool onScreen = AfterglowPassInterface::isValidAttachment(pass.presentAttachmentIndex());
 	if (onScreen) {
-		framebufferCount = swapchain().imageViews().size();
+		framebufferCount = presentImageCount();
 	}
 
 	for (uint32_t framebufferIndex = 0; framebufferIndex < framebufferCount; ++framebufferIndex) {
@@ -179,7 +201,7 @@ void AfterglowFramebufferManager::recreatePassFramebuffers(AfterglowPassInterfac
 		for (uint32_t attachmentIndex = 0; attachmentIndex < subpassContext.attachmentCount(); ++attachmentIndex) {
 			if (attachmentIndex == pass.presentAttachmentIndex()) {
 				// Present attachment
-				framebuffer.appendImageView(swapchain().imageView(framebufferIndex));
+				framebuffer.appendImageView(presentImageView(framebufferIndex));
 			}
 			else {
 				// Regular color and depth attachment
@@ -192,6 +214,36 @@ void AfterglowFramebufferManager::recreatePassFramebuffers(AfterglowPassInterfac
 	}
 }
 
+inline img::ImageReference AfterglowFramebufferManager::createAttachmentImage(
+	AfterglowPassInterface& pass, uint32_t attachmentIndex, VkExtent2D extent, std::unique_ptr<AfterglowObject>& destImage
+) {
+	auto& attachment = pass.subpassContext().attachment(attachmentIndex);
+	// DepthImage
+	if (pass.subpassContext().isDepthAttachmentIndex(attachmentIndex)) {
+		// @note: One depth image only, for read and write.
+		auto usage = AfterglowDepthImage::inputAttachmentUsage();
+		auto depthImage = std::make_unique<AfterglowDepthImage>(
+			device(), extent, attachment.samples, usage
+		);
+		depthImage->sampler().setAddressModes(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+		auto imageRef = img::MakeImageReference(*depthImage);
+		destImage = std::move(depthImage);
+		return imageRef;
+	}
+	// ColorImage
+	auto usage = AfterglowColorImage::defaultUsage();
+	if (pass.isSampledAttachment(attachmentIndex)) {
+		usage = AfterglowColorImage::inputAttachmentUsage();
+	}
+	auto colorImage = std::make_unique<AfterglowColorImage>(
+		device(), extent, attachment.format, attachment.samples, usage
+	);	
+	colorImage->sampler().setAddressModes(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+	auto imageRef = img::MakeImageReference(*colorImage);
+	destImage = std::move(colorImage);
+	return imageRef;
+}
+
 inline VkExtent2D AfterglowFramebufferManager::passExtent(AfterglowPassInterface& pass) {
 	switch (pass.extentMode()) {
 	case (AfterglowPassInterface::ExtentMode::Fixed):
@@ -199,14 +251,43 @@ inline VkExtent2D AfterglowFramebufferManager::passExtent(AfterglowPassInterface
 		break;
 	case (AfterglowPassInterface::ExtentMode::Swapchain):
 		return { 
-			static_cast<uint32_t>(pass.scale().x * _swapchain.extent().width),
-			static_cast<uint32_t>(pass.scale().y * _swapchain.extent().height),
+			static_cast<uint32_t>(pass.scale().x * extent().width),
+			static_cast<uint32_t>(pass.scale().y * extent().height),
 		};
 	default:
 		EXCEPT_CLASS_RUNTIME(std::format("Unsupported extent mode: {}", util::EnumValue(pass.extentMode())));
 	}
 }
 
+inline uint32_t AfterglowFramebufferManager::presentImageCount() const noexcept {
+	if (_swapchain) {
+		return static_cast<uint32_t>(_swapchain->imageViews().size());
+	}
+	return static_cast<uint32_t>(_offscreenTargets.size());
+}
+
+inline VkImageView AfterglowFramebufferManager::presentImageView(uint32_t index) {
+	if (_swapchain) {
+		return _swapchain->imageView(index);
+	}
+	return _offscreenTargets[index]->imageView();
+}
+
+void AfterglowFramebufferManager::recreateOffscreenTargets() {
+	_offscreenTargets.clear();
+	for (uint32_t index = 0; index < cfg::maxFrameInFlight; ++index) {
+		// Same format with the swapchain, so present passes and pipelines are shared with the windowed mode.
+		auto& target = _offscreenTargets.emplace_back(std::make_unique<AfterglowColorImage>(
+			device(), 
+			_offscreenExtent, 
+			swapchain::presentFormat, 
+			VK_SAMPLE_COUNT_1_BIT, 
+			AfterglowColorImage::inputAttachmentUsage() | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+		));
+		target->sampler().setAddressModes(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+	}
+}
+
 //inline AfterglowRenderPass* AfterglowFramebufferManager::findOnScreenRenderPass() {
 //	for (int32_t index = _passManager.fixedPasses().size() - 1; index >= 0; --index) {
 //		auto& fixedPass = _passManager.fixedPasses()[index];
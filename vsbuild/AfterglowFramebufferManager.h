@@ -1,4 +1,5 @@
 #pragma once
+#include <optional>
 #include "AfterglowFramebuffer.h"
 #include "AfterglowColorImage.h"
 #include "AfterglowDepthImage.h"
@@ -23,13 +24,21 @@ public:
 	// using AttachmentImages = std::vector<AttachmentImage>;
 
 	AfterglowFramebufferManager(AfterglowPassManager& passManager, AfterglowSwapchain& swapchain);
+	// @brief: Headless mode, present attachments are replaced by offscreen color targets with a fixed extent.
+	AfterglowFramebufferManager(AfterglowPassManager& passManager, AfterglowDevice& device, VkExtent2D offscreenExtent);
 
 	inline AfterglowDevice& device() noexcept;
 	inline AfterglowSwapchain& swapchain() noexcept;
 
+	bool headless() const noexcept;
+	// @return: Swapchain extent, or offscreen extent in headless mode.
+	VkExtent2D extent() const noexcept;
+	float aspectRatio() const noexcept;
+
 	// If window size is changed, call this function.
 	void recreateSwapchain();
 	// If returns -1, means failed to acquire image index, should interrupt this draw.
+	// In headless mode, offscreen target index is returned directly without any semaphore signaled.
 	int acquireNextImage(AfterglowSynchronizer& synchronizer);
 
 	//AfterglowFramebuffer& onScreenFramebuffer(uint32_t index);
@@ -42,15 +51,35 @@ public:
 
 private:
 	using PerPassImages = std::vector<std::unique_ptr<AfterglowObject>>;
+	using OffscreenTargets = std::vector<std::unique_ptr<AfterglowColorImage>>;
+
+	// Attachment image which is shared by render graph resources with non-overlapping lifetimes.
+	struct AliasedImage {
+		std::unique_ptr<AfterglowObject> image;
+		std::optional<img::ImageReference> reference;
+	};
+	using AliasedImages = std::vector<AliasedImage>;
 
 	void recreatePassFramebuffers(AfterglowPassInterface& pass);
+	inline img::ImageReference createAttachmentImage(
+		AfterglowPassInterface& pass, uint32_t attachmentIndex, VkExtent2D extent, std::unique_ptr<AfterglowObject>& destImage
+	);
+	inline uint32_t presentImageCount() const noexcept;
+	inline VkImageView presentImageView(uint32_t index);
+	void recreateOffscreenTargets();
 	inline VkExtent2D passExtent(AfterglowPassInterface & pass);
 
 	// @brief: RenderPass which is the last fixedPass has swapchin extent and export color attaachment.
 	//inline AfterglowRenderPass* findOnScreenRenderPass();
 
 	AfterglowPassManager& _passManager;
-	AfterglowSwapchain& _swapchain;
+	AfterglowDevice& _device;
+	// Null in headless mode.
+	AfterglowSwapchain* _swapchain;
+
+	// Headless present targets, one per frame in flight.
+	OffscreenTargets _offscreenTargets;
+	VkExtent2D _offscreenExtent{};
 
 	// Seperate to offscreen and onscreen framebuffers. recreate onscreen attachment and framebuffer only.
 	// Multi-framebuffers for swapchain.
@@ -60,6 +89,8 @@ private:
 	render::PassUnorderedMap<AfterglowFramebuffer::Array> _framebuffers;
 
 	render::PassUnorderedMap<PerPassImages> _images;
+	// Indexed by the render graph alias slot.
+	AliasedImages _aliasedImages;
 	render::PassUnorderedMap<img::ImageReferences> _imageReferences;
 	
 	bool _swapchainImageSetOutdatedFlag = false;
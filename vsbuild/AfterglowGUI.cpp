@@ -47,12 +47,19 @@ AfterglowGUI::AfterglowGUI(AfterglowWindow& window) : _window(window) {
 }
 
 AfterglowGUI::~AfterglowGUI() {
+	// Render context was never binded, e.g. headless mode.
+	if (!_impl) {
+		return;
+	}
 	ImGui_ImplVulkan_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
 }
 
 ImDrawData* AfterglowGUI::update() {
+	if (!_impl) {
+		return nullptr;
+	}
 	applyInputCallbacks();
 
 	ImGui_ImplVulkan_NewFrame();
@@ -7,26 +7,58 @@ AfterglowGraphicsQueue::AfterglowGraphicsQueue(AfterglowDevice& device) :
 	AfterglowQueue(device, device.physicalDevice().graphicsFamilyIndex()) {
 }
 
-void AfterglowGraphicsQueue::submit(VkCommandBuffer* commandBuffers, AfterglowSynchronizer& synchronizer) {
-	// Which semaphores ans which stages want to wait.
-	VkSemaphore waitSemaphores[] = {
-		synchronizer.semaphore(AfterglowSynchronizer::SemaphoreFlag::ComputeFinished),
-		synchronizer.semaphore(AfterglowSynchronizer::SemaphoreFlag::ImageAvaliable)
-	};
+void AfterglowGraphicsQueue::submit(VkCommandBuffer* commandBuffers, AfterglowSynchronizer& synchronizer, bool presentable) {
+	bool timelined = synchronizer.timelined();
 
+	// Which semaphores ans which stages want to wait.
 	// waitStages means that
 	// theoretically the implementation can already start executing our vertex shader
 	// and such while the image is not yet available.
-	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+	// Values of binary semaphores are ignored.
+	VkSemaphore waitSemaphores[3]{};
+	uint64_t waitValues[3]{};
+	VkPipelineStageFlags waitStages[3]{};
+	uint32_t waitSemaphoreCount = 0;
+
+	// In timeline backend, compute dependency is the value signaled by the last compute submission.
+	waitSemaphores[waitSemaphoreCount] = timelined 
+		? synchronizer.timelineSemaphore(AfterglowSynchronizer::TimelineFlag::Compute)
+		: synchronizer.semaphore(AfterglowSynchronizer::SemaphoreFlag::ComputeFinished);
+	waitValues[waitSemaphoreCount] = synchronizer.submittedValue(AfterglowSynchronizer::TimelineFlag::Compute);
+	waitStages[waitSemaphoreCount++] = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+
+	// Async compute runs one frame ahead, so graphics consumes the results of the last frame.
+	uint32_t lastFrameIndex = synchronizer.device().lastFrameIndex();
+	if (timelined && synchronizer.frameValue(AfterglowSynchronizer::TimelineFlag::AsyncCompute, lastFrameIndex) > 0) {
+		waitSemaphores[waitSemaphoreCount] = synchronizer.timelineSemaphore(AfterglowSynchronizer::TimelineFlag::AsyncCompute);
+		waitValues[waitSemaphoreCount] = synchronizer.frameValue(AfterglowSynchronizer::TimelineFlag::AsyncCompute, lastFrameIndex);
+		waitStages[waitSemaphoreCount++] = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+	}
+
+	// Skip it if nothing was acquired.
+	if (presentable) {
+		waitSemaphores[waitSemaphoreCount] = synchronizer.semaphore(AfterglowSynchronizer::SemaphoreFlag::ImageAvaliable);
+		waitStages[waitSemaphoreCount++] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	}
 
 	// Specify which semaphores to signal once the command buffer(s) have finished execution.
-	VkSemaphore signalSemaphores[] = { synchronizer.semaphore(AfterglowSynchronizer::SemaphoreFlag::RenderFinished) };
+	VkSemaphore signalSemaphores[2]{};
+	uint64_t signalValues[2]{};
+	uint32_t signalSemaphoreCount = 0;
+	if (presentable) {
+		signalSemaphores[signalSemaphoreCount++] = synchronizer.semaphore(AfterglowSynchronizer::SemaphoreFlag::RenderFinished);
+	}
+	uint64_t signalValue = synchronizer.advance(AfterglowSynchronizer::TimelineFlag::Render);
+	if (timelined) {
+		signalValues[signalSemaphoreCount] = signalValue;
+		signalSemaphores[signalSemaphoreCount++] = synchronizer.timelineSemaphore(AfterglowSynchronizer::TimelineFlag::Render);
+	}
 
 	// Submit optimization.
 	VkSubmitInfo submitInfo{};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-	submitInfo.waitSemaphoreCount = sizeof(waitSemaphores) / sizeof(VkSemaphore);
+	submitInfo.waitSemaphoreCount = waitSemaphoreCount;
 	submitInfo.pWaitSemaphores = waitSemaphores;
 	submitInfo.pWaitDstStageMask = waitStages;
 	// commandBuffers to actually submit
@@ -35,11 +67,21 @@ void AfterglowGraphicsQueue::submit(VkCommandBuffer* commandBuffers, AfterglowSy
 	// AfterglowCommandBuffer grarentees same memory layout with VkCommandBuffer.
 	submitInfo.pCommandBuffers = commandBuffers;
 
-	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.signalSemaphoreCount = signalSemaphoreCount;
 	submitInfo.pSignalSemaphores = signalSemaphores;
 
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	if (timelined) {
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+		timelineInfo.pWaitSemaphoreValues = waitValues;
+		timelineInfo.signalSemaphoreValueCount = signalSemaphoreCount;
+		timelineInfo.pSignalSemaphoreValues = signalValues;
+		submitInfo.pNext = &timelineInfo;
+	}
+
 	// DEBUG_COST_BEGIN("GraphicsSubmit");
-	if (vkQueueSubmit(_queue, 1, &submitInfo, synchronizer.fence(AfterglowSynchronizer::FenceFlag::RenderInFlight)) != VK_SUCCESS) {
+	if (vkQueueSubmit(_queue, 1, &submitInfo, synchronizer.submitFence(AfterglowSynchronizer::FenceFlag::RenderInFlight)) != VK_SUCCESS) {
 		EXCEPT_CLASS_RUNTIME("Failed to submit draw command buffer.");
 	}
 	// DEBUG_COST_END;
@@ -5,6 +5,7 @@ class AfterglowGraphicsQueue : public AfterglowQueue {
 public:
 	AfterglowGraphicsQueue(AfterglowDevice& device);
 
-	void submit(VkCommandBuffer* commandBuffers, AfterglowSynchronizer& synchronizer);
+	// @param presentable: If false (headless), swapchain image semaphores are neither waited nor signaled.
+	void submit(VkCommandBuffer* commandBuffers, AfterglowSynchronizer& synchronizer, bool presentable = true);
 };
 
@@ -0,0 +1,17 @@
+#include "AfterglowHostStorageBuffer.h"
+
+AfterglowHostStorageBuffer::AfterglowHostStorageBuffer(AfterglowDevice& device, uint64_t bufferSize) :
+	AfterglowBuffer(device), _bufferSize(bufferSize) {
+	info().usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+	initMemory(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	// Persistent mapped by the memory allocator.
+	_mapped = _memory.mapped();
+}
+
+void AfterglowHostStorageBuffer::writeMemory(const void* data, uint64_t size, uint64_t offset) {
+	memcpy(static_cast<char*>(_mapped) + offset, data, size);
+}
+
+uint64_t AfterglowHostStorageBuffer::byteSize() {
+	return _bufferSize;
+}
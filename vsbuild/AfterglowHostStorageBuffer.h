@@ -0,0 +1,23 @@
+#pragma once
+#include "AfterglowBuffer.h"
+
+/**
+* @brief: Host visible storage buffer which is persistently mapped, for per frame data written by CPU and read by shaders.
+* @note: Device local storage buffers which are filled by uploads or compute shaders are AfterglowStorageBuffer.
+*/
+class AfterglowHostStorageBuffer : public AfterglowBuffer<AfterglowHostStorageBuffer> {
+public:
+	AfterglowHostStorageBuffer(AfterglowDevice& device, uint64_t bufferSize);
+
+	/**
+	* @brief: Copy data into mapped memory directly.
+	* @warning: Make sure offset + size not greater than byteSize().
+	*/
+	void writeMemory(const void* data, uint64_t size, uint64_t offset = 0);
+
+	uint64_t byteSize() override;
+
+private:
+	uint64_t _bufferSize;
+	void* _mapped;
+};
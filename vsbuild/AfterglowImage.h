@@ -1,5 +1,5 @@
 #pragma once
-#include "AfterglowDeviceMemory.h"
+#include "AfterglowMemoryAllocator.h"
 #include "AfterglowImageView.h"
 #include "AfterglowSampler.h"
 #include "AssetDefinitions.h"
@@ -28,13 +28,13 @@ proxy_base_protected(Parent):
 
 protected:
 	void initMemory(VkMemoryPropertyFlags properties);
-	uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 
 	VkImageMemoryBarrier makeBarrier(VkImageLayout oldLayout, VkImageLayout newLayout);
 	inline VkFormat vulkanFormat(const img::Info& info);
 
 	AfterglowDevice& _device;
-	AfterglowDeviceMemory::AsElement _memory;
+	// As a member, it is released after the image was destroyed in destructor.
+	AfterglowMemoryAllocator::Allocation _memory;
 	AfterglowImageView::AsElement _imageView;
 	// TODO: release this after created?
 	img::Info _imageInfo;
@@ -101,7 +101,7 @@ AfterglowSampler& AfterglowImage<DerivedType, useUniqueSampler>::sampler() {
 
 template<typename DerivedType, bool useUniqueSampler>
 inline bool AfterglowImage<DerivedType, useUniqueSampler>::wasInitialized() {
-	return _memory;
+	return static_cast<bool>(_memory);
 }
 
 template<typename DerivedType, bool useUniqueSampler>
@@ -151,27 +151,9 @@ void AfterglowImage<DerivedType, useUniqueSampler>::create() {
 
 template<typename DerivedType, bool useUniqueSampler>
 void AfterglowImage<DerivedType, useUniqueSampler>::initMemory(VkMemoryPropertyFlags properties) {
-	VkMemoryRequirements memoryRequirements;
 	// Remind that Parent::data() could not create automatically, so we use *this.
-	vkGetImageMemoryRequirements(_device, *this, &memoryRequirements);
-	_memory = AfterglowDeviceMemory::makeElement(_device);
-	_memory->allocationSize = memoryRequirements.size;
-	_memory->memoryTypeIndex = findMemoryType(memoryRequirements.memoryTypeBits, properties);
-	// Bind image with memory.
-	vkBindImageMemory(_device, Parent::data(), _memory, 0);
-}
-
-template<typename DerivedType, bool useUniqueSampler>
-uint32_t AfterglowImage<DerivedType, useUniqueSampler>::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-	VkPhysicalDeviceMemoryProperties memoryProperties;
-	vkGetPhysicalDeviceMemoryProperties(_device.physicalDevice(), &memoryProperties);
-	for (uint32_t index = 0; index < memoryProperties.memoryTypeCount; ++index) {
-		if ((typeFilter & (1 << index)) && (memoryProperties.memoryTypes[index].propertyFlags & properties)) {
-			return index;
-		}
-	}
-	throw Parent::runtimeError("Failed to find suitable memory type.");
-	return -1;
+	// Image is bound with the sub allocation inside.
+	_memory = _device.memoryAllocator().allocate(static_cast<VkImage>(*this), properties);
 }
 
 template<typename DerivedType, bool useUniqueSampler>
@@ -1,8 +1,6 @@
 #include "AfterglowIndexBuffer.h"
 
-#include "AfterglowCommandPool.h"
-#include "AfterglowGraphicsQueue.h"
-#include "AfterglowStagingBuffer.h"
+#include "AfterglowUploadContext.h"
 
 
 AfterglowIndexBuffer::AfterglowIndexBuffer(AfterglowDevice& device) : 
@@ -37,11 +35,11 @@ std::weak_ptr<const AfterglowIndexBuffer::IndexArray> AfterglowIndexBuffer::inde
 	return _indices;
 }
 
-void AfterglowIndexBuffer::submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue) {
-	AfterglowStagingBuffer stagingBuffer(_device, safeIndices()->data(), byteSize());
-	commandPool.allocateSingleCommand(
-		graphicsQueue, 
-		[this, &stagingBuffer](VkCommandBuffer commandBuffer) {cmdCopyBuffer(commandBuffer, stagingBuffer); }
+void AfterglowIndexBuffer::submit(AfterglowUploadContext& uploadContext) {
+	uploadContext.upload(
+		safeIndices()->data(), 
+		byteSize(), 
+		[this](VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset) {cmdCopyBuffer(commandBuffer, srcBuffer, srcOffset); }
 	);
 	// Indices is presistantly map to GPU, so NEVER clear then.
 }
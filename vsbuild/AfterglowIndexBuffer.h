@@ -2,8 +2,7 @@
 #include "VertexStructs.h"
 #include "AfterglowBuffer.h"
 
-class AfterglowCommandPool;
-class AfterglowGraphicsQueue;
+class AfterglowUploadContext;
 
 class AfterglowIndexBuffer : public AfterglowBuffer<AfterglowIndexBuffer> {
 public:
@@ -28,8 +27,8 @@ public:
 	void setIndex(Size pos, Index value);
 	std::weak_ptr<const IndexArray> indexData() const;
 	
-	// Creating a staging buffer and use it copy memery to GPU, then clear stagingbuffer.
-	void submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue);
+	// Copy indices to the staging ring and record the buffer copy into the current upload batch.
+	void submit(AfterglowUploadContext& uploadContext);
 
 protected:
 	uint64_t byteSize() override;
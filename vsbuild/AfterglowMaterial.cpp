@@ -36,6 +36,7 @@ AfterglowMaterial::AfterglowMaterial(const AfterglowMaterial& other) :
 	_cullMode(other._cullMode),
 	_wireframe(other._wireframe),
 	_depthWrite(other._depthWrite),
+	_instancing(other._instancing),
 	_faceStencilInfos(other._faceStencilInfos), 
 	_vertexTypeIndex(other._vertexTypeIndex),
 	_vertexShaderPath(other._vertexShaderPath),
@@ -44,7 +45,10 @@ AfterglowMaterial::AfterglowMaterial(const AfterglowMaterial& other) :
 	_subpassName(other._subpassName), 
 	_scalars(other._scalars),
 	_vectors(other._vectors),
-	_textures(other._textures) {
+	_textures(other._textures), 
+	_keywords(other._keywords), 
+	_keywordMask(other._keywordMask), 
+	_shaderModel(other._shaderModel) {
 	if (other._computeTask) {
 		_computeTask = std::make_unique<AfterglowComputeTask>(*other._computeTask);
 	}
@@ -56,6 +60,7 @@ void AfterglowMaterial::operator=(const AfterglowMaterial& other) {
 	_cullMode = other._cullMode;
 	_wireframe = other._wireframe;
 	_depthWrite = other._depthWrite;
+	_instancing = other._instancing;
 	_faceStencilInfos = other._faceStencilInfos;
 	_vertexTypeIndex = other._vertexTypeIndex;
 	_vertexShaderPath = other._vertexShaderPath;
@@ -65,6 +70,9 @@ void AfterglowMaterial::operator=(const AfterglowMaterial& other) {
 	_scalars = other._scalars;
 	_vectors = other._vectors;
 	_textures = other._textures;
+	_keywords = other._keywords;
+	_keywordMask = other._keywordMask;
+	_shaderModel = other._shaderModel;
 	if (other._computeTask) {
 		_computeTask = std::make_unique<AfterglowComputeTask>(*other._computeTask);
 	}
@@ -76,6 +84,7 @@ AfterglowMaterial::AfterglowMaterial(AfterglowMaterial&& rval) noexcept :
 	_cullMode(std::move(rval._cullMode)),
 	_wireframe(std::move(rval._wireframe)),
 	_depthWrite(std::move(rval._depthWrite)),
+	_instancing(std::move(rval._instancing)),
 	_faceStencilInfos(std::move(rval._faceStencilInfos)),
 	_vertexTypeIndex(std::move(rval._vertexTypeIndex)),
 	_vertexShaderPath(std::move(rval._vertexShaderPath)),
@@ -84,7 +93,10 @@ AfterglowMaterial::AfterglowMaterial(AfterglowMaterial&& rval) noexcept :
 	_subpassName(std::move(rval._subpassName)),
 	_scalars(std::move(rval._scalars)),
 	_vectors(std::move(rval._vectors)),
-	_textures(std::move(rval._textures)) {
+	_textures(std::move(rval._textures)), 
+	_keywords(std::move(rval._keywords)), 
+	_keywordMask(rval._keywordMask), 
+	_shaderModel(rval._shaderModel) {
 	if (rval._computeTask) {
 		_computeTask = std::move(rval._computeTask);
 	}
@@ -96,6 +108,7 @@ void AfterglowMaterial::operator=(AfterglowMaterial&& rval) noexcept {
 	_cullMode = std::move(rval._cullMode);
 	_wireframe = std::move(rval._wireframe);
 	_depthWrite = std::move(rval._depthWrite);
+	_instancing = std::move(rval._instancing);
 	_faceStencilInfos = std::move(rval._faceStencilInfos);
 	_vertexTypeIndex = std::move(rval._vertexTypeIndex);
 	_vertexShaderPath = std::move(rval._vertexShaderPath);
@@ -105,6 +118,9 @@ void AfterglowMaterial::operator=(AfterglowMaterial&& rval) noexcept {
 	_scalars = std::move(rval._scalars);
 	_vectors = std::move(rval._vectors);
 	_textures = std::move(rval._textures);
+	_keywords = std::move(rval._keywords);
+	_keywordMask = rval._keywordMask;
+	_shaderModel = rval._shaderModel;
 	if (rval._computeTask) {
 		_computeTask = std::move(rval._computeTask);
 	}
@@ -187,6 +203,10 @@ void AfterglowMaterial::setDepthWrite(bool depthWrite) noexcept {
 	_depthWrite = depthWrite;
 }
 
+void AfterglowMaterial::setInstancing(bool instancing) noexcept {
+	_instancing = instancing;
+}
+
 void AfterglowMaterial::setTopology(render::Topology topology) noexcept {
 	_topology = topology;
 }
@@ -255,6 +275,38 @@ bool AfterglowMaterial::depthWrite() const noexcept {
 	return _depthWrite;
 }
 
+bool AfterglowMaterial::instancing() const noexcept {
+	return _instancing && !_computeTask;
+}
+
+void AfterglowMaterial::setKeywords(const shader::Keywords& keywords) {
+	_keywords = keywords;
+}
+
+void AfterglowMaterial::setKeywordMask(shader::KeywordMask keywordMask) noexcept {
+	_keywordMask = keywordMask;
+}
+
+const shader::Keywords& AfterglowMaterial::keywords() const noexcept {
+	return _keywords;
+}
+
+shader::KeywordMask AfterglowMaterial::keywordMask() const noexcept {
+	return _keywordMask;
+}
+
+shader::Defines AfterglowMaterial::keywordDefines() const {
+	return shader::KeywordDefines(_keywords, _keywordMask);
+}
+
+void AfterglowMaterial::setShaderModel(shader::Model shaderModel) noexcept {
+	_shaderModel = shaderModel;
+}
+
+shader::Model AfterglowMaterial::shaderModel() const noexcept {
+	return _shaderModel;
+}
+
 AfterglowMaterial::Parameter<AfterglowMaterial::Scalar>* AfterglowMaterial::scalar(shader::Stage stage, const std::string& name) {
 	return parameter<Scalar>(_scalars, stage, name);
 }
@@ -70,6 +70,8 @@ public:
 	void setCullMode(render::CullMode cullMode) noexcept;
 	void setWireframe(bool wireframe) noexcept;
 	void setDepthWrite(bool depthWrite) noexcept;
+	// @brief: Draws sharing mesh and material instance are merged into one instanced draw, vertex shader should read per object data from LoadObjectInstance(instanceID).
+	void setInstancing(bool instancing) noexcept;
 	void setTopology(render::Topology topology) noexcept;
 
 	void setVertexShader(const std::string& shaderPath);
@@ -77,6 +79,11 @@ public:
 	void setCustomPass(const std::string& passName);
 	void setSubpass(const std::string& subpassName);
 
+	// @brief: Declare keywords of shader variants, keyword mask is kept, so set keywords before selecting a variant.
+	void setKeywords(const shader::Keywords& keywords);
+	// @brief: Select the shader variant compiled by this material.
+	void setKeywordMask(shader::KeywordMask keywordMask) noexcept;
+
 	void setScalar(shader::Stage stage, const std::string& name, Scalar defaultValue);
 	void setVector(shader::Stage stage, const std::string& name, Vector defaultValue);
 	void setTexture(shader::Stage stage, const std::string& name, const TextureInfo& textureInfo);
@@ -91,6 +98,17 @@ public:
 	render::CullMode cullMode() const noexcept;
 	bool wireframe() const noexcept;
 	bool depthWrite() const noexcept;
+	// @note: Compute task materials are never instanced, their instance count is decided by the compute task.
+	bool instancing() const noexcept;
+
+	const shader::Keywords& keywords() const noexcept;
+	shader::KeywordMask keywordMask() const noexcept;
+	// @return: Defines of the selected variant, passed to all shader stages.
+	shader::Defines keywordDefines() const;
+
+	// @brief: Requested shader model of vertex and fragment shaders, compute task has its own one.
+	void setShaderModel(shader::Model shaderModel) noexcept;
+	shader::Model shaderModel() const noexcept;
 
 	Parameter<Scalar>* scalar(shader::Stage stage, const std::string& name);
 	Parameter<Vector>* vector(shader::Stage stage, const std::string& name);
@@ -154,6 +172,7 @@ private:
 
 	bool _wireframe = false;
 	bool _depthWrite = true;
+	bool _instancing = false;
 
 	render::FaceStencilInfos _faceStencilInfos{};
 
@@ -168,6 +187,10 @@ private:
 	Parameters<Vector> _vectors;
 	Parameters<TextureInfo> _textures;
 
+	shader::Keywords _keywords;
+	shader::KeywordMask _keywordMask = 0;
+	shader::Model _shaderModel = shader::Model::SM6_0;
+
 	std::unique_ptr<AfterglowComputeTask> _computeTask = nullptr;
 };
 
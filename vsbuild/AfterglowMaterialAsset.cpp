@@ -1,6 +1,7 @@
 #include "AfterglowMaterialAsset.h"
 #include <fstream>
 #include <mutex>
+#include <optional>
 #include <json.hpp>
 
 #include "AfterglowMaterial.h"
@@ -124,6 +125,9 @@ void AfterglowMaterialAsset::initMaterial() {
 			}
 		});
 	}
+	if (data.contains("shaderModel") && data["shaderModel"].is_string()) {
+		material.setShaderModel(shaderModel(data["shaderModel"]));
+	}
 	if (data.contains("customPassName") && data["customPassName"].is_string()) {
 		material.setCustomPass(data["customPassName"]);
 	}
@@ -145,6 +149,9 @@ void AfterglowMaterialAsset::initMaterial() {
 	if (data.contains("depthWrite") && data["depthWrite"].is_boolean()) {
 		material.setDepthWrite(data["depthWrite"]);
 	}
+	if (data.contains("instancing") && data["instancing"].is_boolean()) {
+		material.setInstancing(data["instancing"]);
+	}
 	if (data.contains("stencil") && data["stencil"].is_object()) {
 		render::FaceStencilInfos faceStencilInfos{};
 		initMaterialStencilInfo("front", faceStencilInfos.front);
@@ -152,6 +159,36 @@ void AfterglowMaterialAsset::initMaterial() {
 		material.setFaceStencilInfo(std::move(faceStencilInfos));
 	}
 
+	// Keyword: { "name": "NAME" } for boolean, { "name": "NAME", "values": ["A", "B", ...] } for enum.
+	if (data.contains("keywords") && data["keywords"].is_array()) {
+		shader::Keywords keywords;
+		uint32_t keywordBitCount = 0;
+		for (const auto& keywordData : data["keywords"]) {
+			if (!keywordData.is_object() || !keywordData.contains("name") || !keywordData["name"].is_string()) {
+				continue;
+			}
+			shader::Keyword keyword{ .name = keywordData["name"] };
+			if (keywordData.contains("values") && keywordData["values"].is_array()) {
+				for (const auto& value : keywordData["values"]) {
+					if (value.is_string()) {
+						keyword.values.push_back(value);
+					}
+				}
+			}
+			// Keywords are validated here once, so setters of material instances never exceed the mask.
+			keywordBitCount += shader::KeywordBitCount(keyword);
+			if (keywordBitCount > shader::maxKeywordBitCount) {
+				DEBUG_CLASS_ERROR(std::format(
+					"Keywords exceed {} mask bits, \"{}\" and following keywords are ignored, in material: \"{}\"", 
+					shader::maxKeywordBitCount, keyword.name, materialName()
+				));
+				break;
+			}
+			keywords.push_back(std::move(keyword));
+		}
+		material.setKeywords(keywords);
+	}
+
 	if (data.contains("scalars") && data["scalars"].is_array()) {
 		for (const auto& scalar : data["scalars"]) {
 			if (scalar.contains("name") && scalar["name"].is_string()
@@ -206,9 +243,15 @@ void AfterglowMaterialAsset::initMaterialComputeTask() {
 	if (computeTaskData.contains("computeOnly") && computeTaskData["computeOnly"].is_boolean()) {
 		computeTask.setComputeOnly(computeTaskData["computeOnly"]);
 	}
+	if (computeTaskData.contains("async") && computeTaskData["async"].is_boolean()) {
+		computeTask.setAsync(computeTaskData["async"]);
+	}
 	if (computeTaskData.contains("computeShaderPath") && computeTaskData["computeShaderPath"].is_string()) {
 		computeTask.setComputeShader(computeTaskData["computeShaderPath"]);
 	}
+	if (computeTaskData.contains("shaderModel") && computeTaskData["shaderModel"].is_string()) {
+		computeTask.setShaderModel(shaderModel(computeTaskData["shaderModel"]));
+	}
 	if (computeTaskData.contains("dispatchGroup")
 		&& computeTaskData["dispatchGroup"].is_array()
 		&& computeTaskData["dispatchGroup"].size() >= 3) {
@@ -332,6 +375,19 @@ inline void AfterglowMaterialAsset::initMaterialStencilInfo(std::string_view src
 	}
 }
 
+inline shader::Model AfterglowMaterialAsset::shaderModel(const std::string& modelName) {
+	std::optional<shader::Model> model;
+	Inreflect<shader::Model>::forEachAttribute([&modelName, &model](auto enumInfo){
+		if (enumInfo.name == modelName) {
+			model = enumInfo.raw;
+		}
+	});
+	if (!model) {
+		DEBUG_TYPE_WARNING(AfterglowMaterialAsset, std::format("Unknown shader model \"{}\", SM6_0 is used instead.", modelName));
+	}
+	return model.value_or(shader::Model::SM6_0);
+}
+
 void AfterglowMaterialAsset::parseShaderDeclarations() {	
 	// <shader::Stage, {ScalarCount, memberDeclarations}>
 	// ScalarCount use for memory alignment.
@@ -363,12 +419,20 @@ void AfterglowMaterialAsset::parseShaderDeclarations() {
 		0
 	);
 
+	// Merged instanced draws bind the per object set of their first draw, so the mesh uniform is not declared for instancing materials,
+	// any shader that reads it fails to compile instead of reading the first object's data for all instances.
+	if (_impl->material.instancing()) {
+		perObjectUniformStructDeclaration.clear();
+	}
+
 	// Vertex Shader
 	std::string& vertexShaderDeclaration = _impl->shaderDeclarations[shader::Stage::Vertex];
 	// Vertex Shader: Global uniform
 	vertexShaderDeclaration += globalUniformStructDeclaration;
 	// Vertex Shader: Mesh uniform
 	vertexShaderDeclaration += perObjectUniformStructDeclaration;
+	// Vertex Shader: Object instance
+	vertexShaderDeclaration += makeObjectInstanceDeclaration(_impl->material.instancing());
 	// Vertex Shader: Vertex stage uniform declaration.
 	vertexShaderDeclaration += makeUniformStructDeclaration(
 		"MaterialVertexUniform", 
@@ -600,6 +664,30 @@ inline std::string AfterglowMaterialAsset::makeUniformStructDeclaration(
 	return declaration;
 }
 
+inline std::string AfterglowMaterialAsset::makeObjectInstanceDeclaration(bool instancing) {
+	std::string declaration;
+	declaration += "struct ObjectInstance {\n";
+	declaration += makeUniformMemberDeclarationContext<ubo::ObjectInstance>();
+	declaration += "};\n";
+	if (instancing) {
+		declaration += std::format(
+			"[[vk::binding({}, {})]] StructuredBuffer<ObjectInstance> objectInstances;\n",
+			util::EnumValue(shader::PerObjectSetBindingIndex::ObjectInstances),
+			util::EnumValue(shader::SetIndex::PerObject)
+		);
+		// SV_InstanceID maps to InstanceIndex in SPIR-V, which includes the firstInstance of instanced draw.
+		declaration += "ObjectInstance LoadObjectInstance(uint instanceID) {\n\treturn objectInstances[instanceID];\n}\n";
+		return declaration;
+	}
+	// Not instancing, read the per object uniform.
+	declaration += "ObjectInstance LoadObjectInstance(uint instanceID) {\n\tObjectInstance instance;\n";
+	Inreflect<ubo::ObjectInstance>::forEachAttribute([&declaration](auto typeInfo) {
+		declaration += std::format("\tinstance.{0} = {0};\n", typeInfo.name);
+	});
+	declaration += "\treturn instance;\n}\n";
+	return declaration;
+}
+
 inline std::string AfterglowMaterialAsset::makeCombinedTextureSamplerDeclaration(
 	uint32_t setIndex, 
 	uint32_t bindingIndex, 
@@ -80,6 +80,8 @@ private:
 	void initMaterialComputeTask();
 
 	inline void initMaterialStencilInfo(std::string_view srcFaceName, render::StencilInfo& dstStencilInfo);
+	// @brief: Model name is the enum name e.g. "SM6_2", SM6_0 if unknown.
+	static inline shader::Model shaderModel(const std::string& modelName);
 
 	void loadShaderAssets();
 
@@ -103,6 +105,9 @@ private:
 		const std::string& structName, const std::string& memberContext, shader::SetIndex shaderSet, uint32_t bindingIndex
 	);
 
+	// @brief: ObjectInstance struct and LoadObjectInstance(instanceID), which reads PerObjectUniform if the material is not instancing.
+	static inline std::string makeObjectInstanceDeclaration(bool instancing);
+
 	static inline std::string makeCombinedTextureSamplerDeclaration(
 		uint32_t setIndex, 
 		uint32_t bindingIndex, 
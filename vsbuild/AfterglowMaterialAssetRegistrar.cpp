@@ -1,4 +1,6 @@
 #include "AfterglowMaterialAssetRegistrar.h"
+#include <utility>
+#include <algorithm>
 
 #include "AfterglowMaterialManager.h"
 #include "AfterglowAssetMonitor.h"
@@ -8,6 +10,7 @@
 #include "AfterglowMaterialResource.h"
 #include "AfterglowMaterialUtilities.h"
 #include "AfterglowComputeTask.h"
+#include "AfterglowShaderModule.h"
 #include "ExceptionUtilities.h"
 
 struct AfterglowMaterialAssetRegistrar::Impl {
@@ -27,7 +30,10 @@ struct AfterglowMaterialAssetRegistrar::Impl {
 	inline void increaseShaderAssetReference(const std::string& assetPath, const std::string& materialName);
 	inline void decreaseShaderAssetReference(const std::string& assetPath, const std::string& materialName);
 
-	inline void updateShaderAssetReferences(UpdateShaderAssetReferencesFunc func,  AfterglowMaterial& material, const std::string& materialName);
+	// @brief: Update references of shader files of the material, and files included by them.
+	inline void updateShaderAssetReferences(UpdateShaderAssetReferencesFunc func, const AfterglowMaterial& material, const std::string& materialName);
+	// @return: True if any shader file of the material is monitored for this material.
+	inline bool isMonitored(const AfterglowMaterial& material, const std::string& materialName) const;
 
 	AfterglowMaterialManager& materialManager;
 	AfterglowAssetMonitor& assetMonitor;
@@ -141,6 +147,12 @@ void AfterglowMaterialAssetRegistrar::unregisterMaterialInstanceAsset(const std:
 	}
 }
 
+void AfterglowMaterialAssetRegistrar::watchIncludedFiles(const std::string& materialName, const AfterglowMaterial& material) {
+	if (_impl->isMonitored(material, materialName)) {
+		_impl->updateShaderAssetReferences(&Impl::increaseShaderAssetReference, material, materialName);
+	}
+}
+
 AfterglowMaterialAssetRegistrar::Impl::Impl(AfterglowMaterialManager& materialManagerRef, AfterglowAssetMonitor& assetMonitorRef) : 
 	materialManager(materialManagerRef), assetMonitor(assetMonitorRef) {
 	initAssetMonitorCallbacks();
@@ -195,7 +207,9 @@ void AfterglowMaterialAssetRegistrar::Impl::modifiedMateiralAssetCallback(Impl&
 			context.materialManager.removeMaterial(oldMaterialName);
 			oldMaterialName = newMaterialName;
 		}
-		context.createMaterialFromAsset(materialAsset);
+		// Shaders are compiled in background, the material is applied at a frame boundary.
+		context.materialManager.reloadMaterial(newMaterialName, materialAsset);
+		context.updateShaderAssetReferences(&Impl::increaseShaderAssetReference, materialAsset.material(), newMaterialName);
 	}
 	catch (const std::exception& assetException) {
 		DEBUG_TYPE_ERROR(Impl, std::format(
@@ -256,31 +270,9 @@ void AfterglowMaterialAssetRegistrar::Impl::modifiedMateiralInstanceAssetCallbac
 }
 
 void AfterglowMaterialAssetRegistrar::Impl::modifiedShaderAssetCallback(Impl& context, const std::string& modifiedPath, AfterglowAssetMonitor::TagInfos& tagInfos) {
-	auto& materialManager = context.materialManager;
-	// Copy the tagInfos due to shader tagInfos will be changed by decreaseShaderAssetReference().
-	AfterglowAssetMonitor::TagInfos copiedTagInfos = tagInfos;
-	for (const auto& [materialName, verificationInfo] : copiedTagInfos) {
-		if (verificationInfo != Impl::materialNameTag) {
-			continue;
-		}
-		auto* matLayout = materialManager.materialLayout(materialName);
-		// If material not found, decrease the shader asset reference.
-		if (!matLayout) {
-			// context.decreaseShaderAssetReference(modifiedPath, materialName);
-			continue;
-		}
-		auto& material = matLayout->material();
-		auto materialAsset = AfterglowMaterialAsset(material);
-
-		// Make sure pipeline was released before we update it.
-		materialManager.waitGPU();
-		materialManager.safeApplyShaders(*matLayout, materialAsset);
-
-		// When shader changed, only pipeline need to rebuild, resources are same.
-		// So do not call mark matLayout to dated, dated will also reload its matResources.
-		// markDated(matLayout);
-		matLayout->updatePipelines();
-	}
+	// Only materials which use this file (directly or by includes) are reloaded, found by the dependency graph.
+	// Shaders and pipelines are rebuilt in background, old pipelines are kept until new ones are ready.
+	context.materialManager.reloadShaderFile(modifiedPath);
 }
 
 inline void AfterglowMaterialAssetRegistrar::Impl::increaseShaderAssetReference(const std::string& assetPath, const std::string& materialName) {
@@ -320,17 +312,47 @@ inline void AfterglowMaterialAssetRegistrar::Impl::decreaseShaderAssetReference(
 	}
 }
 
-inline void AfterglowMaterialAssetRegistrar::Impl::updateShaderAssetReferences(UpdateShaderAssetReferencesFunc func, AfterglowMaterial& material, const std::string& materialName) {
-	(this->*func)(material.vertexShaderPath(), materialName);
-	(this->*func)(material.fragmentShaderPath(), materialName);
+inline void AfterglowMaterialAssetRegistrar::Impl::updateShaderAssetReferences(UpdateShaderAssetReferencesFunc func, const AfterglowMaterial& material, const std::string& materialName) {
+	std::vector<std::string> shaderPaths{ material.vertexShaderPath(), material.fragmentShaderPath() };
 	if (material.hasComputeTask()) {
-		(this->*func)(material.computeTask().computeShaderPath(), materialName);
+		shaderPaths.push_back(material.computeTask().computeShaderPath());
 		// Register initComputeShader assets.
 		for (const auto& ssboInfo : material.computeTask().ssboInfos()) {
 			if (ssboInfo.initMode() != compute::SSBOInitMode::ComputeShader) {
 				continue;
 			}
-			(this->*func)(ssboInfo.initResource(), materialName);
+			shaderPaths.push_back(ssboInfo.initResource());
 		}
 	}
+
+	// Included files are known after compilation, shared ones are updated once.
+	std::vector<std::string> includedPaths;
+	for (const auto& shaderPath : shaderPaths) {
+		(this->*func)(shaderPath, materialName);
+		if (!shaderPath.empty()) {
+			auto shaderIncludedPaths = AfterglowShaderModule::includeGraph().dependencies(util::NormalizePath(shaderPath));
+			includedPaths.insert(includedPaths.end(), shaderIncludedPaths.begin(), shaderIncludedPaths.end());
+		}
+	}
+	std::sort(includedPaths.begin(), includedPaths.end());
+	includedPaths.erase(std::unique(includedPaths.begin(), includedPaths.end()), includedPaths.end());
+	for (const auto& includedPath : includedPaths) {
+		// A missing included file is a compilation error, it should not stop monitoring others.
+		try {
+			(this->*func)(includedPath, materialName);
+		}
+		catch (const std::exception& error) {
+			DEBUG_CLASS_WARNING(std::format("Failed to monitor included file: {}, due to: {}", includedPath, error.what()));
+		}
+	}
+}
+
+inline bool AfterglowMaterialAssetRegistrar::Impl::isMonitored(const AfterglowMaterial& material, const std::string& materialName) const {
+	auto isMonitoredPath = [this, &materialName](const std::string& path) {
+		const auto* assetInfo = std::as_const(assetMonitor).registeredAssetInfo(path);
+		return assetInfo && assetInfo->tagInfos.contains(materialName);
+	};
+	return isMonitoredPath(material.vertexShaderPath()) 
+		|| isMonitoredPath(material.fragmentShaderPath()) 
+		|| (material.hasComputeTask() && isMonitoredPath(material.computeTask().computeShaderPath()));
 }
@@ -5,6 +5,7 @@
 
 class AfterglowMaterialManager;
 class AfterglowAssetMonitor;
+class AfterglowMaterial;
 
 class AfterglowMaterialAssetRegistrar {
 public:
@@ -17,6 +18,12 @@ public:
 	void unregisterMaterialAsset(const std::string& materialPath);
 	void unregisterMaterialInstanceAsset(const std::string& materialInstancePath);
 
+	/**
+	* @brief: Monitor files included by shaders of the material, invoke it after shaders of the material are compiled.
+	* @note: Materials which are not from assets are ignored.
+	*/
+	void watchIncludedFiles(const std::string& materialName, const AfterglowMaterial& material);
+
 private:
 	struct Impl;
 	std::unique_ptr<Impl> _impl;
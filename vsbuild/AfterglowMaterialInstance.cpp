@@ -1,5 +1,7 @@
 #include "AfterglowMaterialInstance.h"
 
+#include <algorithm>
+
 AfterglowMaterialInstance::AfterglowMaterialInstance() : 
 	AfterglowMaterial(AfterglowMaterial::defaultMaterial()), _parent(&AfterglowMaterial::defaultMaterial()) {
 }
@@ -50,6 +52,7 @@ AfterglowMaterialInstance AfterglowMaterialInstance::makeRedirectedInstance(cons
 			instance.setTexture(stage, textureParam.name, *value);
 		}
 	}
+	instance.setKeywordMask(keywordMask());
 	return instance;
 }
 
@@ -84,6 +87,50 @@ bool AfterglowMaterialInstance::setTexture(shader::Stage stage, const std::strin
 	return true;
 }
 
+bool AfterglowMaterialInstance::setKeyword(const std::string& name, bool enabled) {
+	uint32_t keywordIndex = shader::KeywordIndex(keywords(), name);
+	if (keywordIndex >= keywords().size() || !keywords()[keywordIndex].values.empty() || !keywordsSelectable()) {
+		return false;
+	}
+	setKeywordMask(shader::SetKeywordValue(keywords(), keywordMask(), keywordIndex, enabled));
+	return true;
+}
+
+bool AfterglowMaterialInstance::setKeywordValue(const std::string& name, const std::string& value) {
+	uint32_t keywordIndex = shader::KeywordIndex(keywords(), name);
+	if (keywordIndex >= keywords().size() || !keywordsSelectable()) {
+		return false;
+	}
+	const auto& values = keywords()[keywordIndex].values;
+	auto iterator = std::find(values.begin(), values.end(), value);
+	if (iterator == values.end()) {
+		return false;
+	}
+	setKeywordMask(shader::SetKeywordValue(keywords(), keywordMask(), keywordIndex, static_cast<uint32_t>(iterator - values.begin())));
+	return true;
+}
+
+inline bool AfterglowMaterialInstance::keywordsSelectable() const noexcept {
+	// Compute tasks are dispatched by the layout of the material itself, a variant layout would dispatch it once more.
+	if (_parent->hasComputeTask()) {
+		return false;
+	}
+	// Material assets drop keywords out of the mask, it's only for materials built in code.
+	return shader::KeywordsBitCount(keywords()) <= shader::maxKeywordBitCount;
+}
+
+void AfterglowMaterialInstance::setKeywordMask(shader::KeywordMask keywordMask) noexcept {
+	AfterglowMaterial::setKeywordMask(keywordMask);
+}
+
+const shader::Keywords& AfterglowMaterialInstance::keywords() const noexcept {
+	return AfterglowMaterial::keywords();
+}
+
+shader::KeywordMask AfterglowMaterialInstance::keywordMask() const noexcept {
+	return AfterglowMaterial::keywordMask();
+}
+
 AfterglowMaterialInstance::Parameter<AfterglowMaterialInstance::Scalar>* AfterglowMaterialInstance::scalar(shader::Stage stage, const std::string& name) {
 	return AfterglowMaterial::scalar(stage, name);
 }
@@ -126,4 +173,5 @@ const AfterglowMaterial& AfterglowMaterialInstance::parentMaterial() const noexc
 
 void AfterglowMaterialInstance::reset() {
 	this->operator=(*_parent);
+	setKeywordMask(0);
 }
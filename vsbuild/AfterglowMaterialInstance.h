@@ -26,6 +26,19 @@ public:
 	// @return: true if set parameter successfully.
 	bool setTexture(shader::Stage stage, const std::string& name, const TextureInfo& assetInfo);
 
+	/**
+	* @brief: Select a shader variant by keywords declared in the parent material.
+	* @desc: The variant is switched when this instance is submitted, a variant not used before is switched after it was compiled in background.
+	* @return: true if the keyword (and the value) is declared.
+	*	false if keywords of the parent exceed the mask, or the parent has a compute task, which has no variants.
+	*/
+	bool setKeyword(const std::string& name, bool enabled);
+	bool setKeywordValue(const std::string& name, const std::string& value);
+	void setKeywordMask(shader::KeywordMask keywordMask) noexcept;
+
+	const shader::Keywords& keywords() const noexcept;
+	shader::KeywordMask keywordMask() const noexcept;
+
 	// TODO: Deprecate these non-const container functions. modify parameters from set functions.
 	Parameter<Scalar>* scalar(shader::Stage stage, const std::string& name);
 	Parameter<Vector>* vector(shader::Stage stage, const std::string& name);
@@ -42,10 +55,12 @@ public:
 
 	const AfterglowMaterial& parentMaterial() const noexcept;
 
-	// @brief: Restore all parameters from parent.
+	// @brief: Restore all parameters from parent, keywords are restored to default.
 	void reset();
 
 private:
+	inline bool keywordsSelectable() const noexcept;
+
 	/**
 	* @desc: 
 	* 	If current material instance exists this param and has a non-default value, 
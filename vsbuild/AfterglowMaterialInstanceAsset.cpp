@@ -47,6 +47,21 @@ std::string AfterglowMaterialInstanceAsset::parentMaterialName() const {
 
 void AfterglowMaterialInstanceAsset::fill(AfterglowMaterialInstance& destMaterialInstance) const {
 	auto& data = _impl->data;
+	// Keywords: { "BOOLEAN_NAME": true, "ENUM_NAME": "VALUE" }
+	if (data.contains("keywords") && data["keywords"].is_object()) {
+		for (const auto& [name, value] : data["keywords"].items()) {
+			bool succeeded = false;
+			if (value.is_boolean()) {
+				succeeded = destMaterialInstance.setKeyword(name, value.get<bool>());
+			}
+			else if (value.is_string()) {
+				succeeded = destMaterialInstance.setKeywordValue(name, value.get<std::string>());
+			}
+			if (!succeeded) {
+				DEBUG_CLASS_WARNING(std::format("Keyword \"{}\" is not declared by the parent material, or its value is invalid.", name));
+			}
+		}
+	}
 	if (data.contains("scalars") && data["scalars"].is_array()) {
 		for (const auto& scalar : data["scalars"]) {
 			if (!scalar.contains("name") || !scalar["name"].is_string()
@@ -76,7 +76,7 @@ void AfterglowMaterialLayout::compileVertexShader(const std::string& shaderCode)
 		throw runtimeError("Failed to compute vertex shader due to this material is compute only.");
 	}
 	_vertexShader.recreate(
-		device(), shader::Stage::Vertex, shaderCode, _material.vertexShaderPath()
+		device(), shader::Stage::Vertex, shaderCode, _material.vertexShaderPath(), _material.keywordDefines(), _material.shaderModel()
 	);
 }
 
@@ -85,24 +85,19 @@ void AfterglowMaterialLayout::compileFragmentShader(const std::string& shaderCod
 		throw runtimeError("Failed to compute fragment shader due to this material is compute only.");
 	}
 	_fragmentShader.recreate(
-		device(), shader::Stage::Fragment, shaderCode, _material.fragmentShaderPath()
+		device(), shader::Stage::Fragment, shaderCode, _material.fragmentShaderPath(), _material.keywordDefines(), _material.shaderModel()
 	);
 }
 
 void AfterglowMaterialLayout::compileComputeShader(const std::string& shaderCode) {
 	verifyComputeTask();
+	auto& computeTask = _material.computeTask();
 	_computeLayout->shader.recreate(
-		device(), shader::Stage::Compute, shaderCode, _material.computeTask().computeShaderPath()
+		device(), shader::Stage::Compute, shaderCode, computeTask.computeShaderPath(), _material.keywordDefines(), computeTask.shaderModel()
 	);
 }
 
-void AfterglowMaterialLayout::updateDescriptorSetLayouts(
-	AfterglowPassManager& passManager,
-	render::PassUnorderedMap<AfterglowDescriptorSetLayout::AsElement>& allPassSetLayouts,
-	AfterglowDescriptorSetLayout& globalSetLayout,
-	AfterglowDescriptorSetLayout& perObjectSetLayout
-) {
-	// Update pass
+void AfterglowMaterialLayout::updatePass(AfterglowPassManager& passManager) {
 	if (_material.customPassName().empty()) {
 		_pass = passManager.findPass(_material.domain());
 	}
@@ -116,6 +111,15 @@ void AfterglowMaterialLayout::updateDescriptorSetLayouts(
 		));
 		_pass = passManager.findPass(render::Domain::Forward);
 	}
+}
+
+void AfterglowMaterialLayout::updateDescriptorSetLayouts(
+	AfterglowPassManager& passManager,
+	render::PassUnorderedMap<AfterglowDescriptorSetLayout::AsElement>& allPassSetLayouts,
+	AfterglowDescriptorSetLayout& globalSetLayout,
+	AfterglowDescriptorSetLayout& perObjectSetLayout
+) {
+	updatePass(passManager);
 
 	// Material Sets:
 	// Set 0: Global Set	(Managed in the MaterialManager instead of MaterialContext)
@@ -280,7 +284,9 @@ void AfterglowMaterialLayout::updateComputePipeline() {
 				device(),
 				shader::Stage::Compute,
 				materialAsset->shaderDeclaration(shader::Stage::Compute) + shaderAsset.code(),
-				_material.computeTask().computeShaderPath()
+				_material.computeTask().computeShaderPath(), 
+				_material.keywordDefines(), 
+				computeTask.shaderModel()
 			);
 		}
 		catch (const std::runtime_error& error) {
@@ -314,6 +320,51 @@ void AfterglowMaterialLayout::updatePipelines() {
 	}
 }
 
+void AfterglowMaterialLayout::createPipelines() {
+	// Implicit conversion creates the vulkan object.
+	if (!isComputeOnly() && _pipeline) {
+		static_cast<VkPipeline>(*_pipeline);
+	}
+	if (!_computeLayout) {
+		return;
+	}
+	if (_computeLayout->pipeline) {
+		static_cast<VkPipeline>(*_computeLayout->pipeline);
+	}
+	if (_computeLayout->indirectResetPipeline) {
+		static_cast<VkPipeline>(*_computeLayout->indirectResetPipeline);
+	}
+	for (auto& ssboInitPipeline : _computeLayout->ssboInitPipelines) {
+		static_cast<VkPipeline>(*ssboInitPipeline);
+	}
+}
+
+void AfterglowMaterialLayout::stageFrom(const AfterglowMaterialLayout& source) {
+	_pass = source._pass;
+	_rawDescriptorSetLayouts = source._rawDescriptorSetLayouts;
+}
+
+void AfterglowMaterialLayout::swapPipelines(AfterglowMaterialLayout& staged) {
+	_vertexShader.raw().swap(staged._vertexShader.raw());
+	_fragmentShader.raw().swap(staged._fragmentShader.raw());
+	_pipeline.raw().swap(staged._pipeline.raw());
+	std::swap(_subpassIndex, staged._subpassIndex);
+	std::swap(_computeLayout, staged._computeLayout);
+	// Pipelines were rebuilt, initialize compute task again, same as updateComputePipeline().
+	if (_material.hasComputeTask()) {
+		_material.computeTask().setDispatchStatuses(AfterglowComputeTask::DispatchStatus::None);
+	}
+}
+
+void AfterglowMaterialLayout::swapShaders(AfterglowMaterialLayout& staged) {
+	_vertexShader.raw().swap(staged._vertexShader.raw());
+	_fragmentShader.raw().swap(staged._fragmentShader.raw());
+	if (staged._computeLayout) {
+		verifyComputeTask();
+		_computeLayout->shader.raw().swap(staged._computeLayout->shader.raw());
+	}
+}
+
 void AfterglowMaterialLayout::appendDescriptorSetLayout(shader::Stage stage) {
 	auto vulkanStage = vulkanShaderStage(stage);
 
@@ -44,6 +44,9 @@ public:
 	void compileFragmentShader(const std::string& shaderCode);
 	void compileComputeShader(const std::string& shaderCode);
 
+	// @brief: Find the pass of current material, the default pass (Forward) is used if not found.
+	void updatePass(AfterglowPassManager& passManager);
+
 	// @brief: Apply material modification to layout.
 	void updateDescriptorSetLayouts(
 		AfterglowPassManager& passManager, 
@@ -60,6 +63,21 @@ public:
 
 	// @brief: Update both of the compute pipeline and the render pipeline.
 	void updatePipelines();
+	/**
+	* @brief: Create vulkan pipelines now instead of on the first bind.
+	* @note: Thread safe between different material layouts, pipelines are created with the shared device pipeline cache.
+	*/
+	void createPipelines();
+
+	/**
+	* @brief: Use the pass and descriptor set layouts of the source, so shaders and pipelines could be built out of the source.
+	* @warning: Descriptor set layouts are referenced, the source should not update them before staged pipelines are created.
+	*/
+	void stageFrom(const AfterglowMaterialLayout& source);
+	// @brief: Exchange shaders and pipelines with the staged layout, old ones are destroyed with the staged layout.
+	void swapPipelines(AfterglowMaterialLayout& staged);
+	// @brief: Exchange shaders only, pipelines are rebuilt by updatePipelines().
+	void swapShaders(AfterglowMaterialLayout& staged);
 
 	static VkShaderStageFlags vulkanShaderStage(shader::Stage stage);
 
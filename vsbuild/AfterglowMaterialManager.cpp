@@ -1,32 +1,46 @@
 #include "AfterglowMaterialManager.h"
 #include <utility>
+#include <algorithm>
 
 #include <map>
+#include <deque>
+#include <iostream>
+#include <thread>
+#include <optional>
+#include <condition_variable>
 #include <unordered_set>
 #include <unordered_map>
 
 #include "GlobalAssets.h"
 #include "AfterglowMaterialUtilities.h"
 #include "AfterglowSynchronizer.h"
+#include "AfterglowDeletionQueue.h"
 #include "AfterglowMaterialAsset.h"
 #include "AfterglowMaterialAssetRegistrar.h"
 #include "AfterglowMaterialResource.h"
 #include "AfterglowDescriptorSetWriter.h"
 #include "AfterglowDescriptorSetReferences.h"
+#include "AfterglowHostStorageBuffer.h"
 #include "AfterglowComputeTask.h"
 #include "AfterglowPassManager.h"
+#include "AfterglowShaderModule.h"
+#include "DependencyGraph.h"
+#include "AfterglowDxcInstances.h"
+#include "LocalClock.h"
+#include "LinearAllocator.h"
+#include "WorkerPool.h"
 
 
 struct AfterglowMaterialManager::Impl {
 	using MaterialLayouts = std::unordered_map<std::string, AfterglowMaterialLayout>;
 	using MaterialResources = std::unordered_map<std::string, AfterglowMaterialResource>;
+	// <variantName, materialName>
+	using MaterialVariantBases = std::unordered_map<std::string, std::string>;
 	using InFlightDescriptorSets = std::array<AfterglowDescriptorSets::AsElement, cfg::maxFrameInFlight>;
 
 	struct PerObjectSetContext {
 		const ubo::MeshUniform* meshUniform = nullptr;
-		std::array<AfterglowUniformBuffer::AsElement, cfg::maxFrameInFlight> inFlightUniformBuffers;
-		// This set allocate own mesh buffer only
-		InFlightDescriptorSets inFlightSets;
+		// Per object set ref is the shared one, mesh uniform is located by the dynamic offset.
 		std::array<AfterglowDescriptorSetReferences, cfg::maxFrameInFlight> inFlightSetReferences;
 		std::array<bool, cfg::maxFrameInFlight> inFlightMaterialChangedFlags;
 		bool activated = false;
@@ -58,7 +72,12 @@ struct AfterglowMaterialManager::Impl {
 
 	using DatedMaterialLayouts = std::unordered_set<AfterglowMaterialLayout*>;
 	using DatedMaterialResources = std::array<std::unordered_map<AfterglowMaterialResource*, MaterialResourceUpdateFlag>, cfg::maxFrameInFlight>;
-	using DatedPerObjectSetContexts = std::unordered_map<AfterglowMaterialResource*, PerObjectSetContexts*>;
+	// Entries are kept across frames and only the dated flag is reset, so the steady-state frame never touches the allocator.
+	struct DatedPerObjectSetContext {
+		PerObjectSetContexts* contexts = nullptr;
+		bool dated = false;
+	};
+	using DatedPerObjectSetContexts = std::unordered_map<AfterglowMaterialResource*, DatedPerObjectSetContext>;
 
 	// ComputeTask external ssbo context
 	struct ComputeExternalSSBOContext {
@@ -70,10 +89,48 @@ struct AfterglowMaterialManager::Impl {
 	};
 	using ComputeExternalSSBOContexts = std::unordered_map<AfterglowMaterialLayout*, ComputeExternalSSBOContext>;
 
+	// Hot reload
+	enum class ReloadMode {
+		Shaders,	// Shaders and pipelines are built in background, then swapped in.
+		Material	// Shaders are built in background, then the layout is applied as a dated one.
+	};
+
+	struct ReloadJob {
+		ReloadMode mode = ReloadMode::Shaders;
+		std::string name;
+		AfterglowMaterialLayout* target = nullptr;
+		// Source of the staged layout, it is never touched by the reload thread.
+		AfterglowMaterial material;
+		std::unique_ptr<AfterglowMaterialLayout> staged;
+		std::optional<std::string> error;
+	};
+	using ReloadJobs = std::deque<std::unique_ptr<ReloadJob>>;
+
+	// ShaderFile -> Material -> MaterialInstance, files included by shader files are in AfterglowShaderModule::includeGraph().
+	struct DependencyNode {
+		enum class Type : uint32_t {
+			ShaderFile, 
+			Material, 
+			MaterialInstance
+		};
+
+		Type type;
+		std::string name;
+
+		bool operator==(const DependencyNode& other) const = default;
+
+		struct Hash {
+			size_t operator()(const DependencyNode& node) const noexcept {
+				return std::hash<std::string>{}(node.name) ^ util::EnumValue(node.type);
+			}
+		};
+	};
+	using MaterialDependencyGraph = DependencyGraph<DependencyNode, DependencyNode::Hash>;
+
 	Impl(
 		AfterglowMaterialManager& inManager, 
 		AfterglowCommandPool& inCommandPool,
-		AfterglowGraphicsQueue& inGraphicsQueue,
+		AfterglowUploadContext& inUploadContext,
 		AfterglowPassManager& inPassManager,
 		AfterglowAssetMonitor& inAssetMonitor, 
 		AfterglowSynchronizer& inSynchronizer
@@ -92,12 +149,45 @@ struct AfterglowMaterialManager::Impl {
 	inline void initAllPassImageSets(render::PassUnorderedMap<img::ImageReferences>& allPassImages);
 
 	// Call it when that material submit.
-	inline void reloadMaterialResources(AfterglowMaterialLayout& matLayout);
+	inline void reloadMaterialResources(const std::string& name);
+	// @brief: Link shader files of the material, replace old links if the material was modified.
+	inline void linkMaterialShaderFiles(const std::string& name, const AfterglowMaterial& material);
+	// @return: Name of the material layout which compiles this keyword variant of the material.
+	static inline std::string variantName(const std::string& name, shader::KeywordMask keywordMask);
+	/**
+	* @brief: Layout of the keyword variant, it is created on first use and built by the reload thread.
+	* @return: Layout of the material itself if keyword mask is 0, nullptr if the material is not exists.
+	* @note: A new layout is in buildingVariantLayouts until its shaders and pipelines were swapped in.
+	*/
+	inline AfterglowMaterialLayout* acquireVariantLayout(const std::string& name, shader::KeywordMask keywordMask);
+	// @brief: Rebuild variants from the modified material, in reload thread if possible.
+	inline void updateMaterialVariants(const std::string& name);
+	// @brief: Move the material instance to the layout of its selected variant, descriptor sets are recreated.
+	inline void applyMaterialInstanceVariant(const std::string& name);
+	// @brief: Remove variant layouts which are not used by any material instance.
+	inline void collectUnusedVariants();
+
+	// @return: Names of materials use this shader file directly or by includes, in order of name.
+	inline std::vector<std::string> shaderFileDependentMaterials(const std::string& shaderFile);
 
-	inline void applyMaterialLayout(AfterglowMaterialLayout& matLayout);
+	/**
+	* @brief: Apply all dated material layouts in order of material name.
+	*	Shaders of all layouts are compiled on compile workers, then pipelines are created on them as well.
+	*	Failed layouts fall back to error shaders on the calling thread, errors are reported in order of material name.
+	*/
+	inline void applyMaterialLayouts();
+	// @return: False if the pipeline update is delayed by the compute external ssbo context.
+	inline bool applyMaterialLayout(const std::string& name, AfterglowMaterialLayout& matLayout);
 	inline void applyMaterialResource(AfterglowMaterialResource& matResource, MaterialResourceUpdateFlag updateFlag, uint32_t frameIndex);
 	inline void applyPerObjectGlobalSetContext(AfterglowMaterialResource& matResource, PerObjectSetContexts& perObjectSetContexts, uint32_t frameIndex);
 	inline void applyGlobalUniformSet(uint32_t frameIndex);
+	// @brief: Initialize the shared per object set and make sure the mesh uniform ring could hold all objects.
+	inline void reservePerObjectSet(uint32_t frameIndex, uint64_t objectCount);
+	// @return: true if the buffer was (re)created, it should be registered to the per object set again.
+	inline bool reserveMeshUniformRing(uint32_t frameIndex, uint64_t objectCount);
+	inline bool reserveObjectInstanceBuffer(uint32_t frameIndex, uint64_t instanceCount);
+	inline void registerMeshUniformRing(uint32_t frameIndex);
+	inline void registerObjectInstanceBuffer(uint32_t frameIndex);
 
 	inline void applyPassImageSets(AfterglowPassInterface& pass, img::ImageReferences& passImages, uint32_t frameIndex);
 	inline void applySwapchainPassImageSets(render::PassUnorderedMap<img::ImageReferences>& allPassImages, uint32_t frameIndex);
@@ -114,13 +204,44 @@ struct AfterglowMaterialManager::Impl {
 	inline bool submitMaterialInstanceWithoutLock(const std::string& name, MaterialResourceUpdateFlag updateFlag);
 	inline void markAsDated(AfterglowMaterialResource& matResource, MaterialResourceUpdateFlag flag = MaterialResourceUpdateFlag::UniformTexture);
 
+	// @brief: Compile shaders of all stages used by the material of this layout.
+	static inline void compileShaders(
+		AfterglowMaterialLayout& matLayout, 
+		const AfterglowMaterialAsset& matAsset, 
+		util::OptionalRef<AfterglowPassInterface> pass, 
+		util::OptionalRef<AfterglowComputeTask::SSBOInfoRefs> associatedSSBOInfos
+	);
+
+	// @return: False if the layout should be reloaded synchronously (external ssbos, or it is dated already).
+	inline bool reloadable(AfterglowMaterialLayout& matLayout, const AfterglowMaterial& material);
+	/**
+	* @brief: Queue the layout to the reload thread, a newer request replaces the pending one of the same layout.
+	* @warning: Invoke it with the manager mutex locked.
+	*/
+	inline void queueReload(const std::string& name, AfterglowMaterialLayout& matLayout, const AfterglowMaterial& material, ReloadMode mode);
+	inline void reloadLoop(std::stop_token stopToken);
+	// @brief: Build shaders (and pipelines) of the staged layout, runs in the reload thread.
+	static inline void buildReloadJob(ReloadJob& job);
+	// @brief: Swap finished jobs into their layouts, invoke it in render thread at a frame boundary.
+	inline void applyFinishedReloads();
+	/**
+	* @brief: Drop all reload jobs of this layout, and wait if one is building. 
+	* @desc: Staged layouts reference descriptor set layouts of the target, so drop them before the target updates its set layouts.
+	* @return: Dropped jobs.
+	*/
+	inline ReloadJobs discardReloadJobs(AfterglowMaterialLayout& matLayout);
+
 	// Static Pool Size
 	// TODO: add a new pool for dynamic pool size.
 	// Place front to make sure descriptor set destruct later than descriptor sets.
 	AfterglowDescriptorPool::AsElement descriptorPool;
 	AfterglowSharedTexturePool texturePool;
+	// Resident generation of the texture pool which material resources were rebound with.
+	uint64_t residentTextureGeneration = 0;
 	AfterglowPassManager& passManager;
 	AfterglowSynchronizer& synchronizer;
+	// Removed resources, layouts and outgrown buffers, they may be in flight. Destroyed before the descriptor pool and the texture pool.
+	AfterglowDeletionQueue deletionQueue;
 
 	AfterglowMaterialAssetRegistrar assetRegistrar;
 
@@ -138,51 +259,97 @@ struct AfterglowMaterialManager::Impl {
 	AfterglowDescriptorSetLayout::AsElement perObjectDescriptorSetLayout;
 	// Mesh Uniform Resources
 	MaterialPerObjectSetContexts materialPerObjectSetContexts;
+	// One per object set for all objects in a frame, it refers to the ring and the instance buffer of its frame.
+	InFlightDescriptorSets perObjectInFlightSets;
+	// Persistent mapped mesh uniforms of all objects, bound with dynamic offsets.
+	std::array<AfterglowUniformBuffer::AsElement, cfg::maxFrameInFlight> inFlightMeshUniformRings;
+	// Object instances of instancing materials.
+	std::array<AfterglowHostStorageBuffer::AsElement, cfg::maxFrameInFlight> inFlightObjectInstanceBuffers;
+	// Aligned by minUniformBufferOffsetAlignment, initialized with the first ring.
+	uint32_t meshUniformStride = 0;
+	// Write position of current frame ring, reset every frame.
+	uint32_t meshUniformRingOffset = 0;
 
 	AfterglowDescriptorSetWriter descriptorSetWriter;
 
 	DatedMaterialLayouts datedMaterialLayouts;
 	DatedMaterialResources datedMaterialResources;
 	DatedPerObjectSetContexts datedPerObjectSetContexts;
-	std::vector<PerObjectSetContexts*> perObjectSetContextRemovingCache;
+	// Transient per frame containers, reset in updateResources().
+	LinearAllocator frameAllocator{ 4 * 1024 };
+	std::pmr::vector<PerObjectSetContexts*> perObjectSetContextRemovingCache{ &frameAllocator };
 	std::vector<std::string> materialRemovingCache;
 	std::vector<std::string> materialInstanceRemovingCache;
+	// Material instances selected another variant, they are moved at the frame boundary.
+	std::vector<std::string> materialInstanceVariantCache;
+
+	// Keyword variants used by material instances, each one is a material layout named by variantName().
+	MaterialVariantBases materialVariantBases;
+	// New variant layouts which are built by the reload thread, nothing in flight uses them yet.
+	DatedMaterialLayouts buildingVariantLayouts;
+	// Material instances keep their current layouts until the selected variant was built.
+	std::unordered_set<std::string> variantWaitingInstances;
 
 	ComputeExternalSSBOContexts computeExternalSSBOContexts;
 	DatedMaterialLayouts datedComputeExternalSSBOContextKeys;
 
+	MaterialDependencyGraph dependencyGraph;
+
+	// Each worker compiles with its own AfterglowDxcInstances, included files are shared by the mutex protected AfterglowShaderIncludeCache,
+	// and VkPipelineCache is internally synchronized, so layouts are built in parallel.
+	WorkerPool compileWorkers;
+
 	AfterglowMaterialManager& manager;
+
+	std::mutex reloadMutex;
+	std::condition_variable_any reloadCondition;
+	ReloadJobs pendingReloadJobs;
+	ReloadJob* buildingReloadJob = nullptr;
+	ReloadJobs finishedReloadJobs;
+	// Place back to make sure the reload thread joined before other resources released.
+	std::unique_ptr<std::jthread> reloadThread;
 };
 
 AfterglowMaterialManager::Impl::Impl(
 	AfterglowMaterialManager& inManager,
 	AfterglowCommandPool& inCommandPool, 
-	AfterglowGraphicsQueue& inGraphicsQueue, 
+	AfterglowUploadContext& inUploadContext, 
 	AfterglowPassManager& inPassManager, 
 	AfterglowAssetMonitor& inAssetMonitor, 
 	AfterglowSynchronizer& inSynchronizer) :
-	texturePool(inCommandPool, inGraphicsQueue, inSynchronizer),
+	texturePool(inCommandPool, inUploadContext, inSynchronizer),
 	passManager(inPassManager),
 	assetRegistrar(inManager, inAssetMonitor),
 	synchronizer(inSynchronizer), 
+	deletionQueue(inSynchronizer), 
 	perObjectDescriptorSetLayout(AfterglowDescriptorSetLayout::makeElement(inCommandPool.device())),
 	descriptorPool(AfterglowDescriptorPool::makeElement(inCommandPool.device())),
+	compileWorkers(cfg::shaderCompileWorkerCount),
 	descriptorSetWriter(inCommandPool.device()), 
-	manager(inManager) {
+	manager(inManager), 
+	reloadThread(std::make_unique<std::jthread>([this](std::stop_token stopToken) { reloadLoop(stopToken); })) {
 	// TODO: Check remaining set size every update, if have not enough size, reset pool and dated all material resources(remember reload layout ).
 	(*descriptorPool).extendUniformPoolSize(cfg::uniformDescriptorSize);
 	(*descriptorPool).extendImageSamplerPoolSize(cfg::samplerDescriptorSize);
+	(*descriptorPool).extendStorageBufferPoolSize(cfg::storageBufferDescriptorSize);
+	// Mesh uniform ring of the shared per object sets.
+	(*descriptorPool).extendUniformDynamicPoolSize(cfg::maxFrameInFlight);
 	(*descriptorPool).setMaxDescritporSets(cfg::descriptorSetSize);
 
 	// @note: Apply manually due to late initialize issue.
 	//initGlobalDescriptorSets();
 
-	// Initialize PerOjbect set binding[0] : mesh uniform
+	// Initialize PerOjbect set binding[0] : mesh uniform, offset of each object is dynamic.
 	// All stages are supported, hardcoded yet.
 	(*perObjectDescriptorSetLayout).appendBinding(
-		VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+		VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
 		VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT
 	);
+	// PerObject set binding[1] : object instances, read by vertex shader only.
+	(*perObjectDescriptorSetLayout).appendBinding(
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		VK_SHADER_STAGE_VERTEX_BIT
+	);
 }
 
 inline AfterglowMaterialInstance& AfterglowMaterialManager::Impl::createMaterialInstanceWithoutLock(const std::string& name, const std::string& parentMaterialName) {
@@ -203,6 +370,10 @@ inline AfterglowMaterialInstance& AfterglowMaterialManager::Impl::createMaterial
 			name,
 			AfterglowMaterialResource{ *matLayout, descriptorSetWriter, descriptorPool, texturePool }
  		).first->second;
+		dependencyGraph.setDependencies(
+			{ DependencyNode::Type::MaterialInstance, name }, 
+			{ { DependencyNode::Type::Material, parentMaterialName } }
+		);
 	}
 	else {
 		matResource = &materialResources.at(name);
@@ -221,7 +392,11 @@ inline bool AfterglowMaterialManager::Impl::removeMaterialInstanceWithoutLock(co
 		}
 		datedPerObjectSetContexts.erase(&matResource);
 		materialPerObjectSetContexts.erase(&matResource);
+		// Descriptor sets and buffers may be in flight.
+		deletionQueue.release(std::move(matResource));
 		materialResources.erase(matResourceIterator);
+		dependencyGraph.remove({ DependencyNode::Type::MaterialInstance, name });
+		variantWaitingInstances.erase(name);
 		return true;
 	}
 	return false;
@@ -327,40 +502,259 @@ inline void AfterglowMaterialManager::Impl::initAllPassImageSets(render::PassUno
 	}
 }
 
-inline void AfterglowMaterialManager::Impl::reloadMaterialResources(AfterglowMaterialLayout& matLayout) {
+inline void AfterglowMaterialManager::Impl::reloadMaterialResources(const std::string& name) {
 	// Submit all matterial instances of this material.
-	// TODO: optimize here by a graph: matLayout->{resources}
-	for (auto& [matResourceName, matResource] : materialResources) {
-		auto* a = &matResource.materialLayout();
-		if (&matResource.materialLayout() == &matLayout) {
-			matResource.reloadMaterialLayout();
-			markAsDated(matResource);
+	for (const auto& node : dependencyGraph.dependents({ DependencyNode::Type::Material, name })) {
+		if (node.type != DependencyNode::Type::MaterialInstance) {
+			continue;
+		}
+		auto iterator = materialResources.find(node.name);
+		if (iterator != materialResources.end()) {
+			iterator->second.reloadMaterialLayout();
+			markAsDated(iterator->second);
 		}
 	}
 }
 
-inline void AfterglowMaterialManager::Impl::applyMaterialLayout(AfterglowMaterialLayout& matLayout) {
-	matLayout.updateDescriptorSetLayouts(
+inline void AfterglowMaterialManager::Impl::linkMaterialShaderFiles(const std::string& name, const AfterglowMaterial& material) {
+	MaterialDependencyGraph::Nodes shaderFiles;
+	auto appendShaderFile = [&shaderFiles](const std::string& path) {
+		if (!path.empty()) {
+			shaderFiles.push_back({ DependencyNode::Type::ShaderFile, util::NormalizePath(path) });
+		}
+	};
+	appendShaderFile(material.vertexShaderPath());
+	appendShaderFile(material.fragmentShaderPath());
+	if (material.hasComputeTask()) {
+		appendShaderFile(material.computeTask().computeShaderPath());
+		for (const auto& ssboInfo : material.computeTask().ssboInfos()) {
+			if (ssboInfo.initMode() == compute::SSBOInitMode::ComputeShader) {
+				appendShaderFile(ssboInfo.initResource());
+			}
+		}
+	}
+	dependencyGraph.setDependencies({ DependencyNode::Type::Material, name }, shaderFiles);
+}
+
+inline std::string AfterglowMaterialManager::Impl::variantName(const std::string& name, shader::KeywordMask keywordMask) {
+	return std::format("{}#{:x}", name, keywordMask);
+}
+
+inline AfterglowMaterialLayout* AfterglowMaterialManager::Impl::acquireVariantLayout(const std::string& name, shader::KeywordMask keywordMask) {
+	auto layoutIterator = materialLayouts.find(name);
+	if (layoutIterator == materialLayouts.end()) {
+		DEBUG_CLASS_ERROR(std::format("Failed to acquire variant due to material is not exist: {}", name));
+		return nullptr;
+	}
+	if (keywordMask == 0) {
+		return &layoutIterator->second;
+	}
+	// Variant layouts never own compute tasks, or the task would be dispatched by the variant in addition to the base layout.
+	if (std::as_const(layoutIterator->second).material().hasComputeTask()) {
+		DEBUG_CLASS_WARNING(std::format("Keyword variants of compute task materials are not supported, the material is used: {}", name));
+		return nullptr;
+	}
+	auto layoutName = variantName(name, keywordMask);
+	if (auto variantIterator = materialLayouts.find(layoutName); variantIterator != materialLayouts.end()) {
+		return &variantIterator->second;
+	}
+
+	AfterglowMaterial variantMaterial = layoutIterator->second.material();
+	variantMaterial.setKeywordMask(keywordMask);
+	auto* matLayout = &materialLayouts.emplace(layoutName, AfterglowMaterialLayout{ variantMaterial }).first->second;
+	materialVariantBases.emplace(layoutName, name);
+	linkMaterialShaderFiles(layoutName, variantMaterial);
+	// No command buffer references a new layout, so its set layouts are created without waiting for the GPU,
+	// and shaders are compiled out of the render thread.
+	matLayout->updateDescriptorSetLayouts(
 		passManager, 
 		allPassDescriptorSetLayouts, 
 		globalDescriptorSetLayout, 
 		perObjectDescriptorSetLayout
 	);
-	// Reload all derived material instances. 
-	reloadMaterialResources(matLayout);
-	// Delay the shader update if any external ssbo exists.
-	if (datedComputeExternalSSBOContextKeys.contains(&matLayout)) {
+	queueReload(layoutName, *matLayout, variantMaterial, ReloadMode::Shaders);
+	buildingVariantLayouts.insert(matLayout);
+	DEBUG_CLASS_INFO(std::format("Material variant is created: {}", layoutName));
+	return matLayout;
+}
+
+inline void AfterglowMaterialManager::Impl::updateMaterialVariants(const std::string& name) {
+	auto layoutIterator = materialLayouts.find(name);
+	if (layoutIterator == materialLayouts.end()) {
 		return;
 	}
-	try {
-		matLayout.updatePipelines();
+	for (const auto& [layoutName, materialName] : materialVariantBases) {
+		if (materialName != name) {
+			continue;
+		}
+		auto& variantLayout = materialLayouts.at(layoutName);
+		AfterglowMaterial variantMaterial = layoutIterator->second.material();
+		variantMaterial.setKeywordMask(std::as_const(variantLayout).material().keywordMask());
+		if (reloadable(variantLayout, variantMaterial)) {
+			queueReload(layoutName, variantLayout, variantMaterial, ReloadMode::Material);
+			continue;
+		}
+		variantLayout.setMaterial(variantMaterial);
+		manager.safeApplyShaders(variantLayout, AfterglowMaterialAsset(variantMaterial));
+		linkMaterialShaderFiles(layoutName, variantMaterial);
+		datedMaterialLayouts.insert(&variantLayout);
+	}
+}
+
+inline void AfterglowMaterialManager::Impl::applyMaterialInstanceVariant(const std::string& name) {
+	auto resourceIterator = materialResources.find(name);
+	if (resourceIterator == materialResources.end()) {
+		return;
+	}
+	variantWaitingInstances.erase(name);
+	auto keywordMask = resourceIterator->second.materialInstance().keywordMask();
+	if (keywordMask == std::as_const(resourceIterator->second).materialLayout().material().keywordMask()) {
+		return;
+	}
+	// Instance depends on the layout it uses, which is the material itself or one of its variants.
+	std::string materialName;
+	for (const auto& node : dependencyGraph.dependencies({ DependencyNode::Type::MaterialInstance, name })) {
+		if (node.type == DependencyNode::Type::Material) {
+			auto baseIterator = materialVariantBases.find(node.name);
+			materialName = baseIterator != materialVariantBases.end() ? baseIterator->second : node.name;
+			break;
+		}
+	}
+	auto* matLayout = acquireVariantLayout(materialName, keywordMask);
+	if (!matLayout) {
+		return;
+	}
+	if (buildingVariantLayouts.contains(matLayout)) {
+		variantWaitingInstances.insert(name);
+		return;
+	}
+
+	// Descriptor sets are allocated with set layouts of the material layout, so the resource is recreated.
+	auto materialInstance = resourceIterator->second.materialInstance();
+	removeMaterialInstanceWithoutLock(name);
+	auto& matResource = materialResources.emplace(
+		name, 
+		AfterglowMaterialResource{ *matLayout, descriptorSetWriter, descriptorPool, texturePool }
+	).first->second;
+	matResource.setMateiralInstance(materialInstance.makeRedirectedInstance(matLayout->material()));
+	dependencyGraph.setDependencies(
+		{ DependencyNode::Type::MaterialInstance, name }, 
+		{ { DependencyNode::Type::Material, keywordMask == 0 ? materialName : variantName(materialName, keywordMask) } }
+	);
+	markAsDated(matResource);
+}
+
+inline void AfterglowMaterialManager::Impl::collectUnusedVariants() {
+	std::vector<std::string> unusedVariantNames;
+	for (const auto& [layoutName, materialName] : materialVariantBases) {
+		// Instances wait for building variants without depending on them.
+		if (buildingVariantLayouts.contains(&materialLayouts.at(layoutName))) {
+			continue;
+		}
+		if (dependencyGraph.dependents({ DependencyNode::Type::Material, layoutName }).empty()) {
+			unusedVariantNames.push_back(layoutName);
+		}
+	}
+	for (const auto& layoutName : unusedVariantNames) {
+		DEBUG_CLASS_INFO(std::format("Unused material variant is removed: {}", layoutName));
+		removeMaterialWithoutLock(layoutName);
+	}
+}
+
+inline std::vector<std::string> AfterglowMaterialManager::Impl::shaderFileDependentMaterials(const std::string& shaderFile) {
+	auto shaderFiles = AfterglowShaderModule::includeGraph().dependents(shaderFile);
+	shaderFiles.push_back(shaderFile);
+
+	std::vector<std::string> materialNames;
+	for (const auto& file : shaderFiles) {
+		for (const auto& node : dependencyGraph.dependents({ DependencyNode::Type::ShaderFile, file })) {
+			if (node.type == DependencyNode::Type::Material) {
+				materialNames.push_back(node.name);
+			}
+		}
+	}
+	std::sort(materialNames.begin(), materialNames.end());
+	materialNames.erase(std::unique(materialNames.begin(), materialNames.end()), materialNames.end());
+	return materialNames;
+}
+
+inline void AfterglowMaterialManager::Impl::applyMaterialLayouts() {
+	using NamedLayout = std::pair<const std::string*, AfterglowMaterialLayout*>;
+	std::vector<NamedLayout> namedLayouts;
+	namedLayouts.reserve(datedMaterialLayouts.size());
+	for (auto& [name, matLayout] : materialLayouts) {
+		if (datedMaterialLayouts.contains(&matLayout)) {
+			namedLayouts.emplace_back(&name, &matLayout);
+		}
 	}
-	catch (const std::runtime_error& error) {
-		manager.applyErrorShaders(matLayout);
-		DEBUG_CLASS_ERROR(std::format("Failed to apply material, probably some problems occur in shaders: {}", error.what()));
+	std::sort(namedLayouts.begin(), namedLayouts.end(), [](const auto& lhs, const auto& rhs) { return *lhs.first < *rhs.first; });
+
+	// Descriptor set layouts and material resources are shared, apply them on this thread.
+	std::vector<NamedLayout> pipelineLayouts;
+	for (auto& [name, matLayout] : namedLayouts) {
+		// Set layouts of the target will be recreated, build reloading jobs again from them.
+		auto discardedJobs = discardReloadJobs(*matLayout);
+		appendDatedComputeExternalSSBOContext(*matLayout);
+		if (applyMaterialLayout(*name, *matLayout)) {
+			pipelineLayouts.emplace_back(name, matLayout);
+		}
+		for (auto& job : discardedJobs) {
+			queueReload(*name, *matLayout, job->mode == ReloadMode::Material ? job->material : matLayout->material(), job->mode);
+		}
+	}
+
+	// Each task touches its own layout only, errors are kept by task index for deterministic reporting.
+	std::vector<std::optional<std::string>> errors(pipelineLayouts.size());
+	compileWorkers.parallelFor(static_cast<uint32_t>(pipelineLayouts.size()), [&](uint32_t index, uint32_t workerIndex) {
+		try {
+			pipelineLayouts[index].second->updatePipelines();
+		}
+		catch (const std::exception& error) {
+			errors[index] = error.what();
+		}
+	});
+	compileWorkers.parallelFor(static_cast<uint32_t>(pipelineLayouts.size()), [&](uint32_t index, uint32_t workerIndex) {
+		if (errors[index]) {
+			return;
+		}
+		try {
+			pipelineLayouts[index].second->createPipelines();
+		}
+		catch (const std::exception& error) {
+			errors[index] = error.what();
+		}
+	});
+
+	for (uint32_t index = 0; index < pipelineLayouts.size(); ++index) {
+		if (!errors[index]) {
+			continue;
+		}
+		auto& [name, matLayout] = pipelineLayouts[index];
+		DEBUG_CLASS_ERROR(std::format(
+			"Failed to apply material \"{}\", probably some problems occur in shaders: {}", *name, *errors[index]
+		));
+		manager.applyErrorShaders(*matLayout);
 		// After error shader compilation, Retry to update material layout.
-		matLayout.updatePipelines();
+		matLayout->updatePipelines();
 	}
+
+	// Included files are known after compilation, failed ones as well.
+	for (auto& [name, matLayout] : namedLayouts) {
+		assetRegistrar.watchIncludedFiles(*name, matLayout->material());
+	}
+}
+
+inline bool AfterglowMaterialManager::Impl::applyMaterialLayout(const std::string& name, AfterglowMaterialLayout& matLayout) {
+	matLayout.updateDescriptorSetLayouts(
+		passManager, 
+		allPassDescriptorSetLayouts, 
+		globalDescriptorSetLayout, 
+		perObjectDescriptorSetLayout
+	);
+	// Reload all derived material instances. 
+	reloadMaterialResources(name);
+	// Delay the shader update if any external ssbo exists.
+	return !datedComputeExternalSSBOContextKeys.contains(&matLayout);
 }
 
 inline void AfterglowMaterialManager::Impl::applyMaterialResource(AfterglowMaterialResource& matResource, MaterialResourceUpdateFlag updateFlag, uint32_t frameIndex) {
@@ -391,27 +785,15 @@ inline void AfterglowMaterialManager::Impl::applyPerObjectGlobalSetContext(After
 	auto& matResourceSets = matResource.inFlightDescriptorSets()[frameIndex];
 	auto& matLayout = matResource.materialLayout();
 
+	auto& perObjectSet = perObjectInFlightSets[frameIndex][0];
+	auto& meshUniformRing = *inFlightMeshUniformRings[frameIndex];
+
 	bool inactivatedExists = false;
 	// Many objects using same material instance.
 	for (auto& [id, perObjectSetContext] : perObjectSetContexts) {
-		// Initialize set.
-		auto& sets = perObjectSetContext.inFlightSets[frameIndex];
-		auto& buffer = perObjectSetContext.inFlightUniformBuffers[frameIndex];
 		auto& setReferences = perObjectSetContext.inFlightSetReferences[frameIndex];
 		bool& materialChanged = perObjectSetContext.inFlightMaterialChangedFlags[frameIndex];
 
-		if (!sets) {
-			sets.recreate(descriptorPool, perObjectDescriptorSetLayout, 1);
-		}
-
-		// Initialize / update buffer memory.
-		if (!buffer || (*buffer).sourceData() != perObjectSetContext.meshUniform) {
-			buffer.recreate(manager.device(), perObjectSetContext.meshUniform, sizeof(ubo::MeshUniform));
-		}
-		else {
-			(*buffer).updateMemory();
-		}
-
 		// Update set references
 		if (!setReferences.source() || materialChanged) {
 			setReferences.reset(matResourceSets);
@@ -423,18 +805,15 @@ inline void AfterglowMaterialManager::Impl::applyPerObjectGlobalSetContext(After
 			// Pass set ref
 			setReferences[util::EnumValue(shader::SetIndex::Pass)] = globalSetContext.allPassInFlightSets[&matLayout.pass()][frameIndex][0];
 			// Per object set ref
-			setReferences[util::EnumValue(shader::SetIndex::PerObject)] = sets[0];
+			setReferences[util::EnumValue(shader::SetIndex::PerObject)] = perObjectSet;
 
 			materialChanged = false;
 		}
 
-		// Register mesh uniform buffer.
-		descriptorSetWriter.registerBuffer(
-			*buffer,
-			perObjectDescriptorSetLayout,
-			sets[0],
-			util::EnumValue(shader::PerObjectSetBindingIndex::MeshUniform)
-		);
+		// Write mesh uniform into the ring, it's valid for the objects which submitted in this frame.
+		meshUniformRing.writeMemory(perObjectSetContext.meshUniform, sizeof(ubo::MeshUniform), meshUniformRingOffset);
+		setReferences.setDynamicOffset(util::EnumValue(shader::SetIndex::PerObject), meshUniformRingOffset);
+		meshUniformRingOffset += meshUniformStride;
 
 		inactivatedExists |= !perObjectSetContext.activated;
 		perObjectSetContext.activated = false;
@@ -467,6 +846,83 @@ inline void AfterglowMaterialManager::Impl::applyGlobalUniformSet(uint32_t frame
 	);
 }
 
+inline void AfterglowMaterialManager::Impl::reservePerObjectSet(uint32_t frameIndex, uint64_t objectCount) {
+	auto& sets = perObjectInFlightSets[frameIndex];
+	bool setCreated = false;
+	if (!sets) {
+		sets.recreate(descriptorPool, perObjectDescriptorSetLayout, 1);
+		setCreated = true;
+	}
+	if (reserveMeshUniformRing(frameIndex, objectCount) || setCreated) {
+		registerMeshUniformRing(frameIndex);
+	}
+	if (reserveObjectInstanceBuffer(frameIndex, 0) || setCreated) {
+		registerObjectInstanceBuffer(frameIndex);
+	}
+}
+
+inline bool AfterglowMaterialManager::Impl::reserveMeshUniformRing(uint32_t frameIndex, uint64_t objectCount) {
+	if (meshUniformStride == 0) {
+		auto alignment = manager.device().physicalDevice().properties().limits.minUniformBufferOffsetAlignment;
+		meshUniformStride = static_cast<uint32_t>(util::Align(sizeof(ubo::MeshUniform), alignment));
+	}
+	auto& ring = inFlightMeshUniformRings[frameIndex];
+	uint64_t capacity = 0;
+	if (ring) {
+		capacity = (*ring).byteSize() / meshUniformStride;
+		if (objectCount <= capacity) {
+			return false;
+		}
+		// Old ring could be in flight.
+		deletionQueue.release(std::move(ring));
+	}
+	capacity = std::max<uint64_t>(capacity, cfg::meshUniformCapacity);
+	while (capacity < objectCount) {
+		capacity *= 2;
+	}
+	ring.recreate(manager.device(), nullptr, capacity * meshUniformStride);
+	return true;
+}
+
+inline bool AfterglowMaterialManager::Impl::reserveObjectInstanceBuffer(uint32_t frameIndex, uint64_t instanceCount) {
+	auto& buffer = inFlightObjectInstanceBuffers[frameIndex];
+	uint64_t capacity = 0;
+	if (buffer) {
+		capacity = (*buffer).byteSize() / sizeof(ubo::ObjectInstance);
+		if (instanceCount <= capacity) {
+			return false;
+		}
+		// Old buffer could be in flight.
+		deletionQueue.release(std::move(buffer));
+	}
+	capacity = std::max<uint64_t>(capacity, cfg::objectInstanceCapacity);
+	while (capacity < instanceCount) {
+		capacity *= 2;
+	}
+	buffer.recreate(manager.device(), capacity * sizeof(ubo::ObjectInstance));
+	return true;
+}
+
+inline void AfterglowMaterialManager::Impl::registerMeshUniformRing(uint32_t frameIndex) {
+	// Dynamic descriptor views one mesh uniform, dynamic offset selects the object.
+	descriptorSetWriter.registerBuffer(
+		*inFlightMeshUniformRings[frameIndex],
+		perObjectDescriptorSetLayout,
+		perObjectInFlightSets[frameIndex][0],
+		util::EnumValue(shader::PerObjectSetBindingIndex::MeshUniform), 
+		sizeof(ubo::MeshUniform)
+	);
+}
+
+inline void AfterglowMaterialManager::Impl::registerObjectInstanceBuffer(uint32_t frameIndex) {
+	descriptorSetWriter.registerBuffer(
+		*inFlightObjectInstanceBuffers[frameIndex],
+		perObjectDescriptorSetLayout,
+		perObjectInFlightSets[frameIndex][0],
+		util::EnumValue(shader::PerObjectSetBindingIndex::ObjectInstances)
+	);
+}
+
 inline void AfterglowMaterialManager::Impl::applyPassImageSets(
 	AfterglowPassInterface& pass, 
 	img::ImageReferences& passImages, 
@@ -552,6 +1008,10 @@ AfterglowSharedTexturePool& AfterglowMaterialManager::texturePool() noexcept {
 void AfterglowMaterialManager::waitGPU() const {
 	_impl->synchronizer.wait(AfterglowSynchronizer::FenceFlag::ComputeInFlight);
 	_impl->synchronizer.wait(AfterglowSynchronizer::FenceFlag::RenderInFlight);
+	_impl->synchronizer.wait(
+		AfterglowSynchronizer::TimelineFlag::AsyncCompute, 
+		_impl->synchronizer.submittedValue(AfterglowSynchronizer::TimelineFlag::AsyncCompute)
+	);
 }
 
 inline void AfterglowMaterialManager::Impl::appendGlobalSetTextureResource(shader::GlobalSetBindingIndex textureBindingIndex) {
@@ -561,7 +1021,8 @@ inline void AfterglowMaterialManager::Impl::appendGlobalSetTextureResource(shade
 	auto& resource = globalSetContext.globalTextureResources.emplace_back(
 		// std::string(Inreflect<shader::GlobalSetBindingIndex>::enumName(textureBindingIndex)),
 		util::EnumValue(textureBindingIndex),
-		std::make_unique<AfterglowTextureReference>(texturePool.texture({ assetInfo }))
+		// Global descriptor sets are written once, so the texture is not streamed.
+		std::make_unique<AfterglowTextureReference>(texturePool.texture({ assetInfo }, false))
 	);
 
 	// Write descriptor set
@@ -703,6 +1164,11 @@ inline bool AfterglowMaterialManager::Impl::submitMaterialInstanceWithoutLock(co
 		return false;
 	}
 	markAsDated(iterator->second, updateFlag);
+	// Old descriptor sets may be in flight, so the variant is switched at the frame boundary.
+	auto& matResource = iterator->second;
+	if (matResource.materialInstance().keywordMask() != std::as_const(matResource).materialLayout().material().keywordMask()) {
+		materialInstanceVariantCache.push_back(name);
+	}
 	return true;
 }
 
@@ -719,6 +1185,198 @@ inline void AfterglowMaterialManager::Impl::markAsDated(AfterglowMaterialResourc
 	}
 }
 
+inline void AfterglowMaterialManager::Impl::compileShaders(
+	AfterglowMaterialLayout& matLayout,
+	const AfterglowMaterialAsset& matAsset,
+	util::OptionalRef<AfterglowPassInterface> pass,
+	util::OptionalRef<AfterglowComputeTask::SSBOInfoRefs> associatedSSBOInfos) {
+	auto& material = matLayout.material();
+	if (!material.hasComputeTask() || !material.computeTask().isComputeOnly()) {
+		matLayout.compileVertexShader(matAsset.generateShaderCode(
+			shader::Stage::Vertex, pass, associatedSSBOInfos
+		));
+		matLayout.compileFragmentShader(matAsset.generateShaderCode(
+			shader::Stage::Fragment, pass, associatedSSBOInfos
+		));
+	}
+
+	if (material.hasComputeTask()) {
+		matLayout.compileComputeShader(matAsset.generateShaderCode(
+			shader::Stage::Compute, pass, associatedSSBOInfos
+		));
+		// No require to apply compute shader initializer, them will generated in updateComputePipeline automatically.
+		// @see: AfterglowMaterialLayout::updateComputePipeline
+	}
+}
+
+inline bool AfterglowMaterialManager::Impl::reloadable(AfterglowMaterialLayout& matLayout, const AfterglowMaterial& material) {
+	// External ssbo contexts are maintained in render thread only.
+	for (const auto* each : { &material, &std::as_const(matLayout).material() }) {
+		if (each->hasComputeTask() && !each->computeTask().externalSSBOs().empty()) {
+			return false;
+		}
+	}
+	// Set layouts of a dated layout will be recreated soon.
+	return !datedMaterialLayouts.contains(&matLayout);
+}
+
+inline void AfterglowMaterialManager::Impl::queueReload(const std::string& name, AfterglowMaterialLayout& matLayout, const AfterglowMaterial& material, ReloadMode mode) {
+	auto isTarget = [&matLayout](const auto& job) { return job->target == &matLayout; };
+
+	std::lock_guard lock{ reloadMutex };
+	// Find the latest job of this layout, pending one is newer than the building one, and then finished ones.
+	const ReloadJob* latestJob = nullptr;
+	auto pendingIterator = std::find_if(pendingReloadJobs.begin(), pendingReloadJobs.end(), isTarget);
+	if (pendingIterator != pendingReloadJobs.end()) {
+		latestJob = pendingIterator->get();
+	}
+	else if (buildingReloadJob && isTarget(buildingReloadJob)) {
+		latestJob = buildingReloadJob;
+	}
+	else if (auto finishedIterator = std::find_if(finishedReloadJobs.rbegin(), finishedReloadJobs.rend(), isTarget); 
+		finishedIterator != finishedReloadJobs.rend()) {
+		latestJob = finishedIterator->get();
+	}
+
+	auto job = std::make_unique<ReloadJob>();
+	job->name = name;
+	job->target = &matLayout;
+	// Material modification is not applied yet, so shaders should be built from the modified one.
+	if (mode == ReloadMode::Shaders && latestJob && latestJob->mode == ReloadMode::Material) {
+		job->mode = ReloadMode::Material;
+		job->material = latestJob->material;
+	}
+	else {
+		job->mode = mode;
+		job->material = material;
+	}
+	job->staged = std::make_unique<AfterglowMaterialLayout>(job->material);
+	job->staged->stageFrom(matLayout);
+	if (job->mode == ReloadMode::Material) {
+		// Custom pass could be changed by the modified material.
+		job->staged->updatePass(passManager);
+	}
+
+	if (pendingIterator != pendingReloadJobs.end()) {
+		*pendingIterator = std::move(job);
+	}
+	else {
+		pendingReloadJobs.push_back(std::move(job));
+	}
+	reloadCondition.notify_all();
+}
+
+inline void AfterglowMaterialManager::Impl::reloadLoop(std::stop_token stopToken) {
+	std::unique_lock lock{ reloadMutex };
+	while (reloadCondition.wait(lock, stopToken, [this]() { return !pendingReloadJobs.empty(); })) {
+		auto job = std::move(pendingReloadJobs.front());
+		pendingReloadJobs.pop_front();
+		buildingReloadJob = job.get();
+
+		lock.unlock();
+		buildReloadJob(*job);
+		lock.lock();
+
+		buildingReloadJob = nullptr;
+		finishedReloadJobs.push_back(std::move(job));
+		// Wake up the render thread if it is waiting for this job.
+		reloadCondition.notify_all();
+	}
+}
+
+inline void AfterglowMaterialManager::Impl::buildReloadJob(ReloadJob& job) {
+	try {
+		auto& staged = *job.staged;
+		AfterglowMaterialAsset matAsset(staged.material());
+		// Reloadable materials have no external ssbo, same as the target's.
+		AfterglowComputeTask::SSBOInfoRefs associatedSSBOInfos;
+		compileShaders(staged, matAsset, staged.pass(), associatedSSBOInfos);
+		// Pipelines of a modified material depend on its new set layouts, they are created in the dated flow.
+		if (job.mode == ReloadMode::Shaders) {
+			staged.updatePipelines();
+			staged.createPipelines();
+		}
+	}
+	catch (const std::exception& error) {
+		job.error = error.what();
+	}
+}
+
+inline void AfterglowMaterialManager::Impl::applyFinishedReloads() {
+	ReloadJobs finishedJobs;
+	{
+		std::lock_guard lock{ reloadMutex };
+		finishedJobs.swap(finishedReloadJobs);
+	}
+	if (finishedJobs.empty()) {
+		return;
+	}
+
+	LockGuard lockGuard{ manager._mutex };
+	bool variantsBuilt = false;
+	for (auto& job : finishedJobs) {
+		if (buildingVariantLayouts.erase(job->target)) {
+			variantsBuilt = true;
+			// New variant has no old shaders, use the error shaders instead.
+			if (job->error) {
+				DEBUG_CLASS_ERROR(std::format(
+					"Failed to build material variant \"{}\", probably some problems occur in shaders: {}", job->name, *job->error
+				));
+				manager.applyErrorShaders(*job->target);
+				job->target->updatePipelines();
+				continue;
+			}
+		}
+		if (job->error) {
+			DEBUG_CLASS_ERROR(std::format(
+				"Failed to reload material \"{}\", old shaders are kept: {}", job->name, *job->error
+			));
+			continue;
+		}
+		if (job->mode == ReloadMode::Shaders) {
+			job->target->swapPipelines(*job->staged);
+			// Old pipelines may be in flight, they are released with the staged layout.
+			deletionQueue.release(std::move(job->staged));
+			assetRegistrar.watchIncludedFiles(job->name, job->target->material());
+		}
+		else {
+			job->target->setMaterial(job->material);
+			job->target->swapShaders(*job->staged);
+			linkMaterialShaderFiles(job->name, job->material);
+			datedMaterialLayouts.insert(job->target);
+			updateMaterialVariants(job->name);
+		}
+	}
+
+	if (!variantsBuilt) {
+		return;
+	}
+	// Move waiting instances to their built variants, variants which were deselected meanwhile are collected.
+	std::vector<std::string> waitingInstanceNames{ variantWaitingInstances.begin(), variantWaitingInstances.end() };
+	for (const auto& name : waitingInstanceNames) {
+		applyMaterialInstanceVariant(name);
+	}
+	collectUnusedVariants();
+}
+
+inline AfterglowMaterialManager::Impl::ReloadJobs AfterglowMaterialManager::Impl::discardReloadJobs(AfterglowMaterialLayout& matLayout) {
+	ReloadJobs discardedJobs;
+	auto isTarget = [&matLayout](const auto& job) { return job->target == &matLayout; };
+
+	std::unique_lock lock{ reloadMutex };
+	reloadCondition.wait(lock, [this, &isTarget]() { return !buildingReloadJob || !isTarget(buildingReloadJob); });
+	// Finished jobs are older than pending ones.
+	for (auto* jobs : { &finishedReloadJobs, &pendingReloadJobs }) {
+		for (auto& job : *jobs) {
+			if (isTarget(job)) {
+				discardedJobs.push_back(std::move(job));
+			}
+		}
+		std::erase_if(*jobs, [](const auto& job) { return !job; });
+	}
+	return discardedJobs;
+}
+
 inline bool AfterglowMaterialManager::Impl::removeMaterialWithoutLock(const std::string& name) {
 	auto& matResources = materialResources;
 	auto layoutIterator = materialLayouts.find(name);
@@ -728,6 +1386,18 @@ inline bool AfterglowMaterialManager::Impl::removeMaterialWithoutLock(const std:
 	}
 	auto& matLayout = layoutIterator->second;
 
+	// Variants are removed with their material.
+	std::vector<std::string> variantNames;
+	for (const auto& [layoutName, materialName] : materialVariantBases) {
+		if (materialName == name) {
+			variantNames.push_back(layoutName);
+		}
+	}
+	for (const auto& layoutName : variantNames) {
+		removeMaterialWithoutLock(layoutName);
+	}
+	materialVariantBases.erase(name);
+
 	// Handling material layouts with is ssbo associated with this.
 	for (auto& [otherMatLayout, externalSSBOContext] : computeExternalSSBOContexts) {
 		for (auto* associatedMaterialResource : externalSSBOContext.associatedMaterialResources) {
@@ -752,20 +1422,30 @@ inline bool AfterglowMaterialManager::Impl::removeMaterialWithoutLock(const std:
 	}
 
 	// Remove material layout
+	discardReloadJobs(matLayout);
+	dependencyGraph.remove({ DependencyNode::Type::Material, name });
 	datedMaterialLayouts.erase(&matLayout);
-	materialLayouts.erase(layoutIterator);
 	// Remove compute external ssbo contexts.
 	datedComputeExternalSSBOContextKeys.erase(&matLayout);
-	computeExternalSSBOContexts.erase(&matLayout);
+	auto externalSSBOContextIterator = computeExternalSSBOContexts.find(&matLayout);
+	if (externalSSBOContextIterator != computeExternalSSBOContexts.end()) {
+		deletionQueue.release(std::move(externalSSBOContextIterator->second));
+		computeExternalSSBOContexts.erase(externalSSBOContextIterator);
+	}
+	buildingVariantLayouts.erase(&matLayout);
+	// Pipelines may be in flight.
+	deletionQueue.release(std::move(matLayout));
+	materialLayouts.erase(layoutIterator);
+	return true;
 }
 
 AfterglowMaterialManager::AfterglowMaterialManager(
 	AfterglowCommandPool& commandPool, 
-	AfterglowGraphicsQueue& graphicsQueue, 
+	AfterglowUploadContext& uploadContext, 
 	AfterglowPassManager& passManager,
 	AfterglowAssetMonitor& assetMonitor, 
 	AfterglowSynchronizer& synchronizer) :
-	_impl(std::make_unique<Impl>(*this, commandPool, graphicsQueue, passManager, assetMonitor, synchronizer)) {
+	_impl(std::make_unique<Impl>(*this, commandPool, uploadContext, passManager, assetMonitor, synchronizer)) {
 	
 	// Initialize ErrorMaterial (For base object)
 	createMaterial(mat::ErrorMaterialName(), AfterglowMaterial::errorMaterial());
@@ -841,10 +1521,168 @@ AfterglowMaterial& AfterglowMaterialManager::createMaterial(
 			safeApplyShaders(*matLayout, *materialAsset);
 		}
 	}
+	_impl->linkMaterialShaderFiles(name, *safeSrcMaterial);
 	_impl->datedMaterialLayouts.insert(matLayout);
+	_impl->updateMaterialVariants(name);
 	return matLayout->material();
 }
 
+void AfterglowMaterialManager::reloadMaterial(const std::string& name, const AfterglowMaterialAsset& materialAsset) {
+	{
+		LockGuard lockGuard{ _mutex };
+		auto iterator = _impl->materialLayouts.find(name);
+		if (iterator != _impl->materialLayouts.end() && _impl->reloadable(iterator->second, materialAsset.material())) {
+			_impl->queueReload(name, iterator->second, materialAsset.material(), Impl::ReloadMode::Material);
+			return;
+		}
+	}
+	createMaterial(name, materialAsset.material(), materialAsset);
+}
+
+void AfterglowMaterialManager::reloadShaders(const std::string& name) {
+	AfterglowMaterialLayout* matLayout = nullptr;
+	{
+		LockGuard lockGuard{ _mutex };
+		auto iterator = _impl->materialLayouts.find(name);
+		if (iterator == _impl->materialLayouts.end()) {
+			return;
+		}
+		matLayout = &iterator->second;
+		if (_impl->reloadable(*matLayout, matLayout->material())) {
+			_impl->queueReload(name, *matLayout, matLayout->material(), Impl::ReloadMode::Shaders);
+			return;
+		}
+	}
+	// Make sure pipeline was released before we update it.
+	waitGPU();
+	safeApplyShaders(*matLayout, AfterglowMaterialAsset(matLayout->material()));
+	// When shader changed, only pipeline need to rebuild, resources are same.
+	// So do not mark matLayout to dated, dated will also reload its matResources.
+	matLayout->updatePipelines();
+	_impl->assetRegistrar.watchIncludedFiles(name, matLayout->material());
+}
+
+void AfterglowMaterialManager::reloadShaderFile(const std::string& path) {
+	std::vector<std::string> materialNames;
+	{
+		LockGuard lockGuard{ _mutex };
+		materialNames = _impl->shaderFileDependentMaterials(util::NormalizePath(path));
+	}
+	for (const auto& materialName : materialNames) {
+		reloadShaders(materialName);
+	}
+}
+
+void AfterglowMaterialManager::benchmarkShaderCompilation(uint32_t iterations) {
+	struct ShaderSource {
+		shader::Stage stage;
+		std::string code;
+		std::string name;
+		shader::Defines defines;
+		shader::Model model;
+	};
+	std::vector<ShaderSource> shaderSources;
+	{
+		LockGuard lockGuard{ _mutex };
+		for (auto& [name, matLayout] : _impl->materialLayouts) {
+			const auto& material = std::as_const(matLayout).material();
+			try {
+				AfterglowMaterialAsset matAsset(material);
+				auto& associatedSSBOInfos = _impl->computeExternalSSBOContexts[&matLayout].associatedSSBOInfos;
+				if (!material.hasComputeTask() || !material.computeTask().isComputeOnly()) {
+					shaderSources.emplace_back(
+						shader::Stage::Vertex, 
+						matAsset.generateShaderCode(shader::Stage::Vertex, matLayout.pass(), associatedSSBOInfos), 
+						material.vertexShaderPath(), 
+						material.keywordDefines(), 
+						AfterglowShaderModule::supportedModel(device(), shader::Stage::Vertex, material.shaderModel())
+					);
+					shaderSources.emplace_back(
+						shader::Stage::Fragment, 
+						matAsset.generateShaderCode(shader::Stage::Fragment, matLayout.pass(), associatedSSBOInfos), 
+						material.fragmentShaderPath(), 
+						material.keywordDefines(), 
+						AfterglowShaderModule::supportedModel(device(), shader::Stage::Fragment, material.shaderModel())
+					);
+				}
+				if (material.hasComputeTask()) {
+					shaderSources.emplace_back(
+						shader::Stage::Compute, 
+						matAsset.generateShaderCode(shader::Stage::Compute, matLayout.pass(), associatedSSBOInfos), 
+						material.computeTask().computeShaderPath(), 
+						material.keywordDefines(), 
+						AfterglowShaderModule::supportedModel(device(), shader::Stage::Compute, material.computeTask().shaderModel())
+					);
+				}
+			}
+			catch (const std::exception& error) {
+				DEBUG_CLASS_WARNING(std::format("Material \"{}\" is skipped in shader compilation benchmark: {}", name, error.what()));
+			}
+		}
+	}
+
+	AfterglowShaderModule::includeCache().clear();
+	auto includeStatisticsBegin = AfterglowShaderModule::includeCache().statistics();
+	uint32_t dxcCreatedCountBegin = AfterglowDxcInstances::createdCount();
+	uint32_t failedCount = 0;
+	uint64_t firstIterationTime = 0;
+	uint64_t totalTime = 0;
+	// Reports of the first iteration, in order of shader sources.
+	std::vector<std::string> optimizationReports(shaderSources.size());
+	LocalClock clock;
+	for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+		clock.update();
+		for (size_t index = 0; index < shaderSources.size(); ++index) {
+			const auto& shaderSource = shaderSources[index];
+			try {
+				AfterglowShaderModule::compileSpirv(
+					shaderSource.stage, 
+					shaderSource.code, 
+					shaderSource.name, 
+					shaderSource.defines, 
+					shaderSource.model, 
+					false, 
+					iteration == 0 ? &optimizationReports[index] : nullptr
+				);
+			}
+			catch (const std::exception&) {
+				++failedCount;
+			}
+		}
+		clock.update();
+		uint64_t iterationTime = clock.deltaTime<unit::Microseconds>();
+		if (iteration == 0) {
+			firstIterationTime = iterationTime;
+		}
+		totalTime += iterationTime;
+	}
+
+	// Benchmark result should be visible in release build too, so output it directly.
+	auto includeStatistics = AfterglowShaderModule::includeCache().statistics();
+	uint64_t compileCount = std::max<uint64_t>(shaderSources.size() * iterations, 1);
+	uint64_t warmCompileCount = std::max<uint64_t>(shaderSources.size() * (iterations - std::min(iterations, 1u)), 1);
+	std::cout << std::format(
+		"[AfterglowMaterialManager] Shader compilation: {} shaders x {} iterations, failed: {}, "
+		"time per shader (us): avg {}, first iteration {}, warm iterations {}, "
+		"DXC instances created: {}, include cache hit/read: {}/{}\n",
+		shaderSources.size(), iterations, failedCount, 
+		totalTime / compileCount, 
+		firstIterationTime / std::max<uint64_t>(shaderSources.size(), 1), 
+		(totalTime - firstIterationTime) / warmCompileCount, 
+		AfterglowDxcInstances::createdCount() - dxcCreatedCountBegin, 
+		includeStatistics.hitCount - includeStatisticsBegin.hitCount, 
+		includeStatistics.readCount - includeStatisticsBegin.readCount
+	);
+	for (size_t index = 0; index < shaderSources.size(); ++index) {
+		if (!optimizationReports[index].empty()) {
+			std::cout << std::format(
+				"[AfterglowMaterialManager] Spirv optimization of {} ({}): {}\n", 
+				shaderSources[index].name, inreflect::EnumName(shaderSources[index].stage), optimizationReports[index]
+			);
+		}
+	}
+}
+
 AfterglowMaterialInstance& AfterglowMaterialManager::createMaterialInstance(const std::string& name, const std::string& parentMaterialName) {
 	LockGuard lockGuard{ _mutex };
 	return _impl->createMaterialInstanceWithoutLock(name, parentMaterialName);
@@ -962,7 +1800,7 @@ bool AfterglowMaterialManager::submitMeshUniform(const std::string& materialInst
 	}
 	perObjectSetContext.activated = true;
 
-	_impl->datedPerObjectSetContexts[&materialResource] = &perObjectSetContexts;
+	_impl->datedPerObjectSetContexts[&materialResource] = { &perObjectSetContexts, true };
 	return true;
 }
 
@@ -987,15 +1825,22 @@ void AfterglowMaterialManager::updateMaterials(
 		_impl->inFlightSwapchainImageSetOutdatedFlags[frameIndex] = false;
 	}
 
-	for (auto* matLayout : _impl->datedMaterialLayouts) {
-		_impl->appendDatedComputeExternalSSBOContext(*matLayout);
-		_impl->applyMaterialLayout(*matLayout);
-	}
+	_impl->applyMaterialLayouts();
 	for (auto& [matResource, flag] : _impl->datedMaterialResources[frameIndex]) {
 		_impl->applyMaterialResource(*matResource, flag, frameIndex);
 	}
-	for (auto& [materialResource, perObjectSetContexts] : _impl->datedPerObjectSetContexts) {
-		_impl->applyPerObjectGlobalSetContext(*materialResource , *perObjectSetContexts, frameIndex);
+	uint64_t objectCount = 0;
+	for (auto& [materialResource, datedContext] : _impl->datedPerObjectSetContexts) {
+		if (datedContext.dated) {
+			objectCount += datedContext.contexts->size();
+		}
+	}
+	_impl->reservePerObjectSet(frameIndex, objectCount);
+	_impl->meshUniformRingOffset = 0;
+	for (auto& [materialResource, datedContext] : _impl->datedPerObjectSetContexts) {
+		if (datedContext.dated) {
+			_impl->applyPerObjectGlobalSetContext(*materialResource , *datedContext.contexts, frameIndex);
+		}
 	}
 
 	for (auto* key : _impl->datedComputeExternalSSBOContextKeys) {
@@ -1008,16 +1853,16 @@ void AfterglowMaterialManager::updateMaterials(
 	std::lock_guard lock{ _mutex };
 	_impl->datedMaterialLayouts.clear();
 	_impl->datedMaterialResources[frameIndex].clear();
-	_impl->datedPerObjectSetContexts.clear();
+	for (auto& [materialResource, datedContext] : _impl->datedPerObjectSetContexts) {
+		datedContext.dated = false;
+	}
 	_impl->datedComputeExternalSSBOContextKeys.clear();
 }
 
 void AfterglowMaterialManager::updateResources() {
-	if (!_impl->perObjectSetContextRemovingCache.empty()
-		|| !_impl->materialInstanceRemovingCache.empty()
-		|| !_impl->materialRemovingCache.empty()) {
-		waitGPU();
-	}
+	// Removed vulkan objects are released into the deletion queue, nothing waits for the GPU here.
+	_impl->deletionQueue.update();
+	// Contexts only refer to descriptor sets, recorded command buffers never read them.
 	for (auto* perObjectSetContexts : _impl->perObjectSetContextRemovingCache) {
 		// Clear inactivated context and reset the flag.
 		// Recreate them all is effecient than erase_if due to all context were marked as inactivate.
@@ -1031,12 +1876,48 @@ void AfterglowMaterialManager::updateResources() {
 	for (const auto& name : _impl->materialRemovingCache) {
 		_impl->removeMaterialWithoutLock(name);
 	}
+	// Variant layouts created here are built by the reload thread, instances move to them in applyFinishedReloads().
+	for (const auto& name : _impl->materialInstanceVariantCache) {
+		_impl->applyMaterialInstanceVariant(name);
+	}
+	// Instances left their variants only if they were removed or switched.
+	if (!_impl->materialInstanceRemovingCache.empty() || !_impl->materialInstanceVariantCache.empty()) {
+		_impl->collectUnusedVariants();
+	}
+	// Swap reloaded shaders and pipelines at the frame boundary.
+	_impl->applyFinishedReloads();
 
 	std::lock_guard lock{ _mutex };
 	_impl->texturePool.update();
+	// Rebind streamed textures which became resident or evicted, only descriptor sets are rewritten.
+	if (_impl->residentTextureGeneration != _impl->texturePool.residentGeneration()) {
+		_impl->residentTextureGeneration = _impl->texturePool.residentGeneration();
+		for (auto& [name, matResource] : _impl->materialResources) {
+			if (matResource.texturesOutdated()) {
+				_impl->markAsDated(matResource, Impl::MaterialResourceUpdateFlag::None);
+			}
+		}
+	}
 	_impl->materialRemovingCache.clear();
-	_impl->perObjectSetContextRemovingCache.clear();
+	// Drop the storage before the arena is reset, a cleared vector still holds its capacity there.
+	_impl->perObjectSetContextRemovingCache = std::pmr::vector<Impl::PerObjectSetContexts*>{ &_impl->frameAllocator };
+	_impl->frameAllocator.reset();
 	_impl->materialInstanceRemovingCache.clear();
+	_impl->materialInstanceVariantCache.clear();
+}
+
+void AfterglowMaterialManager::submitObjectInstances(const std::vector<ubo::ObjectInstance>& objectInstances) {
+	// Same frame index as descriptorSetReferences().
+	uint32_t frameIndex = device().lastFrameIndex();
+	if (_impl->reserveObjectInstanceBuffer(frameIndex, objectInstances.size())) {
+		_impl->registerObjectInstanceBuffer(frameIndex);
+		_impl->descriptorSetWriter.write();
+	}
+	if (!objectInstances.empty()) {
+		(*_impl->inFlightObjectInstanceBuffers[frameIndex]).writeMemory(
+			objectInstances.data(), objectInstances.size() * sizeof(ubo::ObjectInstance)
+		);
+	}
 }
 
 AfterglowMaterialResource& AfterglowMaterialManager::errorMaterialResource() {
@@ -1078,6 +1959,8 @@ AfterglowDescriptorSetReferences* AfterglowMaterialManager::descriptorSetReferen
 	uint32_t frameIndex = device().lastFrameIndex();
 	auto& setRefs = setContextIterator->second.inFlightSetReferences[frameIndex];
 	_impl->applyComputeExternalSSBOSetReference(matResource->materialLayout(), setRefs, frameIndex);
+	// Every draw and dispatch queries its set references here, so textures in use are not evicted.
+	matResource->markUsed(_impl->texturePool.frame());
 	return &setRefs;
 }
 
@@ -1090,21 +1973,5 @@ void AfterglowMaterialManager::applyShaders(AfterglowMaterialLayout& matLayout,
 		? _impl->computeExternalSSBOContexts[&matLayout].associatedSSBOInfos
 		: util::OptionalRef<AfterglowComputeTask::SSBOInfoRefs>(std::nullopt);
 
-	auto& material = matLayout.material();
-	if (!material.hasComputeTask() || !material.computeTask().isComputeOnly()) {
-		matLayout.compileVertexShader(matAsset.generateShaderCode(
-			shader::Stage::Vertex, pass, associatedSSBOInfos
-		));
-		matLayout.compileFragmentShader(matAsset.generateShaderCode(
-			shader::Stage::Fragment, pass, associatedSSBOInfos
-		));
-	}
-
-	if (material.hasComputeTask()) {
-		matLayout.compileComputeShader(matAsset.generateShaderCode(
-			shader::Stage::Compute, pass, associatedSSBOInfos
-		));
-		// No require to apply compute shader initializer, them will generated in updateComputePipeline automatically.
-		// @see: AfterglowMaterialLayout::updateComputePipeline
-	}
+	Impl::compileShaders(matLayout, matAsset, pass, associatedSSBOInfos);
 }
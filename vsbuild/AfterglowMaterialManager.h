@@ -14,7 +14,7 @@
 class AfterglowSynchronizer;
 class AfterglowMaterialAsset;
 class AfterglowCommandPool;
-class AfterglowGraphicsQueue;
+class AfterglowUploadContext;
 class AfterglowPassManager;
 class AfterglowAssetMonitor;
 class AfterglowDevice;
@@ -31,7 +31,7 @@ public:
 
 	AfterglowMaterialManager(
 		AfterglowCommandPool& commandPool, 
-		AfterglowGraphicsQueue& graphicsQueue, 
+		AfterglowUploadContext& uploadContext, 
 		AfterglowPassManager& passManager, 
 		AfterglowAssetMonitor& assetMonitor, 
 		AfterglowSynchronizer& synchronizer
@@ -73,6 +73,30 @@ public:
 	*/
 	AfterglowMaterialInstance& createMaterialInstance(const std::string& name, const std::string& parentMaterialName);
 
+	/**
+	* @brief: Reload a modified material asset, shaders are compiled in the background and swapped in at a frame boundary.
+	* @desc: Old shaders are kept if compilation failed. New materials and materials with external ssbos are created by createMaterial() instead.
+	* @thread_safety
+	*/
+	void reloadMaterial(const std::string& name, const AfterglowMaterialAsset& materialAsset);
+	/**
+	* @brief: Rebuild shaders and pipelines of the material in the background, they are swapped in at a frame boundary.
+	* @desc: Old pipelines are kept if compilation failed.
+	* @warning: Make sure it be invoked in render thread only, it waits the GPU if the material can not be reloaded in background.
+	*/
+	void reloadShaders(const std::string& name);
+	/**
+	* @brief: Reload shaders of materials which use this file, directly or by #include.
+	* @warning: Make sure it be invoked in render thread only, same as reloadShaders().
+	*/
+	void reloadShaderFile(const std::string& path);
+
+	/**
+	* @brief: Compile shaders of all material layouts for iterations times, spirv cache is bypassed, timings are printed.
+	* @desc: Include cache is cleared before the first iteration, so it shows the cost of cold includes.
+	*/
+	void benchmarkShaderCompilation(uint32_t iterations);
+
 	/**
 	* @brief: Remove material and its instances.
 	* @thread_safety
@@ -112,6 +136,9 @@ public:
 
 	/**
 	* @brief: Apply material info to descriptors manually.
+	* @desc: 
+	*	If keyword mask of the instance was changed, it is moved to the layout of that variant in the next updateResources().
+	*	A variant used for the first time is built by the reload thread, the instance keeps its current layout until then.
 	* @param: name MaterialInstanceContext's name.
 	* @return: true if update succefully.
 	* @thred-safety
@@ -136,6 +163,13 @@ public:
 	*/
 	bool submitMeshUniform(const std::string& materialInstanceName, const ubo::MeshUniform& meshUniform);
 
+	/**
+	* @brief: Upload object instances of instancing materials, instanced draws index them by firstInstance.
+	* @note: Invoke it after prepareNextFrameContext(), same as descriptorSetReferences().
+	* @warning: GPU will be waited if the instance buffer should grow.
+	*/
+	void submitObjectInstances(const std::vector<ubo::ObjectInstance>& objectInstances);
+
 	// @brief: write descritptor sets to device.
 	void updateMaterials(
 		render::PassUnorderedMap<img::ImageReferences>& allPassImages, 
@@ -90,6 +90,43 @@ const AfterglowStorageBuffer* AfterglowMaterialResource::indirectStorageBuffer()
 	return const_cast<AfterglowMaterialResource*>(this)->indirectStorageBuffer();
 }
 
+bool AfterglowMaterialResource::isAsyncCompute() noexcept {
+	auto& material = _materialLayout.material();
+	return device().asyncComputeEnabled() && material.hasComputeTask() && material.computeTask().isAsync();
+}
+
+bool AfterglowMaterialResource::texturesOutdated() const noexcept {
+	for (const auto& [stage, resource] : _stageResources) {
+		for (const auto& [textureName, textureResource] : resource.textureResources) {
+			if (!textureResource.textureRef) {
+				continue;
+			}
+			auto* texture = &textureResource.textureRef->texture();
+			for (auto* boundTexture : textureResource.inFlightBoundTextures) {
+				if (boundTexture != texture) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+void AfterglowMaterialResource::markUsed(uint64_t frame) noexcept {
+	// Many objects share a material resource, textures are stamped once per frame.
+	if (_lastUsedFrame == frame) {
+		return;
+	}
+	_lastUsedFrame = frame;
+	for (auto& [stage, resource] : _stageResources) {
+		for (auto& [textureName, textureResource] : resource.textureResources) {
+			if (textureResource.textureRef) {
+				textureResource.textureRef->markUsed(frame);
+			}
+		}
+	}
+}
+
 //void AfterglowMaterialResource::update(uint32_t frameIndex) {
 //	updateUniforms(frameIndex);
 //	updateTextures(frameIndex);
@@ -225,6 +262,7 @@ void AfterglowMaterialResource::submitDescriptorSets(uint32_t frameIndex) {
 				*(*_inFlightDescriptorSets[frameIndex]).find(setLayout),  // Ugly find, try to remove it.
 				textureResource.bindingIndex
 			);
+			textureResource.inFlightBoundTextures[frameIndex] = &textureResource.textureRef->texture();
 		}
 	}
 	//DEBUG_COST_END;
@@ -279,6 +317,7 @@ inline void AfterglowMaterialResource::reregisterUnmodifiedTextures() {
 					*(*_inFlightDescriptorSets[index]).find(setLayout),  // Ugly find, try to remove it.
 					textureResource.bindingIndex
 				);
+				textureResource.inFlightBoundTextures[index] = &textureResource.textureRef->texture();
 			}
 		}
 	}
@@ -350,14 +389,14 @@ inline void AfterglowMaterialResource::synchronizeStorageBuffers() {
 		// Recreate buffers Whatever these buffers are exist or not, due to material layout may change the buffer size and layout.
 		frameSSBOResources.resize(numFrameSSBOs);
 		// TODO: Badsize for texture
+		bool asyncShared = isAsyncCompute();
 		AfterglowSSBOInitializer initializer{ ssboInfo };
-		AfterglowStagingBuffer stagingBuffer(device(), initializer.data(), initializer.byteSize());
 		for (auto& ssboResource : frameSSBOResources) {
 			if (ssboInfo.isBuffer()) {
 				// @note: Clear another type buffer to avoid data residue.
 				ssboResource.image.reset();
-				ssboResource.buffer.recreate(device(), initializer.data(), initializer.byteSize(), ssboInfo.usage());
-				(*ssboResource.buffer).submit(_texturePool.commandPool(), _texturePool.graphicsQueue(), stagingBuffer);
+				ssboResource.buffer.recreate(device(), initializer.data(), initializer.byteSize(), ssboInfo.usage(), asyncShared);
+				(*ssboResource.buffer).submit(_texturePool.uploadContext());
 			}
 			else {
 				ssboResource.buffer.reset();
@@ -366,9 +405,10 @@ inline void AfterglowMaterialResource::synchronizeStorageBuffers() {
 					computeTextureExtent(ssboInfo), 
 					computeTextureFormat(ssboInfo), 
 					ssboInfo.textureDimension(), 
-					ssboInfo.textureSampleMode()
+					ssboInfo.textureSampleMode(), 
+					asyncShared
 				);
-				(*ssboResource.image).submit(_texturePool.commandPool(), _texturePool.graphicsQueue(), stagingBuffer);
+				(*ssboResource.image).submit(_texturePool.uploadContext(), initializer.data(), initializer.byteSize());
 			}
 		}
 
@@ -418,9 +458,11 @@ inline AfterglowStorageBuffer* AfterglowMaterialResource::currentFrameStorageBuf
 	if (!inFlightResources) {
 		return nullptr;
 	}
+	// Async compute runs one frame ahead, graphics reads the buffers of last frame.
+	uint32_t frameIndex = isAsyncCompute() ? device().lastFrameIndex() : device().currentFrameIndex();
 	// Limit maximum index for read only buffer.
 	uint32_t index = std::min(
-		static_cast<uint32_t>(inFlightResources->size()) - 1, device().currentFrameIndex()
+		static_cast<uint32_t>(inFlightResources->size()) - 1, frameIndex
 	);
 	return (*inFlightResources)[index].buffer;
 }
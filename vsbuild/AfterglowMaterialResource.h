@@ -23,6 +23,8 @@ public:
 
 		uint32_t bindingIndex = 0;
 		std::array<bool, cfg::maxFrameInFlight> inFlightModifiedFlags{};
+		// Images written into descriptor sets, they differ from textureRef->texture() if the texture became resident or evicted.
+		std::array<AfterglowTextureImage*, cfg::maxFrameInFlight> inFlightBoundTextures{};
 		std::unique_ptr<AfterglowTextureReference> textureRef;
 	};
 
@@ -86,6 +88,14 @@ public:
 	AfterglowStorageBuffer* indirectStorageBuffer() noexcept;
 	const AfterglowStorageBuffer* indirectStorageBuffer() const noexcept;
 
+	// @return: True if the compute task is async and device enabled async compute.
+	bool isAsyncCompute() noexcept;
+
+	// @return: True if descriptor sets of any frame refer to outdated images, e.g. placeholders or evicted textures.
+	bool texturesOutdated() const noexcept;
+	// @brief: Stamp textures as used in this frame, so they are not evicted, see AfterglowSharedTexturePool::frame().
+	void markUsed(uint64_t frame) noexcept;
+
 	// @brief: Reload resources, costly, less call.
 	// @deprecated: sepreated into updateUniforms(), updateTextures() and submit.
 	// void update(uint32_t frameIndex);
@@ -143,6 +153,7 @@ private:
 	AfterglowSharedTexturePool& _texturePool;
 
 	bool _shouldReregisterTextures;
+	uint64_t _lastUsedFrame = 0;
 
 	std::unique_ptr<SpecifiedSSBOResources> _specifiedSSBOResources;
 };
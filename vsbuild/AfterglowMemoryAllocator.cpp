@@ -0,0 +1,410 @@
+#include "AfterglowMemoryAllocator.h"
+
+#include <mutex>
+#include <vector>
+#include <format>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <unordered_map>
+
+#include "AfterglowPhysicalDevice.h"
+#include "AfterglowDeviceMemory.h"
+#include "AfterglowUtilities.h"
+#include "BuddyAllocator.h"
+#include "Configurations.h"
+#include "DebugUtilities.h"
+#include "ExceptionUtilities.h"
+
+struct AfterglowMemoryAllocator::Block {
+	Block(VkDeviceSize size, uint32_t inPoolIndex);
+
+	AfterglowDeviceMemory::AsElement memory;
+	void* mapped = nullptr;
+	BuddyAllocator nodes;
+	uint32_t poolIndex = 0;
+};
+
+struct AfterglowMemoryAllocator::Impl {
+	enum class ResourceKind {
+		Buffer = 0,
+		Image = 1,
+
+		EnumCount
+	};
+
+	struct DedicatedMemory {
+		AfterglowDeviceMemory::AsElement memory;
+		uint32_t heapIndex = 0;
+	};
+
+	Impl(AfterglowDevice& inDevice);
+
+	inline uint32_t poolIndex(uint32_t memoryTypeIndex, ResourceKind kind) const noexcept;
+	inline VkDeviceSize blockSize(uint32_t memoryTypeIndex) const noexcept;
+	inline bool hostVisible(uint32_t memoryTypeIndex) const noexcept;
+	inline uint32_t heapIndex(uint32_t memoryTypeIndex) const noexcept;
+
+	/**
+	* @param dedicatedInfo: Resource of the dedicated allocation, its pNext is not used.
+	* @warning: Invoke it with the mutex locked.
+	*/
+	Allocation allocate(
+		AfterglowMemoryAllocator& allocator,
+		const VkMemoryRequirements& requirements,
+		VkMemoryPropertyFlags properties,
+		ResourceKind kind,
+		VkMemoryDedicatedAllocateInfo dedicatedInfo
+	);
+	inline Block& createBlock(uint32_t memoryTypeIndex, uint32_t poolIndex);
+	inline void* mapMemory(VkDeviceMemory memory, uint32_t memoryTypeIndex);
+
+	// Smallest buddy node, allocations are rounded up to it.
+	static inline VkDeviceSize _minNodeSize = 256;
+
+	AfterglowDevice& device;
+	VkPhysicalDeviceMemoryProperties memoryProperties{};
+
+	// Index: memoryTypeIndex * ResourceKind::EnumCount + ResourceKind.
+	std::vector<std::vector<std::unique_ptr<Block>>> pools;
+	std::unordered_map<VkDeviceMemory, DedicatedMemory> dedicatedMemories;
+	// Bytes of vkAllocateMemory of each heap.
+	std::vector<VkDeviceSize> heapBytes;
+	// Bytes of buddy nodes and dedicated allocations in use of each heap, budget usage is measured by it.
+	std::vector<VkDeviceSize> heapUsedBytes;
+	uint64_t evictingBytes = 0;
+	Statistics statistics;
+
+	mutable std::mutex mutex;
+};
+
+AfterglowMemoryAllocator::Block::Block(VkDeviceSize size, uint32_t inPoolIndex) :
+	nodes(size, Impl::_minNodeSize), poolIndex(inPoolIndex) {
+}
+
+AfterglowMemoryAllocator::Impl::Impl(AfterglowDevice& inDevice) :
+	device(inDevice) {
+	vkGetPhysicalDeviceMemoryProperties(device.physicalDevice(), &memoryProperties);
+	pools.resize(memoryProperties.memoryTypeCount * util::EnumValue(ResourceKind::EnumCount));
+	heapBytes.resize(memoryProperties.memoryHeapCount);
+	heapUsedBytes.resize(memoryProperties.memoryHeapCount);
+}
+
+inline uint32_t AfterglowMemoryAllocator::Impl::poolIndex(uint32_t memoryTypeIndex, ResourceKind kind) const noexcept {
+	return memoryTypeIndex * util::EnumValue(ResourceKind::EnumCount) + util::EnumValue(kind);
+}
+
+inline VkDeviceSize AfterglowMemoryAllocator::Impl::blockSize(uint32_t memoryTypeIndex) const noexcept {
+	// Small heaps (e.g. device local host visible heap) should not be occupied by a few blocks.
+	VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].size;
+	VkDeviceSize size = cfg::memoryBlockSize;
+	while (size > heapSize / 8 && size > _minNodeSize) {
+		size >>= 1;
+	}
+	return size;
+}
+
+inline bool AfterglowMemoryAllocator::Impl::hostVisible(uint32_t memoryTypeIndex) const noexcept {
+	return memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+}
+
+inline uint32_t AfterglowMemoryAllocator::Impl::heapIndex(uint32_t memoryTypeIndex) const noexcept {
+	return memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+}
+
+AfterglowMemoryAllocator::Allocation AfterglowMemoryAllocator::Impl::allocate(
+	AfterglowMemoryAllocator& allocator,
+	const VkMemoryRequirements& requirements,
+	VkMemoryPropertyFlags properties,
+	ResourceKind kind,
+	VkMemoryDedicatedAllocateInfo dedicatedInfo) {
+	uint32_t memoryTypeIndex = allocator.findMemoryType(requirements.memoryTypeBits, properties);
+	VkDeviceSize currentBlockSize = blockSize(memoryTypeIndex);
+	VkDeviceSize nodeSize = std::max(requirements.size, requirements.alignment);
+
+	Allocation allocation;
+	allocation._size = requirements.size;
+
+	if (nodeSize >= std::min(cfg::dedicatedAllocationThreshold, currentBlockSize / 2)) {
+		auto memory = AfterglowDeviceMemory::makeElement(device);
+		memory->allocationSize = requirements.size;
+		memory->memoryTypeIndex = memoryTypeIndex;
+		memory->pNext = &dedicatedInfo;
+		VkDeviceMemory memoryHandle = memory;
+		allocation._memory = memoryHandle;
+		allocation._mapped = mapMemory(memoryHandle, memoryTypeIndex);
+		dedicatedMemories.emplace(memoryHandle, DedicatedMemory{ std::move(memory), heapIndex(memoryTypeIndex) });
+		// Set the allocator last, the allocation is not released if something above throws.
+		allocation._allocator = &allocator;
+
+		++statistics.dedicatedCount;
+		statistics.dedicatedBytes += requirements.size;
+		heapBytes[heapIndex(memoryTypeIndex)] += requirements.size;
+		heapUsedBytes[heapIndex(memoryTypeIndex)] += requirements.size;
+		return allocation;
+	}
+
+	uint32_t index = poolIndex(memoryTypeIndex, kind);
+	Block* targetBlock = nullptr;
+	std::optional<VkDeviceSize> offset;
+	for (auto& block : pools[index]) {
+		offset = block->nodes.allocate(block->nodes.level(nodeSize));
+		if (offset) {
+			targetBlock = block.get();
+			break;
+		}
+	}
+	if (!offset) {
+		targetBlock = &createBlock(memoryTypeIndex, index);
+		offset = targetBlock->nodes.allocate(targetBlock->nodes.level(nodeSize));
+	}
+
+	uint32_t level = targetBlock->nodes.level(nodeSize);
+	VkDeviceSize levelSize = targetBlock->nodes.levelSize(level);
+
+	allocation._memory = targetBlock->memory;
+	allocation._offset = *offset;
+	allocation._mapped = targetBlock->mapped ? static_cast<char*>(targetBlock->mapped) + *offset : nullptr;
+	allocation._block = targetBlock;
+	allocation._level = level;
+	allocation._allocator = &allocator;
+
+	++statistics.allocationCount;
+	statistics.usedBytes += levelSize;
+	heapUsedBytes[heapIndex(memoryTypeIndex)] += levelSize;
+	return allocation;
+}
+
+inline AfterglowMemoryAllocator::Block& AfterglowMemoryAllocator::Impl::createBlock(uint32_t memoryTypeIndex, uint32_t poolIndex) {
+	auto block = std::make_unique<Block>(blockSize(memoryTypeIndex), poolIndex);
+	block->memory.recreate(device);
+	block->memory->allocationSize = block->nodes.size();
+	block->memory->memoryTypeIndex = memoryTypeIndex;
+	// Allocate it here, the block is appended to the pool only if it is valid.
+	VkDeviceMemory memoryHandle = block->memory;
+	block->mapped = mapMemory(memoryHandle, memoryTypeIndex);
+
+	++statistics.blockCount;
+	statistics.blockBytes += block->nodes.size();
+	heapBytes[heapIndex(memoryTypeIndex)] += block->nodes.size();
+	return *pools[poolIndex].emplace_back(std::move(block));
+}
+
+inline void* AfterglowMemoryAllocator::Impl::mapMemory(VkDeviceMemory memory, uint32_t memoryTypeIndex) {
+	if (!hostVisible(memoryTypeIndex)) {
+		return nullptr;
+	}
+	void* mapped = nullptr;
+	if (vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+		EXCEPT_TYPE_RUNTIME(AfterglowMemoryAllocator, "Failed to map device memory.");
+	}
+	return mapped;
+}
+
+AfterglowMemoryAllocator::Allocation::Allocation(Allocation&& other) noexcept :
+	_allocator(std::exchange(other._allocator, nullptr)),
+	_memory(std::exchange(other._memory, VK_NULL_HANDLE)),
+	_offset(other._offset),
+	_size(other._size),
+	_mapped(std::exchange(other._mapped, nullptr)),
+	_block(std::exchange(other._block, nullptr)),
+	_level(other._level) {
+}
+
+AfterglowMemoryAllocator::Allocation& AfterglowMemoryAllocator::Allocation::operator=(Allocation&& other) noexcept {
+	if (this != &other) {
+		if (_allocator) {
+			_allocator->release(*this);
+		}
+		_allocator = std::exchange(other._allocator, nullptr);
+		_memory = std::exchange(other._memory, VK_NULL_HANDLE);
+		_offset = other._offset;
+		_size = other._size;
+		_mapped = std::exchange(other._mapped, nullptr);
+		_block = std::exchange(other._block, nullptr);
+		_level = other._level;
+	}
+	return *this;
+}
+
+AfterglowMemoryAllocator::Allocation::~Allocation() {
+	if (_allocator) {
+		_allocator->release(*this);
+	}
+}
+
+AfterglowMemoryAllocator::Allocation::operator bool() const noexcept {
+	return _memory != VK_NULL_HANDLE;
+}
+
+VkDeviceMemory AfterglowMemoryAllocator::Allocation::memory() const noexcept {
+	return _memory;
+}
+
+VkDeviceSize AfterglowMemoryAllocator::Allocation::offset() const noexcept {
+	return _offset;
+}
+
+VkDeviceSize AfterglowMemoryAllocator::Allocation::size() const noexcept {
+	return _size;
+}
+
+void* AfterglowMemoryAllocator::Allocation::mapped() const noexcept {
+	return _mapped;
+}
+
+AfterglowMemoryAllocator::AfterglowMemoryAllocator(AfterglowDevice& device) :
+	_impl(std::make_unique<Impl>(device)) {
+}
+
+AfterglowMemoryAllocator::~AfterglowMemoryAllocator() {
+	if (_impl->statistics.allocationCount > 0 || !_impl->dedicatedMemories.empty()) {
+		DEBUG_CLASS_WARNING(std::format(
+			"Allocator is destroyed with {} allocations and {} dedicated allocations alive.",
+			_impl->statistics.allocationCount, _impl->dedicatedMemories.size()
+		));
+	}
+}
+
+AfterglowMemoryAllocator::Allocation AfterglowMemoryAllocator::allocate(VkBuffer buffer, VkMemoryPropertyFlags properties) {
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(_impl->device, buffer, &requirements);
+	VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+	dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+	dedicatedInfo.buffer = buffer;
+
+	Allocation allocation;
+	{
+		std::lock_guard lock{ _impl->mutex };
+		allocation = _impl->allocate(*this, requirements, properties, Impl::ResourceKind::Buffer, dedicatedInfo);
+	}
+	if (vkBindBufferMemory(_impl->device, buffer, allocation.memory(), allocation.offset()) != VK_SUCCESS) {
+		EXCEPT_CLASS_RUNTIME("Failed to bind buffer memory.");
+	}
+	return allocation;
+}
+
+AfterglowMemoryAllocator::Allocation AfterglowMemoryAllocator::allocate(VkImage image, VkMemoryPropertyFlags properties) {
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(_impl->device, image, &requirements);
+	VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+	dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+	dedicatedInfo.image = image;
+
+	Allocation allocation;
+	{
+		std::lock_guard lock{ _impl->mutex };
+		allocation = _impl->allocate(*this, requirements, properties, Impl::ResourceKind::Image, dedicatedInfo);
+	}
+	if (vkBindImageMemory(_impl->device, image, allocation.memory(), allocation.offset()) != VK_SUCCESS) {
+		EXCEPT_CLASS_RUNTIME("Failed to bind image memory.");
+	}
+	return allocation;
+}
+
+uint32_t AfterglowMemoryAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
+	auto& memoryProperties = _impl->memoryProperties;
+	for (uint32_t index = 0; index < memoryProperties.memoryTypeCount; ++index) {
+		if ((typeFilter & (1 << index)) && (memoryProperties.memoryTypes[index].propertyFlags & properties) == properties) {
+			return index;
+		}
+	}
+	EXCEPT_CLASS_RUNTIME("Failed to find suitable memory type.");
+}
+
+AfterglowMemoryAllocator::Statistics AfterglowMemoryAllocator::statistics() const {
+	std::lock_guard lock{ _impl->mutex };
+	Statistics statistics = _impl->statistics;
+	VkDeviceSize freeBytes = 0;
+	VkDeviceSize largestFreeBytesSum = 0;
+	for (const auto& pool : _impl->pools) {
+		for (const auto& block : pool) {
+			freeBytes += block->nodes.size() - block->nodes.usedSize();
+			VkDeviceSize largestFree = block->nodes.largestFreeSize();
+			largestFreeBytesSum += largestFree;
+			statistics.largestFreeBytes = std::max(statistics.largestFreeBytes, largestFree);
+		}
+	}
+	if (freeBytes > 0) {
+		statistics.fragmentation = 1.0f - static_cast<float>(largestFreeBytesSum) / static_cast<float>(freeBytes);
+	}
+	return statistics;
+}
+
+AfterglowMemoryAllocator::Budget AfterglowMemoryAllocator::budget() const {
+	auto& memoryProperties = _impl->memoryProperties;
+	Budget budget;
+	std::lock_guard lock{ _impl->mutex };
+	budget.evicting = _impl->evictingBytes;
+	if (_impl->device.memoryBudgetEnabled()) {
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+		budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+		VkPhysicalDeviceMemoryProperties2 memoryProperties2{};
+		memoryProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+		memoryProperties2.pNext = &budgetProperties;
+		vkGetPhysicalDeviceMemoryProperties2(_impl->device.physicalDevice(), &memoryProperties2);
+		for (uint32_t index = 0; index < memoryProperties.memoryHeapCount; ++index) {
+			if (memoryProperties.memoryHeaps[index].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+				// Whole blocks are counted by the driver, replace them with the used bytes of their nodes.
+				VkDeviceSize heapUsage = budgetProperties.heapUsage[index];
+				VkDeviceSize blockBytes = std::min(heapUsage, _impl->heapBytes[index]);
+				budget.usage += heapUsage - blockBytes + _impl->heapUsedBytes[index];
+				budget.budget += budgetProperties.heapBudget[index];
+			}
+		}
+		return budget;
+	}
+
+	uint64_t heapSize = 0;
+	for (uint32_t index = 0; index < memoryProperties.memoryHeapCount; ++index) {
+		if (memoryProperties.memoryHeaps[index].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+			budget.usage += _impl->heapUsedBytes[index];
+			heapSize += memoryProperties.memoryHeaps[index].size;
+		}
+	}
+	budget.budget = std::min(heapSize, cfg::memoryBudgetFallbackLimit);
+	return budget;
+}
+
+void AfterglowMemoryAllocator::beginEviction(uint64_t bytes) noexcept {
+	std::lock_guard lock{ _impl->mutex };
+	_impl->evictingBytes += bytes;
+}
+
+void AfterglowMemoryAllocator::endEviction(uint64_t bytes) noexcept {
+	std::lock_guard lock{ _impl->mutex };
+	_impl->evictingBytes -= std::min(bytes, _impl->evictingBytes);
+}
+
+void AfterglowMemoryAllocator::release(Allocation& allocation) noexcept {
+	std::lock_guard lock{ _impl->mutex };
+	auto& statistics = _impl->statistics;
+	if (!allocation._block) {
+		auto iterator = _impl->dedicatedMemories.find(allocation._memory);
+		if (iterator != _impl->dedicatedMemories.end()) {
+			--statistics.dedicatedCount;
+			statistics.dedicatedBytes -= allocation._size;
+			_impl->heapBytes[iterator->second.heapIndex] -= allocation._size;
+			_impl->heapUsedBytes[iterator->second.heapIndex] -= allocation._size;
+			_impl->dedicatedMemories.erase(iterator);
+		}
+		return;
+	}
+
+	auto& block = *allocation._block;
+	VkDeviceSize levelSize = block.nodes.levelSize(allocation._level);
+	block.nodes.free(allocation._offset, allocation._level);
+	--statistics.allocationCount;
+	statistics.usedBytes -= levelSize;
+	uint32_t memoryTypeIndex = block.poolIndex / util::EnumValue(Impl::ResourceKind::EnumCount);
+	_impl->heapUsedBytes[_impl->heapIndex(memoryTypeIndex)] -= levelSize;
+
+	// Keep the last block of the pool.
+	auto& pool = _impl->pools[block.poolIndex];
+	if (block.nodes.allocationCount() == 0 && pool.size() > 1) {
+		--statistics.blockCount;
+		statistics.blockBytes -= block.nodes.size();
+		_impl->heapBytes[_impl->heapIndex(memoryTypeIndex)] -= block.nodes.size();
+		std::erase_if(pool, [&block](const auto& poolBlock) { return poolBlock.get() == &block; });
+	}
+}
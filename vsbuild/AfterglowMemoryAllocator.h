@@ -0,0 +1,106 @@
+#pragma once
+#include <memory>
+#include <cstdint>
+
+#include "AfterglowDevice.h"
+
+/**
+* @brief: Device memory sub-allocator, resources share large blocks instead of one vkAllocateMemory per resource.
+* @desc:
+*	Blocks are split by the buddy strategy, node offsets are aligned to their power of two sizes, so resource alignments are satisfied implicitly.
+*	Each memory type has separate block pools for buffers and images, they never share a block due to bufferImageGranularity.
+*	Resources of cfg::dedicatedAllocationThreshold or larger own dedicated allocations.
+*	Host visible blocks are persistently mapped, use Allocation::mapped() instead of vkMapMemory.
+*	Empty blocks are released except the last one of each pool, so recreated resources do not reallocate blocks.
+*	Device local budget comes from VK_EXT_memory_budget if it is enabled, otherwise from cfg::memoryBudgetFallbackLimit.
+*	Budget usage counts sub allocations instead of whole blocks, so releasing a resource lowers the usage even if its block is kept.
+*	Resource pools share the pending eviction bytes here, so one overage is not evicted by every pool.
+* @note: Thread safe.
+*/
+class AfterglowMemoryAllocator : public AfterglowObject {
+private:
+	struct Block;
+
+public:
+	struct Statistics {
+		uint32_t blockCount = 0;
+		uint32_t dedicatedCount = 0;
+		// Sub allocations in blocks.
+		uint64_t allocationCount = 0;
+		// Unit::Bytes
+		uint64_t blockBytes = 0;
+		// Bytes of buddy nodes in use, including the rounding up to power of two.
+		uint64_t usedBytes = 0;
+		uint64_t dedicatedBytes = 0;
+		// Largest free node of all blocks, the largest allocation which fits without a new block.
+		uint64_t largestFreeBytes = 0;
+		// [0, 1], 1 - (sum of the largest free node of each block) / (free bytes of all blocks), 0 means free space is contiguous.
+		float fragmentation = 0.0f;
+	};
+
+	// @brief: Sum of all device local heaps.
+	struct Budget {
+		// Unit::Bytes
+		// Bytes of sub allocations and dedicated allocations, free space of blocks is excluded.
+		uint64_t usage = 0;
+		uint64_t budget = 0;
+		// Bytes which were evicted by resource pools but not released yet.
+		uint64_t evicting = 0;
+	};
+
+	// @brief: Move only handle of an allocation, the memory is released on destruction.
+	class Allocation {
+	public:
+		Allocation() = default;
+		Allocation(Allocation&& other) noexcept;
+		Allocation& operator=(Allocation&& other) noexcept;
+		~Allocation();
+
+		explicit operator bool() const noexcept;
+
+		VkDeviceMemory memory() const noexcept;
+		VkDeviceSize offset() const noexcept;
+		VkDeviceSize size() const noexcept;
+		// @return: Host address of this allocation, nullptr if the memory is not host visible.
+		void* mapped() const noexcept;
+
+	private:
+		friend class AfterglowMemoryAllocator;
+
+		AfterglowMemoryAllocator* _allocator = nullptr;
+		VkDeviceMemory _memory = VK_NULL_HANDLE;
+		VkDeviceSize _offset = 0;
+		VkDeviceSize _size = 0;
+		void* _mapped = nullptr;
+		// Owner block, nullptr for dedicated allocations.
+		Block* _block = nullptr;
+		uint32_t _level = 0;
+	};
+
+	AfterglowMemoryAllocator(AfterglowDevice& device);
+	~AfterglowMemoryAllocator();
+
+	// @brief: Allocate memory for the buffer and bind it.
+	Allocation allocate(VkBuffer buffer, VkMemoryPropertyFlags properties);
+	// @brief: Allocate memory for the image (optimal tiling) and bind it.
+	Allocation allocate(VkImage image, VkMemoryPropertyFlags properties);
+
+	// @return: Memory type which has all of the properties, looked up in the cached memory properties.
+	uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+	Statistics statistics() const;
+	// @note: Usage of VK_EXT_memory_budget includes other processes and driver internal allocations.
+	Budget budget() const;
+
+	// @brief: Record bytes of resources which are evicted, they are released after their frames were retired.
+	void beginEviction(uint64_t bytes) noexcept;
+	// @brief: Invoke it once the evicted resources were released or removed.
+	void endEviction(uint64_t bytes) noexcept;
+
+private:
+	struct Impl;
+
+	void release(Allocation& allocation) noexcept;
+
+	std::unique_ptr<Impl> _impl;
+};
@@ -5,9 +5,9 @@
 
 AfterglowMeshManager::AfterglowMeshManager(
 	AfterglowCommandPool& commandPool, 
-	AfterglowGraphicsQueue& graphicsQueue, 
+	AfterglowUploadContext& uploadContext, 
 	AfterglowSynchronizer& synchronizer) :
-	_meshPool(commandPool, graphicsQueue, synchronizer) {
+	_meshPool(commandPool, uploadContext, synchronizer) {
 }
 
 AfterglowDevice& AfterglowMeshManager::device() noexcept {
@@ -31,7 +31,12 @@ inline void AfterglowMeshManager::fillMeshUniformAABB(AfterglowMeshResource& res
 }
 
 void AfterglowMeshManager::updateMeshUniformResourceInfo(AfterglowStaticMeshComponent& staticMesh, AfterglowComputeComponent* compute) {
-	uint32_t indexCount = (*staticMesh.meshResource()->indexBuffers()[0]).indexCount();
+	auto& indexBuffers = staticMesh.meshResource()->indexBuffers();
+	// Failed to load.
+	if (indexBuffers.empty()) {
+		return;
+	}
+	uint32_t indexCount = (*indexBuffers[0]).indexCount();
 	staticMesh.meshResource()->meshUniform().indexCount = indexCount;
 	if (compute) {
 		compute->meshUniform().indexCount = indexCount;
@@ -62,7 +67,7 @@ void AfterglowMeshManager::updateUniforms(AfterglowRenderableContext& renderable
 			// shape mesh could not change the resource, so just initialize it as soon as the mesh resource initialized. 
 			if (shapeMesh.shape() == AfterglowShapeMeshComponent::Shape::NDCRetangle) {
 				reinterpret_cast<AfterglowShapeMeshResource*>(meshResource.get())->initializeShape<shape::NDCRectangle>(
-					_meshPool.commandPool(), _meshPool.graphicsQueue()
+					_meshPool.commandPool(), _meshPool.uploadContext()
 				);
 			}
 		}
@@ -86,7 +91,7 @@ void AfterglowMeshManager::updateUniforms(AfterglowRenderableContext& renderable
 	//	auto& shapeResource = processProcess->shapeResource();
 	//	if (!shapeResource) {
 	//		shapeResource = std::make_unique<AfterglowShapeMeshResource>();
-	//		shapeResource->initializeShape<shape::NDCRectangle>(_meshPool.commandPool(), _meshPool.graphicsQueue());
+	//		shapeResource->initializeShape<shape::NDCRectangle>(_meshPool.commandPool(), _meshPool.uploadContext());
 	//	}
 	//}
 }
@@ -99,6 +104,10 @@ void AfterglowMeshManager::updateResources(AfterglowRenderableContext& renderabl
 	for (auto& staticMesh : staticMeshes) {
 		if (staticMesh.meshResource() && staticMesh.meshDated()) {
 			staticMesh.meshResource()->setMeshReference(_meshPool.mesh(staticMesh.modelAssetInfo()));
+			// Placeholder is bound while the mesh is streaming, keep it dated until the mesh is resident.
+			if (staticMesh.meshResource()->meshReference().streaming()) {
+				continue;
+			}
 			// AABB is updated only if mesh dated.
 			fillMeshUniformAABB(*staticMesh.meshResource());
 			// Update mesh uniform resource info
@@ -110,3 +119,7 @@ void AfterglowMeshManager::updateResources(AfterglowRenderableContext& renderabl
 	// Update real reasource from the Mesh Pool.
 	_meshPool.update();
 }
+
+void AfterglowMeshManager::markUsed(AfterglowMeshResource& meshResource) noexcept {
+	meshResource.markUsed(_meshPool.frame());
+}
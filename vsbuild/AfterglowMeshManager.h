@@ -16,7 +16,7 @@ class AfterglowMeshManager : public AfterglowObject {
 public:
 	AfterglowMeshManager(
 		AfterglowCommandPool& commandPool, 
-		AfterglowGraphicsQueue& graphicsQueue, 
+		AfterglowUploadContext& uploadContext, 
 		AfterglowSynchronizer& synchronizer
 	);
 
@@ -27,6 +27,9 @@ public:
 	// @warning: Make sure invoke it after the GPU draw was completed.
 	void updateResources(AfterglowRenderableContext& renderableContext);
 
+	// @brief: Invoke it for every drawn mesh, idle meshes are evicted first if the memory budget is exceeded.
+	void markUsed(AfterglowMeshResource& meshResource) noexcept;
+
 private:
 	static inline void fillMeshUniform(const AfterglowTransformComponent& transform, ubo::MeshUniform& destMeshUnifrom);
 	static inline void fillMeshUniformAABB(AfterglowMeshResource& resource);
@@ -23,6 +23,12 @@ const AfterglowMeshReference& AfterglowMeshResource::meshReference() const {
 	return *_meshReference;
 }
 
+void AfterglowMeshResource::markUsed(uint64_t frame) noexcept {
+	if (_mode == Mode::SharedPool && _meshReference) {
+		_meshReference->markUsed(frame);
+	}
+}
+
 AfterglowIndexBuffer::Array& AfterglowMeshResource::indexBuffers() {
 	if (_mode == Mode::Custom) {
 		return *_meshBuffer->indexBuffers;
@@ -25,6 +25,8 @@ public:
 	// @desc: For Reference mode. dispatch mesh buffer from 
 	void setMeshReference(const AfterglowMeshReference& reference);
 	const AfterglowMeshReference& meshReference() const;
+	// @brief: Stamp the shared pool mesh as used in this frame, custom buffers are ignored.
+	void markUsed(uint64_t frame) noexcept;
 
 	AfterglowIndexBuffer::Array& indexBuffers();
 	std::vector<AfterglowVertexBufferHandle>& vertexBufferHandles();
@@ -57,6 +57,15 @@ bool AfterglowPassInterface::isExportColorAttachment(uint32_t inAttachmentIndex)
 	return false;
 }
 
+VkImageLayout AfterglowPassInterface::presentLayout() {
+	return AfterglowSubpassContext::presentLayout(device().presentEnabled());
+}
+
+bool AfterglowPassInterface::isSampledAttachment(uint32_t attachmentIndex) const {
+	return subpassContext().attachments()[attachmentIndex].finalLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL /* Input attachment and vast majority export*/
+		|| isExportColorAttachment(attachmentIndex) /* Present export case*/;
+}
+
 const AfterglowPassInterface::BarrierArray* AfterglowPassInterface::exportBarriers() {
 	return _exportBarriers.get();
 }
@@ -87,11 +96,12 @@ VkImageMemoryBarrier& AfterglowPassInterface::appendColorBarrier(const VkImage e
 		.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 },
 	});
 	_exportBarrierSrcPipelineStage |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	_exportBarrierDstPipelineStage |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 
 	// Color to Present transition.
 	if (isValidAttachment(presentAttachmentIndex())) {
 		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		barrier.newLayout = presentLayout();
 	}
 	return barrier;
 }
@@ -110,12 +120,22 @@ VkImageMemoryBarrier& AfterglowPassInterface::appendDepthBarrier(const VkImage e
 			.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT, 0, 1, 0, 1 },
 		});
 	_exportBarrierSrcPipelineStage |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	_exportBarrierDstPipelineStage |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 	return barrier;
 }
 
+VkImageMemoryBarrier& AfterglowPassInterface::appendBarrier(
+	const VkImageMemoryBarrier& barrier, VkPipelineStageFlags srcPipelineStage, VkPipelineStageFlags dstPipelineStage
+) {
+	_exportBarrierSrcPipelineStage |= srcPipelineStage;
+	_exportBarrierDstPipelineStage |= dstPipelineStage;
+	return _exportBarriers->emplace_back(barrier);
+}
+
 void AfterglowPassInterface::clearBarriers() {
 	_exportBarriers = std::make_unique<BarrierArray>();
 	_exportBarrierSrcPipelineStage = VK_PIPELINE_STAGE_NONE;
+	_exportBarrierDstPipelineStage = VK_PIPELINE_STAGE_NONE;
 }
 
 void AfterglowPassInterface::recordImportAttachments(
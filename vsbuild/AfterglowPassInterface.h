@@ -108,8 +108,12 @@ public:
 	inline int32_t exportDepthAttachmentIndex() const noexcept { return _exportDepthAttachmentIndex; }
 
 	bool isExportColorAttachment(uint32_t inAttachmentIndex) const noexcept;
+	// @brief: Attachment is read by shaders after this pass or subpass, so its image requires the input attachment usage.
+	bool isSampledAttachment(uint32_t attachmentIndex) const;
 
 	inline int32_t presentAttachmentIndex() const noexcept { return _presentAttachmentIndex; }
+	// @return: Final layout of the present attachment, it is not the present layout in headless mode.
+	VkImageLayout presentLayout();
 
 	// Export attachment names.
 	inline const std::string* exportColorAttachmentName(ColorAttachment attachment) const { return _exportColorAttachmentNames[util::EnumValue(attachment)].get(); }
@@ -118,7 +122,7 @@ public:
 
 	// Barriers
 	VkPipelineStageFlags exportBarrierSrcPipelineStage() const noexcept { return _exportBarrierSrcPipelineStage; }
-	//VkPipelineStageFlagBits exportBarrierDstPipelineStage() const noexcept { return VkPipelineStageFlagBits(_exportBarrierDstPipelineStage); }
+	VkPipelineStageFlags exportBarrierDstPipelineStage() const noexcept { return _exportBarrierDstPipelineStage; }
 
 	const BarrierArray* exportBarriers(); 
 	// Multiple export color image support.
@@ -126,6 +130,8 @@ public:
 	VkImageMemoryBarrier& appendColorBarrier(const VkImage exportColorImage, uint32_t exportAttachmentIndex);
 	//VkImageMemoryBarrier& appendPresentBarrier(const VkImage exportColorImage, uint32_t exportAttachmentIndex);
 	VkImageMemoryBarrier& appendDepthBarrier(const VkImage exportDepthImage);
+	// @brief: Append a barrier which was computed by AfterglowRenderGraph.
+	VkImageMemoryBarrier& appendBarrier(const VkImageMemoryBarrier& barrier, VkPipelineStageFlags srcPipelineStage, VkPipelineStageFlags dstPipelineStage);
 	void clearBarriers();
 
 	virtual std::string_view passName() const = 0;
@@ -166,7 +172,7 @@ private:
 	int32_t _presentAttachmentIndex = invalidAttachmentIndex();
 
 	VkPipelineStageFlags _exportBarrierSrcPipelineStage = VK_PIPELINE_STAGE_NONE;
-	//uint32_t _exportBarrierDstPipelineStage = VK_PIPELINE_STAGE_NONE;
+	VkPipelineStageFlags _exportBarrierDstPipelineStage = VK_PIPELINE_STAGE_NONE;
 	std::unique_ptr<BarrierArray> _exportBarriers;
 
 	BindingFramebufferArray _framebuffers;
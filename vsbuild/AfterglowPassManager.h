@@ -1,6 +1,7 @@
 #pragma once
 #include "AfterglowPassInterface.h"
 #include "AfterglowPassSetBase.h"
+#include "AfterglowRenderGraph.h"
 #include "AfterglowUtilities.h"
 
 class AfterglowPassManager : public AfterglowObject {
@@ -36,12 +37,16 @@ public:
 	FixedPasses& fixedPasses() noexcept { return _fixedPasses; }
 	inline bool isFinalPass(AfterglowPassInterface& pass) const noexcept { return &pass == _finalPass; }
 
+	// @note: Compiled by AfterglowFramebufferManager when all framebuffers are recreated.
+	inline AfterglowRenderGraph& renderGraph() noexcept { return _renderGraph; }
+
 private:
 	AfterglowDevice& _device;
 	FixedPasses _fixedPasses;
 	CustomPassSets _customPassSets;
 
 	AfterglowPassInterface* _finalPass = nullptr;
+	AfterglowRenderGraph _renderGraph;
 };
 
 template<render::PassSetType Type, typename ...Params>
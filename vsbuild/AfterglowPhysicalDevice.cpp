@@ -8,7 +8,7 @@
 #include "RenderConfigurations.h"
 
 
-AfterglowPhysicalDevice::AfterglowPhysicalDevice(AfterglowInstance& instance, AfterglowSurface& surface) {
+AfterglowPhysicalDevice::AfterglowPhysicalDevice(AfterglowInstance& instance, AfterglowSurface* surface) {
 	uint32_t deviceCount = 0;
 	vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
 	if (deviceCount == 0) {
@@ -26,6 +26,7 @@ AfterglowPhysicalDevice::AfterglowPhysicalDevice(AfterglowInstance& instance, Af
 	if (candidates.rbegin()->first > 0) {
 		linkData(candidates.rbegin()->second);
 		_queueFamilyIndices = findQueueFamilies(data(), surface);
+		_presentSupport = surface != nullptr;
 	}
 	else {
 		throw runtimeError("Failed to find a suitable GPU.");
@@ -34,6 +35,35 @@ AfterglowPhysicalDevice::AfterglowPhysicalDevice(AfterglowInstance& instance, Af
 	// After physical device linked, get its properties and features.
 	vkGetPhysicalDeviceProperties(*this, &_properties);
 	vkGetPhysicalDeviceFeatures(*this, &_features);
+	if (_properties.apiVersion >= VK_API_VERSION_1_2) {
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{};
+		timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		VkPhysicalDeviceShaderFloat16Int8Features float16Int8Features{};
+		float16Int8Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES;
+		float16Int8Features.pNext = &timelineSemaphoreFeatures;
+		VkPhysicalDevice16BitStorageFeatures storage16BitFeatures{};
+		storage16BitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES;
+		storage16BitFeatures.pNext = &float16Int8Features;
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &storage16BitFeatures;
+		vkGetPhysicalDeviceFeatures2(*this, &features2);
+		_timelineSemaphoreSupport = timelineSemaphoreFeatures.timelineSemaphore;
+		_native16BitTypesSupport = float16Int8Features.shaderFloat16 
+			&& _features.shaderInt16 
+			&& storage16BitFeatures.storageBuffer16BitAccess 
+			&& storage16BitFeatures.uniformAndStorageBuffer16BitAccess;
+
+		_subgroupProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &_subgroupProperties;
+		vkGetPhysicalDeviceProperties2(*this, &properties2);
+		_subgroupProperties.pNext = nullptr;
+	}
+	// Budget properties are chained to vkGetPhysicalDeviceMemoryProperties2, which is vulkan 1.1.
+	_memoryBudgetSupport = _properties.apiVersion >= VK_API_VERSION_1_1 
+		&& checkOptionalExtensionSupport(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
 	_msaaSampleCount = cfg::enableMSAA ? getMaxUsableSamleCount() : VK_SAMPLE_COUNT_1_BIT;
 }
 
@@ -50,6 +80,14 @@ uint32_t AfterglowPhysicalDevice::presentFamilyIndex() {
 	return _queueFamilyIndices.presentFamily.value();
 }
 
+uint32_t AfterglowPhysicalDevice::asyncComputeFamilyIndex() {
+	return _queueFamilyIndices.asyncComputeFamily.value_or(graphicsFamilyIndex());
+}
+
+bool AfterglowPhysicalDevice::asyncComputeFamilySupport() const noexcept {
+	return _queueFamilyIndices.asyncComputeFamily.has_value();
+}
+
 AfterglowPhysicalDevice::SwapchainSupportDetails AfterglowPhysicalDevice::querySwapchainSupport(AfterglowSurface& surface) {
 	return querySwapchainSupport(data(), surface);
 }
@@ -62,6 +100,26 @@ const VkPhysicalDeviceFeatures& AfterglowPhysicalDevice::features() const noexce
 	return _features;
 }
 
+bool AfterglowPhysicalDevice::timelineSemaphoreSupport() const noexcept {
+	return _timelineSemaphoreSupport;
+}
+
+const VkPhysicalDeviceSubgroupProperties& AfterglowPhysicalDevice::subgroupProperties() const noexcept {
+	return _subgroupProperties;
+}
+
+bool AfterglowPhysicalDevice::native16BitTypesSupport() const noexcept {
+	return _native16BitTypesSupport;
+}
+
+bool AfterglowPhysicalDevice::memoryBudgetSupport() const noexcept {
+	return _memoryBudgetSupport;
+}
+
+bool AfterglowPhysicalDevice::presentSupport() const noexcept {
+	return _presentSupport;
+}
+
 VkFormatProperties AfterglowPhysicalDevice::formatProperties(VkFormat format) {
 	VkFormatProperties formatProperties;
 	vkGetPhysicalDeviceFormatProperties(*this, format, &formatProperties);
@@ -96,7 +154,7 @@ VkSampleCountFlagBits AfterglowPhysicalDevice::msaaSampleCount() noexcept {
 	return _msaaSampleCount;
 }
 
-AfterglowPhysicalDevice::QueueFamilyIndices AfterglowPhysicalDevice::findQueueFamilies(VkPhysicalDevice device, AfterglowSurface& surface) {
+AfterglowPhysicalDevice::QueueFamilyIndices AfterglowPhysicalDevice::findQueueFamilies(VkPhysicalDevice device, AfterglowSurface* surface) {
 	QueueFamilyIndices indices;
 	uint32_t queueFamilyCount = 0;
 	vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
@@ -111,10 +169,16 @@ AfterglowPhysicalDevice::QueueFamilyIndices AfterglowPhysicalDevice::findQueueFa
 			indices.graphicFamily = index;
 		}
 
-		VkBool32 presentSupport = false;
-		vkGetPhysicalDeviceSurfaceSupportKHR(device, index, surface, &presentSupport);
-		if (presentSupport) {
-			indices.presentFamily = index;
+		// Headless: nothing to present, just reuse the graphics family.
+		if (!surface) {
+			indices.presentFamily = indices.graphicFamily;
+		}
+		else {
+			VkBool32 presentSupport = false;
+			vkGetPhysicalDeviceSurfaceSupportKHR(device, index, *surface, &presentSupport);
+			if (presentSupport) {
+				indices.presentFamily = index;
+			}
 		}
 
 		if (indices.isValid()) {
@@ -122,6 +186,15 @@ AfterglowPhysicalDevice::QueueFamilyIndices AfterglowPhysicalDevice::findQueueFa
 		}
 		++index;
 	}
+
+	// Dedicated compute family runs beside graphics family.
+	for (uint32_t familyIndex = 0; familyIndex < queueFamilyCount; ++familyIndex) {
+		auto queueFlags = queueFamilies[familyIndex].queueFlags;
+		if ((queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+			indices.asyncComputeFamily = familyIndex;
+			break;
+		}
+	}
 	return indices;
 }
 
@@ -147,13 +220,16 @@ AfterglowPhysicalDevice::SwapchainSupportDetails AfterglowPhysicalDevice::queryS
 	return details;
 }
 
-bool AfterglowPhysicalDevice::checkDeviceExtensionSupport(VkPhysicalDevice device) {
+bool AfterglowPhysicalDevice::checkDeviceExtensionSupport(VkPhysicalDevice device, bool presentable) {
 	uint32_t extensionCount;
 	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
 	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
 	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
 	std::set<std::string> requiredExtensions(cfg::deviceExtensions.begin(), cfg::deviceExtensions.end());
+	if (presentable) {
+		requiredExtensions.insert(cfg::presentDeviceExtensions.begin(), cfg::presentDeviceExtensions.end());
+	}
 
 	for (const auto& extension : availableExtensions) {
 		requiredExtensions.erase(extension.extensionName);
@@ -163,14 +239,28 @@ bool AfterglowPhysicalDevice::checkDeviceExtensionSupport(VkPhysicalDevice devic
 	return requiredExtensions.empty();
 }
 
-bool AfterglowPhysicalDevice::isDeviceSuitable(VkPhysicalDevice device, AfterglowSurface& surface) {
+bool AfterglowPhysicalDevice::checkOptionalExtensionSupport(const char* extensionName) {
+	uint32_t extensionCount;
+	vkEnumerateDeviceExtensionProperties(*this, nullptr, &extensionCount, nullptr);
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(*this, nullptr, &extensionCount, availableExtensions.data());
+
+	for (const auto& extension : availableExtensions) {
+		if (std::string(extension.extensionName) == extensionName) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool AfterglowPhysicalDevice::isDeviceSuitable(VkPhysicalDevice device, AfterglowSurface* surface) {
 	// No filter now, we just choose the first suitable one.
 	QueueFamilyIndices indices = findQueueFamilies(device, surface);
-	bool extensionsSupported = checkDeviceExtensionSupport(device);
+	bool extensionsSupported = checkDeviceExtensionSupport(device, surface != nullptr);
 
-	bool swapChainAdequate = false;
-	if (extensionsSupported) {
-		SwapchainSupportDetails swapChainSupport = querySwapchainSupport(device, surface);
+	bool swapChainAdequate = !surface;
+	if (extensionsSupported && surface) {
+		SwapchainSupportDetails swapChainSupport = querySwapchainSupport(device, *surface);
 		swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
 	}
 
@@ -183,7 +273,7 @@ bool AfterglowPhysicalDevice::isDeviceSuitable(VkPhysicalDevice device, Afterglo
 		&& supportedFeatures.samplerAnisotropy;
 }
 
-int AfterglowPhysicalDevice::evaluateDeviceSuitablility(VkPhysicalDevice device, AfterglowSurface& surface) {
+int AfterglowPhysicalDevice::evaluateDeviceSuitablility(VkPhysicalDevice device, AfterglowSurface* surface) {
 	// Just a simple example of GPU Suitablility Evaluation.
 	VkPhysicalDeviceProperties deviceProperties;
 	vkGetPhysicalDeviceProperties(device, &deviceProperties);
@@ -12,6 +12,8 @@ public:
 	struct QueueFamilyIndices {
 		std::optional<uint32_t>  graphicFamily;
 		std::optional<uint32_t>  presentFamily;
+		// [Optional] Family supports compute but not graphics, for async compute.
+		std::optional<uint32_t>  asyncComputeFamily;
 		bool isValid() const noexcept;
 	};
 
@@ -21,11 +23,15 @@ public:
 		std::vector<VkPresentModeKHR> presentModes;
 	};
 
-	AfterglowPhysicalDevice(AfterglowInstance& instance, AfterglowSurface& surface);
+	// @param surface: Nullable, present support is not required in headless mode.
+	AfterglowPhysicalDevice(AfterglowInstance& instance, AfterglowSurface* surface);
 	~AfterglowPhysicalDevice();
 
 	uint32_t graphicsFamilyIndex();
 	uint32_t presentFamilyIndex();
+	// @return: Dedicated compute family if exists, otherwise the graphics family.
+	uint32_t asyncComputeFamilyIndex();
+	bool asyncComputeFamilySupport() const noexcept;
 
 	// Swapchain supprot.
 	SwapchainSupportDetails querySwapchainSupport(AfterglowSurface& surface);
@@ -34,6 +40,16 @@ public:
 	const VkPhysicalDeviceProperties& properties() const noexcept;
 	// Physical device features.
 	const VkPhysicalDeviceFeatures& features() const noexcept;
+	// Vulkan 1.2 timeline semaphore feature.
+	bool timelineSemaphoreSupport() const noexcept;
+	// Vulkan 1.1 subgroup properties, supported stages and operations are 0 if the device is lower than vulkan 1.1.
+	const VkPhysicalDeviceSubgroupProperties& subgroupProperties() const noexcept;
+	// @return: True if shaderFloat16, shaderInt16 and 16-bit storage buffer access are all supported.
+	bool native16BitTypesSupport() const noexcept;
+	// VK_EXT_memory_budget, heap usages and budgets are queried from the driver.
+	bool memoryBudgetSupport() const noexcept;
+	// @return: False in headless mode, the device was selected without a surface.
+	bool presentSupport() const noexcept;
 
 	VkFormatProperties formatProperties(VkFormat format);
 
@@ -43,16 +59,24 @@ public:
 	VkSampleCountFlagBits msaaSampleCount() noexcept;
 
 private:
-	QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device, AfterglowSurface& surface);
+	QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device, AfterglowSurface* surface);
 	SwapchainSupportDetails querySwapchainSupport(VkPhysicalDevice device, AfterglowSurface& surface);
-	bool checkDeviceExtensionSupport(VkPhysicalDevice device);
-	bool isDeviceSuitable(VkPhysicalDevice device, AfterglowSurface& surface);
-	int evaluateDeviceSuitablility(VkPhysicalDevice device, AfterglowSurface& surface);
+	// @param presentable: cfg::presentDeviceExtensions are required as well.
+	bool checkDeviceExtensionSupport(VkPhysicalDevice device, bool presentable);
+	// @return: True if the linked device supports this optional extension.
+	bool checkOptionalExtensionSupport(const char* extensionName);
+	bool isDeviceSuitable(VkPhysicalDevice device, AfterglowSurface* surface);
+	int evaluateDeviceSuitablility(VkPhysicalDevice device, AfterglowSurface* surface);
 	VkSampleCountFlagBits getMaxUsableSamleCount();
 
 	QueueFamilyIndices _queueFamilyIndices;
 	VkSampleCountFlagBits _msaaSampleCount;
 	VkPhysicalDeviceProperties _properties;
 	VkPhysicalDeviceFeatures _features;
+	bool _timelineSemaphoreSupport = false;
+	VkPhysicalDeviceSubgroupProperties _subgroupProperties{};
+	bool _native16BitTypesSupport = false;
+	bool _memoryBudgetSupport = false;
+	bool _presentSupport = false;
 };
 
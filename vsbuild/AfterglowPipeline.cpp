@@ -3,6 +3,7 @@
 #include "AfterglowStructLayout.h"
 #include "AfterglowShaderModule.h"
 #include "AfterglowPassInterface.h"
+#include "AfterglowPipelineCache.h"
 #include "Configurations.h"
 #include "RenderConfigurations.h"
 #include "ExceptionUtilities.h"
@@ -301,7 +302,7 @@ void AfterglowPipeline::create() {
 	// Delay binding for modify pipline layout after create info.
 	info().layout = _pipelineLayout;
 
-	if (vkCreateGraphicsPipelines(device(), VK_NULL_HANDLE, 1, &info(), nullptr, &data()) != VK_SUCCESS) {
+	if (vkCreateGraphicsPipelines(device(), device().pipelineCache(), 1, &info(), nullptr, &data()) != VK_SUCCESS) {
 		throw runtimeError("Failed to create graphics pipeline.");
 	}
 	_dependencies.reset();
@@ -0,0 +1,160 @@
+#include "AfterglowPipelineCache.h"
+
+#include <format>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+
+#include "AfterglowDevice.h"
+#include "AfterglowPhysicalDevice.h"
+#include "Configurations.h"
+#include "AfterglowUtilities.h"
+#include "ExceptionUtilities.h"
+
+AfterglowPipelineCache::AfterglowPipelineCache(AfterglowDevice& device) : 
+	_device(device) {
+	auto& properties = _device.physicalDevice().properties();
+	std::string uuid;
+	for (uint8_t byte : properties.pipelineCacheUUID) {
+		uuid += std::format("{:02x}", byte);
+	}
+	_cacheFilePath = std::format(
+		"{}{:04x}_{:04x}_{:08x}_{}{}", 
+		cfg::pipelineCacheDirectory, properties.vendorID, properties.deviceID, properties.driverVersion, uuid, cfg::pipelineCacheSuffix
+	);
+	// Create it early, pipelines may be created from worker threads.
+	initialize();
+}
+
+AfterglowPipelineCache::~AfterglowPipelineCache() {
+	if (isDataExists()) {
+		try {
+			save();
+		}
+		catch (const std::exception& error) {
+			DEBUG_CLASS_ERROR(error.what());
+		}
+	}
+	destroy(vkDestroyPipelineCache, _device, data(), nullptr);
+}
+
+void AfterglowPipelineCache::save() {
+	size_t dataSize = 0;
+	if (vkGetPipelineCacheData(_device, *this, &dataSize, nullptr) != VK_SUCCESS) {
+		EXCEPT_CLASS_RUNTIME("Failed to get pipeline cache data size.");
+	}
+	std::vector<char> cacheData(dataSize);
+	if (vkGetPipelineCacheData(_device, *this, &dataSize, cacheData.data()) != VK_SUCCESS) {
+		EXCEPT_CLASS_RUNTIME("Failed to get pipeline cache data.");
+	}
+	cacheData.resize(dataSize);
+
+	FileHead fileHead{};
+	fileHead.version = _currentVersion;
+	fileHead.dataSize = dataSize;
+	fileHead.dataHash = util::HashBytes(cacheData.data(), dataSize);
+
+	// Write to a temporary file first, an interrupted write never corrupts the previous cache.
+	std::filesystem::create_directories(cfg::pipelineCacheDirectory);
+	std::string tempFilePath = _cacheFilePath + ".tmp";
+	{
+		std::ofstream outFile(tempFilePath, std::ios::binary | std::ios::trunc);
+		if (!outFile) {
+			EXCEPT_CLASS_RUNTIME("Failed to write pipeline cache file: " + tempFilePath);
+		}
+		outFile.write(reinterpret_cast<const char*>(&fileHead), sizeof(FileHead));
+		outFile.write(cacheData.data(), dataSize);
+		if (!outFile) {
+			EXCEPT_CLASS_RUNTIME("Failed to write pipeline cache file: " + tempFilePath);
+		}
+	}
+	std::filesystem::rename(tempFilePath, _cacheFilePath);
+	DEBUG_CLASS_INFO(std::format("Pipeline cache was saved, {} bytes: {}", dataSize, _cacheFilePath));
+}
+
+const std::string& AfterglowPipelineCache::cacheFilePath() const noexcept {
+	return _cacheFilePath;
+}
+
+bool AfterglowPipelineCache::loaded() const noexcept {
+	return _loaded;
+}
+
+void AfterglowPipelineCache::initCreateInfo() {
+	loadCacheData();
+	info().sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	info().initialDataSize = _initialData.size();
+	info().pInitialData = _initialData.empty() ? nullptr : _initialData.data();
+}
+
+void AfterglowPipelineCache::create() {
+	VkResult result = vkCreatePipelineCache(_device, &info(), nullptr, &data());
+	if (result != VK_SUCCESS && _loaded) {
+		// Driver rejected the blob, fall back to an empty cache.
+		DEBUG_CLASS_WARNING("Driver rejected the pipeline cache data, an empty cache is created.");
+		_loaded = false;
+		info().initialDataSize = 0;
+		info().pInitialData = nullptr;
+		result = vkCreatePipelineCache(_device, &info(), nullptr, &data());
+	}
+	if (result != VK_SUCCESS) {
+		throw runtimeError("Failed to create pipeline cache.");
+	}
+	_initialData.clear();
+	_initialData.shrink_to_fit();
+}
+
+inline void AfterglowPipelineCache::loadCacheData() {
+	_loaded = false;
+	_initialData.clear();
+
+	std::ifstream inFile(_cacheFilePath, std::ios::binary);
+	if (!inFile) {
+		DEBUG_CLASS_INFO("Pipeline cache file not found, an empty cache is created: " + _cacheFilePath);
+		return;
+	}
+	std::error_code errorCode;
+	uint64_t fileSize = std::filesystem::file_size(_cacheFilePath, errorCode);
+	FileHead fileHead{};
+	inFile.read(reinterpret_cast<char*>(&fileHead), sizeof(FileHead));
+	if (errorCode || !inFile || std::string(fileHead.flag, 3) != "apc" || fileHead.version != _currentVersion) {
+		DEBUG_CLASS_WARNING("Invalid pipeline cache file head, discard it: " + _cacheFilePath);
+		return;
+	}
+	// dataSize comes from the file, check it before allocating anything.
+	if (fileHead.dataSize != fileSize - sizeof(FileHead)) {
+		DEBUG_CLASS_WARNING("Pipeline cache data size mismatches the file size, discard it: " + _cacheFilePath);
+		return;
+	}
+
+	std::vector<char> cacheData(fileHead.dataSize);
+	inFile.read(cacheData.data(), fileHead.dataSize);
+	if (static_cast<uint64_t>(inFile.gcount()) != fileHead.dataSize 
+		|| util::HashBytes(cacheData.data(), cacheData.size()) != fileHead.dataHash) {
+		DEBUG_CLASS_WARNING("Pipeline cache file is corrupt, discard it: " + _cacheFilePath);
+		return;
+	}
+	if (!verifyHeader(cacheData)) {
+		DEBUG_CLASS_WARNING("Pipeline cache is stale, discard it: " + _cacheFilePath);
+		return;
+	}
+	_initialData = std::move(cacheData);
+	_loaded = true;
+	DEBUG_CLASS_INFO(std::format("Pipeline cache was loaded, {} bytes: {}", _initialData.size(), _cacheFilePath));
+}
+
+inline bool AfterglowPipelineCache::verifyHeader(const std::vector<char>& cacheData) const {
+	VkPipelineCacheHeaderVersionOne header{};
+	if (cacheData.size() < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, cacheData.data(), sizeof(header));
+
+	auto& properties = _device.physicalDevice().properties();
+	return header.headerSize >= sizeof(header)
+		&& header.headerSize <= cacheData.size()
+		&& header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+		&& header.vendorID == properties.vendorID
+		&& header.deviceID == properties.deviceID
+		&& std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "AfterglowProxyObject.h"
+
+class AfterglowDevice;
+
+/**
+* @brief: Device-wide VkPipelineCache, it's loaded from disk on creation and saved back on destruction.
+* @desc:
+*	Cache file is keyed by vendorID, deviceID, driverVersion and pipelineCacheUUID, see cacheFilePath().
+*	Blobs which are stale (header mismatch) or corrupt (size or hash mismatch) are discarded, an empty cache is created instead.
+* @note: VkPipelineCache is internally synchronized, pipelines could be created with it from any thread.
+*/
+class AfterglowPipelineCache : public AfterglowProxyObject<AfterglowPipelineCache, VkPipelineCache, VkPipelineCacheCreateInfo> {
+public:
+	struct alignas(8) FileHead {
+		// Afterglow pipeline cache
+		char flag[4] = "apc";
+		uint32_t version;
+		uint64_t dataSize;
+		uint64_t dataHash;
+	};
+
+	AfterglowPipelineCache(AfterglowDevice& device);
+	~AfterglowPipelineCache();
+
+	// @brief: Write the pipeline cache data to cacheFilePath(), it's invoked on destruction automatically.
+	void save();
+	// @return: Cache file of the current physical device and driver.
+	const std::string& cacheFilePath() const noexcept;
+	// @return: True if the initial data was loaded from disk.
+	bool loaded() const noexcept;
+
+proxy_protected:
+	void initCreateInfo();
+	void create();
+
+private:
+	inline void loadCacheData();
+	// @return: True if the vulkan cache header matches the current physical device.
+	inline bool verifyHeader(const std::vector<char>& cacheData) const;
+
+	static inline uint32_t _currentVersion = 1;
+
+	AfterglowDevice& _device;
+	std::string _cacheFilePath;
+	std::vector<char> _initialData;
+	bool _loaded = false;
+};
+
@@ -16,7 +16,7 @@ AfterglowPostProcessPass::AfterglowPostProcessPass(AfterglowDevice& device, Afte
 		AfterglowSubpassContext::depthAttachment(depthFormat, AfterglowSubpassContext::PassUsage::Import, msaaSampleCount)
 	);
 	uint32_t exportColorAttachmentIndex = subpassContext().appendAttachment(
-		AfterglowSubpassContext::presentAttachment(swapchain::presentFormat, AfterglowSubpassContext::PassUsage::Export)
+		AfterglowSubpassContext::presentAttachment(swapchain::presentFormat, presentLayout(), AfterglowSubpassContext::PassUsage::Export)
 	);
 
 	// PassIO
@@ -0,0 +1,260 @@
+#include "AfterglowRenderGraph.h"
+
+#include <algorithm>
+#include <format>
+#include "AfterglowPassManager.h"
+#include "ExceptionUtilities.h"
+
+void AfterglowRenderGraph::compile(AfterglowPassManager& passManager) {
+	_passNodes.clear();
+	_resources.clear();
+	_aliasSlots.clear();
+	_passIndices.clear();
+
+	passManager.forEachPass([this, &passManager](AfterglowPassInterface& pass) {
+		appendPassNode(passManager, pass);
+	});
+	cullPasses(passManager);
+	assignAliasSlots();
+
+	DEBUG_CLASS_INFO(std::format(
+		"Render graph was compiled, passes: {}, culled passes: {}, resources: {}, aliased images: {}",
+		passCount(), culledPassCount(), resourceCount(), aliasSlotCount()
+	));
+}
+
+void AfterglowRenderGraph::recreateBarriers(render::PassUnorderedMap<img::ImageReferences>& allPassImages) {
+	for (auto& node : _passNodes) {
+		node.pass->clearBarriers();
+	}
+	_barrierCount = 0;
+	for (const auto& resource : _resources) {
+		const AttachmentUse* lastUse = nullptr;
+		for (const auto& use : resource.uses) {
+			if (_passNodes[use.passIndex].culled) {
+				continue;
+			}
+			if (lastUse) {
+				appendBarrier(*lastUse, use, allPassImages);
+			}
+			lastUse = &use;
+		}
+	}
+}
+
+bool AfterglowRenderGraph::culled(AfterglowPassInterface& pass) const {
+	auto iterator = _passIndices.find(&pass);
+	if (iterator == _passIndices.end()) {
+		// Pass was not compiled, keep it.
+		return false;
+	}
+	return _passNodes[iterator->second].culled;
+}
+
+bool AfterglowRenderGraph::culled(AfterglowPassSetBase& passSet) const {
+	return std::ranges::all_of(passSet.passes(), [this](auto& pass) { return !pass || culled(*pass); });
+}
+
+int32_t AfterglowRenderGraph::aliasSlot(AfterglowPassInterface& pass, uint32_t attachmentIndex) const {
+	auto iterator = _passIndices.find(&pass);
+	if (iterator == _passIndices.end()) {
+		return invalidAliasSlot();
+	}
+	auto& node = _passNodes[iterator->second];
+	if (attachmentIndex >= node.attachmentResources.size()) {
+		return invalidAliasSlot();
+	}
+	auto& resource = _resources[node.attachmentResources[attachmentIndex]];
+	auto& ownerUse = resource.uses.front();
+	// Only the owner creates the image, others reference it from the owner pass.
+	if (ownerUse.passIndex != iterator->second || ownerUse.attachmentIndex != attachmentIndex) {
+		return invalidAliasSlot();
+	}
+	return resource.aliasSlot;
+}
+
+uint32_t AfterglowRenderGraph::aliasSlotCount() const noexcept {
+	return static_cast<uint32_t>(_aliasSlots.size());
+}
+
+AfterglowPassInterface::ExtentMode AfterglowRenderGraph::aliasSlotExtentMode(uint32_t aliasSlot) const {
+	return _aliasSlots.at(aliasSlot).key.extentMode;
+}
+
+inline void AfterglowRenderGraph::appendPassNode(AfterglowPassManager& passManager, AfterglowPassInterface& pass) {
+	uint32_t passIndex = static_cast<uint32_t>(_passNodes.size());
+	_passIndices[&pass] = passIndex;
+	auto& node = _passNodes.emplace_back(PassNode{ .pass = &pass });
+
+	auto& subpassContext = pass.subpassContext();
+	for (uint32_t attachmentIndex = 0; attachmentIndex < subpassContext.attachmentCount(); ++attachmentIndex) {
+		uint32_t resourceIndex = 0;
+		auto* importAttachment = pass.findImportAttachment(attachmentIndex);
+		if (importAttachment) {
+			// Source pass should be executed before, so its resources were already appended.
+			auto* srcPass = passManager.findPass(importAttachment->srcPassName);
+			auto srcIterator = srcPass ? _passIndices.find(srcPass) : _passIndices.end();
+			if (srcIterator == _passIndices.end()) {
+				EXCEPT_CLASS_RUNTIME(std::format(
+					"Import attachment source pass \"{}\" was not found or not executed before \"{}\".",
+					importAttachment->srcPassName, pass.passName()
+				));
+			}
+			resourceIndex = _passNodes[srcIterator->second].attachmentResources.at(importAttachment->srcAttachmentIndex);
+		}
+		else {
+			resourceIndex = static_cast<uint32_t>(_resources.size());
+			_resources.emplace_back();
+		}
+		node.attachmentResources.push_back(resourceIndex);
+		_resources[resourceIndex].uses.push_back({ passIndex, attachmentIndex });
+	}
+}
+
+inline void AfterglowRenderGraph::cullPasses(AfterglowPassManager& passManager) {
+	// Walk backward from the final pass, writers are always visited after their readers.
+	_culledPassCount = 0;
+	for (int32_t passIndex = static_cast<int32_t>(_passNodes.size()) - 1; passIndex >= 0; --passIndex) {
+		auto& node = _passNodes[passIndex];
+		if (passManager.isFinalPass(*node.pass)) {
+			node.culled = false;
+		}
+		if (node.culled) {
+			++_culledPassCount;
+			DEBUG_CLASS_WARNING(std::format("Pass \"{}\" was culled, its attachments were never read.", node.pass->passName()));
+			continue;
+		}
+		for (const auto& importAttachment : node.pass->importAttachments()) {
+			int32_t writerIndex = lastWriterIndex(node.attachmentResources[importAttachment.destAttachmentIndex], passIndex);
+			if (writerIndex >= 0) {
+				_passNodes[writerIndex].culled = false;
+			}
+		}
+	}
+}
+
+inline void AfterglowRenderGraph::assignAliasSlots() {
+	// Resources were appended in order of their first use, so a greedy slot reusing is enough.
+	for (auto& resource : _resources) {
+		auto& ownerUse = resource.uses.front();
+		auto& ownerPass = *_passNodes[ownerUse.passIndex].pass;
+		// Present images are provided by the swapchain.
+		if (ownerUse.attachmentIndex == ownerPass.presentAttachmentIndex()) {
+			continue;
+		}
+		AliasKey key = makeAliasKey(ownerPass, ownerUse.attachmentIndex);
+		uint32_t firstUse = ownerUse.passIndex;
+		uint32_t lastUse = resource.uses.back().passIndex;
+		for (uint32_t slotIndex = 0; slotIndex < _aliasSlots.size(); ++slotIndex) {
+			auto& slot = _aliasSlots[slotIndex];
+			if (slot.lastUse < firstUse && slot.key == key) {
+				resource.aliasSlot = static_cast<int32_t>(slotIndex);
+				slot.lastUse = lastUse;
+				break;
+			}
+		}
+		if (resource.aliasSlot == invalidAliasSlot()) {
+			resource.aliasSlot = static_cast<int32_t>(_aliasSlots.size());
+			_aliasSlots.push_back({ key, lastUse });
+		}
+		// @note: Aliased image begins with an undefined layout in the owner pass,
+		// the external subpass dependency of the owner orders it after the previous user.
+	}
+}
+
+inline void AfterglowRenderGraph::appendBarrier(
+	const AttachmentUse& srcUse,
+	const AttachmentUse& dstUse,
+	render::PassUnorderedMap<img::ImageReferences>& allPassImages
+) {
+	auto& srcPass = *_passNodes[srcUse.passIndex].pass;
+	const auto& srcAttachment = attachment(srcUse);
+	const auto& dstAttachment = attachment(dstUse);
+	bool depth = srcPass.subpassContext().isDepthAttachmentIndex(srcUse.attachmentIndex);
+	bool written = stored(srcAttachment);
+
+	VkImageLayout newLayout = dstAttachment.initialLayout;
+	if (newLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
+		newLayout = depth ? AfterglowSubpassContext::depthAttachmentRWLayout() : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	}
+	// Read after read in the same layout, nothing to wait.
+	if (!written && srcAttachment.finalLayout == newLayout) {
+		return;
+	}
+
+	// Imported attachment is sampled by the pass set, and also loaded as an attachment if required.
+	VkAccessFlags dstAccess = VK_ACCESS_SHADER_READ_BIT;
+	VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	if (dstAttachment.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD || dstAttachment.stencilLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD) {
+		if (depth) {
+			dstAccess |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			dstStage |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		}
+		else {
+			dstAccess |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			dstStage |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		}
+	}
+
+	VkAccessFlags srcAccess = VK_ACCESS_NONE;
+	if (written) {
+		srcAccess = depth ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	}
+	VkPipelineStageFlags srcStage = depth ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+	VkImageAspectFlags aspect = depth ? (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT) : VK_IMAGE_ASPECT_COLOR_BIT;
+	srcPass.appendBarrier(
+		VkImageMemoryBarrier{
+			.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+			.srcAccessMask = srcAccess,
+			.dstAccessMask = dstAccess,
+			.oldLayout = srcAttachment.finalLayout,
+			.newLayout = newLayout,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.image = allPassImages.at(&srcPass)[srcUse.attachmentIndex].image,
+			.subresourceRange = { aspect, 0, 1, 0, 1 },
+		},
+		srcStage,
+		dstStage
+	);
+	++_barrierCount;
+}
+
+inline const VkAttachmentDescription& AfterglowRenderGraph::attachment(const AttachmentUse& use) const {
+	return _passNodes[use.passIndex].pass->subpassContext().attachments()[use.attachmentIndex];
+}
+
+inline int32_t AfterglowRenderGraph::lastWriterIndex(uint32_t resourceIndex, uint32_t passIndex) const {
+	auto& uses = _resources[resourceIndex].uses;
+	for (auto iterator = uses.rbegin(); iterator != uses.rend(); ++iterator) {
+		if (iterator->passIndex < passIndex && stored(attachment(*iterator))) {
+			return static_cast<int32_t>(iterator->passIndex);
+		}
+	}
+	return -1;
+}
+
+inline bool AfterglowRenderGraph::stored(const VkAttachmentDescription& attachment) noexcept {
+	return attachment.storeOp == VK_ATTACHMENT_STORE_OP_STORE || attachment.stencilStoreOp == VK_ATTACHMENT_STORE_OP_STORE;
+}
+
+inline AfterglowRenderGraph::AliasKey AfterglowRenderGraph::makeAliasKey(AfterglowPassInterface& pass, uint32_t attachmentIndex) {
+	const auto& attachment = pass.subpassContext().attachments()[attachmentIndex];
+	AliasKey key{
+		.format = attachment.format,
+		.samples = attachment.samples,
+		.depth = pass.subpassContext().isDepthAttachmentIndex(attachmentIndex) != 0,
+		.sampled = pass.isSampledAttachment(attachmentIndex),
+		.extentMode = pass.extentMode(),
+		.scale = { 0.0f, 0.0f },
+		.extent = { 0, 0 }
+	};
+	if (key.extentMode == AfterglowPassInterface::ExtentMode::Fixed) {
+		key.extent = pass.extent();
+	}
+	else {
+		key.scale = pass.scale();
+	}
+	return key;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <vector>
+#include "AfterglowPassInterface.h"
+#include "AfterglowImage.h"
+
+class AfterglowPassManager;
+class AfterglowPassSetBase;
+
+/**
+* @brief: Render graph which is built from the import and export attachments that passes declared.
+* @desc:
+*	Imported attachments are the reads of a pass, stored attachments are the writes of a pass.
+*	Passes are executed in order of AfterglowPassManager::forEachPass(), the graph decides:
+*		Culling: passes whose writes were never read by the final pass (directly or indirectly) are culled.
+*		Barriers: one barrier between two adjacent uses of an attachment, read after read in the same layout is skipped.
+*		Aliasing: attachments with the same image description and non-overlapping lifetimes share one image.
+*/
+class AfterglowRenderGraph : public AfterglowObject {
+public:
+	constexpr static inline int32_t invalidAliasSlot() noexcept { return -1; }
+
+	// @brief: Rebuild passes, resources and alias slots, invoke it after all custom pass sets were installed.
+	void compile(AfterglowPassManager& passManager);
+	// @brief: Rebuild barriers of all executed passes, invoke it after attachment images were recreated.
+	void recreateBarriers(render::PassUnorderedMap<img::ImageReferences>& allPassImages);
+
+	bool culled(AfterglowPassInterface& pass) const;
+	// @return: true if all passes of this pass set were culled.
+	bool culled(AfterglowPassSetBase& passSet) const;
+
+	// @return: Alias slot of an attachment that owns its image, invalidAliasSlot() if the attachment is imported or presented.
+	int32_t aliasSlot(AfterglowPassInterface& pass, uint32_t attachmentIndex) const;
+	uint32_t aliasSlotCount() const noexcept;
+	AfterglowPassInterface::ExtentMode aliasSlotExtentMode(uint32_t aliasSlot) const;
+
+	inline uint32_t passCount() const noexcept { return static_cast<uint32_t>(_passNodes.size()); }
+	inline uint32_t culledPassCount() const noexcept { return _culledPassCount; }
+	inline uint32_t resourceCount() const noexcept { return static_cast<uint32_t>(_resources.size()); }
+	inline uint32_t barrierCount() const noexcept { return _barrierCount; }
+
+private:
+	struct AttachmentUse {
+		uint32_t passIndex;
+		uint32_t attachmentIndex;
+	};
+
+	// Physical attachment, imported attachments share the resource of their source pass.
+	struct Resource {
+		// Uses in execution order, the first one is the owner which creates the image.
+		std::vector<AttachmentUse> uses;
+		int32_t aliasSlot = invalidAliasSlot();
+	};
+
+	struct PassNode {
+		AfterglowPassInterface* pass = nullptr;
+		// Resource index of each attachment.
+		std::vector<uint32_t> attachmentResources;
+		bool culled = true;
+	};
+
+	// Attachments could share an image only if their images are created identically.
+	struct AliasKey {
+		VkFormat format;
+		VkSampleCountFlagBits samples;
+		bool depth;
+		bool sampled;
+		AfterglowPassInterface::ExtentMode extentMode;
+		glm::vec2 scale;
+		glm::u32vec2 extent;
+
+		bool operator==(const AliasKey& other) const = default;
+	};
+
+	struct AliasSlot {
+		AliasKey key;
+		uint32_t lastUse;
+	};
+
+	inline void appendPassNode(AfterglowPassManager& passManager, AfterglowPassInterface& pass);
+	inline void cullPasses(AfterglowPassManager& passManager);
+	inline void assignAliasSlots();
+	inline void appendBarrier(const AttachmentUse& srcUse, const AttachmentUse& dstUse, render::PassUnorderedMap<img::ImageReferences>& allPassImages);
+
+	inline const VkAttachmentDescription& attachment(const AttachmentUse& use) const;
+	// @return: Pass index of the last use which stored this resource before the pass, -1 if not found.
+	inline int32_t lastWriterIndex(uint32_t resourceIndex, uint32_t passIndex) const;
+
+	static inline bool stored(const VkAttachmentDescription& attachment) noexcept;
+	static inline AliasKey makeAliasKey(AfterglowPassInterface& pass, uint32_t attachmentIndex);
+
+	std::vector<PassNode> _passNodes;
+	std::vector<Resource> _resources;
+	std::vector<AliasSlot> _aliasSlots;
+	render::PassUnorderedMap<uint32_t> _passIndices;
+
+	uint32_t _culledPassCount = 0;
+	uint32_t _barrierCount = 0;
+};
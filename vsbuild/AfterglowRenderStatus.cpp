@@ -28,6 +28,50 @@ void AfterglowRenderStatus::setMaximumFPS(float fps) noexcept {
 	_impl->renderer.ticker().setMaximumFPS(fps);
 }
 
+render::FrameLoopMode AfterglowRenderStatus::frameLoopMode() const noexcept {
+	return _impl->renderer.frameLoopMode();
+}
+
+void AfterglowRenderStatus::setFrameLoopMode(render::FrameLoopMode mode) noexcept {
+	_impl->renderer.setFrameLoopMode(mode);
+}
+
+float AfterglowRenderStatus::frameTime() const noexcept {
+	return _impl->renderer.frameTimeCounters().frameTime;
+}
+
+float AfterglowRenderStatus::recordTime() const noexcept {
+	return _impl->renderer.frameTimeCounters().recordTime;
+}
+
+float AfterglowRenderStatus::waitTime() const noexcept {
+	return _impl->renderer.frameTimeCounters().waitTime;
+}
+
+uint32_t AfterglowRenderStatus::drawCount() const noexcept {
+	return _impl->renderer.bindCounters().draws;
+}
+
+uint32_t AfterglowRenderStatus::instanceCount() const noexcept {
+	return _impl->renderer.bindCounters().instances;
+}
+
+uint32_t AfterglowRenderStatus::pipelineBindCount() const noexcept {
+	return _impl->renderer.bindCounters().pipelineBinds;
+}
+
+uint32_t AfterglowRenderStatus::descriptorSetBindCount() const noexcept {
+	return _impl->renderer.bindCounters().descriptorSetBinds;
+}
+
+uint32_t AfterglowRenderStatus::vertexBufferBindCount() const noexcept {
+	return _impl->renderer.bindCounters().vertexBufferBinds;
+}
+
+uint32_t AfterglowRenderStatus::indexBufferBindCount() const noexcept {
+	return _impl->renderer.bindCounters().indexBufferBinds;
+}
+
 const char* AfterglowRenderStatus::deviceName() noexcept {
 	return _impl->renderer.physicalDeviceProperties().deviceName;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "Inreflect.h"
+#include "RenderDefinitions.h"
 
 class AfterglowRenderer;
 
@@ -38,6 +39,22 @@ public:
 
 	void setMaximumFPS(float fps) noexcept;
 
+	render::FrameLoopMode frameLoopMode() const noexcept;
+	void setFrameLoopMode(render::FrameLoopMode mode) noexcept;
+
+	// Unit: Milliseconds
+	float frameTime() const noexcept;
+	float recordTime() const noexcept;
+	float waitTime() const noexcept;
+
+	// Last frame draw commands, redundant binds are excluded.
+	uint32_t drawCount() const noexcept;
+	uint32_t instanceCount() const noexcept;
+	uint32_t pipelineBindCount() const noexcept;
+	uint32_t descriptorSetBindCount() const noexcept;
+	uint32_t vertexBufferBindCount() const noexcept;
+	uint32_t indexBufferBindCount() const noexcept;
+
 	const char* deviceName() noexcept;
 
 	inline void INVALID_PARAM_TEST(uint8_t u8) {}
@@ -55,6 +72,17 @@ INR_CLASS(AfterglowRenderStatus) {
 		INR_FUNC(fps), 
 		INR_FUNC(maximumFPS),
 		INR_FUNC(setMaximumFPS), 
+		INR_FUNC(frameLoopMode), 
+		INR_FUNC(setFrameLoopMode), 
+		INR_FUNC(frameTime), 
+		INR_FUNC(recordTime), 
+		INR_FUNC(waitTime), 
+		INR_FUNC(drawCount), 
+		INR_FUNC(instanceCount), 
+		INR_FUNC(pipelineBindCount), 
+		INR_FUNC(descriptorSetBindCount), 
+		INR_FUNC(vertexBufferBindCount), 
+		INR_FUNC(indexBufferBindCount), 
 		INR_FUNC(deviceName), 
 		INR_FUNC(INVALID_PARAM_TEST), 
 		INR_FUNC(POINTER_PARAM_TEST), 
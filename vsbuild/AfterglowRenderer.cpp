@@ -1,6 +1,13 @@
 #include "AfterglowRenderer.h"
 
 #include <limits>
+#include <array>
+#include <tuple>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <iostream>
 #include <imgui.h>
 
 #include "Configurations.h"
@@ -16,6 +23,7 @@
 #include "AfterglowPassManager.h"
 #include "AfterglowFramebufferManager.h"
 #include "AfterglowCommandManager.h"
+#include "AfterglowUploadContext.h"
 #include "AfterglowMeshManager.h"
 #include "AfterglowAssetMonitor.h"
 #include "AfterglowMaterialManager.h"
@@ -33,15 +41,61 @@
 #include "ExceptionUtilities.h"
 #include "AfterglowTicker.h"
 #include "LocalClock.h"
+#include "AfterglowShaderModule.h"
+#include "AllocationAudit.h"
 
 struct AfterglowRenderer::Impl {
-	Impl(AfterglowRenderer& inRenderer, AfterglowWindow& inWindow);
+	// Frame time statistics for headless benchmark.
+	struct HeadlessStatistics {
+		uint32_t frameCount = 0;
+		uint64_t totalFrameTime = 0; // Unit::Microseconds
+		uint64_t minFrameTime = std::numeric_limits<uint64_t>::max();
+		uint64_t maxFrameTime = 0;
+	};
+
+	// Heap allocations of named threads in headless benchmark, fixed size to avoid allocating by itself.
+	struct AllocationAuditStatistics {
+		using ThreadAllocationArray = std::array<audit::ThreadAllocations, audit::maxThreadCount>;
+
+		ThreadAllocationArray frameBeginAllocations{};
+		uint32_t frameBeginThreadCount = 0;
+		// Max allocation count in a single frame of each thread.
+		ThreadAllocationArray worstFrameAllocations{};
+		uint32_t allocatingFrameCount = 0;
+		bool failed = false;
+	};
+
+	// Draw of instancing material, merged with other draws which share mesh buffers and material instance.
+	struct InstancedDraw {
+		AfterglowMaterialResource* matResource;
+		AfterglowDescriptorSetReferences* setRefs;
+		AfterglowVertexBufferHandle* vertexBufferHandle;
+		AfterglowIndexBuffer* indexBuffer;
+		uint32_t instanceCount;
+		float depth;
+		ubo::ObjectInstance objectInstance;
+	};
+
+	using FrameTimePoint = std::chrono::high_resolution_clock::time_point;
+
+	Impl(AfterglowRenderer& inRenderer, AfterglowWindow& inWindow, const launch::Options& inOptions);
 	void lateInitialize();
 
 	void renderLoop(std::stop_token stopToken);
 	void draw();
 	void prepareNextFrameContext();
 
+	inline bool headless() const noexcept;
+	// @brief: Block until the GPU released the frame slot, returns blocked time.
+	inline float waitFrameSlot(uint32_t frameIndex);
+	inline void updateFrameTimeCounters(FrameTimePoint frameBegin, float waitTime);
+	// @brief: Count rendered frames and close the window when the frame count was reached.
+	inline void finishHeadlessFrame();
+	inline void beginFrameAllocationAudit() noexcept;
+	// @brief: Compare allocation counters with the frame begin, the first cfg::allocationAuditWarmupFrames are ignored.
+	inline void endFrameAllocationAudit() noexcept;
+	inline void outputAllocationAudit();
+
 	void submitMeshUniforms();
 
 	void recordDraws();
@@ -49,6 +103,11 @@ struct AfterglowRenderer::Impl {
 
 	template<reg::RenderableComponentType Type>
 	inline bool recordDraw(const Type& renderableComponent, const std::string& materialName, uint32_t meshIndex);
+	// @brief: Normalized distance from camera, for draw sorting.
+	template<reg::RenderableComponentType Type>
+	inline float drawDepth(const Type& renderableComponent) const;
+	// @brief: Merge instanced draws and upload their object instances.
+	inline void recordInstancedDraws();
 	inline bool recordComputeDraw(const std::string& materialName, const ubo::MeshUniform& meshUniform);
 	inline void recordDispatch(const std::string& materialName, const ubo::MeshUniform& meshUniform);
 
@@ -60,6 +119,23 @@ struct AfterglowRenderer::Impl {
 	inline void updateGlobalUniformFrustumPlanes() noexcept;
 
 	AfterglowWindow& window;
+	launch::Options options;
+	HeadlessStatistics headlessStatistics;
+	AllocationAuditStatistics allocationAuditStatistics;
+
+	std::atomic<render::FrameLoopMode> frameLoopMode;
+	// Renderer thread writes, UI thread reads.
+	mutable std::mutex statisticsMutex;
+	render::FrameTimeCounters frameTimeCounters;
+	render::BindCounters bindCounters;
+
+	// Updated before recording draws.
+	glm::vec3 drawSortOrigin = glm::vec3(0.0f);
+	float invDrawSortDistance = 0.0f;
+
+	// Cleared every frame, keep capacities.
+	std::vector<InstancedDraw> instancedDraws;
+	std::vector<ubo::ObjectInstance> objectInstances;
 
 	std::unique_ptr<std::jthread> renderThread;
 
@@ -72,16 +148,21 @@ struct AfterglowRenderer::Impl {
 
 	AfterglowInstance::AsElement instance;
 	AfterglowDebugMessenger::AsElement debugMessenger;
+	// Surface, swapchain and presentQueue are not exist in headless mode.
 	AfterglowSurface::AsElement surface;
 	AfterglowPhysicalDevice::AsElement physicalDevice;
 	AfterglowDevice::AsElement device;
 	std::unique_ptr<AfterglowComputeQueue> computeQueue;
+	// Dedicated compute queue family, nullptr if async compute is not enabled.
+	std::unique_ptr<AfterglowComputeQueue> asyncComputeQueue;
 	std::unique_ptr<AfterglowGraphicsQueue> graphicsQueue;
 	std::unique_ptr<AfterglowPresentQueue> presentQueue;
 	AfterglowSwapchain::AsElement swapchain;
 	std::unique_ptr<AfterglowPassManager> passManager;
 	std::unique_ptr<AfterglowFramebufferManager> framebufferManager;
 	std::unique_ptr<AfterglowCommandManager> commandManager;
+	// Shared by mesh and material managers, so it is destructed after them.
+	std::unique_ptr<AfterglowUploadContext> uploadContext;
 	std::unique_ptr<AfterglowMeshManager> meshManager;
 	std::unique_ptr<AfterglowMaterialManager> materialManager;
 	std::unique_ptr<AfterglowSynchronizer> synchronizer;
@@ -90,8 +171,8 @@ struct AfterglowRenderer::Impl {
 };
 
 
-AfterglowRenderer::AfterglowRenderer(AfterglowWindow& window) : 
-	_impl(std::make_unique<Impl>(*this, window)) {
+AfterglowRenderer::AfterglowRenderer(AfterglowWindow& window, const launch::Options& options) : 
+	_impl(std::make_unique<Impl>(*this, window, options)) {
 	// TODO: Init commands, e.g. Look up table.
 }
 
@@ -135,11 +216,37 @@ const VkPhysicalDeviceProperties& AfterglowRenderer::physicalDeviceProperties()
 }
 
 float AfterglowRenderer::aspectRatio() const noexcept {
-	return (*_impl->swapchain).aspectRatio();
+	return _impl->framebufferManager->aspectRatio();
+}
+
+render::FrameLoopMode AfterglowRenderer::frameLoopMode() const noexcept {
+	return _impl->frameLoopMode.load();
+}
+
+void AfterglowRenderer::setFrameLoopMode(render::FrameLoopMode mode) noexcept {
+	if (mode == render::FrameLoopMode::EnumCount) {
+		return;
+	}
+	_impl->frameLoopMode.store(mode);
 }
 
-AfterglowRenderer::Impl::Impl(AfterglowRenderer& inRenderer, AfterglowWindow& inWindow) :
-	window(inWindow) {
+render::FrameTimeCounters AfterglowRenderer::frameTimeCounters() const noexcept {
+	std::lock_guard lock(_impl->statisticsMutex);
+	return _impl->frameTimeCounters;
+}
+
+render::BindCounters AfterglowRenderer::bindCounters() const noexcept {
+	std::lock_guard lock(_impl->statisticsMutex);
+	return _impl->bindCounters;
+}
+
+bool AfterglowRenderer::benchmarkPassed() const noexcept {
+	return !_impl->allocationAuditStatistics.failed;
+}
+
+AfterglowRenderer::Impl::Impl(AfterglowRenderer& inRenderer, AfterglowWindow& inWindow, const launch::Options& inOptions) :
+	window(inWindow), options(inOptions), frameLoopMode(inOptions.frameLoopMode) {
+	audit::SetEnabled(options.allocationAudit);
 	// Make sure the same vulkan environment is used in different devices.
 	_putenv_s("VK_LAYER_PATH", cfg::layerPath);
 
@@ -152,28 +259,44 @@ AfterglowRenderer::Impl::Impl(AfterglowRenderer& inRenderer, AfterglowWindow& in
 		debugMessenger.recreate(instance);
 	}
 
-	surface.recreate(instance, window);
-	physicalDevice.recreate(instance, surface);
+	if (!headless()) {
+		surface.recreate(instance, window);
+	}
+	physicalDevice.recreate(instance, surface.raw().get());
 	device.recreate(physicalDevice);
 
 	// Initialize queues
 	computeQueue = std::make_unique<AfterglowComputeQueue>(device);
+	// Device is created by queue, async compute state is available from now.
+	if ((*device).asyncComputeEnabled()) {
+		asyncComputeQueue = std::make_unique<AfterglowComputeQueue>(device, (*device).physicalDevice().asyncComputeFamilyIndex());
+	}
 	graphicsQueue = std::make_unique<AfterglowGraphicsQueue>(device);
-	presentQueue = std::make_unique<AfterglowPresentQueue>(device);
+	if (!headless()) {
+		presentQueue = std::make_unique<AfterglowPresentQueue>(device);
+	}
 
 	synchronizer = std::make_unique<AfterglowSynchronizer>(device);
 
-	swapchain.recreate(device, window, surface);
 	passManager = std::make_unique<AfterglowPassManager>(device);
 
-	framebufferManager = std::make_unique<AfterglowFramebufferManager>(*passManager, swapchain);
+	if (headless()) {
+		framebufferManager = std::make_unique<AfterglowFramebufferManager>(
+			*passManager, device, VkExtent2D{ options.width, options.height }
+		);
+	}
+	else {
+		swapchain.recreate(device, window, surface);
+		framebufferManager = std::make_unique<AfterglowFramebufferManager>(*passManager, swapchain);
+	}
 	commandManager = std::make_unique<AfterglowCommandManager>(*passManager);
 	auto& commandPool = commandManager->commandPool();
+	uploadContext = std::make_unique<AfterglowUploadContext>(device, *graphicsQueue);
 
-	meshManager = std::make_unique<AfterglowMeshManager>(commandPool, *graphicsQueue, *synchronizer);
+	meshManager = std::make_unique<AfterglowMeshManager>(commandPool, *uploadContext, *synchronizer);
 
 	materialManager = std::make_unique<AfterglowMaterialManager>(
-		commandPool, *graphicsQueue, *passManager, assetMonitor, *synchronizer
+		commandPool, *uploadContext, *passManager, assetMonitor, *synchronizer
 	);
 
 	renderStatus = std::make_unique<AfterglowRenderStatus>(inRenderer);
@@ -201,6 +324,10 @@ void AfterglowRenderer::Impl::lateInitialize() {
 	framebufferManager->recreateAllFramebuffers(); // RenderPass::create() be triggered here. 
 	commandManager->installFixedPasses();
 	materialManager->initGlobalDescriptorSets(framebufferManager->imageReferences());
+	// Nothing to be seen in headless mode, so UI is skipped.
+	if (headless()) {
+		return;
+	}
 	ui->bindRenderContext(
 		instance,
 		device,
@@ -213,12 +340,29 @@ void AfterglowRenderer::Impl::lateInitialize() {
 }
 
 void AfterglowRenderer::Impl::renderLoop(std::stop_token stopToken) {
+	audit::RegisterThread("Render");
 	while (!window.shouldClose() && !stopToken.stop_requested()) {
 		draw();
 	}
 }
 
 void AfterglowRenderer::Impl::draw() {
+	auto frameBegin = std::chrono::high_resolution_clock::now();
+	beginFrameAllocationAudit();
+	// Fixed in the whole frame even if it was changed by UI thread.
+	const bool pipelined = (frameLoopMode.load() == render::FrameLoopMode::Pipelined);
+	float waitTime = 0.0f;
+
+	/**
+	* @note: Slot mapping
+	*	Per frame uniforms and descriptor sets are written with currentFrameIndex before prepareNextFrameContext(),
+	*	but command buffers and fences are used after it, so both of them belong to nextFrameIndex.
+	*	In pipelined mode, wait for this slot only, GPU keeps executing the previous frame while CPU is recording.
+	*/
+	if (pipelined) {
+		waitTime += waitFrameSlot((*device).nextFrameIndex());
+	}
+
 	// DEBUG_COST_BEGIN("UIContext");
 	// Evaluate UI.
 	commandManager->recordUIDraw(ui->update());
@@ -261,14 +405,24 @@ void AfterglowRenderer::Impl::draw() {
 		renderer.commandManager->applyComputeCommands();
 	}, *this);
 
+	// Uploads of this frame are submitted ahead of compute and graphics, they share the graphics queue.
+	// Async compute queue does not wait for the graphics queue of this frame, so it waits for uploads on CPU instead.
+	if (uploadContext->flush() && asyncComputeQueue) {
+		uploadContext->wait();
+	}
+
 	synchronizer->reset(AfterglowSynchronizer::FenceFlag::ComputeInFlight);
 	computeQueue->submit(commandManager->computeCommandBuffers(), *synchronizer);
+	if (asyncComputeQueue && commandManager->asyncComputeApplied()) {
+		asyncComputeQueue->submitAsync(commandManager->asyncComputeCommandBuffers(), *synchronizer);
+	}
 	// DEBUG_COST_END;
 
 	// Render Submission: 
 	if (!window.drawable()) {
 		// TODO: Optional compute task type for window relativity.
 		computeQueue->cancelSemaphore(*synchronizer);
+		updateFrameTimeCounters(frameBegin, waitTime);
 		return;
 	}
 
@@ -276,6 +430,7 @@ void AfterglowRenderer::Impl::draw() {
 	if (imageIndex == AfterglowFramebufferManager::AcquireState::Invalid) {
 		// If have not graphics queue respond, cancel the compute queue semaphore.
 		computeQueue->cancelSemaphore(*synchronizer);
+		updateFrameTimeCounters(frameBegin, waitTime);
 		return;
 	}
 
@@ -291,19 +446,30 @@ void AfterglowRenderer::Impl::draw() {
 		renderer.commandManager->applyDrawCommands(imageIndex);
 		// DEBUG_COST_END;
 	}, *this, imageIndex);
+	{
+		std::lock_guard lock(statisticsMutex);
+		bindCounters = commandManager->bindCounters();
+	}
 
 	// @note: Processing task before waitting GPU as much as possible.
 
 	// Wait is cost, wait it as late as much as possible.
 	// DEBUG_COST_BEGIN("WaitGPU");
-	synchronizer->wait(AfterglowSynchronizer::FenceFlag::ComputeInFlight);
-	synchronizer->wait(AfterglowSynchronizer::FenceFlag::RenderInFlight);
+	if (!pipelined) {
+		waitTime += waitFrameSlot((*device).currentFrameIndex());
+	}
 	// DEBUG_COST_END;
+	updateFrameTimeCounters(frameBegin, waitTime);
 
 	// DEBUG_COST_BEGIN("SubmitPresent");
 	synchronizer->reset(AfterglowSynchronizer::FenceFlag::RenderInFlight);
-	graphicsQueue->submit(commandManager->drawCommandBuffers(), *synchronizer);
-	presentQueue->submit(window, *framebufferManager, *synchronizer, imageIndex);
+	graphicsQueue->submit(commandManager->drawCommandBuffers(), *synchronizer, !headless());
+	if (headless()) {
+		finishHeadlessFrame();
+	}
+	else {
+		presentQueue->submit(window, *framebufferManager, *synchronizer, imageIndex);
+	}
 	// DEBUG_COST_END;
 }
 
@@ -326,6 +492,131 @@ void AfterglowRenderer::Impl::prepareNextFrameContext() {
 	ticker.tick();
 }
 
+inline bool AfterglowRenderer::Impl::headless() const noexcept {
+	return options.headless;
+}
+
+inline float AfterglowRenderer::Impl::waitFrameSlot(uint32_t frameIndex) {
+	auto waitBegin = std::chrono::high_resolution_clock::now();
+	synchronizer->wait(AfterglowSynchronizer::FenceFlag::ComputeInFlight, frameIndex);
+	synchronizer->wait(AfterglowSynchronizer::FenceFlag::RenderInFlight, frameIndex);
+	synchronizer->wait(
+		AfterglowSynchronizer::TimelineFlag::AsyncCompute, 
+		synchronizer->frameValue(AfterglowSynchronizer::TimelineFlag::AsyncCompute, frameIndex)
+	);
+	return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - waitBegin).count();
+}
+
+inline void AfterglowRenderer::Impl::updateFrameTimeCounters(FrameTimePoint frameBegin, float waitTime) {
+	// Exponential moving average, make counters readable in UI.
+	constexpr float smoothFactor = 0.1f;
+	auto smooth = [](float& counter, float sample) {
+		counter = (counter == 0.0f) ? sample : counter + (sample - counter) * smoothFactor;
+	};
+	// Ticker sleeping is excluded, it's included in frameTime only.
+	float cpuTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - frameBegin).count();
+
+	std::lock_guard lock(statisticsMutex);
+	smooth(frameTimeCounters.frameTime, static_cast<float>(ticker.clock().deltaTimeSec() * 1000.0));
+	smooth(frameTimeCounters.recordTime, std::max(cpuTime - waitTime, 0.0f));
+	smooth(frameTimeCounters.waitTime, waitTime);
+}
+
+inline void AfterglowRenderer::Impl::finishHeadlessFrame() {
+	endFrameAllocationAudit();
+	auto& statistics = headlessStatistics;
+	// The first frame includes pipeline and resource initialization, exclude it from statistics.
+	if (statistics.frameCount > 0) {
+		uint64_t frameTime = ticker.clock().deltaTime<unit::Microseconds>();
+		statistics.totalFrameTime += frameTime;
+		statistics.minFrameTime = std::min(statistics.minFrameTime, frameTime);
+		statistics.maxFrameTime = std::max(statistics.maxFrameTime, frameTime);
+	}
+	++statistics.frameCount;
+
+	if (options.frameCount == 0 || statistics.frameCount < options.frameCount) {
+		return;
+	}
+	// Benchmark result should be visible in release build too, so output it directly.
+	if (statistics.frameCount > 1) {
+		uint32_t sampleCount = statistics.frameCount - 1;
+		auto counters = frameTimeCounters;
+		std::cout << std::format(
+			"[AfterglowRenderer] Headless {}x{}, {} frames, {} loop, frame time (us): avg {}, min {}, max {}, "
+			"record/wait (ms): {:.3f}/{:.3f}\n",
+			options.width, options.height, statistics.frameCount, 
+			inreflect::EnumName(frameLoopMode.load()),
+			statistics.totalFrameTime / sampleCount, statistics.minFrameTime, statistics.maxFrameTime, 
+			counters.recordTime, counters.waitTime
+		);
+	}
+	auto spirvCacheStatistics = AfterglowShaderModule::spirvCache().statistics();
+	std::cout << std::format(
+		"[AfterglowRenderer] Spirv cache hit/miss: {}/{}, evicted: {}, entries: {}, size (KB): {}\n", 
+		spirvCacheStatistics.hitCount, spirvCacheStatistics.missCount, spirvCacheStatistics.evictionCount, 
+		spirvCacheStatistics.entryCount, spirvCacheStatistics.totalSize / 1024
+	);
+	outputAllocationAudit();
+	if (options.shaderCompileBenchmarkIterations > 0) {
+		materialManager->benchmarkShaderCompilation(options.shaderCompileBenchmarkIterations);
+	}
+	window.requestClose();
+}
+
+inline void AfterglowRenderer::Impl::beginFrameAllocationAudit() noexcept {
+	if (!options.allocationAudit) {
+		return;
+	}
+	auto& statistics = allocationAuditStatistics;
+	statistics.frameBeginThreadCount = audit::Snapshot(statistics.frameBeginAllocations);
+}
+
+inline void AfterglowRenderer::Impl::endFrameAllocationAudit() noexcept {
+	if (!options.allocationAudit || headlessStatistics.frameCount < cfg::allocationAuditWarmupFrames) {
+		return;
+	}
+	auto& statistics = allocationAuditStatistics;
+	AllocationAuditStatistics::ThreadAllocationArray frameEndAllocations;
+	uint32_t threadCount = audit::Snapshot(frameEndAllocations);
+
+	bool allocated = false;
+	// Unnamed counter (index 0) is shared by the system thread and others, it's not audited.
+	for (uint32_t index = 1; index < threadCount; ++index) {
+		// Threads registered in this frame begin from zero.
+		uint64_t beginCount = index < statistics.frameBeginThreadCount ? statistics.frameBeginAllocations[index].count : 0;
+		uint64_t frameAllocationCount = frameEndAllocations[index].count - beginCount;
+		auto& worst = statistics.worstFrameAllocations[index];
+		worst.threadName = frameEndAllocations[index].threadName;
+		worst.count = std::max(worst.count, frameAllocationCount);
+		allocated |= (frameAllocationCount > 0);
+	}
+	if (allocated) {
+		++statistics.allocatingFrameCount;
+		statistics.failed = true;
+	}
+}
+
+inline void AfterglowRenderer::Impl::outputAllocationAudit() {
+	if (!options.allocationAudit) {
+		return;
+	}
+	auto& statistics = allocationAuditStatistics;
+	uint32_t auditedFrameCount = headlessStatistics.frameCount - std::min(headlessStatistics.frameCount, cfg::allocationAuditWarmupFrames);
+	if (!statistics.failed) {
+		std::cout << std::format("[AfterglowRenderer] Allocation audit PASSED, {} steady state frames without heap allocation.\n", auditedFrameCount);
+		return;
+	}
+	std::cout << std::format(
+		"[AfterglowRenderer] Allocation audit FAILED, {}/{} steady state frames allocated heap memory.\n", 
+		statistics.allocatingFrameCount, auditedFrameCount
+	);
+	for (const auto& worst : statistics.worstFrameAllocations) {
+		if (worst.threadName && worst.count > 0) {
+			std::cout << std::format("\t{}: up to {} allocations per frame.\n", worst.threadName, worst.count);
+		}
+	}
+}
+
 void AfterglowRenderer::Impl::submitMeshUniforms() {
 	renderableContext->componentPool.forEachTypeComponents([this]<typename ComponentType>(){
 		if constexpr (reg::RenderableComponentType<ComponentType>) {
@@ -355,6 +646,10 @@ void AfterglowRenderer::Impl::submitMeshUniforms() {
 }
 
 void AfterglowRenderer::Impl::recordDraws() {
+	auto& camera = *renderableContext->camera;
+	drawSortOrigin = camera.entity().get<AfterglowTransformComponent>().globalTranslation();
+	invDrawSortDistance = camera.far() > 0.0f ? 1.0f / camera.far() : 0.0f;
+
 	renderableContext->componentPool.forEachTypeComponents([this]<typename ComponentType>(){
 		if constexpr (reg::RenderableComponentType<ComponentType>) {
 			auto& renderables = renderableContext->componentPool.components<ComponentType>();
@@ -363,6 +658,8 @@ void AfterglowRenderer::Impl::recordDraws() {
 				if (!renderable.shouldDraw()) {
 					continue;
 				}
+				// Evicted meshes have no sub mesh, stamp them before drawing so they are re-streamed.
+				meshManager->markUsed(*renderable.meshResource());
 				for (uint32_t drawIndex = 0; drawIndex < renderable.drawCount(); ++drawIndex) {
 					for (uint32_t slotID = 0; slotID < renderable.meshResource()->indexBuffers().size(); ++slotID) {
 						auto& materialName = renderable.materialName(slotID, drawIndex);
@@ -380,6 +677,7 @@ void AfterglowRenderer::Impl::recordDraws() {
 			}
 		}
 	});
+	recordInstancedDraws();
 
 	// Record compute meshes' draw.
 	auto& computeComponents = renderableContext->componentPool.components<AfterglowComputeComponent>();
@@ -443,6 +741,19 @@ inline bool AfterglowRenderer::Impl::recordDraw(const Type& renderableComponent,
 	uint32_t instanceCount = renderableComponent.instanceCount();
 	AfterglowStorageBuffer* indirectBuffer = nullptr;
 	auto& material = matResource->materialLayout().material();
+	if (material.instancing()) {
+		auto& meshUniform = meshResource.meshUniform();
+		instancedDraws.emplace_back(
+			matResource, 
+			setRefs, 
+			&meshResource.vertexBufferHandles()[meshIndex], 
+			&*meshResource.indexBuffers()[meshIndex], 
+			instanceCount, 
+			drawDepth(renderableComponent), 
+			ubo::ObjectInstance{ meshUniform.model, meshUniform.invTransModel, meshUniform.objectID }
+		);
+		return true;
+	}
 	if (material.hasComputeTask()) {
 		// Compute instance count first if it's not default.
 		uint32_t computeInstanceCount = material.computeTask().instanceCount();
@@ -458,11 +769,57 @@ inline bool AfterglowRenderer::Impl::recordDraw(const Type& renderableComponent,
 		meshResource.vertexBufferHandles()[meshIndex], 
 		&*meshResource.indexBuffers()[meshIndex],
 		indirectBuffer, 
-		instanceCount
+		instanceCount, 
+		0, 
+		drawDepth(renderableComponent)
 	);
 	return true;
 }
 
+inline void AfterglowRenderer::Impl::recordInstancedDraws() {
+	objectInstances.clear();
+	// Make mergeable draws adjacent.
+	auto mergeKey = [](const InstancedDraw& draw) {
+		return std::make_tuple(draw.matResource, draw.vertexBufferHandle->buffer, draw.indexBuffer);
+	};
+	std::sort(instancedDraws.begin(), instancedDraws.end(), [&mergeKey](const InstancedDraw& lhs, const InstancedDraw& rhs) {
+		return mergeKey(lhs) < mergeKey(rhs);
+	});
+
+	for (size_t beginIndex = 0; beginIndex < instancedDraws.size();) {
+		auto& firstDraw = instancedDraws[beginIndex];
+		auto firstInstance = static_cast<uint32_t>(objectInstances.size());
+		float depth = firstDraw.depth;
+		size_t endIndex = beginIndex;
+		for (; endIndex < instancedDraws.size() && mergeKey(instancedDraws[endIndex]) == mergeKey(firstDraw); ++endIndex) {
+			auto& draw = instancedDraws[endIndex];
+			// Custom instance count of renderable shares the same object instance, as non-instancing draw does.
+			objectInstances.insert(objectInstances.end(), draw.instanceCount, draw.objectInstance);
+			depth = std::min(depth, draw.depth);
+		}
+		commandManager->recordDraw(
+			*firstDraw.matResource,
+			// Per object sets of instancing draws are same except the mesh uniform, which is not declared in instancing shaders.
+			*firstDraw.setRefs,
+			*firstDraw.vertexBufferHandle,
+			firstDraw.indexBuffer,
+			nullptr,
+			static_cast<uint32_t>(objectInstances.size()) - firstInstance,
+			firstInstance,
+			depth
+		);
+		beginIndex = endIndex;
+	}
+	materialManager->submitObjectInstances(objectInstances);
+	instancedDraws.clear();
+}
+
+template<reg::RenderableComponentType Type>
+inline float AfterglowRenderer::Impl::drawDepth(const Type& renderableComponent) const {
+	auto& transform = renderableComponent.entity().template get<AfterglowTransformComponent>();
+	return glm::distance(drawSortOrigin, transform.globalTranslation()) * invDrawSortDistance;
+}
+
 inline bool AfterglowRenderer::Impl::recordComputeDraw(const std::string& materialName, const ubo::MeshUniform& meshUniform) {
 	auto* matResource = materialManager->materialResource(materialName);
 	if (!matResource) {
@@ -537,7 +894,8 @@ void AfterglowRenderer::Impl::updateGlobalUniform() {
 		globalUniform.dirLightDirection = glm::vec4(directionalLightTransform.globalViewDirection(), diectionalLight->intensity());
 	}
 
-	globalUniform.screenResolution = glm::vec2((*swapchain).extent().width, (*swapchain).extent().height);
+	auto extent = framebufferManager->extent();
+	globalUniform.screenResolution = glm::vec2(extent.width, extent.height);
 	globalUniform.invScreenResolution = glm::vec2(1.0) / globalUniform.screenResolution;
 	globalUniform.cursorPosition = window.input().cursorPosition();
 	// Here replace as render clock instead of logic clock (For uniform shader animation).
@@ -560,7 +918,7 @@ inline void AfterglowRenderer::Impl::updateCamera() {
 		EXCEPT_CLASS_RUNTIME("Not camera exists in the RenderableContext.");
 	}
 	// TODO: bad, thread unsafety, replace it. 
-	camera->setAspectRatio((*swapchain).aspectRatio());
+	camera->setAspectRatio(framebufferManager->aspectRatio());
 	// @deprecated: Move to task thread.
 	// camera->updateMatrices();
 }
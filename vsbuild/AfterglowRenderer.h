@@ -4,6 +4,9 @@
 #include <string>
 #include <memory>
 
+#include "LaunchOptions.h"
+#include "RenderDefinitions.h"
+
 struct AfterglowRenderableContext;
 class AfterglowMaterialManager;
 class AfterglowWindow;
@@ -18,7 +21,7 @@ class AfterglowRenderer {
 public:
 	using RenderMaterials = std::map<std::string, const AfterglowMaterial&>;
 
-	AfterglowRenderer(AfterglowWindow& window);
+	AfterglowRenderer(AfterglowWindow& window, const launch::Options& options = {});
 	~AfterglowRenderer();
 
 	AfterglowMaterialManager& materialManager() noexcept;
@@ -34,6 +37,15 @@ public:
 
 	float aspectRatio() const noexcept;
 
+	render::FrameLoopMode frameLoopMode() const noexcept;
+	// @note: Take effect from the next frame.
+	void setFrameLoopMode(render::FrameLoopMode mode) noexcept;
+	render::FrameTimeCounters frameTimeCounters() const noexcept;
+	// @brief: Draw command counters of the last rendered frame.
+	render::BindCounters bindCounters() const noexcept;
+	// @return: false if the headless benchmark failed, e.g. steady state frames allocated heap memory in allocation audit mode.
+	bool benchmarkPassed() const noexcept;
+
 private:
 	struct Impl;
 	std::unique_ptr<Impl> _impl;
@@ -1,7 +1,10 @@
 #include "AfterglowSemaphores.h"
 
-AfterglowSemaphores::AfterglowSemaphores(AfterglowDevice& device, uint32_t numSemaphores) :
-	AfterglowProxyArray(numSemaphores), _device(device) {
+AfterglowSemaphores::AfterglowSemaphores(AfterglowDevice& device, uint32_t numSemaphores, VkSemaphoreType type) :
+	AfterglowProxyArray(numSemaphores), _device(device), _typeInfo{} {
+	_typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	_typeInfo.semaphoreType = type;
+	_typeInfo.initialValue = 0;
 }
 
 AfterglowSemaphores::~AfterglowSemaphores() {
@@ -14,6 +17,8 @@ AfterglowSemaphores::~AfterglowSemaphores() {
 
 void AfterglowSemaphores::initCreateInfo() {
 	info().sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	// Binary semaphore is the default type, keep the chain empty for it.
+	info().pNext = (_typeInfo.semaphoreType == VK_SEMAPHORE_TYPE_BINARY) ? nullptr : &_typeInfo;
 }
 
 void AfterglowSemaphores::create() {
@@ -4,7 +4,8 @@
 
 class AfterglowSemaphores : public AfterglowProxyArray<AfterglowSemaphores, VkSemaphore, VkSemaphoreCreateInfo> {
 public:
-	AfterglowSemaphores(AfterglowDevice& device, uint32_t numSemaphores);
+	// @param type: Timeline semaphores start from value 0.
+	AfterglowSemaphores(AfterglowDevice& device, uint32_t numSemaphores, VkSemaphoreType type = VK_SEMAPHORE_TYPE_BINARY);
 	~AfterglowSemaphores();
 
 proxy_protected:
@@ -13,5 +14,6 @@ proxy_protected:
 
 private:
 	AfterglowDevice& _device;
+	VkSemaphoreTypeCreateInfo _typeInfo;
 };
 
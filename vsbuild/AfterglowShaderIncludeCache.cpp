@@ -0,0 +1,63 @@
+#include "AfterglowShaderIncludeCache.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "AfterglowShaderAsset.h"
+#include "AfterglowUtilities.h"
+#include "ExceptionUtilities.h"
+
+struct AfterglowShaderIncludeCache::Impl {
+	mutable std::mutex mutex;
+	// <normalizedPath, source>
+	std::unordered_map<std::string, SourcePtr> sources;
+	Statistics statistics;
+};
+
+AfterglowShaderIncludeCache::AfterglowShaderIncludeCache() :
+	_impl(std::make_unique<Impl>()) {
+}
+
+AfterglowShaderIncludeCache::~AfterglowShaderIncludeCache() {
+}
+
+AfterglowShaderIncludeCache::SourcePtr AfterglowShaderIncludeCache::load(const std::string& path) {
+	std::error_code error;
+	auto lastWriteTime = std::filesystem::last_write_time(path, error);
+	if (error) {
+		EXCEPT_CLASS_RUNTIME(std::format("Shader file not exists: \"{}\"", path));
+	}
+	auto normalizedPath = util::NormalizePath(path);
+	{
+		std::lock_guard lock{ _impl->mutex };
+		auto iterator = _impl->sources.find(normalizedPath);
+		if (iterator != _impl->sources.end() && iterator->second->lastWriteTime == lastWriteTime) {
+			++_impl->statistics.hitCount;
+			return iterator->second;
+		}
+	}
+
+	// File reading is out of lock, concurrent misses of the same file read it more than once at worst.
+	AfterglowShaderAsset shaderAsset(path);
+	auto source = std::make_shared<Source>();
+	source->contentHash = util::HashBytes(shaderAsset.code().data(), shaderAsset.code().size());
+	source->code = shaderAsset.code();
+	source->lastWriteTime = lastWriteTime;
+
+	std::lock_guard lock{ _impl->mutex };
+	++_impl->statistics.readCount;
+	_impl->sources[normalizedPath] = source;
+	_impl->statistics.entryCount = _impl->sources.size();
+	return source;
+}
+
+void AfterglowShaderIncludeCache::clear() {
+	std::lock_guard lock{ _impl->mutex };
+	_impl->sources.clear();
+	_impl->statistics.entryCount = 0;
+}
+
+AfterglowShaderIncludeCache::Statistics AfterglowShaderIncludeCache::statistics() const {
+	std::lock_guard lock{ _impl->mutex };
+	return _impl->statistics;
+}
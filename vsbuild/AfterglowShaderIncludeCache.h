@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <filesystem>
+
+/**
+* @brief: Contents of shader include files shared by all compilations, a file is read again only if its last write time changed.
+* @desc: Common headers are included by almost every shader, reading and hashing them once saves most of the include cost.
+* @note: Thread safe, loaded sources are immutable and shared, so they can be pinned by compilers without copying.
+*/
+class AfterglowShaderIncludeCache {
+public:
+	struct Source {
+		std::string code;
+		uint64_t contentHash;
+		std::filesystem::file_time_type lastWriteTime;
+	};
+	using SourcePtr = std::shared_ptr<const Source>;
+
+	struct Statistics {
+		uint64_t hitCount = 0;
+		uint64_t readCount = 0;
+		uint64_t entryCount = 0;
+	};
+
+	AfterglowShaderIncludeCache();
+	~AfterglowShaderIncludeCache();
+
+	// @brief: Throw runtime error if the file not exists or failed to read.
+	SourcePtr load(const std::string& path);
+	void clear();
+
+	Statistics statistics() const;
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> _impl;
+};
@@ -3,21 +3,33 @@
 #include <codecvt>
 
 #include "AfterglowDxcIncludeHandler.h"
+#include "AfterglowDxcInstances.h"
+#include "AfterglowSpirvOptimizer.h"
+#include "AfterglowPhysicalDevice.h"
 #include <wrl\implements.h>
 
 // TODO: GLSL support.
 
 #include "Configurations.h"
+#include "ExceptionUtilities.h"
 
 AfterglowShaderModule::AfterglowShaderModule(
 	AfterglowDevice& device, 
 	shader::Stage shaderStage, 
 	const std::string& shaderCode, 
-	const std::string& shaderName
+	const std::string& shaderName, 
+	const shader::Defines& defines, 
+	shader::Model shaderModel
 	)  :
-	_device(device) {
-
-	compile(shaderStage, shaderCode, shaderName);
+	_device(device), 
+	_shaderModel(supportedModel(device, shaderStage, shaderModel)) {
+	if (_shaderModel != shaderModel) {
+		DEBUG_CLASS_WARNING(std::format(
+			"Device does not support {} for shader \"{}\", fallback variant {} is compiled.", 
+			inreflect::EnumName(shaderModel), shaderName, inreflect::EnumName(_shaderModel)
+		));
+	}
+	_bytes = compileSpirv(shaderStage, shaderCode, shaderName, defines, _shaderModel, true, &_optimizationReport);
 
 	//// TODO: Waiting for support
 	//shaderc_shader_kind kind = shaderKind(shaderStage);
@@ -41,6 +53,60 @@ AfterglowShaderModule::~AfterglowShaderModule() {
 	destroy(vkDestroyShaderModule, _device, data(), nullptr);
 }
 
+AfterglowSpirvCache& AfterglowShaderModule::spirvCache() {
+	static AfterglowSpirvCache spirvCache(cfg::spirvCacheDirectory, cfg::spirvCacheMaxSize);
+	return spirvCache;
+}
+
+AfterglowShaderIncludeCache& AfterglowShaderModule::includeCache() {
+	static AfterglowShaderIncludeCache includeCache;
+	return includeCache;
+}
+
+DependencyGraph<std::string>& AfterglowShaderModule::includeGraph() {
+	static DependencyGraph<std::string> includeGraph;
+	return includeGraph;
+}
+
+shader::Model AfterglowShaderModule::supportedModel(AfterglowDevice& device, shader::Stage shaderStage, shader::Model shaderModel) {
+	if (!shader::ModelRequiresDeviceFeatures(shaderModel)) {
+		return shaderModel;
+	}
+	VkShaderStageFlags stageFlag = 0;
+	switch (shaderStage) {
+	case shader::Stage::Vertex:
+		stageFlag = VK_SHADER_STAGE_VERTEX_BIT;
+		break;
+	case shader::Stage::Fragment:
+		stageFlag = VK_SHADER_STAGE_FRAGMENT_BIT;
+		break;
+	case shader::Stage::Compute:
+		stageFlag = VK_SHADER_STAGE_COMPUTE_BIT;
+		break;
+	default:
+		return shader::Model::SM6_0;
+	}
+	constexpr VkSubgroupFeatureFlags waveOperations = VK_SUBGROUP_FEATURE_BASIC_BIT 
+		| VK_SUBGROUP_FEATURE_VOTE_BIT 
+		| VK_SUBGROUP_FEATURE_BALLOT_BIT 
+		| VK_SUBGROUP_FEATURE_ARITHMETIC_BIT;
+	auto& subgroupProperties = device.physicalDevice().subgroupProperties();
+	if (!(subgroupProperties.supportedStages & stageFlag)
+		|| (subgroupProperties.supportedOperations & waveOperations) != waveOperations
+		|| !device.native16BitTypesEnabled()) {
+		return shader::Model::SM6_0;
+	}
+	return shaderModel;
+}
+
+shader::Model AfterglowShaderModule::shaderModel() const noexcept {
+	return _shaderModel;
+}
+
+const std::string& AfterglowShaderModule::optimizationReport() const noexcept {
+	return _optimizationReport;
+}
+
 // TODO: Waiting for vulkan extension support.
 //shaderc::Compiler& AfterglowShaderModule::compiler() {
 //	static shaderc::Compiler compiler;
@@ -75,21 +141,20 @@ void AfterglowShaderModule::create() {
 	}
 }
 
-void AfterglowShaderModule::compile(shader::Stage shaderStage, const std::string& shaderCode, const std::string& shaderName) {
-	Microsoft::WRL::ComPtr<IDxcLibrary> pLibrary;
-	Microsoft::WRL::ComPtr<IDxcCompiler> pCompiler;
-	DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&pLibrary));
-	DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&pCompiler));
-
-	Microsoft::WRL::ComPtr<IDxcBlobEncoding> pSource;
-	pLibrary->CreateBlobWithEncodingFromPinned(shaderCode.data(), shaderCode.size(), CP_UTF8, &pSource);
-
-	auto* targetShaderModelName = shaderModelName(shaderStage);
+AfterglowShaderModule::CodeBytes AfterglowShaderModule::compileSpirv(
+	shader::Stage shaderStage, 
+	const std::string& shaderCode, 
+	const std::string& shaderName, 
+	const shader::Defines& defines, 
+	shader::Model shaderModel, 
+	bool useSpirvCache, 
+	std::string* destReport) {
+	auto targetProfileName = shaderProfileName(shaderStage, shaderModel);
 	auto shaderEntryName = util::ToWstring(cfg::shaderEntryName);
 
 	std::vector<LPCWSTR> args = {
 		L"-E", shaderEntryName.data(),
-		L"-T", targetShaderModelName,
+		L"-T", targetProfileName.data(),
 		L"-spirv",
 		L"-fvk-use-dx-layout",
 
@@ -97,29 +162,68 @@ void AfterglowShaderModule::compile(shader::Stage shaderStage, const std::string
 		L"-O3",  /* Higher performance for release version */
 		#endif
 	};
+	if (shader::ModelRequiresDeviceFeatures(shaderModel)) {
+		// Wave intrinsics are translated to subgroup operations of vulkan1.1.
+		args.push_back(L"-fspv-target-env=vulkan1.1");
+		args.push_back(L"-enable-16bit-types");
+	}
+	auto modelDefines = shader::ModelDefines(shaderModel);
+	std::vector<std::wstring> defineArgs;
+	defineArgs.reserve(defines.size() + modelDefines.size());
+	for (const auto& [name, value] : defines) {
+		defineArgs.push_back(util::ToWstring(name + "=" + value));
+	}
+	for (const auto& [name, value] : modelDefines) {
+		defineArgs.push_back(util::ToWstring(name + "=" + value));
+	}
+	for (const auto& defineArg : defineArgs) {
+		args.push_back(L"-D");
+		args.push_back(defineArg.data());
+	}
+
+	// Entry point, target profile and defines are included in args, the optimization switch is a key-only arg.
+	auto keyArgs = args;
+	if (cfg::spirvOptimization) {
+		keyArgs.push_back(L"-afterglow-spirv-opt");
+	}
+	auto cacheKey = AfterglowSpirvCache::makeKey(shaderCode, keyArgs);
+	CodeBytes bytes;
+	AfterglowSpirvCache::IncludedFiles cachedIncludedFiles;
+	if (useSpirvCache && spirvCache().load(cacheKey, bytes, &cachedIncludedFiles, destReport)) {
+		linkIncludedFiles(shaderName, cachedIncludedFiles);
+		return bytes;
+	}
+
+	// Source name is the positional arg of IDxcCompiler3, it's excluded from the cache key.
+	auto wideShaderName = util::ToWstring(shaderName);
+	args.insert(args.begin(), wideShaderName.data());
 
-	AfterglowDxcIncludeHandler pIncludeHandler;
+	auto& dxcInstances = AfterglowDxcInstances::threadInstances();
+	DxcBuffer source{ .Ptr = shaderCode.data(), .Size = shaderCode.size(), .Encoding = CP_UTF8 };
 
-	Microsoft::WRL::ComPtr<IDxcOperationResult> pResult;
-	pCompiler->Compile(
-		pSource.Get(),
-		util::ToWstring(shaderName).data(),
-		shaderEntryName.data(),
-		targetShaderModelName, 
+	AfterglowDxcIncludeHandler pIncludeHandler(dxcInstances.utils(), includeCache());
+
+	Microsoft::WRL::ComPtr<IDxcResult> pResult;
+	HRESULT compileStatus = dxcInstances.compiler().Compile(
+		&source,
 		args.data(), static_cast<uint32_t>(args.size()), 
-		nullptr, 0, 
 		&pIncludeHandler,
-		&pResult
+		IID_PPV_ARGS(&pResult)
 	);
+	if (FAILED(compileStatus) || !pResult) {
+		EXCEPT_TYPE_RUNTIME(AfterglowShaderModule, "Failed to invoke shader compiler.");
+	}
+
+	linkIncludedFiles(shaderName, pIncludeHandler.includedFiles());
 
 	HRESULT status;
 	pResult->GetStatus(&status);
 	if (FAILED(status)) {
 		Microsoft::WRL::ComPtr<IDxcBlobEncoding> pErrors;
 		pResult->GetErrorBuffer(&pErrors);
-		DEBUG_CLASS_ERROR("Shader Code: \n" + shaderCode);
-		DEBUG_CLASS_ERROR("Compilation Info: \n" + std::string(static_cast<const char*>(pErrors->GetBufferPointer()), pErrors->GetBufferSize()));
-		throw runtimeError("Shader compilation failed.");
+		DEBUG_TYPE_ERROR(AfterglowShaderModule, "Shader Code: \n" + shaderCode);
+		DEBUG_TYPE_ERROR(AfterglowShaderModule, "Compilation Info: \n" + std::string(static_cast<const char*>(pErrors->GetBufferPointer()), pErrors->GetBufferSize()));
+		EXCEPT_TYPE_RUNTIME(AfterglowShaderModule, "Shader compilation failed.");
 	}
 
 	Microsoft::WRL::ComPtr<IDxcBlob> pBlob;
@@ -127,19 +231,55 @@ void AfterglowShaderModule::compile(shader::Stage shaderStage, const std::string
 	uint32_t* spirvData = (uint32_t*)pBlob->GetBufferPointer();
 	size_t spirvSize = pBlob->GetBufferSize() / sizeof(uint32_t);
 
-	_bytes = {spirvData, spirvData + spirvSize};
+	bytes = {spirvData, spirvData + spirvSize};
+
+	std::string report;
+	if (cfg::spirvOptimization) {
+		AfterglowSpirvOptimizer::Report optimizationReport;
+		if (AfterglowSpirvOptimizer::optimize(bytes, &optimizationReport)) {
+			report = optimizationReport.toString();
+		}
+		else {
+			// Unoptimized spirv is still valid.
+			DEBUG_TYPE_WARNING(AfterglowShaderModule, std::format("Failed to optimize spirv of shader: {}", shaderName));
+		}
+	}
+	if (useSpirvCache) {
+		spirvCache().store(cacheKey, bytes, pIncludeHandler.includedFiles(), report);
+	}
+	if (destReport) {
+		*destReport = std::move(report);
+	}
+	return bytes;
 }
 
-const wchar_t* AfterglowShaderModule::shaderModelName(shader::Stage shaderStage) {
+std::wstring AfterglowShaderModule::shaderProfileName(shader::Stage shaderStage, shader::Model shaderModel) {
+	std::wstring stageName;
 	switch (shaderStage) {
 	case shader::Stage::Vertex:
-		return L"vs_6_0";
+		stageName = L"vs";
+		break;
 	case shader::Stage::Fragment:
-		return L"ps_6_0";
+		stageName = L"ps";
+		break;
 	case shader::Stage::Compute:
-		return L"cs_6_0";
+		stageName = L"cs";
+		break;
 	default: 
-		throw runtimeError("Not supported shader stage.");
+		EXCEPT_TYPE_RUNTIME(AfterglowShaderModule, "Not supported shader stage.");
+	}
+	auto modelVersion = util::EnumValue(shaderModel);
+	return std::format(L"{}_{}_{}", stageName, modelVersion / 10, modelVersion % 10);
+}
+
+inline void AfterglowShaderModule::linkIncludedFiles(const std::string& shaderName, const AfterglowSpirvCache::IncludedFiles& includedFiles) {
+	// Anonymous shaders (e.g. built-in ones) are never reloaded.
+	if (shaderName == "Null") {
+		return;
+	}
+	auto normalizedShaderName = util::NormalizePath(shaderName);
+	for (const auto& includedFile : includedFiles) {
+		includeGraph().link(util::NormalizePath(includedFile.path), normalizedShaderName);
 	}
 }
 
@@ -5,21 +5,66 @@
 
 #include  "ShaderDefinitions.h"
 #include "AfterglowDevice.h"
-
-// TODO: Persistence spirv data (make spirv file asset).
+#include "AfterglowSpirvCache.h"
+#include "AfterglowShaderIncludeCache.h"
+#include "DependencyGraph.h"
 
 class AfterglowShaderModule : public AfterglowProxyObject<AfterglowShaderModule, VkShaderModule, VkShaderModuleCreateInfo>{
 public:
 	using CodeBytes = std::vector<uint32_t>;
-	// @brief: Input hlsl code to compile spirv.
+	/**
+	* @brief: Input hlsl code to compile spirv, defines select the shader variant.
+	* @param shaderModel: Requested model, it falls back to SM6_0 if the device does not support it, see supportedModel().
+	*/
 	AfterglowShaderModule(
 		AfterglowDevice& device, 
 		shader::Stage shaderStage, 
 		const std::string& shaderCode, 
-		const std::string& shaderName = "Null"
+		const std::string& shaderName = "Null", 
+		const shader::Defines& defines = {}, 
+		shader::Model shaderModel = shader::Model::SM6_0
 		);
 	~AfterglowShaderModule();
 
+	// @brief: Compiled spirv is loaded from here if the source, included files and compile args are unchanged.
+	static AfterglowSpirvCache& spirvCache();
+	// @brief: Contents of included files shared by all compilations.
+	static AfterglowShaderIncludeCache& includeCache();
+	/**
+	* @brief: <includedFile, shaderName> links of shaders compiled in this session, paths are normalized by util::NormalizePath().
+	* @desc: Links of failed compilations are recorded as well, so fixing an included file reloads its shaders.
+	*	Links are never removed, a removed #include causes an unnecessary reload at most.
+	*/
+	static DependencyGraph<std::string>& includeGraph();
+
+	/**
+	* @brief: Compile hlsl to spirv without creating a shader module, DXC instances of the calling thread are reused.
+	* @param defines: Passed as "-D name=value", they are part of the spirv cache key, so each variant is cached separately.
+	* @param shaderModel: Compiled as is, shader::ModelDefines() of it are appended to defines.
+	* @param useSpirvCache: False to always invoke the compiler, e.g. for compilation benchmark.
+	* @param destReport [optional]: Filled with the optimization report, empty if spirv optimization is disabled or failed.
+	*/
+	static CodeBytes compileSpirv(
+		shader::Stage shaderStage, 
+		const std::string& shaderCode, 
+		const std::string& shaderName = "Null", 
+		const shader::Defines& defines = {}, 
+		shader::Model shaderModel = shader::Model::SM6_0, 
+		bool useSpirvCache = true, 
+		std::string* destReport = nullptr
+	);
+
+	/**
+	* @return: The requested model if the device supports wave intrinsics (basic, vote, ballot and arithmetic subgroup operations)
+	*	in this stage and native 16-bit types, otherwise SM6_0 as the fallback.
+	*/
+	static shader::Model supportedModel(AfterglowDevice& device, shader::Stage shaderStage, shader::Model shaderModel);
+	// @return: Model actually compiled of this shader module.
+	shader::Model shaderModel() const noexcept;
+
+	// @return: Readable report of code size, instruction count and bindings before and after spirv optimization.
+	const std::string& optimizationReport() const noexcept;
+
 	// TODO: Waiting for vulkan extension support.
 	//static shaderc::Compiler& compiler();
 	//static shaderc::CompileOptions& compileOptions();
@@ -29,12 +74,15 @@ proxy_protected:
 	void create();
 
 private:
-	inline void compile(shader::Stage shaderStage, const std::string& shaderCode, const std::string& shaderName = "Null");
-	const wchar_t* shaderModelName(shader::Stage shaderStage);
+	// @return: Target profile e.g. "cs_6_2".
+	static std::wstring shaderProfileName(shader::Stage shaderStage, shader::Model shaderModel);
+	static inline void linkIncludedFiles(const std::string& shaderName, const AfterglowSpirvCache::IncludedFiles& includedFiles);
 
 	// shaderc_shader_kind shaderKind(shader::Stage shaderStage);
 
 	AfterglowDevice& _device;
 	CodeBytes _bytes;
+	shader::Model _shaderModel;
+	std::string _optimizationReport;
 };
 
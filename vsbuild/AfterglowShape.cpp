@@ -1,7 +1,7 @@
 #include "AfterglowShape.h"
 
-shape::NDCRectangle::NDCRectangle(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue) : 
-	AfterglowShape(commandPool, graphicsQueue) {
+shape::NDCRectangle::NDCRectangle(AfterglowCommandPool& commandPool, AfterglowUploadContext& uploadContext) : 
+	AfterglowShape(commandPool, uploadContext) {
 
 	addShape([](IndexArray& indexData, VertexArray& vertexData){
 		indexData.resize(6);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AfterglowCommandPool.h"
 #include "AfterglowIndexBuffer.h"
 #include "AfterglowVertexBuffer.h"
 #include "AssetDefinitions.h"
@@ -30,13 +31,13 @@ protected:
 	// @param: Indices and vertices
 	using AddShapeCallback = void(IndexArray&, VertexArray&);
 
-	AfterglowShape(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue);
+	AfterglowShape(AfterglowCommandPool& commandPool, AfterglowUploadContext& uploadContext);
 
 	void addShape(AddShapeCallback callback);
 
 private:
 	AfterglowCommandPool& _commandPool;
-	AfterglowGraphicsQueue& _graphicsQueue;
+	AfterglowUploadContext& _uploadContext;
 
 	std::vector<Resource> _resources;
 
@@ -58,16 +59,16 @@ namespace shape {
 
 class shape::NDCRectangle : public AfterglowShape<vert::VertexPT0> {
 public:
-	NDCRectangle(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue);
+	NDCRectangle(AfterglowCommandPool& commandPool, AfterglowUploadContext& uploadContext);
 	// Polynormial desctruction test.
 	~NDCRectangle() { DEBUG_CLASS_INFO("Shape was destructed."); }
 };
 
 
 template<vert::VertexType Type>
-AfterglowShape<Type>::AfterglowShape(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue) :
+AfterglowShape<Type>::AfterglowShape(AfterglowCommandPool& commandPool, AfterglowUploadContext& uploadContext) :
 	_commandPool(commandPool),
-	_graphicsQueue(graphicsQueue) {
+	_uploadContext(uploadContext) {
 }
 
 template<vert::VertexType Type>
@@ -80,8 +81,8 @@ inline void AfterglowShape<Type>::addShape(AddShapeCallback callback) {
 
 	indexBuffer.bind(resource.indexData);
 	vertexBuffer.bind(resource.vertexData.data);
-	indexBuffer.submit(_commandPool, _graphicsQueue);
-	vertexBuffer.submit(_commandPool, _graphicsQueue);
+	indexBuffer.submit(_uploadContext);
+	vertexBuffer.submit(_uploadContext);
 
 	_vertexBufferHandles.push_back(vertexBuffer.handle());
 }
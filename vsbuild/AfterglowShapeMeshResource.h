@@ -4,22 +4,22 @@
 #include "AfterglowMeshResource.h"
 
 class AfterglowCommandPool;
-class AfterglowGraphicsQueue;
+class AfterglowUploadContext;
 
 class AfterglowShapeMeshResource : public AfterglowMeshResource {
 public:
 	AfterglowShapeMeshResource();
 
 	template<shape::ShapeType Type>
-	void initializeShape(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue);
+	void initializeShape(AfterglowCommandPool& commandPool, AfterglowUploadContext& uploadContext);
 
 private: 
 	std::unique_ptr<AfterglowObject> _shape;
 };
 
 template<shape::ShapeType Type>
-inline void AfterglowShapeMeshResource::initializeShape(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue) {
-	_shape = std::make_unique<Type>(commandPool, graphicsQueue);
+inline void AfterglowShapeMeshResource::initializeShape(AfterglowCommandPool& commandPool, AfterglowUploadContext& uploadContext) {
+	_shape = std::make_unique<Type>(commandPool, uploadContext);
 	Type& shape = *reinterpret_cast<Type*>(_shape.get());
 	bindIndexBuffers(shape.indexBuffers());
 	bindVertexBufferHandles(shape.vertexBufferHandles());
@@ -2,6 +2,12 @@
 
 
 
+void AfterglowMeshPoolResource::release() {
+	indexBuffers.clear();
+	vertexBuffers.clear();
+	vertexBufferHandles.clear();
+}
+
 AfterglowMeshReference::AfterglowMeshReference(
 	const model::AssetInfo& assetInfo, AfterglowResourceReference::Resources& meshes, AfterglowReferenceCount& count
 ) : AfterglowResourceReference(assetInfo, meshes, count) {
@@ -13,6 +19,9 @@ AfterglowMeshReference::AfterglowMeshReference(const AfterglowMeshReference& oth
 
 AfterglowIndexBuffer::Array& AfterglowMeshReference::indexBuffers() noexcept {
 	// verifyValue();
+	if (streaming()) {
+		return _placeholderIndexBuffers;
+	}
 	return _value->indexBuffers;
 }
 
@@ -23,6 +32,9 @@ AfterglowIndexBuffer::Array& AfterglowMeshReference::indexBuffers() noexcept {
 
 std::vector<AfterglowVertexBufferHandle>& AfterglowMeshReference::vertexBufferHandles() noexcept {
 	// verifyValue();
+	if (streaming()) {
+		return _placeholderVertexBufferHandles;
+	}
 	return _value->vertexBufferHandles;
 }
 
@@ -37,9 +49,9 @@ const model::AABB& AfterglowMeshReference::aabb() const noexcept {
 
 AfterglowSharedMeshPool::AfterglowSharedMeshPool(
 	AfterglowCommandPool& commandPool, 
-	AfterglowGraphicsQueue& graphicsQueue, 
+	AfterglowUploadContext& uploadContext, 
 	AfterglowSynchronizer& synchronizer) :
-	AfterglowSharedResourcePool(commandPool, graphicsQueue, synchronizer) {
+	AfterglowSharedResourcePool(commandPool, uploadContext, synchronizer) {
 }
 
 AfterglowMeshReference AfterglowSharedMeshPool::mesh(const model::AssetInfo& assetInfo) {
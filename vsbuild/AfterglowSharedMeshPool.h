@@ -15,6 +15,9 @@ struct AfterglowMeshPoolResource : public AfterglowSharedPoolResource {
 	// VertexBufferHandle is type-independent, for different vertex buffer type support.
 	std::vector<AfterglowVertexBufferHandle> vertexBufferHandles;
 	model::AABB aabb;
+
+	// @brief: Destroy buffers of the evicted mesh, AABB is kept for culling.
+	void release();
 };
 
 
@@ -26,10 +29,17 @@ public:
 	AfterglowMeshReference(const AfterglowMeshReference& other);
 
 	// const model::AssetInfo& assetInfo() const;
+	// @return: Empty placeholder if the mesh is streaming.
 	AfterglowIndexBuffer::Array& indexBuffers() noexcept;
 	//AfterglowVertexBuffer::Array& vertexBuffers() noexcept;
+	// @return: Empty placeholder if the mesh is streaming.
 	std::vector<AfterglowVertexBufferHandle>& vertexBufferHandles() noexcept;
 	const model::AABB& aabb() const noexcept;
+
+private:
+	// Placeholder mesh has no sub mesh, so nothing is drawn until the mesh is resident.
+	static inline AfterglowIndexBuffer::Array _placeholderIndexBuffers;
+	static inline std::vector<AfterglowVertexBufferHandle> _placeholderVertexBufferHandles;
 };
 
 
@@ -37,11 +47,14 @@ class AfterglowSharedMeshPool : public AfterglowSharedResourcePool<AfterglowMesh
 public: 
 	AfterglowSharedMeshPool(
 		AfterglowCommandPool& commandPool, 
-		AfterglowGraphicsQueue& graphicsQueue, 
+		AfterglowUploadContext& uploadContext, 
 		AfterglowSynchronizer& synchronizer
 	);
 
-	// @brief: Get ref of mesh resource, if resource not exists, it will create mesh from file automatically.
+	/**
+	* @brief: Get ref of mesh resource, if resource not exists, it will create mesh from file automatically.
+	* @note: New mesh is decoded in a streaming worker, check AfterglowMeshReference::streaming() before using its data.
+	*/
 	AfterglowMeshReference mesh(const model::AssetInfo& assetInfo);
 
 private:
@@ -63,21 +76,32 @@ AfterglowSharedMeshPool::Resource* AfterglowSharedMeshPool::createMesh(const mod
 			}
 		});
 
-	AfterglowModelAsset modelAsset(assetInfo);
-	auto& device = commandPool().device();
-	for (uint32_t index = 0; index < modelAsset.numMeshes(); ++index) {
-		auto& indexBuffer = mesh.indexBuffers.emplace_back();
-		mesh.vertexBuffers.emplace_back(std::make_unique<VertexBuffer>(device));
-
-		indexBuffer.recreate(device);
-		VertexBuffer& vertexBuffer = *reinterpret_cast<VertexBuffer*>(mesh.vertexBuffers.back().get());
-		(*indexBuffer).bind(modelAsset.indices(index));
-		vertexBuffer.bind(modelAsset.vertexData(index));
-		(*indexBuffer).submit(commandPool(), graphicsQueue());
-		vertexBuffer.submit(commandPool(), graphicsQueue());
-
-		mesh.vertexBufferHandles.emplace_back(vertexBuffer.handle());
-	}
-	mesh.aabb = modelAsset.aabb();
+	stream(mesh, assetInfo, [this, assetInfo]() {
+		auto modelAsset = std::make_shared<AfterglowModelAsset>(assetInfo);
+		uint64_t byteSize = 0;
+		for (uint32_t index = 0; index < modelAsset->numMeshes(); ++index) {
+			byteSize += modelAsset->indices(index).lock()->size() * sizeof(vert::StandardIndex);
+			byteSize += modelAsset->vertexData(index).lock()->size();
+		}
+
+		// Vertex data is owned by the asset, keep it alive until the upload was recorded.
+		return StreamedData{ byteSize, [this, modelAsset](Resource& mesh) {
+			auto& device = commandPool().device();
+			for (uint32_t index = 0; index < modelAsset->numMeshes(); ++index) {
+				auto& indexBuffer = mesh.indexBuffers.emplace_back();
+				mesh.vertexBuffers.emplace_back(std::make_unique<VertexBuffer>(device));
+
+				indexBuffer.recreate(device);
+				VertexBuffer& vertexBuffer = *reinterpret_cast<VertexBuffer*>(mesh.vertexBuffers.back().get());
+				(*indexBuffer).bind(modelAsset->indices(index));
+				vertexBuffer.bind(modelAsset->vertexData(index));
+				(*indexBuffer).submit(uploadContext());
+				vertexBuffer.submit(uploadContext());
+
+				mesh.vertexBufferHandles.emplace_back(vertexBuffer.handle());
+			}
+			mesh.aabb = modelAsset->aabb();
+		} };
+	});
 	return &mesh;
 }
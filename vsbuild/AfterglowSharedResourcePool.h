@@ -1,15 +1,50 @@
 #pragma once
+#include <deque>
+#include <mutex>
+#include <format>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "AfterglowCommandPool.h"
-#include "AfterglowGraphicsQueue.h"
+#include "AfterglowMemoryAllocator.h"
+#include "AfterglowUploadContext.h"
 #include "AfterglowReferenceCounter.h"
 #include "AfterglowSynchronizer.h"
+#include "Configurations.h"
 #include "DebugUtilities.h"
+#include "TaskQueue.h"
 
+/**
+* @brief: Common states of shared pool resources.
+* @note: Derived resources implement release(), it destroys device data of an evicted resource and keeps its metadata.
+*/
 struct AfterglowSharedPoolResource {
+	enum class StreamState {
+		// Decoding in a streaming worker, placeholder is used.
+		Decoding, 
+		// Uploads were recorded, placeholder is used until their batch was completed.
+		Uploading, 
+		Resident, 
+		// Decoding failed, placeholder is kept.
+		Failed, 
+		// Evicted due to the memory budget, placeholder is used, device data is released after frames in flight.
+		Evicting, 
+		// Device data was released, it is re-streamed once the resource is used again.
+		Evicted
+	};
+
 	AfterglowReferenceCount count;
+	StreamState streamState = StreamState::Resident;
+	// Upload batch of the resource, see AfterglowUploadContext::ticket().
+	uint64_t uploadTicket = 0;
+	// Pool frame of the last draw or dispatch which used the resource, see AfterglowSharedResourcePool::frame().
+	uint64_t lastUsedFrame = 0;
+	// Streamed bytes, the estimated device memory which is freed by eviction.
+	uint64_t byteSize = 0;
 };
 
 template<typename KeyType, typename ResourceType>
@@ -22,6 +57,11 @@ public:
 	AfterglowResourceReference(const AfterglowResourceReference& other);
 	AfterglowResourceReference(AfterglowResourceReference&&) noexcept = default;
 
+	// @return: True if the resource is being decoded, uploaded or it was evicted, placeholder is used at that time.
+	bool streaming() const noexcept;
+	// @brief: Stamp the resource as used in this frame, idle resources are evicted first if the memory budget is exceeded.
+	void markUsed(uint64_t frame) noexcept;
+
 protected:
 	// @deprecated: std::unordered_map rehash will not change the element address.
 	//inline void verifyValue();
@@ -47,26 +87,83 @@ public:
 
 	AfterglowSharedResourcePool(
 		AfterglowCommandPool& commandPool, 
-		AfterglowGraphicsQueue& graphicsQueue, 
+		AfterglowUploadContext& uploadContext, 
 		AfterglowSynchronizer& synchronizer
 	);
 
 	AfterglowCommandPool& commandPool();
-	AfterglowGraphicsQueue& graphicsQueue();
+	AfterglowUploadContext& uploadContext();
 
+	/**
+	* @brief: Record decoded resources within the upload budget, swap resident ones and release removed ones.
+	* @desc: If device local usage exceeds the memory budget, idle streamed resources are evicted in LRU order.
+	*/
 	void update();
 
+	// @brief: Increased when streamed resources became resident or evicted, rebind the resources whose bound data was changed.
+	uint64_t residentGeneration() const noexcept;
+
+	// @brief: Increased by update(), stamp used resources with it, see AfterglowResourceReference::markUsed().
+	uint64_t frame() const noexcept;
+
 protected:
+	// @brief: Invoked in the render thread with the decoded data, records uploads of the resource.
+	using StreamApplier = std::function<void(Resource&)>;
+
+	struct StreamedData {
+		uint64_t byteSize = 0;
+		StreamApplier apply;
+	};
+
+	// @brief: Invoked in a streaming worker, never touch the pool inside.
+	using StreamDecoder = std::function<StreamedData()>;
+
 	// TODO: should be append back if one frame changed....or check exist when delete
 	inline void removeResource(const Key* key);
 
+	/**
+	* @brief: Decode the resource in a streaming worker, the returned applier is invoked in update() within the upload budget.
+	* @desc: Decoder is kept for re-streaming, only streamed resources are evictable.
+	*/
+	inline void stream(Resource& resource, const Key& key, StreamDecoder decode);
+
 	Resources _resources;
 	std::unordered_set<const Key*> _removingCache;
+	// Resources are erased after GPU finished the submissions which may use them, instead of stalling CPU.
+	std::unordered_map<const Key*, AfterglowSynchronizer::TimelinePoint> _retiringResources;
 
 private:
+	struct Streamed {
+		Key key;
+		StreamedData data;
+	};
+
+	inline void applyStreamedResources();
+	inline void updateUploadingResources();
+	// @brief: Release evicted resources whose frames were retired, and re-stream the used ones.
+	inline void updateEvictedResources();
+	inline void evictResources();
+	inline void eraseResource(typename Resources::iterator iterator);
+
 	AfterglowCommandPool& _commandPool;
-	AfterglowGraphicsQueue& _graphicsQueue;
+	AfterglowUploadContext& _uploadContext;
 	AfterglowSynchronizer& _synchronizer;
+
+	std::unordered_set<const Key*> _uploadingResources;
+	uint64_t _residentGeneration = 0;
+	uint64_t _frame = 0;
+
+	std::unordered_map<const Key*, StreamDecoder> _decoders;
+	// Evicted in this frame, recorded draws still use their data, so retire points are taken in the next update.
+	std::unordered_set<const Key*> _evictingCache;
+	std::unordered_map<const Key*, AfterglowSynchronizer::TimelinePoint> _evictingResources;
+	std::unordered_set<const Key*> _evictedResources;
+
+	std::mutex _streamMutex;
+	// Decoded by workers, in order of completion.
+	std::deque<Streamed> _streamedResources;
+	// Declare it last, workers should be joined before the streamed queue destroys.
+	TaskQueue _streamWorkers;
 };
 
 
@@ -91,6 +188,17 @@ inline AfterglowResourceReference<KeyType, ResourceType>::AfterglowResourceRefer
 	_counter(other._counter) {
 }
 
+template<typename KeyType, typename ResourceType>
+inline bool AfterglowResourceReference<KeyType, ResourceType>::streaming() const noexcept {
+	return _value->streamState != AfterglowSharedPoolResource::StreamState::Resident
+		&& _value->streamState != AfterglowSharedPoolResource::StreamState::Failed;
+}
+
+template<typename KeyType, typename ResourceType>
+inline void AfterglowResourceReference<KeyType, ResourceType>::markUsed(uint64_t frame) noexcept {
+	_value->lastUsedFrame = frame;
+}
+
 // @deprecated: std::unordered_map rehash will not change the element address.
 //template<typename KeyType, typename ResourceType>
 //inline void AfterglowResourceReference<KeyType, ResourceType>::verifyValue() {
@@ -104,11 +212,12 @@ inline AfterglowResourceReference<KeyType, ResourceType>::AfterglowResourceRefer
 template<typename ResourceReferenceType>
 inline AfterglowSharedResourcePool<ResourceReferenceType>::AfterglowSharedResourcePool(
 	AfterglowCommandPool& commandPool, 
-	AfterglowGraphicsQueue& graphicsQueue, 
+	AfterglowUploadContext& uploadContext, 
 	AfterglowSynchronizer& synchronizer) :
 	_commandPool(commandPool),
-	_graphicsQueue(graphicsQueue), 
-	_synchronizer(synchronizer) {
+	_uploadContext(uploadContext), 
+	_synchronizer(synchronizer), 
+	_streamWorkers(cfg::assetStreamWorkerCount, "AssetStream") {
 	
 }
 
@@ -118,32 +227,223 @@ inline AfterglowCommandPool& AfterglowSharedResourcePool<ResourceReferenceType>:
 }
 
 template<typename ResourceReferenceType>
-inline AfterglowGraphicsQueue& AfterglowSharedResourcePool<ResourceReferenceType>::graphicsQueue() {
-	return _graphicsQueue;
+inline AfterglowUploadContext& AfterglowSharedResourcePool<ResourceReferenceType>::uploadContext() {
+	return _uploadContext;
 }
 
 template<typename ResourceReferenceType>
 inline void AfterglowSharedResourcePool<ResourceReferenceType>::update() {
-	if (_removingCache.empty()) {
-		return;
+	++_frame;
+	applyStreamedResources();
+	updateUploadingResources();
+	updateEvictedResources();
+	evictResources();
+
+	// Every command buffer which may use these resources was submitted before update, retire them at the latest timeline point.
+	if (!_removingCache.empty()) {
+		auto retirePoint = _synchronizer.submittedPoint();
+		for (const auto* key : _removingCache) {
+			_retiringResources.insert_or_assign(key, retirePoint);
+		}
+		_removingCache.clear();
 	}
-	// GPU synchronization.
-	_synchronizer.wait(AfterglowSynchronizer::FenceFlag::ComputeInFlight);
-	_synchronizer.wait(AfterglowSynchronizer::FenceFlag::RenderInFlight);
 	
-	for (const auto* key : _removingCache) {
-		auto iterator = _resources.find(*key);
+	for (auto retiringIterator = _retiringResources.begin(); retiringIterator != _retiringResources.end();) {
+		if (!_synchronizer.completed(retiringIterator->second)) {
+			++retiringIterator;
+			continue;
+		}
+		auto iterator = _resources.find(*retiringIterator->first);
+		// Upload batch still reads the staging data into this resource.
+		if (!_uploadContext.completed(iterator->second.uploadTicket)) {
+			++retiringIterator;
+			continue;
+		}
 		if (iterator->second.count.count() <= 0) {
-			_resources.erase(iterator);
+			eraseResource(iterator);
 		}
 		else {
 			DEBUG_CLASS_INFO("Resource reference swap was happen.");
 		}
+		retiringIterator = _retiringResources.erase(retiringIterator);
 	}
-	_removingCache.clear();
+}
+
+template<typename ResourceReferenceType>
+inline uint64_t AfterglowSharedResourcePool<ResourceReferenceType>::residentGeneration() const noexcept {
+	return _residentGeneration;
+}
+
+template<typename ResourceReferenceType>
+inline uint64_t AfterglowSharedResourcePool<ResourceReferenceType>::frame() const noexcept {
+	return _frame;
 }
 
 template<typename ResourceReferenceType>
 inline void AfterglowSharedResourcePool<ResourceReferenceType>::removeResource(const Key* key) {
 	_removingCache.insert(key);
 }
+
+template<typename ResourceReferenceType>
+inline void AfterglowSharedResourcePool<ResourceReferenceType>::stream(Resource& resource, const Key& key, StreamDecoder decode) {
+	resource.streamState = AfterglowSharedPoolResource::StreamState::Decoding;
+	resource.lastUsedFrame = _frame;
+	_decoders.insert_or_assign(&_resources.find(key)->first, decode);
+	_streamWorkers.push([this, key, decode = std::move(decode)]() {
+		Streamed streamed{ key };
+		try {
+			streamed.data = decode();
+		}
+		// An empty applier marks the resource as Failed, so every decode failure must still be pushed back.
+		catch (const std::exception& error) {
+			streamed.data = {};
+			DEBUG_CLASS_ERROR(std::format("Failed to decode streamed resource, due to: {}", error.what()));
+		}
+		catch (...) {
+			streamed.data = {};
+			DEBUG_CLASS_ERROR("Failed to decode streamed resource, due to an unknown exception.");
+		}
+		std::lock_guard lock{ _streamMutex };
+		_streamedResources.push_back(std::move(streamed));
+	});
+}
+
+template<typename ResourceReferenceType>
+inline void AfterglowSharedResourcePool<ResourceReferenceType>::applyStreamedResources() {
+	std::vector<Streamed> streamedResources;
+	{
+		std::lock_guard lock{ _streamMutex };
+		while (!_streamedResources.empty() && _uploadContext.acquireBudget(_streamedResources.front().data.byteSize)) {
+			streamedResources.push_back(std::move(_streamedResources.front()));
+			_streamedResources.pop_front();
+		}
+	}
+
+	for (auto& streamed : streamedResources) {
+		auto iterator = _resources.find(streamed.key);
+		// The resource was removed while decoding, or it is a stale request of a recreated resource.
+		if (iterator == _resources.end() || iterator->second.streamState != AfterglowSharedPoolResource::StreamState::Decoding) {
+			continue;
+		}
+		auto& resource = iterator->second;
+		if (!streamed.data.apply) {
+			resource.streamState = AfterglowSharedPoolResource::StreamState::Failed;
+			continue;
+		}
+		streamed.data.apply(resource);
+		resource.byteSize = streamed.data.byteSize;
+		resource.uploadTicket = _uploadContext.ticket();
+		resource.streamState = AfterglowSharedPoolResource::StreamState::Uploading;
+		_uploadingResources.insert(&iterator->first);
+	}
+}
+
+template<typename ResourceReferenceType>
+inline void AfterglowSharedResourcePool<ResourceReferenceType>::updateUploadingResources() {
+	for (auto uploadingIterator = _uploadingResources.begin(); uploadingIterator != _uploadingResources.end();) {
+		auto& resource = _resources.at(**uploadingIterator);
+		if (!_uploadContext.completed(resource.uploadTicket)) {
+			++uploadingIterator;
+			continue;
+		}
+		resource.streamState = AfterglowSharedPoolResource::StreamState::Resident;
+		++_residentGeneration;
+		uploadingIterator = _uploadingResources.erase(uploadingIterator);
+	}
+}
+
+template<typename ResourceReferenceType>
+inline void AfterglowSharedResourcePool<ResourceReferenceType>::updateEvictedResources() {
+	if (!_evictingCache.empty()) {
+		auto retirePoint = _synchronizer.submittedPoint();
+		for (const auto* key : _evictingCache) {
+			_evictingResources.insert_or_assign(key, retirePoint);
+		}
+		_evictingCache.clear();
+	}
+
+	for (auto evictingIterator = _evictingResources.begin(); evictingIterator != _evictingResources.end();) {
+		if (!_synchronizer.completed(evictingIterator->second)) {
+			++evictingIterator;
+			continue;
+		}
+		auto& resource = _resources.at(*evictingIterator->first);
+		resource.release();
+		resource.streamState = AfterglowSharedPoolResource::StreamState::Evicted;
+		_commandPool.device().memoryAllocator().endEviction(resource.byteSize);
+		_evictedResources.insert(evictingIterator->first);
+		evictingIterator = _evictingResources.erase(evictingIterator);
+	}
+
+	// Used in the last frame, placeholder was drawn instead.
+	for (auto evictedIterator = _evictedResources.begin(); evictedIterator != _evictedResources.end();) {
+		auto& resource = _resources.at(**evictedIterator);
+		if (resource.lastUsedFrame + 1 < _frame) {
+			++evictedIterator;
+			continue;
+		}
+		stream(resource, **evictedIterator, _decoders.at(*evictedIterator));
+		evictedIterator = _evictedResources.erase(evictedIterator);
+	}
+}
+
+template<typename ResourceReferenceType>
+inline void AfterglowSharedResourcePool<ResourceReferenceType>::evictResources() {
+	if (_decoders.empty()) {
+		return;
+	}
+	auto& memoryAllocator = _commandPool.device().memoryAllocator();
+	auto budget = memoryAllocator.budget();
+	auto targetUsage = static_cast<uint64_t>(static_cast<double>(budget.budget) * cfg::memoryBudgetUsageRatio);
+	// Evicting resources of all pools will be released, do not evict more resources for the same bytes.
+	if (budget.usage <= targetUsage + budget.evicting) {
+		return;
+	}
+	uint64_t exceededBytes = budget.usage - targetUsage - budget.evicting;
+
+	std::vector<std::pair<uint64_t, const Key*>> candidates;
+	for (const auto& [key, decoder] : _decoders) {
+		const auto& resource = _resources.at(*key);
+		if (resource.streamState == AfterglowSharedPoolResource::StreamState::Resident 
+			&& resource.count.count() > 0 
+			&& _frame - resource.lastUsedFrame >= cfg::memoryEvictionIdleFrames) {
+			candidates.emplace_back(resource.lastUsedFrame, key);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+	uint64_t evictedBytes = 0;
+	uint32_t evictedCount = 0;
+	for (const auto& [lastUsedFrame, key] : candidates) {
+		if (evictedBytes >= exceededBytes) {
+			break;
+		}
+		auto& resource = _resources.at(*key);
+		resource.streamState = AfterglowSharedPoolResource::StreamState::Evicting;
+		_evictingCache.insert(key);
+		evictedBytes += resource.byteSize;
+		++evictedCount;
+	}
+	if (evictedCount > 0) {
+		memoryAllocator.beginEviction(evictedBytes);
+		++_residentGeneration;
+		DEBUG_CLASS_INFO(std::format(
+			"Memory budget exceeded ({} / {} bytes), {} resources ({} bytes) were evicted.", 
+			budget.usage, budget.budget, evictedCount, evictedBytes
+		));
+	}
+}
+
+template<typename ResourceReferenceType>
+inline void AfterglowSharedResourcePool<ResourceReferenceType>::eraseResource(typename Resources::iterator iterator) {
+	const Key* key = &iterator->first;
+	if (iterator->second.streamState == AfterglowSharedPoolResource::StreamState::Evicting) {
+		_commandPool.device().memoryAllocator().endEviction(iterator->second.byteSize);
+	}
+	_uploadingResources.erase(key);
+	_decoders.erase(key);
+	_evictingCache.erase(key);
+	_evictingResources.erase(key);
+	_evictedResources.erase(key);
+	_resources.erase(iterator);
+}
@@ -4,6 +4,10 @@
 #include "AfterglowImageAsset.h"
 #include "GlobalAssets.h"
 
+void AfterglowTexturePoolResource::release() {
+	buffer.reset();
+}
+
 AfterglowTextureReference::AfterglowTextureReference(const img::AssetInfo& assetInfo, AfterglowResourceReference::Resources& textures, AfterglowReferenceCount& count) :
 	AfterglowResourceReference(assetInfo, textures, count) {
 }
@@ -19,23 +23,37 @@ const img::Info& AfterglowTextureReference::info() const noexcept {
 
 AfterglowTextureImage& AfterglowTextureReference::texture() noexcept {
 	// verifyValue();
+	if (_value->streamState != AfterglowSharedPoolResource::StreamState::Resident) {
+		return *_value->placeholder;
+	}
 	return _value->buffer;
 }
 
 AfterglowSharedTexturePool::AfterglowSharedTexturePool(
 	AfterglowCommandPool& commandPool, 
-	AfterglowGraphicsQueue& graphicsQueue, 
+	AfterglowUploadContext& uploadContext, 
 	AfterglowSynchronizer& synchronizer) :
-	AfterglowSharedResourcePool(commandPool, graphicsQueue, synchronizer) {
+	AfterglowSharedResourcePool(commandPool, uploadContext, synchronizer) {
+	img::Info info{
+		.size = 4, 
+		.format = img::Format::UnsignedInt8, 
+		.channels = img::Channel::RGBA, 
+		.colorSpace = img::ColorSpace::SRGB
+	};
+	auto data = std::make_shared<img::DataArray>(info.size, static_cast<char>(0xFF));
+	_placeholder.recreate(commandPool.device());
+	(*_placeholder).bind(info, data);
+	// Uploaded data is copied into the staging ring, so the data could be released here.
+	(*_placeholder).submit(uploadContext);
 }
 
-AfterglowTextureReference AfterglowSharedTexturePool::texture(const img::AssetInfo& assetInfo) {
+AfterglowTextureReference AfterglowSharedTexturePool::texture(const img::AssetInfo& assetInfo, bool streamed) {
 	img::AssetInfo assetInfoCopy = assetInfo;
 
 	auto textureIterator = _resources.find(assetInfoCopy);
 	Resource* texture = nullptr;
 	if (textureIterator == _resources.end()) {
-		texture = createTexture(assetInfoCopy);
+		texture = createTexture(assetInfoCopy, streamed);
 	}
 	else {
 		texture = &(textureIterator->second);
@@ -44,12 +62,12 @@ AfterglowTextureReference AfterglowSharedTexturePool::texture(const img::AssetIn
 	return AfterglowTextureReference{ std::move(assetInfoCopy), _resources, texture->count };
 }
 
-AfterglowTextureReference AfterglowSharedTexturePool::texture(img::AssetInfo&& rval) {
+AfterglowTextureReference AfterglowSharedTexturePool::texture(img::AssetInfo&& rval, bool streamed) {
 	img::AssetInfo assetInfo{ std::forward<img::AssetInfo>(rval) };
 	auto textureIterator = _resources.find(assetInfo);
 	Resource* texture = nullptr;
 	if (textureIterator == _resources.end()) {
-		texture = createTexture(assetInfo);
+		texture = createTexture(assetInfo, streamed);
 	}
 	else {
 		texture = &(textureIterator->second);
@@ -58,7 +76,7 @@ AfterglowTextureReference AfterglowSharedTexturePool::texture(img::AssetInfo&& r
 	return AfterglowTextureReference{ std::move(assetInfo), _resources, texture->count };
 }
 
-AfterglowSharedTexturePool::Resource* AfterglowSharedTexturePool::createTexture(img::AssetInfo& assetInfo) {
+AfterglowSharedTexturePool::Resource* AfterglowSharedTexturePool::createTexture(img::AssetInfo& assetInfo, bool streamed) {
 	// TODO: mesh pool also do that check?
 	if (!std::filesystem::exists(assetInfo.path)) {
 		DEBUG_CLASS_ERROR(std::format("Path texture is not exists: \"{}\", it was replaced to default texture. ", assetInfo.path));
@@ -82,12 +100,29 @@ AfterglowSharedTexturePool::Resource* AfterglowSharedTexturePool::createTexture(
 		}
 	);
 
-	AfterglowImageAsset imageAsset(assetInfo);
-	texture.info = imageAsset.info();
-	auto& buffer = texture.buffer;
-	buffer.recreate(commandPool().device());
-	(*buffer).bind(imageAsset.info(), imageAsset.data());
-	(*buffer).submit(commandPool(), graphicsQueue());
+	texture.placeholder = _placeholder;
+
+	// Image data is owned by the asset, keep it alive until the upload was recorded.
+	auto applyImageAsset = [this](std::shared_ptr<AfterglowImageAsset> imageAsset) {
+		return [this, imageAsset](Resource& texture) {
+			texture.info = imageAsset->info();
+			auto& buffer = texture.buffer;
+			buffer.recreate(commandPool().device());
+			(*buffer).bind(imageAsset->info(), imageAsset->data());
+			(*buffer).submit(uploadContext());
+		};
+	};
+
+	if (!streamed) {
+		applyImageAsset(std::make_shared<AfterglowImageAsset>(assetInfo))(texture);
+		// Upload batch is submitted before any draw which samples this texture.
+		texture.uploadTicket = uploadContext().ticket();
+		return &texture;
+	}
 
+	stream(texture, assetInfo, [assetInfo, applyImageAsset]() {
+		auto imageAsset = std::make_shared<AfterglowImageAsset>(assetInfo);
+		return StreamedData{ imageAsset->info().size, applyImageAsset(imageAsset) };
+	});
 	return &texture;
 }
\ No newline at end of file
@@ -7,6 +7,11 @@
 struct AfterglowTexturePoolResource : public AfterglowSharedPoolResource {
 	img::Info info;
 	AfterglowTextureImage::AsElement buffer;
+	// Shared 1x1 texture of the pool, used until the buffer is resident.
+	AfterglowTextureImage* placeholder = nullptr;
+
+	// @brief: Destroy the image of the evicted texture, info is kept.
+	void release();
 };
 
 
@@ -15,7 +20,9 @@ public:
 	AfterglowTextureReference(const img::AssetInfo& assetInfo, AfterglowResourceReference::Resources& textures, AfterglowReferenceCount& count);
 	AfterglowTextureReference(const AfterglowTextureReference& other);
 
+	// @note: Info is filled after the texture was decoded.
 	const img::Info& info() const noexcept;
+	// @return: Placeholder texture if the texture is not resident.
 	AfterglowTextureImage& texture() noexcept;
 };
 
@@ -24,19 +31,27 @@ class AfterglowSharedTexturePool : public AfterglowSharedResourcePool<AfterglowT
 public: 
 	AfterglowSharedTexturePool(
 		AfterglowCommandPool& commandPool, 
-		AfterglowGraphicsQueue& graphicsQueue, 
+		AfterglowUploadContext& uploadContext, 
 		AfterglowSynchronizer& synchronizer
 	);
 
-	// @brief: Get ref of texture resource, if resource not exists, it will create texture from file automatically.
-	AfterglowTextureReference texture(const img::AssetInfo& assetInfo);
-	AfterglowTextureReference texture(img::AssetInfo&& rval);
+	/**
+	* @brief: Get ref of texture resource, if resource not exists, it will create texture from file automatically.
+	* @param streamed: 
+	*	If true, the texture is decoded in a streaming worker and the placeholder is bound until it is resident.
+	*	Otherwise it is loaded in the calling thread, for descriptors which are written only once.
+	*/
+	AfterglowTextureReference texture(const img::AssetInfo& assetInfo, bool streamed = true);
+	AfterglowTextureReference texture(img::AssetInfo&& rval, bool streamed = true);
 	
 	// TODO: 
 	// AfterglowSampler& sharedSampler();
 
 private:
-	Resource* createTexture(img::AssetInfo& assetInfo);
+	Resource* createTexture(img::AssetInfo& assetInfo, bool streamed);
+
+	// White, it does not tint the material if its texture is not resident yet.
+	AfterglowTextureImage::AsElement _placeholder;
 
 	// TODO: 
 	// AfterglowSampler::AsElement _sharedSampler;
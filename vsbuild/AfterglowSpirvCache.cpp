@@ -0,0 +1,310 @@
+#include "AfterglowSpirvCache.h"
+
+#include <mutex>
+#include <cwchar>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+
+#include "AfterglowShaderAsset.h"
+#include "AfterglowUtilities.h"
+#include "DebugUtilities.h"
+
+struct AfterglowSpirvCache::Impl {
+	using FileTime = std::filesystem::file_time_type;
+
+	struct Entry {
+		uint64_t size;
+		FileTime lastUseTime;
+	};
+
+	enum class ReadResult {
+		Hit, 
+		Outdated, 
+		// Truncated or inconsistent file, it's removed so the shader is recompiled and stored again.
+		Corrupt
+	};
+
+	Impl(const std::string& inDirectory, uint64_t inMaxSize);
+
+	inline std::string entryPath(Key key) const;
+	inline ReadResult readEntry(Key key, SpirvBytes& destSpirv, IncludedFiles* destIncludedFiles, std::string* destReport) const;
+	inline bool writeEntry(Key key, const SpirvBytes& spirv, const IncludedFiles& includedFiles, const std::string& report) const;
+	// @brief: Remove least recently used entries until the total size is in limit, the kept key is never removed.
+	inline void evict(Key keptKey);
+	inline void removeEntry(Key key);
+
+	std::string directory;
+	uint64_t maxSize;
+
+	mutable std::mutex mutex;
+	std::unordered_map<Key, Entry> entries;
+	Statistics statistics;
+};
+
+AfterglowSpirvCache::Impl::Impl(const std::string& inDirectory, uint64_t inMaxSize) : 
+	directory(inDirectory), maxSize(inMaxSize) {
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	// Rebuild the index from existing files, file name is the hex key.
+	// Files may be removed by other processes while scanning, so only error code overloads are used here.
+	std::filesystem::directory_iterator fileIterator(directory, error);
+	for (; !error && fileIterator != std::filesystem::directory_iterator{}; fileIterator.increment(error)) {
+		const auto& file = *fileIterator;
+		std::error_code fileError;
+		if (!file.is_regular_file(fileError) || file.path().extension() != _suffix) {
+			continue;
+		}
+		Key key = 0;
+		auto stem = file.path().stem().string();
+		auto [end, result] = std::from_chars(stem.data(), stem.data() + stem.size(), key, 16);
+		if (result != std::errc{} || end != stem.data() + stem.size()) {
+			continue;
+		}
+		uint64_t fileSize = file.file_size(fileError);
+		FileTime lastUseTime = file.last_write_time(fileError);
+		if (fileError) {
+			continue;
+		}
+		entries[key] = Entry{ .size = fileSize, .lastUseTime = lastUseTime };
+		statistics.totalSize += fileSize;
+	}
+	statistics.entryCount = entries.size();
+}
+
+inline std::string AfterglowSpirvCache::Impl::entryPath(Key key) const {
+	return std::format("{}{:016x}{}", directory, key, _suffix);
+}
+
+inline AfterglowSpirvCache::Impl::ReadResult AfterglowSpirvCache::Impl::readEntry(Key key, SpirvBytes& destSpirv, IncludedFiles* destIncludedFiles, std::string* destReport) const {
+	std::string path = entryPath(key);
+	std::error_code error;
+	uint64_t remainingSize = std::filesystem::file_size(path, error);
+	std::ifstream inFile(path, std::ios::binary);
+	if (error || !inFile) {
+		return ReadResult::Outdated;
+	}
+	// Every size below comes from the file, bound it by the remaining bytes before allocating.
+	auto consume = [&remainingSize](uint64_t size) {
+		if (size > remainingSize) {
+			return false;
+		}
+		remainingSize -= size;
+		return true;
+	};
+
+	FileHead fileHead{};
+	if (!consume(sizeof(FileHead))) {
+		return ReadResult::Corrupt;
+	}
+	inFile.read(reinterpret_cast<char*>(&fileHead), sizeof(FileHead));
+	if (!inFile || std::string(fileHead.flag, 3) != "asc" || fileHead.version != _currentVersion || fileHead.key != key) {
+		return ReadResult::Corrupt;
+	}
+
+	if (destIncludedFiles) {
+		destIncludedFiles->clear();
+	}
+	// Outdated if any included file was modified.
+	for (uint32_t index = 0; index < fileHead.includedFileCount; ++index) {
+		uint32_t pathSize = 0;
+		uint64_t contentHash = 0;
+		if (!consume(sizeof(pathSize) + sizeof(contentHash))) {
+			return ReadResult::Corrupt;
+		}
+		inFile.read(reinterpret_cast<char*>(&pathSize), sizeof(pathSize));
+		inFile.read(reinterpret_cast<char*>(&contentHash), sizeof(contentHash));
+		if (!inFile || !consume(pathSize)) {
+			return ReadResult::Corrupt;
+		}
+		std::string includedPath(pathSize, '\0');
+		inFile.read(includedPath.data(), pathSize);
+		if (!inFile) {
+			return ReadResult::Corrupt;
+		}
+		try {
+			AfterglowShaderAsset includedAsset(includedPath);
+			if (util::HashBytes(includedAsset.code().data(), includedAsset.code().size()) != contentHash) {
+				return ReadResult::Outdated;
+			}
+		}
+		catch (const std::exception&) {
+			return ReadResult::Outdated;
+		}
+		if (destIncludedFiles) {
+			destIncludedFiles->push_back({ std::move(includedPath), contentHash });
+		}
+	}
+
+	// The report and the spirv must fill the rest of the file exactly.
+	uint64_t spirvByteSize = static_cast<uint64_t>(fileHead.spirvSize) * sizeof(uint32_t);
+	if (!consume(fileHead.reportSize) || remainingSize != spirvByteSize) {
+		return ReadResult::Corrupt;
+	}
+	std::string report(fileHead.reportSize, '\0');
+	inFile.read(report.data(), fileHead.reportSize);
+	if (!inFile) {
+		return ReadResult::Corrupt;
+	}
+
+	destSpirv.resize(fileHead.spirvSize);
+	inFile.read(reinterpret_cast<char*>(destSpirv.data()), spirvByteSize);
+	if (static_cast<uint64_t>(inFile.gcount()) != spirvByteSize
+		|| util::HashBytes(destSpirv.data(), destSpirv.size() * sizeof(uint32_t)) != fileHead.spirvHash) {
+		destSpirv.clear();
+		return ReadResult::Corrupt;
+	}
+	if (destReport) {
+		*destReport = std::move(report);
+	}
+	return ReadResult::Hit;
+}
+
+inline bool AfterglowSpirvCache::Impl::writeEntry(Key key, const SpirvBytes& spirv, const IncludedFiles& includedFiles, const std::string& report) const {
+	FileHead fileHead{};
+	fileHead.version = _currentVersion;
+	fileHead.key = key;
+	fileHead.includedFileCount = static_cast<uint32_t>(includedFiles.size());
+	fileHead.spirvSize = static_cast<uint32_t>(spirv.size());
+	fileHead.spirvHash = util::HashBytes(spirv.data(), spirv.size() * sizeof(uint32_t));
+	fileHead.reportSize = static_cast<uint32_t>(report.size());
+
+	// Write to a temporary file first, other threads or processes never read a partial entry.
+	std::string path = entryPath(key);
+	std::string tempPath = path + ".tmp";
+	{
+		std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+		if (!outFile) {
+			return false;
+		}
+		outFile.write(reinterpret_cast<const char*>(&fileHead), sizeof(FileHead));
+		for (const auto& includedFile : includedFiles) {
+			uint32_t pathSize = static_cast<uint32_t>(includedFile.path.size());
+			outFile.write(reinterpret_cast<const char*>(&pathSize), sizeof(pathSize));
+			outFile.write(reinterpret_cast<const char*>(&includedFile.contentHash), sizeof(includedFile.contentHash));
+			outFile.write(includedFile.path.data(), pathSize);
+		}
+		outFile.write(report.data(), report.size());
+		outFile.write(reinterpret_cast<const char*>(spirv.data()), spirv.size() * sizeof(uint32_t));
+		if (!outFile) {
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(tempPath, path, error);
+	return !error;
+}
+
+inline void AfterglowSpirvCache::Impl::evict(Key keptKey) {
+	if (statistics.totalSize <= maxSize) {
+		return;
+	}
+	std::vector<std::pair<FileTime, Key>> lruKeys;
+	lruKeys.reserve(entries.size());
+	for (const auto& [key, entry] : entries) {
+		if (key != keptKey) {
+			lruKeys.emplace_back(entry.lastUseTime, key);
+		}
+	}
+	std::sort(lruKeys.begin(), lruKeys.end());
+	for (const auto& [lastUseTime, key] : lruKeys) {
+		if (statistics.totalSize <= maxSize) {
+			break;
+		}
+		removeEntry(key);
+		++statistics.evictionCount;
+	}
+}
+
+inline void AfterglowSpirvCache::Impl::removeEntry(Key key) {
+	auto iterator = entries.find(key);
+	if (iterator == entries.end()) {
+		return;
+	}
+	std::error_code error;
+	std::filesystem::remove(entryPath(key), error);
+	statistics.totalSize -= iterator->second.size;
+	entries.erase(iterator);
+	statistics.entryCount = entries.size();
+}
+
+AfterglowSpirvCache::AfterglowSpirvCache(const std::string& directory, uint64_t maxSize) :
+	_impl(std::make_unique<Impl>(directory, maxSize)) {
+}
+
+AfterglowSpirvCache::~AfterglowSpirvCache() {
+	auto& statistics = _impl->statistics;
+	DEBUG_CLASS_INFO(std::format(
+		"Spirv cache hit: {}, miss: {}, evicted: {}, entries: {}, size: {} bytes.", 
+		statistics.hitCount, statistics.missCount, statistics.evictionCount, statistics.entryCount, statistics.totalSize
+	));
+}
+
+AfterglowSpirvCache::Key AfterglowSpirvCache::makeKey(const std::string& shaderCode, const std::vector<const wchar_t*>& compileArgs) noexcept {
+	Key key = util::HashBytes(&_currentVersion, sizeof(_currentVersion));
+	key = util::HashBytes(shaderCode.data(), shaderCode.size(), key);
+	for (const auto* arg : compileArgs) {
+		// Include the terminator, so {"ab", "c"} and {"a", "bc"} have different keys.
+		key = util::HashBytes(arg, (std::wcslen(arg) + 1) * sizeof(wchar_t), key);
+	}
+	return key;
+}
+
+bool AfterglowSpirvCache::load(Key key, SpirvBytes& destSpirv, IncludedFiles* destIncludedFiles, std::string* destReport) {
+	{
+		std::lock_guard lock(_impl->mutex);
+		if (!_impl->entries.contains(key)) {
+			++_impl->statistics.missCount;
+			return false;
+		}
+	}
+	// File reading is out of lock, entries are replaced by rename, so a reader always sees a complete file.
+	auto readResult = _impl->readEntry(key, destSpirv, destIncludedFiles, destReport);
+
+	std::lock_guard lock(_impl->mutex);
+	if (readResult == Impl::ReadResult::Corrupt) {
+		DEBUG_CLASS_WARNING(std::format("Spirv cache entry is corrupt, remove it: {}", _impl->entryPath(key)));
+		_impl->removeEntry(key);
+		++_impl->statistics.evictionCount;
+	}
+	if (readResult != Impl::ReadResult::Hit) {
+		++_impl->statistics.missCount;
+		return false;
+	}
+	++_impl->statistics.hitCount;
+	auto now = Impl::FileTime::clock::now();
+	if (auto iterator = _impl->entries.find(key); iterator != _impl->entries.end()) {
+		iterator->second.lastUseTime = now;
+	}
+	// Persist the use time for LRU eviction in next runs.
+	std::error_code error;
+	std::filesystem::last_write_time(_impl->entryPath(key), now, error);
+	return true;
+}
+
+void AfterglowSpirvCache::store(Key key, const SpirvBytes& spirv, const IncludedFiles& includedFiles, const std::string& report) {
+	std::lock_guard lock(_impl->mutex);
+	if (!_impl->writeEntry(key, spirv, includedFiles, report)) {
+		DEBUG_CLASS_WARNING(std::format("Failed to write spirv cache: {}", _impl->entryPath(key)));
+		return;
+	}
+	std::error_code error;
+	uint64_t size = std::filesystem::file_size(_impl->entryPath(key), error);
+	if (error) {
+		return;
+	}
+	auto& entry = _impl->entries[key];
+	_impl->statistics.totalSize += size - entry.size;
+	entry.size = size;
+	entry.lastUseTime = Impl::FileTime::clock::now();
+	_impl->statistics.entryCount = _impl->entries.size();
+	_impl->evict(key);
+}
+
+AfterglowSpirvCache::Statistics AfterglowSpirvCache::statistics() const {
+	std::lock_guard lock(_impl->mutex);
+	return _impl->statistics;
+}
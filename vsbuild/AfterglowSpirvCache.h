@@ -0,0 +1,69 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+/**
+* @brief: On-disk cache of compiled SPIR-V, one file per entry, evicts least recently used entries if over the size limit.
+* @desc:
+*	Key: hash of the HLSL code and DXC arguments (entry point, target profile and options are all arguments).
+*	Included files are only known after compilation, so each entry records the content hash of its included files,
+*	the entry is valid only if all of them are unchanged.
+*	Optimization report of the spirv is stored in the entry as well, so it's available without recompiling.
+* @note: Thread safe.
+*/
+class AfterglowSpirvCache {
+public:
+	using Key = uint64_t;
+	using SpirvBytes = std::vector<uint32_t>;
+
+	struct IncludedFile {
+		std::string path;
+		uint64_t contentHash;
+	};
+	using IncludedFiles = std::vector<IncludedFile>;
+
+	struct Statistics {
+		uint64_t hitCount = 0;
+		uint64_t missCount = 0;
+		uint64_t evictionCount = 0;
+		uint64_t entryCount = 0;
+		uint64_t totalSize = 0; // Unit::Bytes
+	};
+
+	struct alignas(8) FileHead {
+		// Afterglow spirv cache
+		char flag[4] = "asc";
+		uint32_t version;
+		uint64_t key;
+		uint32_t includedFileCount;
+		uint32_t spirvSize; // Count of uint32_t.
+		uint64_t spirvHash;
+		uint32_t reportSize;
+	};
+
+	// @param maxSize: Total size limit of cache files in bytes.
+	AfterglowSpirvCache(const std::string& directory, uint64_t maxSize);
+	~AfterglowSpirvCache();
+
+	static Key makeKey(const std::string& shaderCode, const std::vector<const wchar_t*>& compileArgs) noexcept;
+
+	/**
+	* @return: True if hit, destSpirv is filled with cached spirv.
+	* @param destIncludedFiles [optional]: Filled with included files of the entry if hit.
+	* @param destReport [optional]: Filled with the stored optimization report if hit, empty if not optimized.
+	*/
+	bool load(Key key, SpirvBytes& destSpirv, IncludedFiles* destIncludedFiles = nullptr, std::string* destReport = nullptr);
+	void store(Key key, const SpirvBytes& spirv, const IncludedFiles& includedFiles, const std::string& report = {});
+
+	Statistics statistics() const;
+
+private:
+	static inline uint32_t _currentVersion = 2;
+	static inline std::string _suffix = ".spv";
+
+	struct Impl;
+	std::unique_ptr<Impl> _impl;
+};
+
@@ -0,0 +1,134 @@
+#include "AfterglowSpirvOptimizer.h"
+
+#include <map>
+#include <format>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <spirv/unified1/spirv.hpp>
+#include <spirv-tools/optimizer.hpp>
+
+#include "DebugUtilities.h"
+
+std::string AfterglowSpirvOptimizer::Report::toString() const {
+	std::string result = std::format(
+		"Code size: {} -> {} bytes, instructions: {} -> {}, bindings: {} -> {}",
+		before.codeSize, after.codeSize,
+		before.instructionCount, after.instructionCount,
+		before.bindings.size(), after.bindings.size()
+	);
+	// Names are stripped in release version, so they are taken from the unoptimized module.
+	for (const auto& binding : before.bindings) {
+		bool kept = std::any_of(after.bindings.begin(), after.bindings.end(), [&binding](const auto& afterBinding) {
+			return afterBinding.set == binding.set && afterBinding.binding == binding.binding;
+		});
+		result += std::format("\n\tset {} binding {}: {}{}", binding.set, binding.binding, binding.name, kept ? "" : " (eliminated)");
+	}
+	return result;
+}
+
+AfterglowSpirvOptimizer::Statistics AfterglowSpirvOptimizer::analyze(const SpirvBytes& spirv) {
+	Statistics statistics;
+	if (spirv.size() < _headerSize || spirv[0] != spv::MagicNumber) {
+		return statistics;
+	}
+	statistics.codeSize = spirv.size() * sizeof(uint32_t);
+
+	struct Decorations {
+		uint32_t set = 0;
+		uint32_t binding = 0;
+		bool hasSet = false;
+		bool hasBinding = false;
+	};
+	std::unordered_map<uint32_t, std::string> names;
+	// Ordered by id, so bindings are stable before sorting.
+	std::map<uint32_t, Decorations> decorations;
+
+	for (size_t offset = _headerSize; offset < spirv.size(); ) {
+		uint32_t wordCount = spirv[offset] >> spv::WordCountShift;
+		uint32_t opcode = spirv[offset] & spv::OpCodeMask;
+		if (wordCount == 0 || offset + wordCount > spirv.size()) {
+			// Broken instruction stream.
+			return Statistics{};
+		}
+		++statistics.instructionCount;
+		const uint32_t* operands = spirv.data() + offset + 1;
+		if (opcode == spv::OpName && wordCount > 2) {
+			names[operands[0]] = literalString(operands + 1, wordCount - 2);
+		}
+		else if (opcode == spv::OpDecorate && wordCount > 3) {
+			auto& targetDecorations = decorations[operands[0]];
+			if (operands[1] == spv::DecorationDescriptorSet) {
+				targetDecorations.set = operands[2];
+				targetDecorations.hasSet = true;
+			}
+			else if (operands[1] == spv::DecorationBinding) {
+				targetDecorations.binding = operands[2];
+				targetDecorations.hasBinding = true;
+			}
+		}
+		offset += wordCount;
+	}
+
+	for (const auto& [id, targetDecorations] : decorations) {
+		if (!targetDecorations.hasBinding) {
+			continue;
+		}
+		auto nameIterator = names.find(id);
+		statistics.bindings.push_back(Binding{
+			.set = targetDecorations.set,
+			.binding = targetDecorations.binding,
+			.name = nameIterator != names.end() ? nameIterator->second : std::format("%{}", id)
+		});
+	}
+	std::sort(statistics.bindings.begin(), statistics.bindings.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.set != rhs.set ? lhs.set < rhs.set : lhs.binding < rhs.binding;
+	});
+	return statistics;
+}
+
+inline std::string AfterglowSpirvOptimizer::literalString(const uint32_t* words, size_t wordCount) {
+	const char* begin = reinterpret_cast<const char*>(words);
+	return std::string(begin, strnlen(begin, wordCount * sizeof(uint32_t)));
+}
+
+bool AfterglowSpirvOptimizer::optimize(SpirvBytes& spirv, Report* destReport) {
+	// DXC targets vulkan1.0 by default, shader model 6.2 and higher target vulkan1.1 (spirv 1.3).
+	constexpr uint32_t spirvVersion1_3 = 0x00010300;
+	bool vulkan1_1 = spirv.size() >= _headerSize && spirv[1] >= spirvVersion1_3;
+	spvtools::Optimizer optimizer(vulkan1_1 ? SPV_ENV_VULKAN_1_1 : SPV_ENV_VULKAN_1_0);
+	optimizer.SetMessageConsumer([](spv_message_level_t level, const char*, const spv_position_t& position, const char* message) {
+		if (level <= SPV_MSG_ERROR) {
+			DEBUG_TYPE_WARNING(AfterglowSpirvOptimizer, std::format("Spirv optimizer at {}: {}", position.index, message));
+		}
+	});
+	optimizer
+		.RegisterPass(spvtools::CreateInlineExhaustivePass())
+		.RegisterPass(spvtools::CreateEliminateDeadFunctionsPass())
+		.RegisterPass(spvtools::CreateLocalSingleStoreElimPass())
+		.RegisterPass(spvtools::CreateCCPPass())
+		.RegisterPass(spvtools::CreateFoldSpecConstantOpAndCompositePass())
+		.RegisterPass(spvtools::CreateDeadBranchElimPass())
+		.RegisterPass(spvtools::CreateAggressiveDCEPass())
+		.RegisterPass(spvtools::CreateEliminateDeadConstantPass())
+	#ifndef _DEBUG
+		.RegisterPass(spvtools::CreateStripDebugInfoPass())
+	#endif
+		.RegisterPass(spvtools::CreateCompactIdsPass());
+
+	// -fvk-use-dx-layout generates block layouts which the validator rejects by default, DXC has validated the module already.
+	spvtools::OptimizerOptions options;
+	options.set_run_validator(false);
+
+	SpirvBytes optimizedSpirv;
+	if (!optimizer.Run(spirv.data(), spirv.size(), &optimizedSpirv, options)) {
+		return false;
+	}
+	if (destReport) {
+		destReport->before = analyze(spirv);
+		destReport->after = analyze(optimizedSpirv);
+	}
+	spirv = std::move(optimizedSpirv);
+	return true;
+}
+
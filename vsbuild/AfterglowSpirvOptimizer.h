@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+* @brief: Post-compile SPIR-V optimization passes and size report of compiled shaders.
+* @desc:
+*	Passes: inlining, constant folding and propagation, dead branch / code / constant elimination,
+*	debug info (names) is stripped in release version.
+*	Material shaders are concatenated from many snippets, most of the code is dead for a specific material,
+*	the report makes the bloat trackable.
+* @note: Thread safe, each call creates its own optimizer.
+*/
+class AfterglowSpirvOptimizer {
+public:
+	using SpirvBytes = std::vector<uint32_t>;
+
+	struct Binding {
+		uint32_t set = 0;
+		uint32_t binding = 0;
+		std::string name;
+	};
+
+	struct Statistics {
+		uint64_t codeSize = 0; // Unit::Bytes
+		uint32_t instructionCount = 0;
+		std::vector<Binding> bindings; // In order of set and binding.
+	};
+
+	struct Report {
+		Statistics before;
+		Statistics after;
+
+		// @brief: Readable report, multiple lines.
+		std::string toString() const;
+	};
+
+	// @return: Statistics of the spirv, empty if it is not a valid spirv module.
+	static Statistics analyze(const SpirvBytes& spirv);
+
+	/**
+	* @brief: Run optimization passes in place.
+	* @param destReport [optional]: Filled with statistics before and after optimization.
+	* @return: False if the optimizer failed, spirv is unchanged in this case.
+	*/
+	static bool optimize(SpirvBytes& spirv, Report* destReport = nullptr);
+
+private:
+	// Magic, version, generator, bound and schema.
+	static inline size_t _headerSize = 5;
+
+	// @brief: Null terminated literal string in words.
+	static inline std::string literalString(const uint32_t* words, size_t wordCount);
+};
+
@@ -3,6 +3,12 @@
 class AfterglowStagingBuffer : public AfterglowBuffer<AfterglowStagingBuffer> {
 public:
 	AfterglowStagingBuffer(AfterglowDevice& device, const void* bufferSource, uint64_t bufferSize);
+	// @brief: Persistently mapped staging buffer, it keeps mapped until destruction, see AfterglowUploadContext.
+	AfterglowStagingBuffer(AfterglowDevice& device, uint64_t bufferSize);
+	~AfterglowStagingBuffer();
+
+	// @return: Host address of the persistent mapping, nullptr if the buffer was filled once.
+	void* mapped() noexcept;
 
 protected:
 	uint64_t byteSize() override;
@@ -11,5 +17,6 @@ private:
 	// Fill memory with data.
 	inline void fillMemory(const void* bufferSource, size_t bufferSize);
 	uint64_t _size;
+	void* _mapped = nullptr;
 };
 
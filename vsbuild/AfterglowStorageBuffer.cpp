@@ -1,12 +1,10 @@
 #include "AfterglowStorageBuffer.h"
 
-#include "AfterglowCommandPool.h"
-#include "AfterglowGraphicsQueue.h"
-#include "AfterglowStagingBuffer.h"
+#include "AfterglowUploadContext.h"
 
 
 
-AfterglowStorageBuffer::AfterglowStorageBuffer(AfterglowDevice& device, const void* buffer, uint64_t bufferSize, compute::SSBOUsage usage) :
+AfterglowStorageBuffer::AfterglowStorageBuffer(AfterglowDevice& device, const void* buffer, uint64_t bufferSize, compute::SSBOUsage usage, bool asyncShared) :
 	AfterglowBuffer(device), _buffer(buffer), _bufferSize(bufferSize) {
 	// TODO: Here usage vertex buffer should be optional?
 	info().usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
@@ -25,6 +23,14 @@ AfterglowStorageBuffer::AfterglowStorageBuffer(AfterglowDevice& device, const vo
 		break;
 	}
 
+	// Graphics and async compute read it in the same frame, exclusive ownership could not be transferred for that.
+	if (asyncShared && device.asyncComputeEnabled()) {
+		auto& familyIndices = device.asyncComputeSharedFamilyIndices();
+		info().sharingMode = VK_SHARING_MODE_CONCURRENT;
+		info().queueFamilyIndexCount = static_cast<uint32_t>(familyIndices.size());
+		info().pQueueFamilyIndices = familyIndices.data();
+	}
+
 	initMemory(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 }
 
@@ -38,15 +44,11 @@ AfterglowStorageBuffer::AfterglowStorageBuffer(AfterglowDevice& device, const vo
 //	return AfterglowStorageBuffer::makeElement(device, &command, sizeof(VkDrawIndexedIndirectCommand), compute::SSBOUsage::Indirect);
 //}
 
-void AfterglowStorageBuffer::submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue) {
-	AfterglowStagingBuffer stagingBuffer(_device, _buffer, _bufferSize);
-	submit(commandPool, graphicsQueue, stagingBuffer);
-}
-
-void AfterglowStorageBuffer::submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue, AfterglowStagingBuffer& stagingBuffer) {
-	commandPool.allocateSingleCommand(
-		graphicsQueue,
-		[this, &stagingBuffer](VkCommandBuffer commandBuffer) {cmdCopyBuffer(commandBuffer, stagingBuffer); }
+void AfterglowStorageBuffer::submit(AfterglowUploadContext& uploadContext) {
+	uploadContext.upload(
+		_buffer, 
+		_bufferSize, 
+		[this](VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset) {cmdCopyBuffer(commandBuffer, srcBuffer, srcOffset); }
 	);
 }
 
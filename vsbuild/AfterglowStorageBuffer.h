@@ -2,29 +2,22 @@
 #include "AfterglowBuffer.h"
 #include "ComputeDefinitions.h"
 
-class AfterglowCommandPool;
-class AfterglowGraphicsQueue;
-class AfterglowStagingBuffer;
+class AfterglowUploadContext;
 
 class AfterglowStorageBuffer : public AfterglowBuffer<AfterglowStorageBuffer> {
 public:
-	AfterglowStorageBuffer(AfterglowDevice& device, const void* buffer, uint64_t bufferSize, compute::SSBOUsage usage);
+	// @param asyncShared: Share the buffer with async compute queue family in concurrent sharing mode.
+	AfterglowStorageBuffer(AfterglowDevice& device, const void* buffer, uint64_t bufferSize, compute::SSBOUsage usage, bool asyncShared = false);
 
 	//static AfterglowStorageBuffer::AsElement makeIndirectCommandBuffer(AfterglowDevice& device);
 	//static AfterglowStorageBuffer::AsElement makeIndexedIndirectCommandBuffer(AfterglowDevice& device);
 
 	/**
 	* @usage: 
-	*	Submit single storage buffer, staging buffer will be created automatically.
+	*	Copy the source buffer to the staging ring and record the buffer copy into the current upload batch.
+	*	Source buffer can be released after submission.
 	*/
-	void submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue);
-
-	/**
-	* @usage: 
-	* 	If you want to create multiple buffers, use this interface to use shared staging buffer. 
-	* Reducing staging buffer construction cost.
-	*/
-	void submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue, AfterglowStagingBuffer& stagingBuffer);
+	void submit(AfterglowUploadContext& uploadContext);
 
 	uint64_t byteSize() override;
 
@@ -1,15 +1,14 @@
 #include "AfterglowStorageImage.h"
-#include "AfterglowCommandPool.h"
-#include "AfterglowGraphicsQueue.h"
 #include "AfterglowStorageBuffer.h"
-#include "AfterglowStagingBuffer.h"
+#include "AfterglowUploadContext.h"
 
 AfterglowStorageImage::AfterglowStorageImage(
 	AfterglowDevice& device, 
 	VkExtent3D extent, 
 	VkFormat format, 
 	compute::SSBOTextureDimension dimension, 
-	compute::SSBOTextureSampleMode sampleMode) :
+	compute::SSBOTextureSampleMode sampleMode, 
+	bool asyncShared) :
 	AfterglowImage(device) {
 	info().format = format;
 	// TODO: If storage image is pure GPU image, don't use transfer dst.
@@ -61,11 +60,18 @@ AfterglowStorageImage::AfterglowStorageImage(
 		DEBUG_CLASS_WARNING("Unknown sample mode, the storage image will apply the default sample mode: LinearRepeat.");
 	}
 
+	if (asyncShared && device.asyncComputeEnabled()) {
+		auto& familyIndices = device.asyncComputeSharedFamilyIndices();
+		info().sharingMode = VK_SHARING_MODE_CONCURRENT;
+		info().queueFamilyIndexCount = static_cast<uint32_t>(familyIndices.size());
+		info().pQueueFamilyIndices = familyIndices.data();
+	}
+
 	initMemory(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 }
 
-void AfterglowStorageImage::submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue, AfterglowStagingBuffer& stagingBuffer) {
-	commandPool.allocateSingleCommand(graphicsQueue, [this](VkCommandBuffer commandBuffer) {
+void AfterglowStorageImage::submit(AfterglowUploadContext& uploadContext, const void* data, uint64_t byteSize) {
+	uploadContext.upload(data, byteSize, [this](VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset) {
 		auto barrier = makeBarrier(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 		barrier.srcAccessMask = 0;
 		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -81,11 +87,9 @@ void AfterglowStorageImage::submit(AfterglowCommandPool& commandPool, AfterglowG
 			1, 
 			&barrier
 		);
-	});
 
-	commandPool.allocateSingleCommand(graphicsQueue, [this, &stagingBuffer](VkCommandBuffer commandBuffer) {
 		VkBufferImageCopy region {
-			.bufferOffset = 0, 
+			.bufferOffset = srcOffset, 
 			.bufferRowLength = 0, 
 			.bufferImageHeight = 0, 
 			.imageSubresource = {
@@ -101,11 +105,9 @@ void AfterglowStorageImage::submit(AfterglowCommandPool& commandPool, AfterglowG
 				static_cast<uint32_t>(_imageInfo.depth) 
 			}
 		};
-		vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, *this, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-	});
+		vkCmdCopyBufferToImage(commandBuffer, srcBuffer, *this, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 
-	commandPool.allocateSingleCommand(graphicsQueue, [this](VkCommandBuffer commandBuffer) {
-		auto barrier = makeBarrier(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+		barrier = makeBarrier(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
 		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
 
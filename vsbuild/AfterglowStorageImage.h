@@ -2,9 +2,7 @@
 #include "AfterglowImage.h"
 #include "ComputeDefinitions.h"
 
-class AfterglowCommandPool;
-class AfterglowGraphicsQueue;
-class AfterglowStagingBuffer;
+class AfterglowUploadContext;
 
 class AfterglowStorageImage : public AfterglowImage<AfterglowStorageImage> {
 public:
@@ -13,10 +11,12 @@ public:
 		VkExtent3D extent, 
 		VkFormat format, 
 		compute::SSBOTextureDimension dimension = compute::SSBOTextureDimension::Texture2D, 
-		compute::SSBOTextureSampleMode sampleMode = compute::SSBOTextureSampleMode::LinearRepeat
+		compute::SSBOTextureSampleMode sampleMode = compute::SSBOTextureSampleMode::LinearRepeat, 
+		bool asyncShared = false
 	);
 
-	void submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue, AfterglowStagingBuffer& stagingBuffer);
+	// @brief: Record layout transitions and the initial data copy into the current upload batch.
+	void submit(AfterglowUploadContext& uploadContext, const void* data, uint64_t byteSize);
 
 };
 
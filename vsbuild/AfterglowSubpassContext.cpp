@@ -37,11 +37,11 @@ VkAttachmentDescription AfterglowSubpassContext::depthAttachment(VkFormat format
 	return attachment;
 }
 
-VkAttachmentDescription AfterglowSubpassContext::presentAttachment(VkFormat format, PassUsage usage) {
+VkAttachmentDescription AfterglowSubpassContext::presentAttachment(VkFormat format, VkImageLayout presentLayout, PassUsage usage) {
 	auto attachment = emptyAttachment(format, VK_SAMPLE_COUNT_1_BIT);
 	modifyAttachmentByPassUsage(usage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, attachment);
 	attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-	attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	attachment.finalLayout = presentLayout;
 	return attachment;
 }
 
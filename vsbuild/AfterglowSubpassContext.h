@@ -38,12 +38,15 @@ public:
 
 	// @note: It seems is a hack.
 	inline static VkImageLayout depthAttachmentRWLayout() { return VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_STENCIL_READ_ONLY_OPTIMAL; }
+	// @param presentable: False in headless mode, offscreen targets are left for readback instead of presenting.
+	inline static VkImageLayout presentLayout(bool presentable) { return presentable ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL; }
 
 	// Attachment presets
 	static VkAttachmentDescription transferAttachment(VkFormat format, PassUsage usage = PassUsage::Local, VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT);
 	static VkAttachmentDescription nonTransferAttachment(VkFormat format, PassUsage usage = PassUsage::Local, VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT);
 	static VkAttachmentDescription depthAttachment(VkFormat format, PassUsage usage = PassUsage::Local, VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT);
-	static VkAttachmentDescription presentAttachment(VkFormat format, PassUsage usage = PassUsage::Export);
+	// @param presentLayout: See presentLayout().
+	static VkAttachmentDescription presentAttachment(VkFormat format, VkImageLayout presentLayout, PassUsage usage = PassUsage::Export);
 	static VkAttachmentDescription emptyAttachment(VkFormat format, VkSampleCountFlagBits sampleCount);
 
 	// Dependency presets
@@ -1,20 +1,45 @@
 #include "AfterglowSynchronizer.h"
 #include <stdexcept>
+#include <algorithm>
 
 #include "AfterglowUtilities.h"
+#include "DebugUtilities.h"
 
 AfterglowSynchronizer::AfterglowSynchronizer(AfterglowDevice& device) : 
+	_backend(device.timelineSemaphoreEnabled() ? Backend::Timeline : Backend::Fence), 
 	_device(device) {
 	for (int frameIndex = 0; frameIndex < cfg::maxFrameInFlight; ++frameIndex) {
 		auto& semaphores = _inFlightSemaphores[frameIndex];
-		auto& fences = _inFlightFences[frameIndex];
 		semaphores.recreate(device, util::EnumValue(SemaphoreFlag::EnumCount));
-		fences.recreate(device, util::EnumValue(FenceFlag::EnumCount));
+		if (!timelined()) {
+			_inFlightFences[frameIndex].recreate(device, util::EnumValue(FenceFlag::EnumCount));
+		}
 	}
+	if (timelined()) {
+		_timelineSemaphores.recreate(device, util::EnumValue(TimelineFlag::EnumCount), VK_SEMAPHORE_TYPE_TIMELINE);
+	}
+	DEBUG_CLASS_INFO(timelined() ? "Timeline semaphore backend is enabled." : "Fence backend is enabled.");
+}
+
+AfterglowSynchronizer::Backend AfterglowSynchronizer::backend() const noexcept {
+	return _backend;
+}
+
+bool AfterglowSynchronizer::timelined() const noexcept {
+	return _backend == Backend::Timeline;
 }
 
 void AfterglowSynchronizer::wait(FenceFlag fenceFlag) {
-	vkWaitForFences(_device, 1, &fence(fenceFlag), VK_TRUE,  UINT64_MAX);
+	wait(fenceFlag, _device.currentFrameIndex());
+}
+
+void AfterglowSynchronizer::wait(FenceFlag fenceFlag, uint32_t frameIndex) {
+	if (timelined()) {
+		auto flag = toTimelineFlag(fenceFlag);
+		wait(flag, _inFlightTimelinePoints[frameIndex][util::EnumValue(flag)]);
+		return;
+	}
+	vkWaitForFences(_device, 1, &fence(fenceFlag, frameIndex), VK_TRUE, UINT64_MAX);
 }
 
 VkResult AfterglowSynchronizer::fenceStatus(FenceFlag fenceFlag) {
@@ -22,6 +47,9 @@ VkResult AfterglowSynchronizer::fenceStatus(FenceFlag fenceFlag) {
 }
 
 void AfterglowSynchronizer::reset(FenceFlag fenceFlag) {
+	if (timelined()) {
+		return;
+	}
 	vkResetFences(_device, 1, &fence(fenceFlag));
 }
 
@@ -33,6 +61,109 @@ VkFence& AfterglowSynchronizer::fence(FenceFlag fenceFlag) {
 	return _inFlightFences[_device.currentFrameIndex()][util::EnumValue(fenceFlag)];
 }
 
+VkFence& AfterglowSynchronizer::fence(FenceFlag fenceFlag, uint32_t frameIndex) {
+	return _inFlightFences[frameIndex][util::EnumValue(fenceFlag)];
+}
+
+VkFence AfterglowSynchronizer::submitFence(FenceFlag fenceFlag) {
+	return timelined() ? VK_NULL_HANDLE : fence(fenceFlag);
+}
+
+VkSemaphore& AfterglowSynchronizer::timelineSemaphore(TimelineFlag timelineFlag) {
+	return _timelineSemaphores[util::EnumValue(timelineFlag)];
+}
+
+uint64_t AfterglowSynchronizer::advance(TimelineFlag timelineFlag) {
+	auto flagIndex = util::EnumValue(timelineFlag);
+	uint64_t value = ++_submittedPoint[flagIndex];
+	_inFlightTimelinePoints[_device.currentFrameIndex()][flagIndex] = value;
+	return value;
+}
+
+uint64_t AfterglowSynchronizer::submittedValue(TimelineFlag timelineFlag) const noexcept {
+	return _submittedPoint[util::EnumValue(timelineFlag)];
+}
+
+uint64_t AfterglowSynchronizer::frameValue(TimelineFlag timelineFlag, uint32_t frameIndex) const noexcept {
+	return _inFlightTimelinePoints[frameIndex][util::EnumValue(timelineFlag)];
+}
+
+uint64_t AfterglowSynchronizer::completedValue(TimelineFlag timelineFlag) {
+	auto flagIndex = util::EnumValue(timelineFlag);
+	auto& completedValue = _completedPoint[flagIndex];
+	if (timelined()) {
+		vkGetSemaphoreCounterValue(_device, timelineSemaphore(timelineFlag), &completedValue);
+		return completedValue;
+	}
+	auto fenceFlag = toFenceFlag(timelineFlag);
+	for (uint32_t frameIndex = 0; frameIndex < cfg::maxFrameInFlight; ++frameIndex) {
+		if (vkGetFenceStatus(_device, fence(fenceFlag, frameIndex)) == VK_SUCCESS) {
+			completedValue = std::max(completedValue, _inFlightTimelinePoints[frameIndex][flagIndex]);
+		}
+	}
+	return completedValue;
+}
+
+void AfterglowSynchronizer::wait(TimelineFlag timelineFlag, uint64_t value) {
+	if (value <= _completedPoint[util::EnumValue(timelineFlag)]) {
+		return;
+	}
+	if (timelined()) {
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &timelineSemaphore(timelineFlag);
+		waitInfo.pValues = &value;
+		vkWaitSemaphores(_device, &waitInfo, UINT64_MAX);
+		_completedPoint[util::EnumValue(timelineFlag)] = value;
+		return;
+	}
+	// Wait the earliest frame slot which submitted this value or a later one.
+	auto flagIndex = util::EnumValue(timelineFlag);
+	uint32_t waitFrameIndex = cfg::maxFrameInFlight;
+	for (uint32_t frameIndex = 0; frameIndex < cfg::maxFrameInFlight; ++frameIndex) {
+		uint64_t frameValue = _inFlightTimelinePoints[frameIndex][flagIndex];
+		if (frameValue >= value 
+			&& (waitFrameIndex == cfg::maxFrameInFlight || frameValue < _inFlightTimelinePoints[waitFrameIndex][flagIndex])) {
+			waitFrameIndex = frameIndex;
+		}
+	}
+	if (waitFrameIndex == cfg::maxFrameInFlight) {
+		DEBUG_CLASS_WARNING("Timeline value was not submitted yet, skip waiting.");
+		return;
+	}
+	vkWaitForFences(_device, 1, &fence(toFenceFlag(timelineFlag), waitFrameIndex), VK_TRUE, UINT64_MAX);
+	completedValue(timelineFlag);
+}
+
+AfterglowSynchronizer::TimelinePoint AfterglowSynchronizer::submittedPoint() const noexcept {
+	return _submittedPoint;
+}
+
+bool AfterglowSynchronizer::completed(const TimelinePoint& point) {
+	for (uint32_t flagIndex = 0; flagIndex < point.size(); ++flagIndex) {
+		if (point[flagIndex] > _completedPoint[flagIndex]
+			&& point[flagIndex] > completedValue(static_cast<TimelineFlag>(flagIndex))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void AfterglowSynchronizer::wait(const TimelinePoint& point) {
+	for (uint32_t flagIndex = 0; flagIndex < point.size(); ++flagIndex) {
+		wait(static_cast<TimelineFlag>(flagIndex), point[flagIndex]);
+	}
+}
+
 AfterglowDevice& AfterglowSynchronizer::device() noexcept {
 	return _device;
 }
+
+inline AfterglowSynchronizer::TimelineFlag AfterglowSynchronizer::toTimelineFlag(FenceFlag fenceFlag) noexcept {
+	return fenceFlag == FenceFlag::ComputeInFlight ? TimelineFlag::Compute : TimelineFlag::Render;
+}
+
+inline AfterglowSynchronizer::FenceFlag AfterglowSynchronizer::toFenceFlag(TimelineFlag timelineFlag) noexcept {
+	return timelineFlag == TimelineFlag::Compute ? FenceFlag::ComputeInFlight : FenceFlag::RenderInFlight;
+}
@@ -8,9 +8,19 @@
 
 class AfterglowSynchronizer : public AfterglowObject {
 public:
+	enum class Backend {
+		// One fence per queue per frame slot, CPU waits by frame slot.
+		Fence, 
+		// One timeline semaphore per queue, CPU waits by value.
+		Timeline, 
+
+		EnumCount
+	};
+
 	enum class SemaphoreFlag {
 		ImageAvaliable,  
 		RenderFinished, 
+		// Fence backend only, timeline backend waits the compute timeline value instead.
 		ComputeFinished, 
 
 		EnumCount
@@ -23,26 +33,86 @@ public:
 		EnumCount
 	};
 
+	enum class TimelineFlag {
+		Compute, 
+		Render, 
+		// Dedicated compute queue, it is never advanced in fence backend.
+		AsyncCompute, 
+
+		EnumCount
+	};
+
+	// Timeline value of each queue, a resource is retired when all of them are completed.
+	using TimelinePoint = std::array<uint64_t, util::EnumValue(TimelineFlag::EnumCount)>;
+
 	using InFlightSemaphores = std::array<AfterglowSemaphores::AsElement, cfg::maxFrameInFlight>;
 	using InFlightFences = std::array<AfterglowFences::AsElement, cfg::maxFrameInFlight>;
+	using InFlightTimelinePoints = std::array<TimelinePoint, cfg::maxFrameInFlight>;
+
+	// @note: Timeline backend is selected if the device enabled timeline semaphore, otherwise fallback to fence backend.
 	AfterglowSynchronizer(AfterglowDevice& device);
 
+	Backend backend() const noexcept;
+	bool timelined() const noexcept;
+
 	// Waiting for response from GPU.
 	void wait(FenceFlag fenceFlag);
+	// @brief: Wait for the fence of a specific frame slot.
+	void wait(FenceFlag fenceFlag, uint32_t frameIndex);
+	// @warning: Fence backend only.
 	VkResult fenceStatus(FenceFlag fenceFlag);
 
-	// After waiting, reset fences manually.
+	// After waiting, reset fences manually. It does nothing in timeline backend.
 	void reset(FenceFlag fenceFlag);
 
 	VkSemaphore& semaphore(SemaphoreFlag semaphoreFlag);
+	// @warning: Fence backend only.
 	VkFence& fence(FenceFlag fenceFlag);
+	// @warning: Fence backend only.
+	VkFence& fence(FenceFlag fenceFlag, uint32_t frameIndex);
+	// @return: Fence to submit with, VK_NULL_HANDLE in timeline backend.
+	VkFence submitFence(FenceFlag fenceFlag);
+
+	// @warning: Timeline backend only.
+	VkSemaphore& timelineSemaphore(TimelineFlag timelineFlag);
+
+	/**
+	* @brief: Increase the timeline value of a queue, call it once per submission of that queue.
+	* @return: The value which should be signaled by this submission.
+	* @note: Value is tracked in fence backend too, it is completed when the fence of its frame slot is signaled.
+	*/
+	uint64_t advance(TimelineFlag timelineFlag);
+	// @return: The value signaled by the last submission.
+	uint64_t submittedValue(TimelineFlag timelineFlag) const noexcept;
+	// @return: The value signaled by the last submission in a frame slot.
+	uint64_t frameValue(TimelineFlag timelineFlag, uint32_t frameIndex) const noexcept;
+	// @return: The greatest value the GPU has finished, never blocking.
+	uint64_t completedValue(TimelineFlag timelineFlag);
+	// @brief: Wait until the GPU finished the value.
+	void wait(TimelineFlag timelineFlag, uint64_t value);
+
+	TimelinePoint submittedPoint() const noexcept;
+	bool completed(const TimelinePoint& point);
+	void wait(const TimelinePoint& point);
 
 	AfterglowDevice& device() noexcept;
 
 private:
+	// Each fence flag is the fallback of a timeline.
+	static inline TimelineFlag toTimelineFlag(FenceFlag fenceFlag) noexcept;
+	static inline FenceFlag toFenceFlag(TimelineFlag timelineFlag) noexcept;
+
 	InFlightSemaphores _inFlightSemaphores;
 	InFlightFences _inFlightFences;
+	AfterglowSemaphores::AsElement _timelineSemaphores;
+
+	// Timeline values of the last submission in each frame slot.
+	InFlightTimelinePoints _inFlightTimelinePoints{};
+	TimelinePoint _submittedPoint{};
+	// Cache for fence backend, fences only tell the latest submission of a frame slot.
+	TimelinePoint _completedPoint{};
 
+	Backend _backend;
 	AfterglowDevice& _device;
 };
 
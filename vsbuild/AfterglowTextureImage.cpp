@@ -2,9 +2,7 @@
 #include <cmath>
 
 
-#include "AfterglowCommandPool.h"
-#include "AfterglowGraphicsQueue.h"
-#include "AfterglowStagingBuffer.h"
+#include "AfterglowUploadContext.h"
 #include "ExceptionUtilities.h"
 
 
@@ -41,49 +39,28 @@ std::weak_ptr<img::DataArray> AfterglowTextureImage::imageData() {
 	return _imageData;
 }
 
-void AfterglowTextureImage::submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue) {
+void AfterglowTextureImage::submit(AfterglowUploadContext& uploadContext) {
 	auto lockedPtr = imageData().lock();
 	if (!lockedPtr) {
 		throw runtimeError("Image data not found, due to the image data source was destructed.");
 	}
-	AfterglowStagingBuffer stagingBuffer(_device, lockedPtr->data(), size());
 
-	commandPool.allocateSingleCommand(
-		graphicsQueue,
-		[this](VkCommandBuffer commandBuffer) {
+	uploadContext.upload(
+		lockedPtr->data(), 
+		size(), 
+		[this](VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset) {
 			cmdPipelineBarrier(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL); 
-		}
-	);
-
-	commandPool.allocateSingleCommand(
-		graphicsQueue,
-		[this, &stagingBuffer](VkCommandBuffer commandBuffer) {
-			cmdCopyBufferToImage(commandBuffer, stagingBuffer);
-		}
-	);
-
-	// Transitioned to VK_IMAGE_LAYOUT_SHDAER_READ_ONLY_OPTIMAL while generating mipmaps.
-	//commandPool.allocateSingleCommand(
-	//	graphicsQueue,
-	//	[this](VkCommandBuffer commandBuffer) {
-	//		cmdPipelineBarrier(
-	//			commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-	//		);
-	//	}
-	//);
-
-	// TODO: Generate mipmap when Offline (or save as cache).
-	commandPool.allocateSingleCommand(
-		graphicsQueue,
-		[this](VkCommandBuffer commandBuffer) {
+			cmdCopyBufferToImage(commandBuffer, srcBuffer, srcOffset);
+			// Transitioned to VK_IMAGE_LAYOUT_SHDAER_READ_ONLY_OPTIMAL while generating mipmaps.
+			// TODO: Generate mipmap when Offline (or save as cache).
 			cmdGenerateMipmaps(commandBuffer);
 		}
 	);
 }
 
-void AfterglowTextureImage::cmdCopyBufferToImage(VkCommandBuffer commandBuffer, AfterglowStagingBuffer& srcStagingBuffer) {
+void AfterglowTextureImage::cmdCopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset) {
 	VkBufferImageCopy region{};
-	region.bufferOffset = 0;
+	region.bufferOffset = srcOffset;
 	region.bufferRowLength = 0;
 	region.bufferImageHeight = 0;
 
@@ -95,7 +72,7 @@ void AfterglowTextureImage::cmdCopyBufferToImage(VkCommandBuffer commandBuffer,
 	region.imageOffset = { 0, 0, 0 };
 	region.imageExtent = { static_cast<uint32_t>(_imageInfo.width), static_cast<uint32_t>(_imageInfo.height), 1 };
 
-	vkCmdCopyBufferToImage(commandBuffer, srcStagingBuffer, *this, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	vkCmdCopyBufferToImage(commandBuffer, srcBuffer, *this, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 }
 
 void AfterglowTextureImage::cmdPipelineBarrier(VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout) {
@@ -1,9 +1,7 @@
 #pragma once
 #include "AfterglowImage.h"
 
-class AfterglowCommandPool;
-class AfterglowGraphicsQueue;
-class AfterglowStagingBuffer;
+class AfterglowUploadContext;
 
 class AfterglowTextureImage : public AfterglowImage<AfterglowTextureImage> {
 public:
@@ -13,12 +11,12 @@ public:
 	void bind(const img::Info& info, std::weak_ptr<img::DataArray> imageData);
 	std::weak_ptr<img::DataArray> imageData();
 
-	// Creating a staging buffer to transfer data to GPU and then free imageData automatically.
-	void submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue);
+	// Record layout transition, copy and mipmap generation into the current upload batch, imageData can be freed after then.
+	void submit(AfterglowUploadContext& uploadContext);
 
 private:
-	// These cmd functin use for single time command.
-	void cmdCopyBufferToImage(VkCommandBuffer commandBuffer, AfterglowStagingBuffer& srcStagingBuffer);
+	// These cmd functin use for upload batch.
+	void cmdCopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset);
 	void cmdPipelineBarrier(VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout);
 	void cmdGenerateMipmaps(VkCommandBuffer commandBuffer);
 
@@ -5,9 +5,11 @@ AfterglowUniformBuffer::AfterglowUniformBuffer(AfterglowDevice& device, const vo
 	info().usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 	// info().size = _uniformSize;
 	initMemory(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-	// Do not unmap for Persistent Mapping.
-	vkMapMemory(device, _memory, 0, _uniformSize, 0, &_mapped);
-	updateMemory();
+	// Persistent mapped by the memory allocator.
+	_mapped = _memory.mapped();
+	if (_uniform) {
+		updateMemory();
+	}
 }
 
 void AfterglowUniformBuffer::updateMemory() {
@@ -19,6 +21,10 @@ void AfterglowUniformBuffer::updateMemory(const void* uniform) {
 	updateMemory();
 }
 
+void AfterglowUniformBuffer::writeMemory(const void* data, uint64_t size, uint64_t offset) {
+	memcpy(static_cast<char*>(_mapped) + offset, data, size);
+}
+
 uint64_t AfterglowUniformBuffer::byteSize() {
 	return _uniformSize;
 }
@@ -4,6 +4,7 @@
 
 class AfterglowUniformBuffer : public AfterglowBuffer<AfterglowUniformBuffer> {
 public:
+	// @param uniform: Could be nullptr if the memory is written by writeMemory() only.
 	AfterglowUniformBuffer(AfterglowDevice& device, const void* uniform, uint64_t uniformSize);
 
 	void updateMemory();
@@ -12,6 +13,11 @@ public:
 	* @warning: Make sure input uniform size equal to byteSize().
 	*/
 	void updateMemory(const void* uniform);
+	/**
+	* @brief: Copy data into mapped memory directly, source data is not changed.
+	* @warning: Make sure offset + size not greater than byteSize().
+	*/
+	void writeMemory(const void* data, uint64_t size, uint64_t offset = 0);
 
 	uint64_t byteSize() override;
 
@@ -0,0 +1,259 @@
+#include "AfterglowUploadContext.h"
+
+#include <array>
+#include <deque>
+#include <vector>
+#include <cstring>
+#include <format>
+
+#include "AfterglowCommandPool.h"
+#include "AfterglowGraphicsQueue.h"
+#include "AfterglowStagingBuffer.h"
+#include "AfterglowFences.h"
+#include "RingAllocator.h"
+#include "Configurations.h"
+#include "DebugUtilities.h"
+#include "ExceptionUtilities.h"
+
+struct AfterglowUploadContext::Impl {
+	struct Batch {
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		// Taken when the batch was submitted, ring space of the batch is released with it.
+		RingAllocator::Mark ringMark;
+		bool recording = false;
+		std::vector<AfterglowStagingBuffer::AsElement> oversizeBuffers;
+	};
+
+	Impl(AfterglowDevice& inDevice, AfterglowGraphicsQueue& inGraphicsQueue);
+
+	Batch& current() noexcept;
+	VkCommandBuffer begin();
+	// @return: False if nothing was recorded.
+	bool submit();
+	// @brief: Block until the oldest in flight batch was completed, then release its staging memory.
+	void retireOldest();
+	// @brief: Release completed batches without blocking.
+	void retireFinished();
+
+	// Satisfies buffer copy and texel size alignment of all supported image formats.
+	static inline VkDeviceSize _alignment = 16;
+
+	AfterglowDevice& device;
+	AfterglowGraphicsQueue& graphicsQueue;
+	AfterglowCommandPool::AsElement commandPool;
+	AfterglowFences::AsElement fences;
+	AfterglowStagingBuffer::AsElement ring;
+	RingAllocator ringAllocator{ cfg::stagingRingSize, _alignment };
+
+	std::array<Batch, cfg::uploadBatchCount> batches;
+	// Submitted batch indices, from the oldest one.
+	std::deque<uint32_t> inFlightBatches;
+	uint32_t currentBatchIndex = 0;
+
+	// Batches are retired in order of submission, so tickets are their sequence numbers.
+	uint64_t submittedSequence = 0;
+	uint64_t completedSequence = 0;
+	uint64_t budgetBytes = 0;
+	bool budgetAcquired = false;
+
+	std::mutex mutex;
+	Statistics statistics;
+};
+
+AfterglowUploadContext::Impl::Impl(AfterglowDevice& inDevice, AfterglowGraphicsQueue& inGraphicsQueue) :
+	device(inDevice), graphicsQueue(inGraphicsQueue) {
+	commandPool.recreate(device);
+	fences.recreate(device, cfg::uploadBatchCount);
+	ring.recreate(device, cfg::stagingRingSize);
+
+	std::array<VkCommandBuffer, cfg::uploadBatchCount> commandBuffers{};
+	VkCommandBufferAllocateInfo allocateInfo{};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocateInfo.commandPool = *commandPool;
+	allocateInfo.commandBufferCount = cfg::uploadBatchCount;
+	if (vkAllocateCommandBuffers(device, &allocateInfo, commandBuffers.data()) != VK_SUCCESS) {
+		EXCEPT_TYPE_RUNTIME(AfterglowUploadContext, "Failed to allocate upload command buffers.");
+	}
+	for (uint32_t index = 0; index < cfg::uploadBatchCount; ++index) {
+		batches[index].commandBuffer = commandBuffers[index];
+	}
+}
+
+AfterglowUploadContext::Impl::Batch& AfterglowUploadContext::Impl::current() noexcept {
+	return batches[currentBatchIndex];
+}
+
+VkCommandBuffer AfterglowUploadContext::Impl::begin() {
+	auto& batch = current();
+	if (batch.recording) {
+		return batch.commandBuffer;
+	}
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	if (vkBeginCommandBuffer(batch.commandBuffer, &beginInfo) != VK_SUCCESS) {
+		EXCEPT_TYPE_RUNTIME(AfterglowUploadContext, "Failed to begin upload command buffer.");
+	}
+	batch.recording = true;
+	return batch.commandBuffer;
+}
+
+bool AfterglowUploadContext::Impl::submit() {
+	auto& batch = current();
+	if (!batch.recording) {
+		return false;
+	}
+
+	// Images were transitioned by their own barriers, buffers have no layout, so make all transfer writes visible here.
+	VkMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+	vkCmdPipelineBarrier(
+		batch.commandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		0,
+		1, &barrier,
+		0, nullptr,
+		0, nullptr
+	);
+	vkEndCommandBuffer(batch.commandBuffer);
+	batch.recording = false;
+	batch.ringMark = ringAllocator.mark();
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &batch.commandBuffer;
+
+	VkFence& fence = fences[currentBatchIndex];
+	vkResetFences(device, 1, &fence);
+	if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS) {
+		EXCEPT_TYPE_RUNTIME(AfterglowUploadContext, "Failed to submit upload command buffer.");
+	}
+	inFlightBatches.push_back(currentBatchIndex);
+	++submittedSequence;
+	++statistics.submitCount;
+
+	// Batches are used in turn, the next one is in flight only if it is the oldest.
+	currentBatchIndex = (currentBatchIndex + 1) % cfg::uploadBatchCount;
+	if (inFlightBatches.front() == currentBatchIndex) {
+		retireOldest();
+	}
+	return true;
+}
+
+void AfterglowUploadContext::Impl::retireOldest() {
+	uint32_t batchIndex = inFlightBatches.front();
+	VkFence& fence = fences[batchIndex];
+	if (vkGetFenceStatus(device, fence) != VK_SUCCESS) {
+		vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+		++statistics.waitCount;
+	}
+
+	auto& batch = batches[batchIndex];
+	ringAllocator.release(batch.ringMark);
+	batch.ringMark = {};
+	batch.oversizeBuffers.clear();
+	inFlightBatches.pop_front();
+	++completedSequence;
+}
+
+void AfterglowUploadContext::Impl::retireFinished() {
+	while (!inFlightBatches.empty() && vkGetFenceStatus(device, fences[inFlightBatches.front()]) == VK_SUCCESS) {
+		retireOldest();
+	}
+}
+
+AfterglowUploadContext::AfterglowUploadContext(AfterglowDevice& device, AfterglowGraphicsQueue& graphicsQueue) :
+	_impl(std::make_unique<Impl>(device, graphicsQueue)) {
+}
+
+AfterglowUploadContext::~AfterglowUploadContext() {
+	wait();
+}
+
+AfterglowDevice& AfterglowUploadContext::device() noexcept {
+	return _impl->device;
+}
+
+bool AfterglowUploadContext::flush() {
+	std::lock_guard lock{ _impl->mutex };
+	_impl->budgetBytes = 0;
+	_impl->budgetAcquired = false;
+	_impl->retireFinished();
+	return _impl->submit();
+}
+
+void AfterglowUploadContext::wait() {
+	std::lock_guard lock{ _impl->mutex };
+	_impl->submit();
+	while (!_impl->inFlightBatches.empty()) {
+		_impl->retireOldest();
+	}
+}
+
+bool AfterglowUploadContext::acquireBudget(uint64_t byteSize) {
+	std::lock_guard lock{ _impl->mutex };
+	if (_impl->budgetAcquired && _impl->budgetBytes + byteSize > cfg::uploadBudgetPerFrame) {
+		return false;
+	}
+	_impl->budgetBytes += byteSize;
+	_impl->budgetAcquired = true;
+	return true;
+}
+
+uint64_t AfterglowUploadContext::ticket() {
+	std::lock_guard lock{ _impl->mutex };
+	// Recording batch is submitted next, if nothing is recording, the last submitted batch covers all commands.
+	return _impl->submittedSequence + (_impl->current().recording ? 1 : 0);
+}
+
+bool AfterglowUploadContext::completed(uint64_t ticket) {
+	std::lock_guard lock{ _impl->mutex };
+	_impl->retireFinished();
+	return ticket <= _impl->completedSequence;
+}
+
+AfterglowUploadContext::Statistics AfterglowUploadContext::statistics() const {
+	std::lock_guard lock{ _impl->mutex };
+	return _impl->statistics;
+}
+
+AfterglowUploadContext::Staging AfterglowUploadContext::stage(const void* data, uint64_t byteSize) {
+	++_impl->statistics.uploadCount;
+	_impl->statistics.uploadBytes += byteSize;
+
+	if (byteSize > cfg::stagingRingSize) {
+		DEBUG_CLASS_WARNING(std::format("Upload size {} exceeds the staging ring, a dedicated staging buffer is used.", byteSize));
+		++_impl->statistics.oversizeCount;
+		auto commandBuffer = _impl->begin();
+		auto& stagingBuffer = _impl->current().oversizeBuffers.emplace_back(
+			AfterglowStagingBuffer::makeElement(_impl->device, data, byteSize)
+		);
+		return Staging{ commandBuffer, *stagingBuffer, 0 };
+	}
+
+	auto offset = _impl->ringAllocator.allocate(byteSize);
+	while (!offset) {
+		// Current batch holds ring space too, submit it so that the space could be released later.
+		_impl->submit();
+		if (_impl->inFlightBatches.empty()) {
+			EXCEPT_CLASS_RUNTIME("Staging ring is exhausted without any batch in flight.");
+		}
+		_impl->retireOldest();
+		offset = _impl->ringAllocator.allocate(byteSize);
+	}
+	std::memcpy(static_cast<char*>((*_impl->ring).mapped()) + *offset, data, byteSize);
+	return Staging{ _impl->begin(), *_impl->ring, *offset };
+}
+
+VkCommandBuffer AfterglowUploadContext::currentCommandBuffer() {
+	return _impl->begin();
+}
+
+std::mutex& AfterglowUploadContext::mutex() noexcept {
+	return _impl->mutex;
+}
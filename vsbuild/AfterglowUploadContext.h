@@ -0,0 +1,109 @@
+#pragma once
+#include <mutex>
+#include <memory>
+#include <cstdint>
+
+#include "AfterglowDevice.h"
+
+class AfterglowGraphicsQueue;
+
+/**
+* @brief: Batched host to device uploads of buffers and images.
+* @desc:
+*	Source data is copied into a persistently mapped staging ring, copies and barriers of all uploads are recorded
+*	into the current transfer command buffer, which is submitted once per frame by flush() with a fence.
+*	Ring space of a batch is released after its fence was signaled, the queue is never idled.
+*	Uploads larger than the ring use a dedicated staging buffer which is released with the batch.
+*	If the ring is exhausted, the current batch is submitted and the oldest batch is waited.
+*	Streamed uploads are metered by a per frame byte budget, and tracked by tickets of their batches.
+* @note:
+*	Thread safe, recording functions are serialized.
+*	Batches are submitted to the graphics queue, draws submitted after flush() see the uploaded data.
+*	A resource must not be destroyed before the batch which uploads it was completed.
+*/
+class AfterglowUploadContext : public AfterglowObject {
+public:
+	struct Statistics {
+		uint64_t uploadCount = 0;
+		uint64_t uploadBytes = 0;
+		// Uploads which did not fit into the ring.
+		uint64_t oversizeCount = 0;
+		uint64_t submitCount = 0;
+		// CPU blocked on a batch fence, due to ring or batch exhaustion, or wait() calls.
+		uint64_t waitCount = 0;
+	};
+
+	AfterglowUploadContext(AfterglowDevice& device, AfterglowGraphicsQueue& graphicsQueue);
+	~AfterglowUploadContext();
+
+	AfterglowDevice& device() noexcept;
+
+	/**
+	* @brief: Copy data into the staging ring and record transfer commands reading it.
+	* @param func: func(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset)
+	* @note: Source data can be released after the call.
+	*/
+	template<typename FuncType>
+	void upload(const void* data, uint64_t byteSize, FuncType&& func);
+
+	// @brief: Record commands without source data, e.g. layout transitions. func(VkCommandBuffer)
+	template<typename FuncType>
+	void record(FuncType&& func);
+
+	/**
+	* @brief: Submit the current batch without waiting, finished batches are retired here.
+	* @return: True if a batch was submitted, nothing is submitted if no command was recorded.
+	*/
+	bool flush();
+
+	// @brief: Submit the current batch and block until all batches were completed.
+	void wait();
+
+	/**
+	* @brief: Consume the upload budget of current frame, the budget is reset by flush().
+	* @return: True if the upload should be recorded in this frame, the first request of a frame always succeeds.
+	*/
+	bool acquireBudget(uint64_t byteSize);
+
+	/**
+	* @return: Ticket of the batch which contains all commands recorded so far, 0 is always completed.
+	* @note: Query it after the upload was recorded.
+	*/
+	uint64_t ticket();
+
+	// @return: True if the batch of this ticket was completed, never blocks.
+	bool completed(uint64_t ticket);
+
+	Statistics statistics() const;
+
+private:
+	struct Impl;
+
+	struct Staging {
+		VkCommandBuffer commandBuffer;
+		VkBuffer buffer;
+		VkDeviceSize offset;
+	};
+
+	// @brief: Sub-allocate staging memory of the current batch and fill it, caller should hold the lock.
+	Staging stage(const void* data, uint64_t byteSize);
+	// @brief: Command buffer of the current batch, caller should hold the lock.
+	VkCommandBuffer currentCommandBuffer();
+	std::mutex& mutex() noexcept;
+
+	std::unique_ptr<Impl> _impl;
+};
+
+
+template<typename FuncType>
+inline void AfterglowUploadContext::upload(const void* data, uint64_t byteSize, FuncType&& func) {
+	std::lock_guard lock{ mutex() };
+	auto staging = stage(data, byteSize);
+	func(staging.commandBuffer, staging.buffer, staging.offset);
+}
+
+template<typename FuncType>
+inline void AfterglowUploadContext::record(FuncType&& func) {
+	std::lock_guard lock{ mutex() };
+	func(currentCommandBuffer());
+}
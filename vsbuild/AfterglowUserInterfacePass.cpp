@@ -11,11 +11,11 @@ AfterglowUserInterfacePass::AfterglowUserInterfacePass(AfterglowDevice& device,
 
 	// Create attachments (Reuse image if import attachments were exist. )
 	uint32_t colorAttachmentIndex = subpassContext().appendAttachment(
-		AfterglowSubpassContext::presentAttachment(colorFormat(), colorUsage)
+		AfterglowSubpassContext::presentAttachment(colorFormat(), presentLayout(), colorUsage)
 	);
 
 	if (prevPass && isValidAttachment(prevPass->presentAttachmentIndex())) {
-		subpassContext().attachment(colorAttachmentIndex).initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		subpassContext().attachment(colorAttachmentIndex).initialLayout = presentLayout();
 	}
 
 	// Pass IO
@@ -1,8 +1,10 @@
 #include "AfterglowUtilities.h"
 
 #include <algorithm>
+#include <array>
 #include <string>
 #include <locale>
+#include <filesystem>
 
 std::wstring util::ToWstring(const std::string& str) {
     // const char* source = str.c_str();
@@ -24,6 +26,60 @@ std::string util::ToString(const std::wstring& wstr) {
     return str;
 }
 
+void util::RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch) {
+    if (entries.size() <= 1) {
+        return;
+    }
+    // Bits that differ between keys, only these bytes require a pass.
+    uint64_t sharedOnes = ~0ull;
+    uint64_t anyOnes = 0;
+    for (const auto& entry : entries) {
+        sharedOnes &= entry.key;
+        anyOnes |= entry.key;
+    }
+    uint64_t differentBits = sharedOnes ^ anyOnes;
+
+    scratch.resize(entries.size());
+    auto* source = &entries;
+    auto* destination = &scratch;
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        if (((differentBits >> shift) & 0xFF) == 0) {
+            continue;
+        }
+        std::array<uint32_t, 256> offsets{};
+        for (const auto& entry : *source) {
+            ++offsets[(entry.key >> shift) & 0xFF];
+        }
+        uint32_t offset = 0;
+        for (auto& count : offsets) {
+            uint32_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+        for (const auto& entry : *source) {
+            (*destination)[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        std::swap(source, destination);
+    }
+    if (source != &entries) {
+        entries.swap(scratch);
+    }
+}
+
+uint64_t util::HashBytes(const void* data, size_t size, uint64_t seed) noexcept {
+    auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t index = 0; index < size; ++index) {
+        hash ^= bytes[index];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string util::NormalizePath(const std::string& path) {
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
 std::string util::UpperCase(const std::string& str) {
     std::string upperStr = str;
     std::transform(str.begin(), str.end(), upperStr.begin(),
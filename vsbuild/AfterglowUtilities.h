@@ -5,6 +5,7 @@
 #include <optional>
 #include <string>
 #include <typeindex>
+#include <vector>
 
 namespace constant {
 	static constexpr float pi_float = 3.1415927f;
@@ -36,6 +37,8 @@ namespace util {
 	std::wstring ToWstring(const std::string& str);
 	std::string ToString(const std::wstring& wstr);
 	std::string UpperCase(const std::string& str);
+	// @brief: Lexically normalized path with '/' separators, e.g. "./Shaders/Lit/../Common.hlsl" -> "Shaders/Common.hlsl". Use it as a path key.
+	std::string NormalizePath(const std::string& path);
 
 	constexpr size_t Align(size_t value, size_t alignment) noexcept;
 
@@ -47,6 +50,24 @@ namespace util {
 
 	template<typename Type, typename WeightType>
 	Type inline constexpr Lerp(Type a, Type b, WeightType t);
+
+	struct SortEntry {
+		uint64_t key;
+		uint32_t index;
+	};
+
+	/**
+	* @brief: Stable LSD radix sort by key, 8 bits per pass. Passes are skipped if that byte is same in all keys.
+	* @param scratch: Temporary storage, keep it alive between calls to avoid reallocation.
+	*/
+	void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+
+	// @brief: Fibonacci hashing, map a value (e.g. a pointer) to a bits wide id. Same value always has the same id.
+	inline constexpr uint64_t HashBits(uint64_t value, uint32_t bits) noexcept;
+
+	// @brief: FNV-1a hash of a byte sequence, it's stable across runs, use it for persistent keys and checksums.
+	// @param seed: Hash of the previous bytes, to hash discontiguous data in sequence.
+	uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull) noexcept;
 }
 
 constexpr uint32_t util::MakeVersion(uint32_t major, uint32_t minor, uint32_t patch) {
@@ -86,6 +107,13 @@ inline constexpr std::underlying_type_t<EnumType> util::EnumValue(EnumType e) no
 	return static_cast<std::underlying_type_t<EnumType>>(e);
 }
 
+inline constexpr uint64_t util::HashBits(uint64_t value, uint32_t bits) noexcept {
+	if (bits == 0) {
+		return 0;
+	}
+	return (value * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+}
+
 template<typename Type, typename WeightType>
 constexpr Type util::Lerp(Type a, Type b, WeightType t) {
 	return a + (b - a) * t;
@@ -2,9 +2,8 @@
 #include <array>
 
 #include "VertexStructs.h"
-#include "AfterglowStagingBuffer.h"
-#include "AfterglowCommandPool.h"
-#include "AfterglowGraphicsQueue.h"
+#include "AfterglowBuffer.h"
+#include "AfterglowUploadContext.h"
 
 // Typeless handle.
 struct AfterglowVertexBufferHandle {
@@ -39,8 +38,8 @@ public:
 	template<typename Attribute>
 	static constexpr VkFormat attributeFormat();
 
-	// Creating a staging buffer and use it copy memery to GPU, then clear stagingbuffer.
-	void submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue);
+	// Copy vertices to the staging ring and record the buffer copy into the current upload batch.
+	void submit(AfterglowUploadContext& uploadContext);
 
 	constexpr static VkVertexInputBindingDescription getBindingDescription();
 	static AttributeDescriptionArray getAttributeDescriptions();
@@ -145,14 +144,14 @@ inline uint64_t AfterglowVertexBufferTemplate<Type>::byteSize() {
 }
 
 template<vert::VertexType Type>
-inline void AfterglowVertexBufferTemplate<Type>::submit(AfterglowCommandPool& commandPool, AfterglowGraphicsQueue& graphicsQueue) {
+inline void AfterglowVertexBufferTemplate<Type>::submit(AfterglowUploadContext& uploadContext) {
 	// Specialization
-	// stagingBuffer: host_vk_buffer (CPU)
+	// staging ring: host_vk_buffer (CPU)
 	// _vertexBuffer(this): vertex_source_array (CPU), local_device_vk_buffer (GPU).
-	AfterglowStagingBuffer stagingBuffer(Parent::_device, lockedData()->data(), byteSize());
-	commandPool.allocateSingleCommand(
-		graphicsQueue,
-		[this, &stagingBuffer](VkCommandBuffer commandBuffer) {Parent::cmdCopyBuffer(commandBuffer, stagingBuffer); }
+	uploadContext.upload(
+		lockedData()->data(), 
+		byteSize(), 
+		[this](VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset) {Parent::cmdCopyBuffer(commandBuffer, srcBuffer, srcOffset); }
 	);
 	// Vertices is presistantly map to GPU, so NEVER clear then.
 }
@@ -28,13 +28,27 @@ struct AfterglowWindow::Impl {
 	bool shouldUnlockCursor = false;
 };
 
-AfterglowWindow::AfterglowWindow() {
-	glfwInit();
+AfterglowWindow::AfterglowWindow(const launch::Options& options) : 
+	_headless(options.headless) {
+	if (_headless) {
+		// Display server is not required.
+#ifdef GLFW_PLATFORM_NULL
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+	}
+	if (!glfwInit()) {
+		// Headless mode requires the null platform of GLFW 3.4 or later.
+		throw runtimeError(_headless ? "Failed to initialize GLFW, the null platform may be unavailable." : "Failed to initialize GLFW.");
+	}
 
 	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-	glfwWindowHint(GLFW_RESIZABLE, cfg::windowResizable);
+	glfwWindowHint(GLFW_RESIZABLE, cfg::windowResizable && !_headless);
+	glfwWindowHint(GLFW_VISIBLE, !_headless);
 
-	linkData(glfwCreateWindow(cfg::windowWidth, cfg::windowHeight, cfg::windowTitle, nullptr,nullptr));
+	linkData(glfwCreateWindow(options.width, options.height, cfg::windowTitle, nullptr,nullptr));
+	if (!data()) {
+		throw runtimeError("Failed to create window.");
+	}
 	glfwSetWindowUserPointer(data(), this);
 
 	_impl = std::make_unique<Impl>(data());
@@ -57,11 +71,22 @@ bool AfterglowWindow::shouldClose() {
 	return glfwWindowShouldClose(data());
 }
 
+void AfterglowWindow::requestClose() {
+	glfwSetWindowShouldClose(data(), GLFW_TRUE);
+}
+
+bool AfterglowWindow::headless() const noexcept {
+	return _headless;
+}
+
 bool AfterglowWindow::resized() const {
 	return _resized;
 }
 
 bool AfterglowWindow::drawable() {
+	if (_headless) {
+		return true;
+	}
 	int width = 0, height = 0;
 	glfwGetFramebufferSize(data(), &width, &height);
 	return width && height;
@@ -6,6 +6,7 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include "AfterglowProxyObject.h"
+#include "LaunchOptions.h"
 
 
 class AfterglowInput;
@@ -14,11 +15,16 @@ class AfterglowGUI;
 class AfterglowWindow : public AfterglowProxyObject<AfterglowWindow, GLFWwindow*> {
 	AFTERGLOW_PROXY_STORAGE_ONLY
 public:
-	AfterglowWindow();
+	AfterglowWindow(const launch::Options& options = {});
 	~AfterglowWindow();
 
 	void update();
 	bool shouldClose();
+	// @thread_safety
+	void requestClose();
+
+	// @brief: Headless window is invisible and never be presented, it keeps input and UI context only.
+	bool headless() const noexcept;
 
 	bool resized() const;
 
@@ -50,6 +56,7 @@ private:
 	AfterglowGUI* _ui = nullptr;
 
 	bool _resized = false;
+	bool _headless = false;
 	// TODO: Not good, try to find a more effective way to keep rendering when the window size is changed.
 	// bool _presented = true;
 };
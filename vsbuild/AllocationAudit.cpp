@@ -0,0 +1,128 @@
+#include "AllocationAudit.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+
+namespace audit {
+	struct ThreadCounter {
+		std::atomic<const char*> threadName = nullptr;
+		std::atomic<uint64_t> count = 0;
+	};
+
+	// Never use heap memory here, operator new depends on them.
+	std::array<ThreadCounter, maxThreadCount> threadCounters;
+	std::atomic<uint32_t> threadCounterCount = 1;
+	std::atomic<bool> enabled = false;
+
+	thread_local ThreadCounter* currentThreadCounter = nullptr;
+
+	inline ThreadCounter& CurrentThreadCounter() noexcept {
+		return currentThreadCounter ? *currentThreadCounter : threadCounters[0];
+	}
+
+	inline void CountAllocation() noexcept {
+		if (enabled.load(std::memory_order_relaxed)) {
+			CurrentThreadCounter().count.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	inline void* Allocate(std::size_t size) {
+		CountAllocation();
+		size = std::max<std::size_t>(size, 1);
+		while (true) {
+			if (void* memory = std::malloc(size)) {
+				return memory;
+			}
+			auto newHandler = std::get_new_handler();
+			if (!newHandler) {
+				throw std::bad_alloc();
+			}
+			newHandler();
+		}
+	}
+
+	inline void* AlignedAllocate(std::size_t size, std::size_t alignment) {
+		CountAllocation();
+		size = std::max<std::size_t>(size, 1);
+		while (true) {
+#ifdef _MSC_VER
+			void* memory = _aligned_malloc(size, alignment);
+#else
+			void* memory = std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+			if (memory) {
+				return memory;
+			}
+			auto newHandler = std::get_new_handler();
+			if (!newHandler) {
+				throw std::bad_alloc();
+			}
+			newHandler();
+		}
+	}
+
+	inline void AlignedFree(void* memory) noexcept {
+#ifdef _MSC_VER
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+}
+
+void audit::SetEnabled(bool inEnabled) noexcept {
+	enabled.store(inEnabled);
+}
+
+bool audit::Enabled() noexcept {
+	return enabled.load();
+}
+
+void audit::RegisterThread(const char* threadName) noexcept {
+	uint32_t index = threadCounterCount.fetch_add(1);
+	if (index >= maxThreadCount) {
+		// Out of counters, keep counting in the unnamed one.
+		threadCounterCount.store(maxThreadCount);
+		return;
+	}
+	threadCounters[index].threadName.store(threadName);
+	currentThreadCounter = &threadCounters[index];
+}
+
+uint64_t audit::ThreadAllocationCount() noexcept {
+	return CurrentThreadCounter().count.load(std::memory_order_relaxed);
+}
+
+uint32_t audit::Snapshot(std::span<ThreadAllocations> destAllocations) noexcept {
+	uint32_t count = std::min({ threadCounterCount.load(), maxThreadCount, static_cast<uint32_t>(destAllocations.size()) });
+	for (uint32_t index = 0; index < count; ++index) {
+		const char* threadName = threadCounters[index].threadName.load();
+		destAllocations[index] = {
+			.threadName = threadName ? threadName : unnamedThreadName,
+			.count = threadCounters[index].count.load(std::memory_order_relaxed)
+		};
+	}
+	return count;
+}
+
+#if ENABLE_ALLOCATION_AUDIT
+// Replaceable allocation functions, array and nothrow versions forward to these by default.
+void* operator new(std::size_t size) {
+	return audit::Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	return audit::AlignedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept {
+	audit::AlignedFree(memory);
+}
+#endif
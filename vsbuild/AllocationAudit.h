@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+// Settings: Replace global operator new and delete for counting, the default allocation functions are used if false.
+// Off by default, define it as true in the preprocessor definitions of a profiling build.
+#ifndef ENABLE_ALLOCATION_AUDIT
+#define ENABLE_ALLOCATION_AUDIT false
+#endif
+
+/**
+* @brief: Counts global operator new calls per thread, for finding heap allocations in the steady state frame.
+* @desc:
+*	Global operator new and delete are replaced in AllocationAudit.cpp if ENABLE_ALLOCATION_AUDIT, 
+*	counting costs an atomic increment only when enabled.
+*	Named threads own their counters, allocations from unnamed threads are gathered in the first counter.
+*/
+namespace audit {
+	// False if ENABLE_ALLOCATION_AUDIT is off, nothing is counted then.
+	constexpr bool available = ENABLE_ALLOCATION_AUDIT;
+
+	struct ThreadAllocations {
+		const char* threadName;
+		uint64_t count;
+	};
+
+	constexpr uint32_t maxThreadCount = 64;
+	constexpr const char* unnamedThreadName = "Unnamed";
+
+	void SetEnabled(bool enabled) noexcept;
+	bool Enabled() noexcept;
+
+	// @param threadName: Should be a string literal, it's referenced directly.
+	void RegisterThread(const char* threadName) noexcept;
+
+	// @return: Allocation count of the calling thread.
+	uint64_t ThreadAllocationCount() noexcept;
+
+	/**
+	* @brief: Copy counters of all threads, the unnamed counter is always the first one.
+	* @return: Count of copied counters.
+	*/
+	uint32_t Snapshot(std::span<ThreadAllocations> destAllocations) noexcept;
+}
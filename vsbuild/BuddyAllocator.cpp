@@ -0,0 +1,83 @@
+#include "BuddyAllocator.h"
+
+#include <algorithm>
+
+BuddyAllocator::BuddyAllocator(uint64_t size, uint64_t minNodeSize) : 
+	_size(size) {
+	uint32_t levelCount = 1;
+	while ((_size >> levelCount) >= minNodeSize) {
+		++levelCount;
+	}
+	_freeNodes.resize(levelCount);
+	_freeNodes[0].insert(0);
+}
+
+uint32_t BuddyAllocator::level(uint64_t size) const noexcept {
+	uint32_t level = 0;
+	uint32_t levelCount = static_cast<uint32_t>(_freeNodes.size());
+	while (level + 1 < levelCount && (_size >> (level + 1)) >= size) {
+		++level;
+	}
+	return level;
+}
+
+uint64_t BuddyAllocator::levelSize(uint32_t level) const noexcept {
+	return _size >> level;
+}
+
+std::optional<uint64_t> BuddyAllocator::allocate(uint32_t level) {
+	int32_t freeLevel = static_cast<int32_t>(level);
+	while (freeLevel >= 0 && _freeNodes[freeLevel].empty()) {
+		--freeLevel;
+	}
+	if (freeLevel < 0) {
+		return std::nullopt;
+	}
+
+	auto& freeNodes = _freeNodes[freeLevel];
+	uint64_t offset = *freeNodes.begin();
+	freeNodes.erase(freeNodes.begin());
+	// Split the larger node, the upper half is free.
+	for (uint32_t splitLevel = freeLevel + 1; splitLevel <= level; ++splitLevel) {
+		_freeNodes[splitLevel].insert(offset + levelSize(splitLevel));
+	}
+	_usedSize += levelSize(level);
+	++_allocationCount;
+	return offset;
+}
+
+void BuddyAllocator::free(uint64_t offset, uint32_t level) {
+	_usedSize -= levelSize(level);
+	--_allocationCount;
+	while (level > 0) {
+		uint64_t buddyOffset = offset ^ levelSize(level);
+		if (!_freeNodes[level].erase(buddyOffset)) {
+			break;
+		}
+		offset = std::min(offset, buddyOffset);
+		--level;
+	}
+	_freeNodes[level].insert(offset);
+}
+
+uint64_t BuddyAllocator::size() const noexcept {
+	return _size;
+}
+
+uint64_t BuddyAllocator::usedSize() const noexcept {
+	return _usedSize;
+}
+
+uint32_t BuddyAllocator::allocationCount() const noexcept {
+	return _allocationCount;
+}
+
+uint64_t BuddyAllocator::largestFreeSize() const noexcept {
+	auto levelIterator = std::find_if(_freeNodes.begin(), _freeNodes.end(), [](const auto& freeNodes) {
+		return !freeNodes.empty();
+	});
+	if (levelIterator == _freeNodes.end()) {
+		return 0;
+	}
+	return levelSize(static_cast<uint32_t>(levelIterator - _freeNodes.begin()));
+}
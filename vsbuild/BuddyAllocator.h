@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <unordered_set>
+
+/**
+* @brief: Buddy offset allocator of a power of two sized block, it only computes offsets, memory is owned by the user.
+* @desc:
+*	Level 0 is the whole block, node size of level n is (size >> n), nodes are never smaller than the min node size.
+*	Node offsets are aligned to their node sizes, so any alignment up to the node size is satisfied implicitly.
+*	A freed node is merged with its free buddy level by level.
+*/
+class BuddyAllocator {
+public:
+	// @param size: Power of two.
+	BuddyAllocator(uint64_t size, uint64_t minNodeSize);
+
+	// @return: Level of the smallest node which holds the size.
+	uint32_t level(uint64_t size) const noexcept;
+	uint64_t levelSize(uint32_t level) const noexcept;
+
+	// @brief: Take a free node of the level, larger nodes are split if necessary.
+	std::optional<uint64_t> allocate(uint32_t level);
+	// @brief: Return the node and merge it with its free buddies.
+	void free(uint64_t offset, uint32_t level);
+
+	uint64_t size() const noexcept;
+	// @note: Bytes of nodes in use, including the rounding up to node sizes.
+	uint64_t usedSize() const noexcept;
+	uint32_t allocationCount() const noexcept;
+	// @return: Size of the largest free node, 0 if the block is full.
+	uint64_t largestFreeSize() const noexcept;
+
+private:
+	uint64_t _size;
+	// Free node offsets of each level.
+	std::vector<std::unordered_set<uint64_t>> _freeNodes;
+	uint64_t _usedSize = 0;
+	uint32_t _allocationCount = 0;
+};
@@ -12,6 +12,11 @@ namespace cfg {
 	constexpr static Text windowTitle = "Afterglow";
 	constexpr static bool windowResizable = true;
 
+	// Headless settings, see launch::Options.
+	constexpr static uint32_t headlessFrameCount = 1000;
+	// Frames which are excluded from allocation audit, caches and containers are growing in these frames.
+	constexpr static uint32_t allocationAuditWarmupFrames = 16;
+
 
 	// Vulkan Configurations
 	// Environ settings
@@ -22,7 +27,7 @@ namespace cfg {
 	constexpr static uint32_t applicationVersion = util::MakeVersion(1, 0, 0);
 	constexpr static Text engineName = "AfterglowEngine";
 	constexpr static uint32_t engineVersion = util::MakeVersion(1, 0, 0);
-	constexpr static uint32_t apiVersion = util::MakeApiVersion(0, 1, 0, 0);
+	constexpr static uint32_t apiVersion = util::MakeApiVersion(0, 1, 2, 0);
 
 	// Validation settings
 	static const std::vector<const char*> validationLayers = {
@@ -39,19 +44,73 @@ namespace cfg {
 
 	// Device settings
 	static const  std::vector<const char*> deviceExtensions = {
+		// "VK_EXT_shader_stencil_export", 
+	};
+	// Required only if there is a surface to present, they are not required in headless mode.
+	static const  std::vector<const char*> presentDeviceExtensions = {
 		// VK_KHR_SWAPCHAIN_EXTENSION_NAME
 		"VK_KHR_swapchain", 
-		// "VK_EXT_shader_stencil_export", 
 	};
 
 	// Semaphore settings
 	constexpr static uint32_t maxFrameInFlight = 2;
+	// Synchronize with timeline semaphores if device supports them, otherwise fallback to fences.
+	constexpr static bool enableTimelineSemaphore = true;
+	// Submit async compute tasks on a dedicated compute queue family if it exists, requires timeline semaphore.
+	constexpr static bool enableAsyncCompute = true;
+
+	// Command recording settings
+	// Worker threads for secondary command buffer recording, 0 means (hardware threads - 1).
+	constexpr static uint32_t drawRecordWorkerCount = 0;
+	// Subpasses with fewer draws than this are recorded inline by the render thread.
+	constexpr static uint32_t parallelDrawRecordThreshold = 512;
+	// Draws per secondary command buffer.
+	constexpr static uint32_t drawRecordChunkSize = 256;
+	// Worker threads for shader compilation and pipeline creation of dated materials, 0 means (hardware threads - 1).
+	constexpr static uint32_t shaderCompileWorkerCount = 0;
 
 	// This extent size remain for dynamic material.
 	constexpr static uint32_t uniformDescriptorSize = 1024;
 	constexpr static uint32_t samplerDescriptorSize = 512;
 	constexpr static uint32_t descriptorSetSize = 1024;
+	constexpr static uint32_t storageBufferDescriptorSize = 1024;
+
+	// Upload settings, see AfterglowUploadContext.
+	// Persistently mapped staging memory shared by all in flight upload batches.
+	constexpr static uint64_t stagingRingSize = 64ull * 1024 * 1024;
+	// Upload command buffers and fences, recording blocks on the oldest batch if all of them are in flight.
+	constexpr static uint32_t uploadBatchCount = 4;
+	// Bytes of streamed assets uploaded per frame, the first streamed asset of a frame is uploaded even if it exceeds the budget.
+	constexpr static uint64_t uploadBudgetPerFrame = 16ull * 1024 * 1024;
+	// Decoding threads of each shared resource pool (textures, meshes).
+	constexpr static uint32_t assetStreamWorkerCount = 2;
+
+	// Device memory settings, see AfterglowMemoryAllocator.
+	// Power of two, it is reduced for small heaps.
+	constexpr static uint64_t memoryBlockSize = 64ull * 1024 * 1024;
+	// Resources of this size or larger own their device memory.
+	constexpr static uint64_t dedicatedAllocationThreshold = 16ull * 1024 * 1024;
+	// Device local memory budget, reported by VK_EXT_memory_budget if it is supported, otherwise this limit (clamped to the heaps).
+	constexpr static uint64_t memoryBudgetFallbackLimit = 2048ull * 1024 * 1024;
+	// Shared pools evict streamed resources in LRU order while the usage exceeds this ratio of the budget.
+	constexpr static float memoryBudgetUsageRatio = 0.9f;
+	// Resources used within these frames are never evicted, it avoids evicting and re-streaming the same resource repeatedly.
+	constexpr static uint64_t memoryEvictionIdleFrames = 300;
+
+	// Initial object count of the per frame mesh uniform ring, it grows by doubling.
+	constexpr static uint32_t meshUniformCapacity = 1024;
+	// Initial object instance count of the per frame instance buffer, it grows by doubling.
+	constexpr static uint32_t objectInstanceCapacity = 1024;
 
 	constexpr static Text shaderEntryName = "main";
 	constexpr static Text shaderRootDirectory = "Shaders/";
+
+	// Pipeline cache file is saved here on shutdown, see AfterglowPipelineCache.
+	constexpr static Text pipelineCacheDirectory = "Caches/Pipelines/";
+	constexpr static Text pipelineCacheSuffix = ".pcache";
+	// Compiled spirv is cached here, least recently used entries are evicted if the total size exceeds the limit.
+	constexpr static Text spirvCacheDirectory = "Caches/Spirv/";
+	constexpr static uint64_t spirvCacheMaxSize = 256ull * 1024 * 1024;
+	// Run AfterglowSpirvOptimizer passes after DXC compilation, the optimization report is stored with cached spirv.
+	constexpr static bool spirvOptimization = true;
 }
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+/**
+* @brief: Deferred destruction of released objects, each object is tagged with a retire point.
+* @desc: Points should never decrease, update() destroys objects from the front while their points were completed.
+* @note: Not thread safe.
+*/
+template<typename PointType>
+class DeletionQueue {
+public:
+	// @brief: Take the ownership of the object, it is destroyed once the point was completed.
+	template<typename Type>
+	void release(const PointType& retirePoint, Type&& object);
+
+	/**
+	* @brief: Destroy objects in order of release, stops at the first one which was not completed.
+	* @param completed: bool completed(const PointType& point)
+	*/
+	template<typename CompletedFuncType>
+	void update(CompletedFuncType&& completed);
+
+	size_t pendingCount() const noexcept;
+
+private:
+	struct Entry {
+		PointType retirePoint;
+		// Type erased, the shared pointer keeps the deleter of the object type.
+		std::shared_ptr<void> object;
+	};
+
+	std::deque<Entry> _entries;
+};
+
+
+template<typename PointType>
+template<typename Type>
+inline void DeletionQueue<PointType>::release(const PointType& retirePoint, Type&& object) {
+	_entries.push_back(Entry{
+		retirePoint, 
+		std::make_shared<std::remove_cvref_t<Type>>(std::forward<Type>(object))
+	});
+}
+
+template<typename PointType>
+template<typename CompletedFuncType>
+inline void DeletionQueue<PointType>::update(CompletedFuncType&& completed) {
+	while (!_entries.empty() && completed(std::as_const(_entries.front().retirePoint))) {
+		_entries.pop_front();
+	}
+}
+
+template<typename PointType>
+inline size_t DeletionQueue<PointType>::pendingCount() const noexcept {
+	return _entries.size();
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <unordered_set>
+#include <unordered_map>
+
+/**
+* @brief: Directed graph of "dependent depends on dependency", a modified node invalidates all of its dependents transitively.
+* @note: Thread safe, queries return copies.
+*/
+template<typename NodeType, typename HashType = std::hash<NodeType>>
+class DependencyGraph {
+public:
+	using Nodes = std::vector<NodeType>;
+
+	// @brief: dependent depends on dependency, duplicated links are ignored.
+	void link(const NodeType& dependency, const NodeType& dependent);
+	// @brief: Replace all dependencies of the dependent, dependents of it are kept.
+	void setDependencies(const NodeType& dependent, const Nodes& dependencies);
+	// @brief: Remove the node and all links of it.
+	void remove(const NodeType& node);
+
+	// @return: Nodes this node depends on directly.
+	Nodes dependencies(const NodeType& node) const;
+	// @return: Nodes depend on this node directly or indirectly in breadth first order, excluding the node itself.
+	Nodes dependents(const NodeType& node) const;
+
+	bool contains(const NodeType& node) const;
+
+private:
+	using NodeSet = std::unordered_set<NodeType, HashType>;
+	using Links = std::unordered_map<NodeType, NodeSet, HashType>;
+
+	inline void unlinkWithoutLock(const NodeType& dependency, const NodeType& dependent);
+
+	mutable std::mutex _mutex;
+	// <dependency, dependents>
+	Links _dependents;
+	// <dependent, dependencies>
+	Links _dependencies;
+};
+
+template<typename NodeType, typename HashType>
+inline void DependencyGraph<NodeType, HashType>::link(const NodeType& dependency, const NodeType& dependent) {
+	std::lock_guard lock{ _mutex };
+	_dependents[dependency].insert(dependent);
+	_dependencies[dependent].insert(dependency);
+}
+
+template<typename NodeType, typename HashType>
+inline void DependencyGraph<NodeType, HashType>::setDependencies(const NodeType& dependent, const Nodes& dependencies) {
+	std::lock_guard lock{ _mutex };
+	if (auto iterator = _dependencies.find(dependent); iterator != _dependencies.end()) {
+		for (const auto& dependency : iterator->second) {
+			unlinkWithoutLock(dependency, dependent);
+		}
+		_dependencies.erase(iterator);
+	}
+	if (dependencies.empty()) {
+		return;
+	}
+	auto& dependentDependencies = _dependencies[dependent];
+	for (const auto& dependency : dependencies) {
+		_dependents[dependency].insert(dependent);
+		dependentDependencies.insert(dependency);
+	}
+}
+
+template<typename NodeType, typename HashType>
+inline void DependencyGraph<NodeType, HashType>::remove(const NodeType& node) {
+	std::lock_guard lock{ _mutex };
+	if (auto iterator = _dependencies.find(node); iterator != _dependencies.end()) {
+		for (const auto& dependency : iterator->second) {
+			unlinkWithoutLock(dependency, node);
+		}
+		_dependencies.erase(iterator);
+	}
+	if (auto iterator = _dependents.find(node); iterator != _dependents.end()) {
+		for (const auto& dependent : iterator->second) {
+			auto dependencyIterator = _dependencies.find(dependent);
+			dependencyIterator->second.erase(node);
+			if (dependencyIterator->second.empty()) {
+				_dependencies.erase(dependencyIterator);
+			}
+		}
+		_dependents.erase(iterator);
+	}
+}
+
+template<typename NodeType, typename HashType>
+inline typename DependencyGraph<NodeType, HashType>::Nodes DependencyGraph<NodeType, HashType>::dependencies(const NodeType& node) const {
+	std::lock_guard lock{ _mutex };
+	auto iterator = _dependencies.find(node);
+	if (iterator == _dependencies.end()) {
+		return {};
+	}
+	return Nodes(iterator->second.begin(), iterator->second.end());
+}
+
+template<typename NodeType, typename HashType>
+inline typename DependencyGraph<NodeType, HashType>::Nodes DependencyGraph<NodeType, HashType>::dependents(const NodeType& node) const {
+	std::lock_guard lock{ _mutex };
+	Nodes result;
+	NodeSet visitedNodes{ node };
+	std::deque<const NodeType*> openNodes{ &node };
+	while (!openNodes.empty()) {
+		auto iterator = _dependents.find(*openNodes.front());
+		openNodes.pop_front();
+		if (iterator == _dependents.end()) {
+			continue;
+		}
+		for (const auto& dependent : iterator->second) {
+			// Cycles are allowed, each node is visited once.
+			if (visitedNodes.insert(dependent).second) {
+				result.push_back(dependent);
+				openNodes.push_back(&dependent);
+			}
+		}
+	}
+	return result;
+}
+
+template<typename NodeType, typename HashType>
+inline bool DependencyGraph<NodeType, HashType>::contains(const NodeType& node) const {
+	std::lock_guard lock{ _mutex };
+	return _dependents.contains(node) || _dependencies.contains(node);
+}
+
+template<typename NodeType, typename HashType>
+inline void DependencyGraph<NodeType, HashType>::unlinkWithoutLock(const NodeType& dependency, const NodeType& dependent) {
+	auto iterator = _dependents.find(dependency);
+	if (iterator == _dependents.end()) {
+		return;
+	}
+	iterator->second.erase(dependent);
+	if (iterator->second.empty()) {
+		_dependents.erase(iterator);
+	}
+}
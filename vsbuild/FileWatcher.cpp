@@ -0,0 +1,281 @@
+#include "FileWatcher.h"
+
+#include <mutex>
+#include <array>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include "AfterglowUtilities.h"
+
+struct FileWatcher::Impl {
+	struct DirectoryWatch {
+		std::string directory;
+		HANDLE handle = INVALID_HANDLE_VALUE;
+		OVERLAPPED overlapped{};
+		// FILE_NOTIFY_INFORMATION is DWORD aligned.
+		alignas(DWORD) std::array<std::byte, 16 * 1024> buffer;
+		bool removed = false;
+	};
+
+	Impl();
+	~Impl();
+
+	inline bool issueRead(DirectoryWatch& watch);
+
+	HANDLE port = nullptr;
+	std::mutex mutex;
+	std::unordered_map<std::string, std::unique_ptr<DirectoryWatch>> directoryWatches;
+	// Cancelled watches are released after their last completions are dequeued.
+	std::unordered_map<DirectoryWatch*, std::unique_ptr<DirectoryWatch>> removedWatches;
+};
+
+FileWatcher::Impl::Impl() {
+	port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+}
+
+FileWatcher::Impl::~Impl() {
+	auto releaseWatch = [](DirectoryWatch& watch) {
+		// Make sure the system never writes the buffer after it was released.
+		DWORD bytes = 0;
+		CancelIoEx(watch.handle, &watch.overlapped);
+		GetOverlappedResult(watch.handle, &watch.overlapped, &bytes, TRUE);
+		CloseHandle(watch.handle);
+	};
+	for (auto& [directory, watch] : directoryWatches) {
+		releaseWatch(*watch);
+	}
+	for (auto& [key, watch] : removedWatches) {
+		releaseWatch(*watch);
+	}
+	if (port) {
+		CloseHandle(port);
+	}
+}
+
+inline bool FileWatcher::Impl::issueRead(DirectoryWatch& watch) {
+	return ReadDirectoryChangesW(
+		watch.handle,
+		watch.buffer.data(),
+		static_cast<DWORD>(watch.buffer.size()),
+		FALSE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+		nullptr,
+		&watch.overlapped,
+		nullptr
+	);
+}
+
+bool FileWatcher::available() const noexcept {
+	return _impl->port;
+}
+
+bool FileWatcher::watchDirectory(const std::string& directory) {
+	if (!_impl->port) {
+		return false;
+	}
+	std::lock_guard lock{ _impl->mutex };
+	if (_impl->directoryWatches.contains(directory)) {
+		return true;
+	}
+	auto watch = std::make_unique<Impl::DirectoryWatch>();
+	watch->directory = directory;
+	watch->handle = CreateFileW(
+		util::ToWstring(directory).data(),
+		FILE_LIST_DIRECTORY,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+		nullptr
+	);
+	if (watch->handle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	// Completion key is the watch itself.
+	if (!CreateIoCompletionPort(watch->handle, _impl->port, reinterpret_cast<ULONG_PTR>(watch.get()), 0)
+		|| !_impl->issueRead(*watch)) {
+		CloseHandle(watch->handle);
+		return false;
+	}
+	_impl->directoryWatches.emplace(directory, std::move(watch));
+	return true;
+}
+
+void FileWatcher::unwatchDirectory(const std::string& directory) {
+	std::lock_guard lock{ _impl->mutex };
+	auto iterator = _impl->directoryWatches.find(directory);
+	if (iterator == _impl->directoryWatches.end()) {
+		return;
+	}
+	auto* watch = iterator->second.get();
+	watch->removed = true;
+	CancelIoEx(watch->handle, &watch->overlapped);
+	_impl->removedWatches.emplace(watch, std::move(iterator->second));
+	_impl->directoryWatches.erase(iterator);
+}
+
+void FileWatcher::waitChanges(ChangedPaths& changedPaths, std::chrono::milliseconds timeout) {
+	DWORD bytes = 0;
+	ULONG_PTR key = 0;
+	OVERLAPPED* overlapped = nullptr;
+	BOOL succeeded = GetQueuedCompletionStatus(_impl->port, &bytes, &key, &overlapped, static_cast<DWORD>(timeout.count()));
+	if (!overlapped) {
+		// Timeout
+		return;
+	}
+
+	std::lock_guard lock{ _impl->mutex };
+	auto* watch = reinterpret_cast<Impl::DirectoryWatch*>(key);
+	if (watch->removed) {
+		CloseHandle(watch->handle);
+		_impl->removedWatches.erase(watch);
+		return;
+	}
+	if (!succeeded || bytes == 0) {
+		// Notifications were overflowed or failed, report the directory to check all files in it.
+		changedPaths.push_back(watch->directory);
+	}
+	else {
+		auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(watch->buffer.data());
+		while (true) {
+			std::wstring fileName(info->FileName, info->FileNameLength / sizeof(WCHAR));
+			changedPaths.push_back(watch->directory + "/" + util::ToString(fileName));
+			if (!info->NextEntryOffset) {
+				break;
+			}
+			info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(reinterpret_cast<const std::byte*>(info) + info->NextEntryOffset);
+		}
+	}
+	if (!_impl->issueRead(*watch)) {
+		// Directory was deleted or became inaccessible.
+		changedPaths.push_back(watch->directory);
+	}
+}
+
+#elif defined(__linux__)
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+struct FileWatcher::Impl {
+	Impl();
+	~Impl();
+
+	int fd = -1;
+	std::mutex mutex;
+	std::unordered_map<std::string, int> directoryWatches;
+	std::unordered_map<int, std::string> watchDirectories;
+	alignas(inotify_event) std::array<char, 16 * 1024> buffer;
+};
+
+FileWatcher::Impl::Impl() {
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+FileWatcher::Impl::~Impl() {
+	if (fd >= 0) {
+		close(fd);
+	}
+}
+
+bool FileWatcher::available() const noexcept {
+	return _impl->fd >= 0;
+}
+
+bool FileWatcher::watchDirectory(const std::string& directory) {
+	if (_impl->fd < 0) {
+		return false;
+	}
+	std::lock_guard lock{ _impl->mutex };
+	if (_impl->directoryWatches.contains(directory)) {
+		return true;
+	}
+	int watch = inotify_add_watch(
+		_impl->fd,
+		directory.data(),
+		IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR
+	);
+	if (watch < 0) {
+		return false;
+	}
+	_impl->directoryWatches[directory] = watch;
+	_impl->watchDirectories[watch] = directory;
+	return true;
+}
+
+void FileWatcher::unwatchDirectory(const std::string& directory) {
+	std::lock_guard lock{ _impl->mutex };
+	auto iterator = _impl->directoryWatches.find(directory);
+	if (iterator == _impl->directoryWatches.end()) {
+		return;
+	}
+	inotify_rm_watch(_impl->fd, iterator->second);
+	_impl->watchDirectories.erase(iterator->second);
+	_impl->directoryWatches.erase(iterator);
+}
+
+void FileWatcher::waitChanges(ChangedPaths& changedPaths, std::chrono::milliseconds timeout) {
+	pollfd pollInfo{ .fd = _impl->fd, .events = POLLIN };
+	if (poll(&pollInfo, 1, static_cast<int>(timeout.count())) <= 0) {
+		return;
+	}
+	ssize_t size = read(_impl->fd, _impl->buffer.data(), _impl->buffer.size());
+	if (size <= 0) {
+		return;
+	}
+
+	std::lock_guard lock{ _impl->mutex };
+	for (ssize_t offset = 0; offset < size; ) {
+		const auto* event = reinterpret_cast<const inotify_event*>(_impl->buffer.data() + offset);
+		offset += sizeof(inotify_event) + event->len;
+
+		if (event->mask & IN_Q_OVERFLOW) {
+			// Notifications were overflowed, report all directories to check all files in them.
+			for (const auto& [directory, watch] : _impl->directoryWatches) {
+				changedPaths.push_back(directory);
+			}
+			continue;
+		}
+		auto iterator = _impl->watchDirectories.find(event->wd);
+		if (iterator == _impl->watchDirectories.end()) {
+			continue;
+		}
+		if (event->mask & IN_IGNORED) {
+			// Directory was deleted or unmounted.
+			changedPaths.push_back(iterator->second);
+			_impl->directoryWatches.erase(iterator->second);
+			_impl->watchDirectories.erase(iterator);
+			continue;
+		}
+		if (event->len > 0) {
+			changedPaths.push_back(iterator->second + "/" + event->name);
+		}
+	}
+}
+
+#else
+struct FileWatcher::Impl {};
+
+bool FileWatcher::available() const noexcept {
+	return false;
+}
+
+bool FileWatcher::watchDirectory(const std::string& directory) {
+	return false;
+}
+
+void FileWatcher::unwatchDirectory(const std::string& directory) {
+}
+
+void FileWatcher::waitChanges(ChangedPaths& changedPaths, std::chrono::milliseconds timeout) {
+}
+
+#endif
+
+FileWatcher::FileWatcher() :
+	_impl(std::make_unique<Impl>()) {
+}
+
+FileWatcher::~FileWatcher() {
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+
+// Regularly, projection independent classes should not add a prefix.
+/**
+* @brief: Directory change notifications from the OS, ReadDirectoryChangesW on windows and inotify on linux.
+* @desc: Directories instead of files are watched, so files replaced by editors (write to temp and rename) are still reported.
+* @note: Thread safe, usually waitChanges() is invoked in a watching thread and others are invoked in any thread.
+*/
+class FileWatcher {
+public:
+	using ChangedPaths = std::vector<std::string>;
+
+	FileWatcher();
+	~FileWatcher();
+
+	// @return: False if event based watching is not supported on this platform, poll files instead.
+	bool available() const noexcept;
+
+	/**
+	* @brief: Watch files in this directory (non-recursively), a directory is watched once no matter how many times it is added.
+	* @return: False if failed to watch this directory.
+	*/
+	bool watchDirectory(const std::string& directory);
+	void unwatchDirectory(const std::string& directory);
+
+	/**
+	* @brief: Wait until any file changed or timeout.
+	* @param changedPaths: Paths of created, modified, renamed and deleted files are appended, in form of "directory/fileName".
+	*/
+	void waitChanges(ChangedPaths& changedPaths, std::chrono::milliseconds timeout);
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> _impl;
+};
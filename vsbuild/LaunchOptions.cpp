@@ -0,0 +1,77 @@
+#include "LaunchOptions.h"
+
+#include <string>
+#include <format>
+
+#include "ExceptionUtilities.h"
+#include "AfterglowUtilities.h"
+#include "AllocationAudit.h"
+
+namespace launch {
+	inline uint32_t ParseUint(int argc, char** argv, int& index) {
+		if (index + 1 >= argc) {
+			EXCEPT_INVALID_ARG(std::format("Launch argument \"{}\" requires a value.", argv[index]));
+		}
+		++index;
+		try {
+			return static_cast<uint32_t>(std::stoul(argv[index]));
+		}
+		catch (const std::exception&) {
+			EXCEPT_INVALID_ARG(std::format("Invalid value of launch argument \"{}\": \"{}\".", argv[index - 1], argv[index]));
+		}
+	}
+
+	template<inreflect::ReflectibleEnumType Type>
+	inline Type ParseEnum(int argc, char** argv, int& index) {
+		if (index + 1 >= argc) {
+			EXCEPT_INVALID_ARG(std::format("Launch argument \"{}\" requires a value.", argv[index]));
+		}
+		++index;
+		std::string_view value = argv[index];
+		for (uint32_t enumIndex = 0; enumIndex < util::EnumValue(Type::EnumCount); ++enumIndex) {
+			auto enumValue = static_cast<Type>(enumIndex);
+			if (inreflect::EnumName(enumValue) == value) {
+				return enumValue;
+			}
+		}
+		EXCEPT_INVALID_ARG(std::format("Invalid value of launch argument \"{}\": \"{}\".", argv[index - 1], argv[index]));
+	}
+}
+
+launch::Options launch::Parse(int argc, char** argv) {
+	Options options;
+	for (int index = 1; index < argc; ++index) {
+		std::string argument = argv[index];
+		if (argument == "--headless") {
+			options.headless = true;
+		}
+		else if (argument == "--frames") {
+			options.frameCount = ParseUint(argc, argv, index);
+		}
+		else if (argument == "--width") {
+			options.width = ParseUint(argc, argv, index);
+		}
+		else if (argument == "--height") {
+			options.height = ParseUint(argc, argv, index);
+		}
+		else if (argument == "--frame-loop") {
+			options.frameLoopMode = ParseEnum<render::FrameLoopMode>(argc, argv, index);
+		}
+		else if (argument == "--allocation-audit") {
+			options.allocationAudit = audit::available;
+			if (!audit::available) {
+				DEBUG_WARNING("Allocation audit is ignored, due to ENABLE_ALLOCATION_AUDIT is off.");
+			}
+		}
+		else if (argument == "--shader-compile-benchmark") {
+			options.shaderCompileBenchmarkIterations = ParseUint(argc, argv, index);
+		}
+		else {
+			DEBUG_WARNING(std::format("Unknown launch argument: \"{}\"", argument));
+		}
+	}
+	if (options.width == 0 || options.height == 0) {
+		EXCEPT_INVALID_ARG("Launch resolution should be greater than zero.");
+	}
+	return options;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+
+#include "Configurations.h"
+#include "RenderDefinitions.h"
+
+namespace launch {
+	// Runtime switches parsed from the command line, they are fixed after the application was created.
+	struct Options {
+		/**
+		* @brief:
+		*	Render without a visible window, VkSurfaceKHR and swapchain.
+		*	Frames are rendered into offscreen targets owned by AfterglowFramebufferManager.
+		*/
+		bool headless = false;
+		// Application exit after rendering these frames in headless mode. 0 means never stop.
+		uint32_t frameCount = cfg::headlessFrameCount;
+		uint32_t width = cfg::windowWidth;
+		uint32_t height = cfg::windowHeight;
+		// Initial frame loop mode, it can be switched in runtime by AfterglowRenderStatus.
+		render::FrameLoopMode frameLoopMode = render::FrameLoopMode::Pipelined;
+		/**
+		* @brief: Count heap allocations of named threads (Render, WorkerPool) per frame.
+		*	In headless mode, the benchmark fails if any frame allocates after cfg::allocationAuditWarmupFrames.
+		* @note: Ignored if ENABLE_ALLOCATION_AUDIT (AllocationAudit.h) is off.
+		*/
+		bool allocationAudit = false;
+		// Compile shaders of all materials for these iterations after the last headless frame. 0 means disabled.
+		uint32_t shaderCompileBenchmarkIterations = 0;
+	};
+
+	/**
+	* @brief:
+	*	Supported arguments:
+	*		--headless
+	*		--frames <count>
+	*		--width <pixels>
+	*		--height <pixels>
+	*		--frame-loop <Serialized|Pipelined>
+	*		--allocation-audit
+	*		--shader-compile-benchmark <iterations>
+	*	Unknown arguments are ignored.
+	*/
+	Options Parse(int argc, char** argv);
+}
@@ -0,0 +1,66 @@
+#include "LinearAllocator.h"
+
+#include <algorithm>
+#include <new>
+#include <cstdint>
+
+LinearAllocator::LinearAllocator(size_t initialCapacity) {
+	appendBlock(initialCapacity);
+}
+
+LinearAllocator::~LinearAllocator() {
+	releaseBlocks();
+}
+
+void LinearAllocator::reset() {
+	if (_blocks.size() > 1) {
+		size_t totalSize = capacity();
+		releaseBlocks();
+		appendBlock(totalSize);
+	}
+	_offset = 0;
+	_filledSize = 0;
+}
+
+size_t LinearAllocator::usedSize() const noexcept {
+	return _filledSize + _offset;
+}
+
+size_t LinearAllocator::capacity() const noexcept {
+	size_t totalSize = 0;
+	for (const auto& block : _blocks) {
+		totalSize += block.size;
+	}
+	return totalSize;
+}
+
+void* LinearAllocator::do_allocate(size_t bytes, size_t alignment) {
+	auto alignedOffset = [this, alignment](const Block& block) {
+		auto address = reinterpret_cast<uintptr_t>(block.data) + _offset;
+		return _offset + (((address + alignment - 1) & ~(alignment - 1)) - address);
+	};
+	auto* block = &_blocks.back();
+	size_t offset = alignedOffset(*block);
+	if (offset + bytes > block->size) {
+		_filledSize += block->size;
+		// Grow geometrically to reach the high water mark in a few frames.
+		appendBlock(std::max(bytes + alignment, block->size * 2));
+		block = &_blocks.back();
+		offset = alignedOffset(*block);
+	}
+	_offset = offset + bytes;
+	return block->data + offset;
+}
+
+inline void LinearAllocator::appendBlock(size_t minSize) {
+	auto* data = static_cast<std::byte*>(::operator new(minSize, std::align_val_t{ alignof(std::max_align_t) }));
+	_blocks.push_back({ data, minSize });
+	_offset = 0;
+}
+
+inline void LinearAllocator::releaseBlocks() {
+	for (auto& block : _blocks) {
+		::operator delete(block.data, std::align_val_t{ alignof(std::max_align_t) });
+	}
+	_blocks.clear();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Regularly, projection independent classes should not add a prefix.
+// Linear (arena) memory resource for transient data, all allocations are released at once by reset().
+// Blocks are kept between resets, so the heap is untouched once the capacity reached the high water mark.
+class LinearAllocator : public std::pmr::memory_resource {
+public:
+	LinearAllocator(size_t initialCapacity = 64 * 1024);
+	~LinearAllocator();
+
+	LinearAllocator(const LinearAllocator&) = delete;
+	LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+	/**
+	* @brief: Release all allocations.
+	* @note: If more than one block was used, they are merged into one block for the next round.
+	* @warning: Destructors of objects are never called, use trivially destructible types only.
+	*/
+	void reset();
+
+	size_t usedSize() const noexcept;
+	size_t capacity() const noexcept;
+
+	template<typename Type, typename ...ParamTypes>
+	Type* create(ParamTypes&& ...params);
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	// Memory is released by reset() only.
+	void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+	struct Block {
+		std::byte* data;
+		size_t size;
+	};
+
+	inline void appendBlock(size_t minSize);
+	inline void releaseBlocks();
+
+	std::vector<Block> _blocks;
+	// Offset in the last block.
+	size_t _offset = 0;
+	// Bytes of all filled blocks except the last one.
+	size_t _filledSize = 0;
+};
+
+template<typename Type, typename ...ParamTypes>
+inline Type* LinearAllocator::create(ParamTypes&& ...params) {
+	static_assert(std::is_trivially_destructible_v<Type>, "LinearAllocator never calls destructors.");
+	return new (allocate(sizeof(Type), alignof(Type))) Type{ std::forward<ParamTypes>(params)... };
+}
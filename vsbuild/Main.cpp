@@ -2,6 +2,7 @@
 #include <stdexcept>
 
 #include "AfterglowApplication.h"
+#include "LaunchOptions.h"
 #include "DebugUtilities.h"
 //
 //#define DEBUG_MODE true
@@ -12,12 +13,15 @@
 
 // #endif
 
-int main() {
+int main(int argc, char** argv) {
 	std::setlocale(LC_ALL, "en_US.utf8");
 
 	try {
-		AfterglowApplication application;
+		AfterglowApplication application(launch::Parse(argc, argv));
 		application.run();
+		if (!application.benchmarkPassed()) {
+			return EXIT_FAILURE;
+		}
 	}
 	catch (const std::exception& error) {
 		DEBUG_FATAL(error.what());
@@ -126,6 +126,52 @@ namespace render {
 
 	using InputAttachmentInfos = std::vector<InputAttachmentInfo>;
 
+	enum class FrameLoopMode : uint16_t {
+		// Wait for in flight fences after recording, CPU always waits GPU to finish the current compute work.
+		Serialized, 
+		// Wait for the frame slot at the beginning of the frame, CPU records the next frame while GPU is executing the previous one.
+		Pipelined, 
+
+		EnumCount
+	};
+
+	INR_CLASS(FrameLoopMode) {
+		INR_ATTRS(
+			INR_ENUM(Serialized), 
+			INR_ENUM(Pipelined)
+		);
+	};
+
+	// Commands recorded per frame, redundant binds are not counted because they are skipped.
+	struct BindCounters {
+		uint32_t draws = 0;
+		// Instances of direct draws, indirect draws are excluded because their counts are decided by GPU.
+		uint32_t instances = 0;
+		uint32_t pipelineBinds = 0;
+		uint32_t descriptorSetBinds = 0;
+		uint32_t vertexBufferBinds = 0;
+		uint32_t indexBufferBinds = 0;
+
+		inline BindCounters& operator+=(const BindCounters& other) noexcept {
+			draws += other.draws;
+			instances += other.instances;
+			pipelineBinds += other.pipelineBinds;
+			descriptorSetBinds += other.descriptorSetBinds;
+			vertexBufferBinds += other.vertexBufferBinds;
+			indexBufferBinds += other.indexBufferBinds;
+			return *this;
+		}
+	};
+
+	// Unit: Milliseconds, smoothed over frames.
+	struct FrameTimeCounters {
+		float frameTime = 0.0f;
+		// CPU time of a frame excluding in flight fence waiting.
+		float recordTime = 0.0f;
+		// CPU time blocked by in flight fences.
+		float waitTime = 0.0f;
+	};
+
 	// Genernal pass export attachmenet names
 	constexpr const char* sceneColorMSTextureName = "sceneColorMSTexture"; // MS: Multiple sample
 	constexpr const char* sceneColorTextureName = "sceneColorTexture";
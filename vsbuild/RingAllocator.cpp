@@ -0,0 +1,65 @@
+#include "RingAllocator.h"
+
+RingAllocator::RingAllocator(uint64_t capacity, uint64_t alignment) : 
+	_capacity(capacity), _alignment(alignment) {
+}
+
+std::optional<uint64_t> RingAllocator::allocate(uint64_t size) {
+	if (_usedSize == 0) {
+		_head = 0;
+		_tail = 0;
+	}
+
+	uint64_t offset = (_head + _alignment - 1) / _alignment * _alignment;
+	uint64_t consumed = 0;
+	if (_usedSize == 0 || _head > _tail) {
+		// Free space: [head, capacity) and [0, tail).
+		if (offset + size <= _capacity) {
+			consumed = offset + size - _head;
+		}
+		else if (size <= _tail) {
+			// Wrap around, the rest of the ring is skipped.
+			offset = 0;
+			consumed = _capacity - _head + size;
+		}
+		else {
+			return std::nullopt;
+		}
+	}
+	else if (_head < _tail && offset + size <= _tail) {
+		// Wrapped, free space: [head, tail).
+		consumed = offset + size - _head;
+	}
+	else {
+		// Head reached tail, the ring is full.
+		return std::nullopt;
+	}
+
+	_head = offset + size;
+	_usedSize += consumed;
+	return offset;
+}
+
+RingAllocator::Mark RingAllocator::mark() noexcept {
+	Mark mark{ _head, _usedSize - _markedSize };
+	_markedSize = _usedSize;
+	return mark;
+}
+
+void RingAllocator::release(const Mark& mark) noexcept {
+	// Marks without allocations never moved the head, their end may be outdated after the ring was reset.
+	if (mark.bytes == 0) {
+		return;
+	}
+	_tail = mark.end;
+	_usedSize -= mark.bytes;
+	_markedSize -= mark.bytes;
+}
+
+uint64_t RingAllocator::capacity() const noexcept {
+	return _capacity;
+}
+
+uint64_t RingAllocator::usedSize() const noexcept {
+	return _usedSize;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+// Offset allocator of a ring buffer, allocations are released in order by marks, e.g. one mark per submitted batch.
+// It only computes offsets, memory of the ring is owned by the user.
+class RingAllocator {
+public:
+	// @brief: Ring space allocated between two marks.
+	struct Mark {
+		// Head when the mark was taken, space before it is released with the mark.
+		uint64_t end = 0;
+		// Bytes allocated since the previous mark, including alignment and wrapping padding.
+		uint64_t bytes = 0;
+	};
+
+	RingAllocator(uint64_t capacity, uint64_t alignment);
+
+	// @return: Aligned offset of the allocation, nullopt if the free space does not fit the size.
+	std::optional<uint64_t> allocate(uint64_t size);
+	// @brief: Take the allocations since the previous mark, the mark should be released after all of them are unused.
+	Mark mark() noexcept;
+	// @brief: Release marks in the order they were taken.
+	void release(const Mark& mark) noexcept;
+
+	uint64_t capacity() const noexcept;
+	uint64_t usedSize() const noexcept;
+
+private:
+	uint64_t _capacity;
+	uint64_t _alignment;
+	uint64_t _head = 0;
+	// Beginning of the oldest unreleased allocation.
+	uint64_t _tail = 0;
+	uint64_t _usedSize = 0;
+	uint64_t _markedSize = 0;
+};
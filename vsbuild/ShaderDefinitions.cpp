@@ -1,5 +1,8 @@
 #include "ShaderDefinitions.h"
 
+#include <bit>
+#include <limits>
+#include <algorithm>
 #include <stdexcept>
 
 #include "AfterglowUtilities.h"
@@ -7,3 +10,84 @@
 uint32_t shader::AttachmentTextureBindingIndex(uint32_t inputAttachmentLocalIndex) {
 	return util::EnumValue(shader::GlobalSetBindingIndex::EnumCount) + inputAttachmentLocalIndex;
 }
+
+uint32_t shader::KeywordBitCount(const Keyword& keyword) noexcept {
+	if (keyword.values.size() <= 2) {
+		return 1;
+	}
+	return static_cast<uint32_t>(std::bit_width(keyword.values.size() - 1));
+}
+
+uint32_t shader::KeywordsBitCount(const Keywords& keywords) noexcept {
+	uint32_t bitCount = 0;
+	for (const auto& keyword : keywords) {
+		bitCount += KeywordBitCount(keyword);
+	}
+	return bitCount;
+}
+
+uint32_t shader::KeywordIndex(const Keywords& keywords, const std::string& name) noexcept {
+	for (uint32_t index = 0; index < keywords.size(); ++index) {
+		if (keywords[index].name == name) {
+			return index;
+		}
+	}
+	return static_cast<uint32_t>(keywords.size());
+}
+
+uint32_t shader::KeywordValue(const Keywords& keywords, KeywordMask mask, uint32_t keywordIndex) noexcept {
+	uint32_t bitOffset = 0;
+	for (uint32_t index = 0; index < keywordIndex && index < keywords.size(); ++index) {
+		bitOffset += KeywordBitCount(keywords[index]);
+	}
+	if (keywordIndex >= keywords.size() || bitOffset >= std::numeric_limits<KeywordMask>::digits) {
+		return 0;
+	}
+	auto bitCount = KeywordBitCount(keywords[keywordIndex]);
+	return static_cast<uint32_t>((mask >> bitOffset) & ((KeywordMask(1) << bitCount) - 1));
+}
+
+shader::KeywordMask shader::SetKeywordValue(const Keywords& keywords, KeywordMask mask, uint32_t keywordIndex, uint32_t value) {
+	if (keywordIndex >= keywords.size()) {
+		throw std::invalid_argument("Keyword index is out of range.");
+	}
+	const auto& keyword = keywords[keywordIndex];
+	if (value >= std::max<size_t>(keyword.values.size(), 2)) {
+		throw std::invalid_argument("Value of keyword \"" + keyword.name + "\" is out of range.");
+	}
+	uint32_t bitOffset = 0;
+	for (uint32_t index = 0; index < keywordIndex; ++index) {
+		bitOffset += KeywordBitCount(keywords[index]);
+	}
+	auto bitCount = KeywordBitCount(keyword);
+	if (bitOffset + bitCount > std::numeric_limits<KeywordMask>::digits) {
+		throw std::invalid_argument("Too many keywords, they should fit in a 64 bits mask.");
+	}
+	KeywordMask valueMask = ((KeywordMask(1) << bitCount) - 1) << bitOffset;
+	return (mask & ~valueMask) | (KeywordMask(value) << bitOffset);
+}
+
+shader::Defines shader::KeywordDefines(const Keywords& keywords, KeywordMask mask) {
+	Defines defines;
+	for (uint32_t index = 0; index < keywords.size(); ++index) {
+		const auto& keyword = keywords[index];
+		defines.emplace_back(keyword.name, std::to_string(KeywordValue(keywords, mask, index)));
+		for (uint32_t valueIndex = 0; valueIndex < keyword.values.size(); ++valueIndex) {
+			defines.emplace_back(keyword.name + "_" + keyword.values[valueIndex], std::to_string(valueIndex));
+		}
+	}
+	return defines;
+}
+
+bool shader::ModelRequiresDeviceFeatures(Model model) noexcept {
+	return util::EnumValue(model) >= util::EnumValue(Model::SM6_2);
+}
+
+shader::Defines shader::ModelDefines(Model model) {
+	std::string featureValue = ModelRequiresDeviceFeatures(model) ? "1" : "0";
+	return {
+		{ "AFTERGLOW_SHADER_MODEL", std::to_string(util::EnumValue(model)) }, 
+		{ "AFTERGLOW_WAVE_OPS", featureValue }, 
+		{ "AFTERGLOW_NATIVE_16BIT", featureValue }
+	};
+}
@@ -1,5 +1,9 @@
 #pragma once
 #include <stdint.h>
+#include <limits>
+#include <string>
+#include <vector>
+#include <utility>
 #include "Inreflect.h"
 
 namespace shader {
@@ -126,9 +130,74 @@ namespace shader {
 
 	enum class  PerObjectSetBindingIndex : uint32_t {
 		MeshUniform = 0, 
+		// Per frame instance data of instancing materials, shared by all per object sets.
+		ObjectInstances = 1, 
 		
 		EnumCount
 	};
 
 	uint32_t AttachmentTextureBindingIndex(uint32_t inputAttachmentLocalIndex);
+
+	// Selects a shader variant, keywords occupy continuous bits in declaration order, 0 is the default variant.
+	using KeywordMask = uint64_t;
+	constexpr uint32_t maxKeywordBitCount = std::numeric_limits<KeywordMask>::digits;
+	// <name, value>, passed to the compiler as "-D name=value".
+	using Define = std::pair<std::string, std::string>;
+	using Defines = std::vector<Define>;
+
+	/**
+	* @brief: Compile time switch of shaders, each used combination is compiled as a variant.
+	*	Boolean keyword if values is empty, otherwise enum keyword which selects one of values, the first one is default.
+	*/
+	struct Keyword {
+		std::string name;
+		std::vector<std::string> values;
+	};
+	using Keywords = std::vector<Keyword>;
+
+	// @return: Count of mask bits used by this keyword.
+	uint32_t KeywordBitCount(const Keyword& keyword) noexcept;
+	// @return: Count of mask bits used by all keywords, they fit in the mask if not greater than maxKeywordBitCount.
+	uint32_t KeywordsBitCount(const Keywords& keywords) noexcept;
+	// @return: Index of the keyword, or keywords.size() if not found.
+	uint32_t KeywordIndex(const Keywords& keywords, const std::string& name) noexcept;
+	// @return: 0 or 1 of a boolean keyword, value index of an enum keyword.
+	uint32_t KeywordValue(const Keywords& keywords, KeywordMask mask, uint32_t keywordIndex) noexcept;
+	// @brief: Throw invalid argument if the keyword index or the value is out of range.
+	KeywordMask SetKeywordValue(const Keywords& keywords, KeywordMask mask, uint32_t keywordIndex, uint32_t value);
+	/**
+	* @brief: Defines of the variant selected by the mask.
+	*	Boolean keyword: NAME=0|1.
+	*	Enum keyword: NAME=valueIndex, and NAME_VALUE=index for each value, so shaders compare as "#if NAME == NAME_VALUE".
+	*/
+	Defines KeywordDefines(const Keywords& keywords, KeywordMask mask);
+
+	/**
+	* @brief: Target shader model, value is the model version (e.g. 62 for 6.2).
+	* @desc: 
+	*	SM6_0: Baseline, spirv for vulkan1.0.
+	*	SM6_2 and higher: Wave intrinsics (vulkan1.1 subgroup operations) and native 16-bit types (-enable-16bit-types).
+	*	If the device does not support them, the shader falls back to SM6_0, see ModelDefines().
+	*/
+	enum class Model : uint32_t {
+		SM6_0 = 60, 
+		SM6_2 = 62, 
+		SM6_6 = 66
+	};
+
+	INR_CLASS(Model) {
+		INR_ATTRS (
+			INR_ENUM(SM6_0), 
+			INR_ENUM(SM6_2), 
+			INR_ENUM(SM6_6)
+		);
+	};
+
+	// @return: True if the model requires wave intrinsics and native 16-bit types support of the device.
+	bool ModelRequiresDeviceFeatures(Model model) noexcept;
+	/**
+	* @brief: Defines of the compiled model, shaders select code paths by them instead of the requested model.
+	*	AFTERGLOW_SHADER_MODEL=60|62|66, AFTERGLOW_WAVE_OPS=0|1, AFTERGLOW_NATIVE_16BIT=0|1.
+	*/
+	Defines ModelDefines(Model model);
 }
@@ -19,16 +19,17 @@
 
 StandardVSOutput main(VSInput input) {
 	StandardVSOutput output;
+	ObjectInstance instance = LoadObjectInstance(input.instanceID);
 	// input.position = floor(input.position * 0.25) * 4.0;
-	float4 worldPosition = mul(model, float4(input.position, 1.0));
+	float4 worldPosition = mul(instance.model, float4(input.position, 1.0));
 	// worldPosition.xyz = floor(worldPosition.xyz * 0.25) * 4.0;
 	output.position = mul(viewProjection, worldPosition);
 	output.worldPosition = worldPosition;
-	output.worldNormal = normalize(mul(invTransModel, float4(input.normal, 0.0)).xyz);
-	output.worldTangent = normalize(mul(invTransModel, float4(input.tangent, 0.0)).xyz);
+	output.worldNormal = normalize(mul(instance.invTransModel, float4(input.normal, 0.0)).xyz);
+	output.worldTangent = normalize(mul(instance.invTransModel, float4(input.tangent, 0.0)).xyz);
 	output.worldBitangent = cross(output.worldNormal, output.worldTangent);
 	output.color = input.color;
-	output.objectID = objectID; // input.instanceID;
+	output.objectID = instance.objectID;
 	output.texCoord0 = input.texCoord0;
 	return output;
 }
\ No newline at end of file
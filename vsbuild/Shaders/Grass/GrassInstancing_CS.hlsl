@@ -57,7 +57,17 @@ void main(
 	}
 
 	uint instanceIndex;
+#if AFTERGLOW_WAVE_OPS
+	// One atomic per wave instead of per grass, the first active lane reserves instances for all visible grass in the wave.
+	uint waveInstanceCount = WaveActiveCountBits(true);
+	uint waveInstanceOffset = 0;
+	if (WaveIsFirstLane()) {
+		InterlockedAdd(IndirectBufferOut[0].instanceCount, waveInstanceCount, waveInstanceOffset);
+	}
+	instanceIndex = WaveReadLaneFirst(waveInstanceOffset) + WavePrefixCountBits(true);
+#else
 	InterlockedAdd(IndirectBufferOut[0].instanceCount, 1, instanceIndex);
+#endif
 	
 	// Write instance buffer
 	InstanceBufferStruct instanceInfo;
@@ -2,7 +2,8 @@
 
 UnlitVSOutput main(VSInput input) {
 	UnlitVSOutput output;
-	output.position = mul(viewProjection, mul(model, float4(input.position, 1.0)));
+	ObjectInstance instance = LoadObjectInstance(input.instanceID);
+	output.position = mul(viewProjection, mul(instance.model, float4(input.position, 1.0)));
 	output.texCoord0 = input.texCoord0;
 	return output;
 }
\ No newline at end of file
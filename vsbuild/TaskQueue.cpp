@@ -0,0 +1,93 @@
+#include "TaskQueue.h"
+#include "AllocationAudit.h"
+#include "DebugUtilities.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct TaskQueue::Impl {
+	Impl(uint32_t workerCount, const char* inThreadName);
+	~Impl();
+
+	void workerLoop(std::stop_token stopToken);
+
+	const char* threadName;
+
+	mutable std::mutex mutex;
+	std::condition_variable_any jobCondition;
+	std::deque<Job> jobs;
+
+	// Declare it last, threads should be joined before other members destroy.
+	std::vector<std::jthread> workers;
+};
+
+TaskQueue::Impl::Impl(uint32_t workerCount, const char* inThreadName) : 
+	threadName(inThreadName) {
+	workerCount = std::max(workerCount, 1u);
+	workers.reserve(workerCount);
+	for (uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex) {
+		workers.emplace_back([this](std::stop_token stopToken) { workerLoop(stopToken); });
+	}
+}
+
+TaskQueue::Impl::~Impl() {
+	for (auto& worker : workers) {
+		worker.request_stop();
+	}
+	// condition_variable_any wakes up the waiting workers when stop requested.
+	workers.clear();
+}
+
+void TaskQueue::Impl::workerLoop(std::stop_token stopToken) {
+	audit::RegisterThread(threadName);
+	while (true) {
+		Job job;
+		{
+			std::unique_lock lock(mutex);
+			if (!jobCondition.wait(lock, stopToken, [this]() { return !jobs.empty(); })) {
+				return;
+			}
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+
+		try {
+			job();
+		}
+		catch (std::exception& exception) {
+			DEBUG_TYPE_ERROR(TaskQueue, std::format("Job of \"{}\" threw: {}", threadName, exception.what()));
+		}
+		catch (...) {
+			DEBUG_TYPE_ERROR(TaskQueue, std::format("Job of \"{}\" threw an unknown exception.", threadName));
+		}
+	}
+}
+
+TaskQueue::TaskQueue(uint32_t workerCount, const char* threadName) :
+	_impl(std::make_unique<Impl>(workerCount, threadName)) {
+}
+
+TaskQueue::~TaskQueue() {
+}
+
+uint32_t TaskQueue::workerCount() const noexcept {
+	return static_cast<uint32_t>(_impl->workers.size());
+}
+
+void TaskQueue::push(Job&& job) {
+	{
+		std::lock_guard lock(_impl->mutex);
+		_impl->jobs.push_back(std::move(job));
+	}
+	_impl->jobCondition.notify_one();
+}
+
+size_t TaskQueue::pendingCount() const {
+	std::lock_guard lock(_impl->mutex);
+	return _impl->jobs.size();
+}
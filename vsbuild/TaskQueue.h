@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <functional>
+
+// Regularly, projection independent classes should not add a prefix.
+// Fixed size worker threads for fire-and-forget jobs in FIFO order, workers sleep when there is no job.
+class TaskQueue {
+public:
+	using Job = std::function<void()>;
+
+	// @param workerCount: at least one worker is created.
+	TaskQueue(uint32_t workerCount = 1, const char* threadName = "TaskQueue");
+	// @note: Running jobs are finished, pending jobs are dropped.
+	~TaskQueue();
+
+	uint32_t workerCount() const noexcept;
+
+	/**
+	* @brief: Queue a job, it never blocks on the job.
+	* @note: Exceptions thrown by jobs are reported and swallowed, handle them inside jobs if they matter.
+	*/
+	void push(Job&& job);
+
+	// @return: Jobs which were queued and not started yet.
+	size_t pendingCount() const;
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> _impl;
+};
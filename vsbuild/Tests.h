@@ -230,3 +230,324 @@ namespace partialSpecificationTest {
 
 	}
 }
+
+// Cases below print their results, they do not need a device.
+namespace testUtility {
+	void check(const char* caseName, bool passed) {
+		std::cout << caseName << ": " << (passed ? "passed" : "FAILED") << '\n';
+	}
+}
+
+#include <fstream>
+#include <limits>
+#include <cstddef>
+#include <filesystem>
+#include "AfterglowSpirvCache.h"
+namespace spirvCacheTest {
+	void test() {
+		auto directory = (std::filesystem::temp_directory_path() / "AfterglowSpirvCacheTest").string() + "/";
+		std::filesystem::remove_all(directory);
+		AfterglowSpirvCache::SpirvBytes spirv(64, 0x07230203);
+		AfterglowSpirvCache::Key key = 1;
+		// Entry file is named by the hex key.
+		auto path = std::format("{}{:016x}.spv", directory, key);
+
+		AfterglowSpirvCache{ directory, 1024 * 1024 }.store(key, spirv, {}, "report");
+		// Spirv size in the head exceeds the rest of the file.
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - sizeof(uint32_t));
+		{
+			AfterglowSpirvCache cache{ directory, 1024 * 1024 };
+			AfterglowSpirvCache::SpirvBytes loadedSpirv;
+			testUtility::check("Truncated spirv cache entry misses", !cache.load(key, loadedSpirv) && loadedSpirv.empty());
+			testUtility::check("Truncated spirv cache entry is evicted", cache.statistics().evictionCount == 1 && !std::filesystem::exists(path));
+		}
+
+		AfterglowSpirvCache{ directory, 1024 * 1024 }.store(key, spirv, {}, "report");
+		// Spirv size in the head is far larger than the file, it is rejected before the destination is resized or read.
+		{
+			std::fstream file{ path, std::ios::binary | std::ios::in | std::ios::out };
+			uint32_t spirvSize = std::numeric_limits<uint32_t>::max();
+			file.seekp(offsetof(AfterglowSpirvCache::FileHead, spirvSize));
+			file.write(reinterpret_cast<const char*>(&spirvSize), sizeof(spirvSize));
+		}
+		{
+			AfterglowSpirvCache cache{ directory, 1024 * 1024 };
+			AfterglowSpirvCache::SpirvBytes loadedSpirv{ 1, 2, 3 };
+			testUtility::check(
+				"Oversized spirv cache head is rejected before reading", 
+				!cache.load(key, loadedSpirv) && loadedSpirv == AfterglowSpirvCache::SpirvBytes{ 1, 2, 3 }
+			);
+		}
+
+		AfterglowSpirvCache{ directory, 1024 * 1024 }.store(key, spirv, {}, "report");
+		// Report size in the head exceeds the file, nothing should be allocated for it.
+		{
+			std::fstream file{ path, std::ios::binary | std::ios::in | std::ios::out };
+			uint32_t reportSize = std::numeric_limits<uint32_t>::max();
+			file.seekp(offsetof(AfterglowSpirvCache::FileHead, reportSize));
+			file.write(reinterpret_cast<const char*>(&reportSize), sizeof(reportSize));
+		}
+		{
+			AfterglowSpirvCache cache{ directory, 1024 * 1024 };
+			AfterglowSpirvCache::SpirvBytes loadedSpirv;
+			std::string report;
+			testUtility::check("Oversized spirv cache report misses", !cache.load(key, loadedSpirv, nullptr, &report) && report.empty());
+			testUtility::check("Oversized spirv cache report is evicted", cache.statistics().evictionCount == 1 && !std::filesystem::exists(path));
+		}
+
+		// Intact entry still hits.
+		AfterglowSpirvCache{ directory, 1024 * 1024 }.store(key, spirv, {}, "report");
+		{
+			AfterglowSpirvCache cache{ directory, 1024 * 1024 };
+			AfterglowSpirvCache::SpirvBytes loadedSpirv;
+			std::string report;
+			testUtility::check("Spirv cache entry hits", cache.load(key, loadedSpirv, nullptr, &report) && loadedSpirv == spirv && report == "report");
+		}
+
+		std::filesystem::remove_all(directory);
+	}
+}
+
+#include <string>
+#include <algorithm>
+#include "DependencyGraph.h"
+namespace dependencyGraphTest {
+	void test() {
+		using Nodes = DependencyGraph<std::string>::Nodes;
+		DependencyGraph<std::string> graph;
+		graph.link("Common.hlsli", "Lighting.hlsli");
+		graph.link("Lighting.hlsli", "Standard.hlsl");
+		graph.setDependencies("Standard", { "Standard.hlsl", "Common.hlsli" });
+		graph.setDependencies("StandardInstance", { "Standard" });
+
+		testUtility::check(
+			"Dependents are transitive in breadth first order", 
+			graph.dependents("Lighting.hlsli") == Nodes{ "Standard.hlsl", "Standard", "StandardInstance" }
+		);
+		// Order of dependents in the same depth is unspecified.
+		auto commonDependents = graph.dependents("Common.hlsli");
+		std::sort(commonDependents.begin(), commonDependents.end());
+		testUtility::check(
+			"Shared dependents are visited once", 
+			commonDependents == Nodes{ "Lighting.hlsli", "Standard", "Standard.hlsl", "StandardInstance" }
+		);
+
+		graph.link("Standard.hlsl", "Common.hlsli");
+		testUtility::check("Cyclic dependents exclude the node itself", graph.dependents("Common.hlsli").size() == 4);
+
+		graph.setDependencies("StandardInstance", { "StandardVariant" });
+		testUtility::check(
+			"Dependencies are replaced", 
+			graph.dependents("Standard").empty() && graph.dependencies("StandardInstance") == Nodes{ "StandardVariant" }
+		);
+
+		graph.remove("Standard.hlsl");
+		testUtility::check(
+			"Removed node is unlinked", 
+			!graph.contains("Standard.hlsl") && graph.dependents("Lighting.hlsli").empty() 
+				&& graph.dependencies("Standard") == Nodes{ "Common.hlsli" }
+		);
+	}
+}
+
+#include <stdexcept>
+#include "ShaderDefinitions.h"
+namespace keywordMaskTest {
+	void test() {
+		shader::Keywords keywords{
+			{ "SHADOW", {} }, 
+			{ "QUALITY", { "LOW", "MEDIUM", "HIGH" } }, 
+			{ "FOG", {} }, 
+			{ "BLEND", { "OPAQUE", "ALPHA" } }
+		};
+		testUtility::check(
+			"Keyword bit counts", 
+			shader::KeywordBitCount(keywords[0]) == 1 && shader::KeywordBitCount(keywords[1]) == 2 
+				&& shader::KeywordBitCount(keywords[3]) == 1 && shader::KeywordsBitCount(keywords) == 5
+		);
+
+		shader::KeywordMask mask = 0;
+		mask = shader::SetKeywordValue(keywords, mask, 1, 2);
+		mask = shader::SetKeywordValue(keywords, mask, 2, 1);
+		mask = shader::SetKeywordValue(keywords, mask, 3, 1);
+		testUtility::check(
+			"Keywords occupy continuous bits in declaration order", 
+			mask == ((2ull << 1) | (1ull << 3) | (1ull << 4))
+		);
+		testUtility::check(
+			"Keyword values are read back", 
+			shader::KeywordValue(keywords, mask, 0) == 0 && shader::KeywordValue(keywords, mask, 1) == 2 
+				&& shader::KeywordValue(keywords, mask, 2) == 1 && shader::KeywordValue(keywords, mask, 3) == 1
+		);
+		mask = shader::SetKeywordValue(keywords, mask, 1, 1);
+		testUtility::check(
+			"Setting a keyword keeps the others", 
+			shader::KeywordValue(keywords, mask, 1) == 1 && shader::KeywordValue(keywords, mask, 2) == 1 
+				&& shader::KeywordValue(keywords, mask, 3) == 1
+		);
+
+		bool outOfRangeThrown = false;
+		try {
+			shader::SetKeywordValue(keywords, mask, 1, 3);
+		}
+		catch (const std::invalid_argument&) {
+			outOfRangeThrown = true;
+		}
+		testUtility::check("Out of range keyword value throws", outOfRangeThrown);
+
+		// Every keyword bit of the mask is used, the last one is the highest bit.
+		shader::Keywords fullKeywords(shader::maxKeywordBitCount, shader::Keyword{ "KEYWORD", {} });
+		auto fullMask = shader::SetKeywordValue(fullKeywords, 0, shader::maxKeywordBitCount - 1, 1);
+		testUtility::check(
+			"Keywords fill the mask", 
+			shader::KeywordsBitCount(fullKeywords) == shader::maxKeywordBitCount 
+				&& fullMask == (shader::KeywordMask(1) << (shader::maxKeywordBitCount - 1))
+		);
+		fullKeywords.push_back(shader::Keyword{ "OVERFLOW", {} });
+		bool overflowThrown = false;
+		try {
+			shader::SetKeywordValue(fullKeywords, 0, shader::maxKeywordBitCount, 1);
+		}
+		catch (const std::invalid_argument&) {
+			overflowThrown = true;
+		}
+		testUtility::check(
+			"Keywords over the mask bits throw", 
+			overflowThrown && shader::KeywordsBitCount(fullKeywords) > shader::maxKeywordBitCount 
+				&& shader::KeywordValue(fullKeywords, fullMask, shader::maxKeywordBitCount) == 0
+		);
+	}
+}
+
+#include <deque>
+#include "RingAllocator.h"
+namespace ringAllocatorTest {
+	void test() {
+		RingAllocator ring{ 256, 16 };
+		// Marks are released in order, as batches are retired by their tickets.
+		std::deque<RingAllocator::Mark> marks;
+
+		auto first = ring.allocate(100);
+		auto second = ring.allocate(50);
+		testUtility::check("Ring offsets are aligned", first == 0 && second == 112);
+		marks.push_back(ring.mark());
+		auto third = ring.allocate(80);
+		marks.push_back(ring.mark());
+		testUtility::check("Full ring rejects allocations", third == 176 && !ring.allocate(16) && ring.usedSize() == 256);
+
+		ring.release(marks.front());
+		marks.pop_front();
+		// Alignment padding before the third allocation belongs to the second batch.
+		testUtility::check("Retired batch releases its ring space", ring.usedSize() == 256 - 162);
+		// Head is at the end of the ring, the allocation wraps to the released space.
+		auto wrapped = ring.allocate(120);
+		testUtility::check("Ring wraps around to the released space", wrapped == 0 && ring.usedSize() == 256 - 162 + 120);
+		testUtility::check("Wrapped head does not pass the tail", !ring.allocate(64));
+		marks.push_back(ring.mark());
+		// Batch without uploads.
+		marks.push_back(ring.mark());
+
+		ring.release(marks.front());
+		marks.pop_front();
+		testUtility::check("Retired batch before the wrap releases the skipped space", ring.usedSize() == 120);
+		auto afterWrap = ring.allocate(128);
+		testUtility::check("Ring allocates after the wrapped head", afterWrap == 128);
+		marks.push_back(ring.mark());
+
+		while (!marks.empty()) {
+			ring.release(marks.front());
+			marks.pop_front();
+		}
+		testUtility::check("Ring is empty after all batches were retired", ring.usedSize() == 0 && ring.allocate(256) == 0);
+	}
+}
+
+#include "BuddyAllocator.h"
+namespace buddyAllocatorTest {
+	void test() {
+		BuddyAllocator block{ 4096, 256 };
+		testUtility::check(
+			"Buddy levels round sizes up to nodes", 
+			block.level(4096) == 0 && block.level(2049) == 0 && block.level(2048) == 1 
+				&& block.level(300) == 3 && block.level(1) == 4 && block.levelSize(4) == 256
+		);
+
+		// 4096 is split into 2048, 1024, 512 and two 256 nodes.
+		auto first = block.allocate(block.level(200));
+		auto second = block.allocate(block.level(256));
+		testUtility::check(
+			"Buddy node is split down to the level", 
+			first && second && *first != *second && block.largestFreeSize() == 2048 && block.usedSize() == 512
+		);
+
+		// Offsets are multiples of node sizes, so alignments up to the node size are satisfied.
+		auto aligned = block.allocate(block.level(1024));
+		testUtility::check("Buddy node is aligned to its size", aligned && *aligned % 1024 == 0);
+
+		auto whole = block.allocate(block.level(4096));
+		testUtility::check("Buddy allocation larger than the free nodes fails", !whole && block.allocationCount() == 3);
+
+		block.free(*first, block.level(200));
+		testUtility::check("Buddy node is not merged with a used buddy", block.largestFreeSize() == 2048 && block.usedSize() == 1280);
+		block.free(*second, block.level(256));
+		testUtility::check("Freed buddies are merged", block.largestFreeSize() == 2048 && block.usedSize() == 1024);
+		block.free(*aligned, block.level(1024));
+		// Empty blocks are released by the memory allocator, except the last one of each pool.
+		testUtility::check(
+			"Empty block is merged into one node", 
+			block.allocationCount() == 0 && block.usedSize() == 0 && block.largestFreeSize() == 4096
+		);
+		testUtility::check("Merged block holds the whole size", block.allocate(block.level(4096)) == 0);
+	}
+}
+
+#include <vector>
+#include "DeletionQueue.h"
+namespace deletionQueueTest {
+	// Records its id when destroyed, moved-from objects record nothing.
+	struct Tracked {
+		Tracked(int inId, std::vector<int>& inDestroyedIds) : id(inId), destroyedIds(&inDestroyedIds) {}
+		Tracked(Tracked&& other) noexcept : id(other.id), destroyedIds(std::exchange(other.destroyedIds, nullptr)) {}
+		~Tracked() {
+			if (destroyedIds) {
+				destroyedIds->push_back(id);
+			}
+		}
+
+		int id;
+		std::vector<int>* destroyedIds;
+	};
+
+	void test() {
+		std::vector<int> destroyedIds;
+		uint64_t completedPoint = 0;
+		auto completed = [&completedPoint](uint64_t point) { return point <= completedPoint; };
+
+		DeletionQueue<uint64_t> queue;
+		queue.release(1, Tracked{ 0, destroyedIds });
+		queue.release(1, Tracked{ 1, destroyedIds });
+		queue.release(2, Tracked{ 2, destroyedIds });
+		queue.release(3, Tracked{ 3, destroyedIds });
+		testUtility::check("Released objects are kept", destroyedIds.empty() && queue.pendingCount() == 4);
+
+		queue.update(completed);
+		testUtility::check("Objects are kept until their points were completed", destroyedIds.empty());
+
+		completedPoint = 2;
+		queue.update(completed);
+		testUtility::check(
+			"Completed objects are destroyed in order of release", 
+			destroyedIds == std::vector<int>{ 0, 1, 2 } && queue.pendingCount() == 1
+		);
+
+		completedPoint = 3;
+		queue.update(completed);
+		testUtility::check("Queue is empty after all points were completed", destroyedIds.size() == 4 && queue.pendingCount() == 0);
+
+		{
+			DeletionQueue<uint64_t> pendingQueue;
+			pendingQueue.release(1, Tracked{ 4, destroyedIds });
+		}
+		testUtility::check("Pending objects are destroyed with the queue", destroyedIds.back() == 4);
+	}
+}
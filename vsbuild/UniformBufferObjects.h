@@ -102,6 +102,22 @@ namespace ubo {
 		);
 	};
 
+	// Per instance data of instancing materials, members are the subset of MeshUniform.
+	// @note: Size is padded to 16 bytes, same as std430 StructuredBuffer element stride.
+	struct ObjectInstance {
+		alignas(16) glm::mat4 model;
+		alignas(16) glm::mat4 invTransModel;
+		alignas(4) uint32_t objectID;
+	};
+
+	INR_CLASS(ObjectInstance) {
+		INR_ATTRS (
+			INR_ATTR(model), 
+			INR_ATTR(invTransModel), 
+			INR_ATTR(objectID)
+		);
+	};
+
 	struct MetaInfo {
 		std::string type;
 		std::string name;
@@ -0,0 +1,128 @@
+#include "WorkerPool.h"
+#include "AllocationAudit.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct WorkerPool::Impl {
+	Impl(uint32_t workerCount);
+	~Impl();
+
+	void workerLoop(std::stop_token stopToken, uint32_t workerIndex);
+	inline void executeTasks(uint32_t workerIndex);
+
+	std::mutex mutex;
+	std::condition_variable_any jobCondition;
+	std::condition_variable doneCondition;
+
+	// Increase once per job, workers compare it with their local generation to find a new job.
+	uint64_t generation = 0;
+	uint32_t busyWorkerCount = 0;
+
+	const Task* task = nullptr;
+	uint32_t taskCount = 0;
+	std::atomic<uint32_t> nextTaskIndex = 0;
+	std::exception_ptr exception;
+
+	// Declare it last, threads should be joined before other members destroy.
+	std::vector<std::jthread> workers;
+};
+
+WorkerPool::Impl::Impl(uint32_t workerCount) {
+	if (workerCount == 0) {
+		workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+	workers.reserve(workerCount);
+	for (uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex) {
+		workers.emplace_back([this, workerIndex](std::stop_token stopToken) { workerLoop(stopToken, workerIndex); });
+	}
+}
+
+WorkerPool::Impl::~Impl() {
+	for (auto& worker : workers) {
+		worker.request_stop();
+	}
+	// condition_variable_any wakes up the waiting workers when stop requested.
+	workers.clear();
+}
+
+void WorkerPool::Impl::workerLoop(std::stop_token stopToken, uint32_t workerIndex) {
+	audit::RegisterThread("WorkerPool");
+	uint64_t localGeneration = 0;
+	while (true) {
+		{
+			std::unique_lock lock(mutex);
+			if (!jobCondition.wait(lock, stopToken, [&]() { return generation != localGeneration; })) {
+				return;
+			}
+			localGeneration = generation;
+		}
+
+		executeTasks(workerIndex);
+
+		std::lock_guard lock(mutex);
+		if (--busyWorkerCount == 0) {
+			doneCondition.notify_one();
+		}
+	}
+}
+
+inline void WorkerPool::Impl::executeTasks(uint32_t workerIndex) {
+	uint32_t taskIndex = nextTaskIndex.fetch_add(1, std::memory_order_relaxed);
+	while (taskIndex < taskCount) {
+		try {
+			(*task)(taskIndex, workerIndex);
+		}
+		catch (...) {
+			std::lock_guard lock(mutex);
+			if (!exception) {
+				exception = std::current_exception();
+			}
+		}
+		taskIndex = nextTaskIndex.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+WorkerPool::WorkerPool(uint32_t workerCount) :
+	_impl(std::make_unique<Impl>(workerCount)) {
+}
+
+WorkerPool::~WorkerPool() {
+}
+
+uint32_t WorkerPool::workerCount() const noexcept {
+	return static_cast<uint32_t>(_impl->workers.size());
+}
+
+void WorkerPool::parallelFor(uint32_t taskCount, Task task) {
+	if (taskCount == 0) {
+		return;
+	}
+	// Not worth to wake up workers.
+	if (taskCount == 1) {
+		task(0, 0);
+		return;
+	}
+
+	std::unique_lock lock(_impl->mutex);
+	_impl->task = &task;
+	_impl->taskCount = taskCount;
+	_impl->nextTaskIndex.store(0, std::memory_order_relaxed);
+	_impl->exception = nullptr;
+	_impl->busyWorkerCount = workerCount();
+	++_impl->generation;
+	_impl->jobCondition.notify_all();
+
+	_impl->doneCondition.wait(lock, [this]() { return _impl->busyWorkerCount == 0; });
+	_impl->task = nullptr;
+
+	if (_impl->exception) {
+		std::rethrow_exception(std::exchange(_impl->exception, nullptr));
+	}
+}
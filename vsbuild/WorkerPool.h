@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <type_traits>
+
+// Regularly, projection independent classes should not add a prefix.
+// Fixed size worker threads for fork-join jobs, workers sleep when there is no job.
+class WorkerPool {
+public:
+	/**
+	* @brief: Non-owning reference of a callable: void(uint32_t taskIndex, uint32_t workerIndex).
+	*	workerIndex is the index of the worker which executes this task, in [0, workerCount). Use it for per-thread resources.
+	* @note: Unlike std::function, it never allocates, the callable should outlive parallelFor().
+	*/
+	class Task {
+	public:
+		template<typename CallableType>
+			requires (!std::is_same_v<std::remove_cvref_t<CallableType>, Task>)
+		Task(CallableType&& callable) noexcept : 
+			_callable(const_cast<void*>(static_cast<const void*>(&callable))),
+			_invoke([](void* callable, uint32_t taskIndex, uint32_t workerIndex) {
+				(*static_cast<std::remove_reference_t<CallableType>*>(callable))(taskIndex, workerIndex);
+			}) {
+		}
+
+		inline void operator()(uint32_t taskIndex, uint32_t workerIndex) const { _invoke(_callable, taskIndex, workerIndex); }
+
+	private:
+		void* _callable;
+		void(*_invoke)(void*, uint32_t, uint32_t);
+	};
+
+	// @param workerCount: 0 means (hardware threads - 1), at least one worker is created.
+	WorkerPool(uint32_t workerCount = 0);
+	~WorkerPool();
+
+	uint32_t workerCount() const noexcept;
+
+	/**
+	* @brief: Execute task for each index in [0, taskCount), block the caller until all tasks finished.
+	* @note: The first exception thrown by tasks is rethrown in caller thread.
+	* @warning: Not reentrant, never call it from a task.
+	*/
+	void parallelFor(uint32_t taskCount, Task task);
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> _impl;
+};